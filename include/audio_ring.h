@@ -0,0 +1,142 @@
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+/**
+ * 音频采集环形缓冲区 (单生产者 / 多读者)
+ *
+ * - 生产者：音频采集任务，唯一读取 I2S 的地方
+ * - 读者：HTTP 处理函数、流发送任务，各自持有一个 64 位样本游标
+ *
+ * 游标是从开机起的绝对样本序号，不会回绕；读者落后超过环容量时，
+ * read() 会把游标推进到最旧的可用样本，并通过 dropped 报告丢失的样本数。
+ * 读写都不加锁：64 位写指针和时间锚点用同一个顺序锁 (SeqlockI64Pair) 成对发布，读完后再校验一次是否被覆盖。
+ *
+ * 写指针同时带有一个时间锚点：下一个样本 (序号 = head) 的采集时刻 (halNowUs 时钟)，
+ * 任意样本的采集时刻按采样率从锚点推算，见 sampleTimeUs()。
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "seqlock.h"
+
+class AudioRing {
+public:
+    // storage 由调用者提供 (内部 RAM 或 PSRAM)；guard 为生产者单次写入的最大样本数
+    void begin(int16_t* storage, uint32_t capacity, uint32_t guard, uint32_t sample_rate) {
+        buf_ = storage;
+        cap_ = capacity;
+        guard_ = guard < capacity ? guard : 0;
+        rate_ = sample_rate;
+        head_time_.store(0, 0);
+    }
+
+    bool ready() const { return buf_ != nullptr && cap_ > 0; }
+    uint32_t capacity() const { return cap_; }
+    uint32_t sampleRate() const { return rate_; }
+
+    // 已写入的样本总数 (即下一个样本的序号)
+    uint64_t head() const {
+        uint64_t h;
+        int64_t t;
+        snapshot(&h, &t);
+        return h;
+    }
+
+    // 序号为 index 的样本的采集时刻 (可以是尚未写入的样本)；尚未写入任何样本时返回 -1
+    int64_t sampleTimeUs(uint64_t index) const {
+        uint64_t h;
+        int64_t t;
+        snapshot(&h, &t);
+        if (h == 0) return -1;
+        return t + samplesToUs((int64_t)(index - h));
+    }
+
+    // 当前仍可读取的最旧样本序号
+    uint64_t tail() const {
+        uint64_t h = head();
+        uint64_t window = cap_ - guard_;
+        return h > window ? h - window : 0;
+    }
+
+    /**
+     * 仅供生产者调用。end_us 为这一块最后一个样本到达的时刻 (I2S 读取返回的时刻)。
+     * 读取可能因调度而晚返回，但不会早于采集，测得的时刻只会偏晚：
+     * 早于按采样率推算的时刻时立即采用，晚于时只缓慢跟随 (吸收 I2S 与 esp_timer 的漂移)。
+     */
+    void write(const int16_t* src, uint32_t n, int64_t end_us) {
+        if (!ready() || n == 0) return;
+        uint64_t h;
+        int64_t t;
+        snapshot(&h, &t);
+        int64_t measured = end_us + samplesToUs(1);     // 下一个样本的时刻
+        if (h == 0) {
+            t = measured;
+        } else {
+            int64_t predicted = t + samplesToUs(n);
+            t = measured < predicted ? measured : predicted + (measured - predicted) / 64;
+        }
+        uint32_t pos = (uint32_t)(h % cap_);
+        uint32_t first = n < cap_ - pos ? n : cap_ - pos;
+        memcpy(buf_ + pos, src, first * sizeof(int16_t));
+        if (n > first) {
+            memcpy(buf_, src + first, (n - first) * sizeof(int16_t));
+        }
+        publish(h + n, t);
+    }
+
+    /**
+     * 从 *cursor 开始读取最多 max 个样本，返回实际读取数并推进游标。
+     * 若游标已落出环外，先跳到最旧可用样本，跳过的样本数累加到 *dropped。
+     */
+    uint32_t read(uint64_t* cursor, int16_t* dst, uint32_t max, uint64_t* dropped) const {
+        if (!ready()) return 0;
+        for (int attempt = 0; attempt < 3; attempt++) {
+            uint64_t h = head();
+            uint64_t oldest = tail();
+            if (*cursor < oldest) {
+                if (dropped) *dropped += oldest - *cursor;
+                *cursor = oldest;
+            }
+            if (*cursor >= h) return 0;
+
+            uint64_t avail = h - *cursor;
+            uint32_t n = avail < max ? (uint32_t)avail : max;
+            uint32_t pos = (uint32_t)(*cursor % cap_);
+            uint32_t first = n < cap_ - pos ? n : cap_ - pos;
+            memcpy(dst, buf_ + pos, first * sizeof(int16_t));
+            if (n > first) {
+                memcpy(dst + first, buf_, (n - first) * sizeof(int16_t));
+            }
+
+            // 复制期间生产者可能已经覆盖了这段数据，校验后再提交游标
+            if (*cursor >= tail()) {
+                *cursor += n;
+                return n;
+            }
+        }
+        return 0;
+    }
+
+private:
+    int64_t samplesToUs(int64_t samples) const {
+        return rate_ ? samples * 1000000LL / (int64_t)rate_ : 0;
+    }
+
+    void snapshot(uint64_t* h, int64_t* t) const {
+        int64_t head;
+        head_time_.load(&head, t);
+        *h = (uint64_t)head;
+    }
+
+    void publish(uint64_t h, int64_t t) {
+        head_time_.store((int64_t)h, t);
+    }
+
+    int16_t* buf_ = nullptr;
+    uint32_t cap_ = 0;
+    uint32_t guard_ = 0;
+    uint32_t rate_ = 0;
+    SeqlockI64Pair head_time_;              // 写指针和锚点 (序号为 head 的样本的采集时刻)
+};
+
+#endif // AUDIO_RING_H
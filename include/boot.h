@@ -0,0 +1,41 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+/**
+ * 启动阶段计时
+ *
+ * setup() 中各初始化步骤并行执行 (WiFi 在后台关联、摄像头在视频任务中初始化、
+ * 音频任务在网络就绪前就开始写采集环)，这里记录每个阶段相对开机时刻的开始和结束时间，
+ * 启动完成后打印一张时间表，并通过 /metrics 导出。
+ */
+
+#include <stdint.h>
+#include "metrics.h"
+
+enum BootPhase {
+    BOOT_PHASE_SETUP,           // setup() 开始到返回
+    BOOT_PHASE_WIFI_START,      // 启动 WiFi 管理任务 (不等待连接)
+    BOOT_PHASE_MIC,             // I2S 初始化
+    BOOT_PHASE_HTTP,            // 监听 socket
+    BOOT_PHASE_CAMERA,          // esp_camera_init (在视频任务中执行)
+    BOOT_PHASE_FIRST_FRAME,     // 第一帧进入帧缓存
+    BOOT_PHASE_FIRST_AUDIO,     // 第一块音频进入采集环
+    BOOT_PHASE_WIFI_CONNECTED,  // 首次获得 IP
+    BOOT_PHASE_COUNT
+};
+
+void bootPhaseStart(BootPhase phase);
+void bootPhaseEnd(BootPhase phase);
+
+// 瞬时事件：开始时间记为开机时刻，结束时间为当前时刻 (只记录第一次)
+void bootMark(BootPhase phase);
+
+// 帧、音频和 WiFi 都就绪后返回 true
+bool bootComplete();
+
+// 打印启动时间表 (只打印一次，返回是否打印)
+bool bootLogSummary();
+
+void bootRenderMetrics(MetricsWriter &w);
+
+#endif // BOOT_H
@@ -0,0 +1,75 @@
+#ifndef CAMERA_CONFIG_H
+#define CAMERA_CONFIG_H
+
+/**
+ * 摄像头参数 (分辨率 / JPEG 质量 / 曝光 / 白平衡 / 增益)
+ *
+ * /camera/config 修改的参数先保存到存储，再交给视频任务在两次取帧之间通过
+ * sensor_t 的 set_* 写入传感器，不做 esp_camera_deinit / init：
+ *
+ * - HTTP 任务只提交参数并等待视频任务应用 (最多 CAMERA_CONFIG_APPLY_TIMEOUT_MS)，
+ *   不直接操作摄像头，也不在请求中做恢复
+ * - 视频任务在摄像头初始化和每次重新初始化 (连续捕获失败后) 之后重新应用全部参数，
+ *   恢复后不会回到驱动默认值
+ * - 开机时从 CAMERA_CONFIG_PATH 读取上次保存的参数，文件不存在或版本不符时使用默认值
+ *
+ * 数码变焦 (zoom_*) 是传感器窗口：OV2640 只读出该区域并缩放到 frame_size，
+ * 对所有读者生效；单个请求的 ROI 裁剪见 jpeg_crop.h。
+ *
+ * 双流 (still_size)：frame_size 是预览分辨率，/capture 的静态照片临时切换到 still_size
+ * 再切回 (still_capture.h)。
+ */
+
+#include <stdint.h>
+#include "hal.h"
+#include "metrics.h"
+
+#ifndef CAMERA_CONFIG_PATH
+#define CAMERA_CONFIG_PATH              "/camera.cfg"
+#endif
+#ifndef CAMERA_CONFIG_APPLY_TIMEOUT_MS
+#define CAMERA_CONFIG_APPLY_TIMEOUT_MS  1000    // 请求等待视频任务应用参数的上限
+#endif
+
+#define CAMERA_STILL_OFF    HAL_FRAME_SIZE_COUNT    // still_size：关闭双流
+
+// 分辨率名称 (qqvga / qvga / vga / svga / xga / sxga / uxga)，找不到返回 HAL_FRAME_SIZE_COUNT
+const char *cameraFrameSizeName(uint8_t frame_size);
+HalFrameSize cameraFrameSizeByName(const char *name);
+const char *cameraStillSizeName(uint8_t still_size);    // 关闭时为 "off"
+void cameraFrameSizeDims(uint8_t frame_size, uint16_t *width, uint16_t *height);
+
+// 读取保存的参数 (视频任务启动时调用一次)
+void cameraConfigBegin();
+
+// 当前生效 (或等待应用) 的参数
+HalCameraSettings cameraConfigCurrent();
+
+// 同上，分辨率超过本机帧缓冲时降到上限 (实际写入传感器的参数)
+HalCameraSettings cameraConfigEffective();
+
+// 视频任务最近一次写入传感器的参数 (提交后、应用前仍为旧值)
+HalCameraSettings cameraConfigApplied();
+
+// 已应用变焦窗口的序号：视频任务每次把不同的变焦窗口写入传感器时加一
+// (包括重新初始化后从全幅恢复到保存的窗口)，之后取到的帧才按新窗口采集
+uint32_t cameraConfigZoomGeneration();
+
+// 范围检查，失败时返回说明文字，通过返回 NULL
+const char *cameraConfigValidate(const HalCameraSettings &settings);
+
+// 保存参数并交给视频任务应用，返回本次提交的序号；persisted 为写入存储是否成功
+uint32_t cameraConfigSubmit(const HalCameraSettings &settings, bool *persisted);
+
+// 等待序号 generation 的参数被视频任务应用；超时返回 false，ok 为 halCameraApply 的结果
+bool cameraConfigWaitApplied(uint32_t generation, uint32_t timeout_ms, bool *ok);
+
+// ==================== 视频任务调用 ====================
+
+bool cameraConfigPending();         // 有尚未应用的提交
+void cameraConfigApplyPending();    // 应用最新提交 (没有提交时不做任何事)
+void cameraConfigReapply();         // 摄像头 (重新) 初始化后恢复全部参数
+
+void cameraConfigRenderMetrics(MetricsWriter &w);
+
+#endif // CAMERA_CONFIG_H
@@ -0,0 +1,97 @@
+#ifndef CAMERA_HEALTH_H
+#define CAMERA_HEALTH_H
+
+/**
+ * 摄像头健康监督
+ *
+ * 视频任务每次取帧后交给 cameraHealthCheck 判定，异常时调用 cameraHealthRecover
+ * 执行分级恢复。恢复只在视频任务中进行 (驱动不允许与取帧并发)，HTTP 处理函数
+ * 不做任何恢复，只继续提供最近一帧正常帧并用响应头标明它有多旧。
+ *
+ * 异常 (连续计数，任一正常帧清零)：
+ *   grab_failed  取帧失败 (驱动超时 / 帧缓冲溢出)
+ *   bad_jpeg     jpegValidate (jpeg_check.h) 判定损坏或截断，丢弃不发布；
+ *                正常帧去掉 EOI 之后的填充
+ *   slow         取帧耗时超过平均值的 CAMERA_SLOW_GRAB_FACTOR 倍且超过 CAMERA_SLOW_GRAB_MIN_US，
+ *                帧本身仍然发布
+ *
+ * 分级恢复 (按连续异常次数)：
+ *   < CAMERA_SOFT_RESET_AFTER     重试
+ *   = CAMERA_SOFT_RESET_AFTER     传感器软复位 + 重新应用参数
+ *   = CAMERA_REINIT_AFTER         驱动去初始化 + 初始化 + 重新应用参数
+ *   = CAMERA_POWER_CYCLE_AFTER    传感器断电重启 + 重新应用参数
+ *   >= CAMERA_BACKOFF_AFTER       等待 CAMERA_BACKOFF_MS 后从重新初始化一级再来
+ *
+ * 进入 recovering / failed 和故障后恢复为 ok 时发布 camera 事件 (events.h)。
+ */
+
+#include <stdint.h>
+#include "hal.h"
+#include "metrics.h"
+
+#ifndef CAMERA_SOFT_RESET_AFTER
+#define CAMERA_SOFT_RESET_AFTER     3
+#endif
+#ifndef CAMERA_REINIT_AFTER
+#define CAMERA_REINIT_AFTER         6
+#endif
+#ifndef CAMERA_POWER_CYCLE_AFTER
+#define CAMERA_POWER_CYCLE_AFTER    9
+#endif
+#ifndef CAMERA_BACKOFF_AFTER
+#define CAMERA_BACKOFF_AFTER        12
+#endif
+#ifndef CAMERA_BACKOFF_MS
+#define CAMERA_BACKOFF_MS           5000
+#endif
+#ifndef CAMERA_SLOW_GRAB_FACTOR
+#define CAMERA_SLOW_GRAB_FACTOR     4
+#endif
+#ifndef CAMERA_SLOW_GRAB_MIN_US
+#define CAMERA_SLOW_GRAB_MIN_US     200000
+#endif
+#ifndef CAMERA_STALE_AFTER_MS
+#define CAMERA_STALE_AFTER_MS       2000    // 最新帧超过该时长 (且超过两个捕获间隔) 视为过期
+#endif
+
+enum CameraHealthState {
+    CAMERA_HEALTH_OK,
+    CAMERA_HEALTH_DEGRADED,     // 有连续异常，尚在重试
+    CAMERA_HEALTH_RECOVERING,   // 已执行过复位 / 重新初始化 / 断电重启，尚未恢复
+    CAMERA_HEALTH_FAILED,       // 全部恢复手段都失败，退避等待中
+    CAMERA_HEALTH_STATE_COUNT
+};
+
+enum CameraFault {
+    CAMERA_FAULT_NONE,
+    CAMERA_FAULT_GRAB_FAILED,
+    CAMERA_FAULT_BAD_JPEG,
+    CAMERA_FAULT_SLOW,
+    CAMERA_FAULT_COUNT
+};
+
+enum CameraRecoveryAction {
+    CAMERA_ACTION_SOFT_RESET,
+    CAMERA_ACTION_REINIT,
+    CAMERA_ACTION_POWER_CYCLE,
+    CAMERA_ACTION_COUNT
+};
+
+// 判定一次取帧 (frame 为 NULL 表示取帧失败)，正常帧的 len 截到 EOI；
+// 返回 BAD_JPEG 时调用者不发布该帧
+CameraFault cameraHealthCheck(HalFrame *frame, uint32_t capture_us);
+
+// 有连续异常时执行下一级恢复 (可能阻塞数百毫秒，只在视频任务中调用)
+void cameraHealthRecover();
+
+CameraHealthState cameraHealthState();
+const char *cameraHealthStateName(CameraHealthState state);
+const char *cameraHealthActionName(CameraRecoveryAction action);
+
+// 最近一帧正常帧的采集时刻 (尚无时为 -1)，以及按当前捕获间隔是否已过期
+int64_t cameraHealthLastGoodUs();
+bool cameraHealthStale(int64_t frame_timestamp_us);
+
+void cameraHealthRenderMetrics(MetricsWriter &w);
+
+#endif // CAMERA_HEALTH_H
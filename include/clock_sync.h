@@ -0,0 +1,52 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+/**
+ * 设备时钟到墙上时间的映射
+ *
+ * 帧和音频样本都用设备单调时钟 (halNowUs，ESP32 上即 esp_timer) 打时间戳，
+ * 不受网络延迟影响；主机用这里给出的偏移换算成墙上时间：
+ *
+ *   wall_us = capture_us + offset_us
+ *
+ * 偏移来源 (优先级从高到低)：
+ *   host    主机通过 /time?host_us=... 写入自己的时钟 (主机按往返时间的一半补偿)
+ *   system  SNTP 校准后的系统时间 (主机构建为操作系统时钟)
+ *   none    尚无可用的映射，主机只能使用设备单调时间做相对对齐
+ */
+
+#include <stdint.h>
+
+#ifndef CLOCK_SNTP_SERVER
+#define CLOCK_SNTP_SERVER "pool.ntp.org"
+#endif
+
+// 主机写入的时间须落在此范围内 (Unix 微秒，2020-09 ~ 2100-01)，拒绝单位错误或未校准的主机时钟
+#ifndef CLOCK_HOST_MIN_UNIX_US
+#define CLOCK_HOST_MIN_UNIX_US 1600000000000000LL
+#endif
+#ifndef CLOCK_HOST_MAX_UNIX_US
+#define CLOCK_HOST_MAX_UNIX_US 4102444800000000LL
+#endif
+
+enum ClockSource {
+    CLOCK_SOURCE_NONE,
+    CLOCK_SOURCE_SYSTEM,
+    CLOCK_SOURCE_HOST
+};
+
+// 启动 SNTP (WiFi 尚未连接时也可调用，连上后自动同步)
+void clockSyncBegin();
+
+// 当前偏移 (墙上时间 - 设备单调时间)，返回偏移来源
+ClockSource clockWallOffset(int64_t *offset_us);
+
+// 主机写入的墙上时间 (Unix 微秒)，对应设备收到请求的时刻；超出合理范围时不写入，返回 false
+bool clockSetHostTime(int64_t host_unix_us);
+
+// 距上次主机校准的毫秒数，从未校准返回 -1
+int64_t clockHostSyncAgeMs();
+
+const char *clockSourceName(ClockSource source);
+
+#endif // CLOCK_SYNC_H
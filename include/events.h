@@ -0,0 +1,81 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+/**
+ * 设备事件队列 (/events)
+ *
+ * 各模块发生值得主机知道的事情时发布一条事件 (场景切换、WiFi 断开、摄像头恢复、
+ * 语音起止、画面运动、存储将满、内部堆不足)，按序号保存在 EVENT_QUEUE_SIZE 条的环中，
+ * 满了覆盖最旧的一条。
+ *
+ *   /events?since=N    取序号大于 N 的事件 (JSON)，响应中的 next 作为下一次的 since；
+ *                      since 早于环中最旧的一条时 dropped 为 true (中间的事件已被覆盖)
+ *   /events (Accept: text/event-stream 或 ?stream=1)
+ *                      Server-Sent Events 长连接，事件发生后立即推送，主机不再轮询；
+ *                      断线重连时浏览器 / 客户端带上 Last-Event-ID 从断点继续
+ *
+ * 发布无锁：序号由原子加一分配，每个槽位带自己的序号作为顺序锁 (写入期间为 0)，
+ * 读者复制前后各读一次槽位序号，不一致即为写入中或已被覆盖。发布方不会被读者或
+ * 其他发布方阻塞，可以在 WiFi 事件回调等不宜持锁的上下文中调用 (不能在中断中调用)。
+ * 两个发布方同时写同一槽位需要相隔整整一圈 (EVENT_QUEUE_SIZE 条)，实际不会发生。
+ *
+ * 事件流任务不轮询：注册一个信号量，每条事件写入完成后发布方 give 一次，任务阻塞在上面。
+ *
+ * 事件时刻使用设备单调时钟 (halNowUs)，与帧和音频的 X-Capture-Us 相同。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "metrics.h"
+#include "hal.h"
+
+#ifndef EVENT_QUEUE_SIZE
+#define EVENT_QUEUE_SIZE    32
+#endif
+#ifndef EVENT_MAX_WAITERS
+#define EVENT_MAX_WAITERS   4       // 同时等待新事件的任务数上限 (每个事件流连接一个)
+#endif
+
+enum EventType {
+    EVENT_SCENE,                // 场景切换：value 为距离分数 (0~100)，ref 为帧序号
+    EVENT_WIFI,                 // WiFi：value 1 已连接 (ref 为断开到连上的毫秒数) / 0 断开 (ref 为 reason)
+    EVENT_CAMERA,               // 摄像头健康状态变化：value 为 CameraHealthState，
+                                // recovering 时 ref 为恢复动作，恢复为 ok 时 ref 为故障时长 (ms)
+    EVENT_VAD,                  // 语音：value 1 起始 (ref 为高出噪声底的 dB) / 0 结束 (ref 为语音时长 ms)
+    EVENT_MOTION,               // 画面运动：value 1 开始 (ref 为变化面积千分比) / 0 结束 (ref 为持续时长 ms)
+    EVENT_STORAGE_FULL,         // 存储将满：value 为已用千分比，ref 为剩余 KB
+    EVENT_LOW_HEAP,             // 内部堆不足：value 为空闲字节，ref 为最大连续空闲块
+    EVENT_TYPE_COUNT
+};
+
+struct Event {
+    uint32_t seq;               // 从 1 开始
+    EventType type;
+    int64_t timestamp_us;
+    int32_t value;              // 含义见 EventType
+    uint32_t ref;
+    uint32_t segment;           // VAD / 运动开始时创建的预录片段 id (/segment/*)，0 表示没有
+};
+
+const char *eventTypeName(EventType type);
+
+void eventPublish(EventType type, int64_t timestamp_us, int32_t value, uint32_t ref, uint32_t segment = 0);
+
+// 序号大于 after 的事件 (按序号升序，最多 max 条)，返回数量；遇到尚在写入的事件时停在它之前。
+// oldest 为环中最旧一条的序号 (没有事件时为 0)，读取途中被覆盖的事件跳过并计入 oldest
+int eventsRead(uint32_t after, Event *out, int max, uint32_t *oldest);
+
+// 最新分配的序号 (0 表示还没有事件)
+uint32_t eventsLastSeq();
+
+// 注册 / 注销等待新事件的信号量。注册后每条事件写入完成时 give 一次 (多条事件可能合并为一次唤醒)；
+// 已满返回 false。注销后发布方仍可能 give 最后一次，信号量须在任务存续期间保留
+bool eventsAddWaiter(HalSemaphore sem);
+void eventsRemoveWaiter(HalSemaphore sem);
+
+// 事件的 JSON 对象 ({"seq":..,"type":..,"capture_us":.., 各类型字段})，返回长度 (同 snprintf)
+int eventFormatJson(const Event &e, char *buf, size_t cap);
+
+void eventsRenderMetrics(MetricsWriter &w);
+
+#endif // EVENTS_H
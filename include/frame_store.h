@@ -0,0 +1,104 @@
+#ifndef FRAME_STORE_H
+#define FRAME_STORE_H
+
+/**
+ * 最新帧缓存 (单生产者，多读者)
+ *
+ * 视频任务持续捕获帧并复制到这里，HTTP 处理函数和流任务只读取最新一帧，
+ * 不再各自调用 esp_camera_fb_get()：
+ * - 摄像头驱动的帧缓冲立即归还，驱动可以继续采集
+ * - 网络就绪前就已经有帧可用 (启动后第一次请求无需等待摄像头)
+ * - 多个读者共享同一帧，不会互相抢帧
+ *
+ * FRAME_STORE_SLOTS 个槽位，每个槽位有引用计数。生产者只写既不是最新帧、
+ * 也没有读者持有的槽位，写完后原子地发布为最新帧；没有空闲槽位时丢弃该帧。
+ * 读者 acquire 最新槽位 (引用计数 +1)，发送完毕后 release。
+ *
+ * 预录：每隔 FRAME_PREROLL_INTERVAL_MS 把刚发布的槽位标记为保留，最多保留
+ * preroll_frames 个 (先进先出)。保留的槽位不会被覆盖，触发录制时直接引用这些槽位，
+ * 不再复制。槽位总数 = FRAME_STORE_SLOTS + preroll_frames，内存上限固定。
+ *
+ * 缩略图：同样每隔 FRAME_PREROLL_INTERVAL_MS (与预录保留同一帧) 由生产者生成 1/8 缩略图
+ * (jpeg_thumb.h)，放在独立的小环中 (preroll_frames + FRAME_THUMB_SPARE 个，每个 slot_bytes / 8)。
+ * 缩略图按帧序号查找，读者同样用引用计数持有；生产者先清除序号再检查引用计数。
+ *
+ * 隐私遮挡：帧复制进槽位时按 privacy_mask.h 的区域涂黑，槽位中只有遮挡后的帧。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef FRAME_STORE_SLOTS
+#define FRAME_STORE_SLOTS   3       // 1 个正在写 + 最多 2 个被读者持有
+#endif
+#ifndef FRAME_PREROLL_FRAMES
+#define FRAME_PREROLL_FRAMES        10      // 预录保留的帧数上限 (有 PSRAM 时)
+#endif
+#ifndef FRAME_PREROLL_INTERVAL_MS
+#define FRAME_PREROLL_INTERVAL_MS   500     // 每隔多久保留一帧 (10 帧 x 500 ms = 5 s)
+#endif
+
+#ifndef FRAME_THUMB_SPARE
+#define FRAME_THUMB_SPARE           2       // 缩略图环比预录多保留的个数 (无 PSRAM 时只有这些)
+#endif
+
+#define FRAME_STORE_MAX_SLOTS (FRAME_STORE_SLOTS + FRAME_PREROLL_FRAMES)
+#define FRAME_THUMB_MAX_SLOTS (FRAME_PREROLL_FRAMES + FRAME_THUMB_SPARE)
+
+struct HalFrame;
+
+// 读者持有的帧引用
+struct FrameRef {
+    const uint8_t *buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    int64_t timestamp_us;       // 采集时间 (halNowUs 时钟)
+    uint32_t seq;               // 帧序号，从 1 开始
+    uint8_t slot;
+};
+
+// 缩略图元数据 (列表用)
+struct FrameThumbInfo {
+    uint32_t seq;               // 原帧序号
+    int64_t timestamp_us;
+    uint16_t width;             // 缩略图尺寸
+    uint16_t height;
+    uint16_t src_width;         // 原帧尺寸
+    uint16_t src_height;
+    size_t len;
+    bool kept;                  // 原帧仍在预录中保留
+};
+
+// 分配槽位 (slot_bytes 为单帧上限，preroll_frames 不超过 FRAME_PREROLL_FRAMES)
+bool frameStoreBegin(size_t slot_bytes, int preroll_frames);
+bool frameStoreReady();
+size_t frameStoreBytes();       // 已分配的槽位总字节数
+size_t frameStoreSlotBytes();   // 单帧上限
+
+// 生产者：复制一帧 (并遮挡) 后发布为最新帧；帧过大、没有空闲槽位或遮挡失败时返回 false
+bool frameStorePublish(const HalFrame &frame);
+
+// 读者：取得最新帧的引用，尚无帧时返回 false；用完必须 release
+bool frameStoreAcquire(FrameRef *ref);
+void frameStoreRelease(FrameRef *ref);
+
+// 最新帧序号 (0 表示尚无帧)
+uint32_t frameStoreSeq();
+
+// 读者：取得采集时刻 >= since_us 的预录帧 (按时间顺序)，返回数量；每个都要 release
+int frameStoreAcquireHistory(int64_t since_us, FrameRef *refs, int max);
+
+// 当前保留的预录帧数和最旧一帧的采集时刻 (没有时为 -1)
+int frameStoreHistoryCount();
+int64_t frameStoreHistoryOldestUs();
+
+// 读者：取得帧序号为 seq 的缩略图 (seq 为 0 时取最新一张)，没有时返回 false；
+// ref 中的宽高为缩略图尺寸，用完必须 frameStoreReleaseThumb
+bool frameStoreAcquireThumb(uint32_t seq, FrameRef *ref);
+void frameStoreReleaseThumb(FrameRef *ref);
+
+// 当前全部缩略图的元数据，按帧序号升序，返回数量
+int frameStoreListThumbs(FrameThumbInfo *infos, int max);
+
+#endif // FRAME_STORE_H
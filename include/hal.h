@@ -0,0 +1,156 @@
+#ifndef HAL_H
+#define HAL_H
+
+/**
+ * 硬件抽象层 (HAL)
+ *
+ * 业务代码 (HTTP 路由、采集环、流任务、指标、追踪) 只通过这里访问硬件和操作系统，
+ * 因此同一份代码既能在 ESP32 上运行，也能在 Linux 主机上编译、运行和做基准测试。
+ *
+ * 实现：
+ *   src/hal/esp32/hal_esp32.cpp   - esp_camera / I2S / esp_timer / FreeRTOS / SPIFFS
+ *   src/hal/native/hal_native.cpp - JPEG 文件回放 / WAV 文件回放 / CLOCK_MONOTONIC / std::thread
+ *
+ * 网络不在这里抽象：lwIP 提供与 Linux 相同的 BSD socket 接口，
+ * http_server 直接使用 socket API，主机上默认监听 127.0.0.1。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== 日志 ====================
+
+// ESP32 输出到 Serial，主机输出到 stderr
+void halLog(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// ==================== 时钟 ====================
+
+int64_t halNowUs();             // 开机以来的单调时钟 (微秒)，ESP32 上即 esp_timer_get_time()
+uint32_t halMillis();
+void halDelayMs(uint32_t ms);
+
+// 墙上时钟 (Unix 微秒)；尚未同步 (ESP32 上 SNTP 未完成) 时返回 false
+bool halWallClockUs(int64_t *unix_us);
+// 启动后台 SNTP 同步；主机构建直接使用操作系统时钟，为空操作
+void halTimeSyncBegin(const char *server);
+
+// ==================== 任务 ====================
+
+typedef void (*HalTaskFn)(void *arg);
+
+// 创建任务；priority / core 只在 ESP32 上生效
+bool halTaskCreate(HalTaskFn fn, const char *name, uint32_t stack_size,
+                   void *arg, int priority, int core, void **handle_out);
+void halTaskExit();             // 结束当前任务，不返回到调用者 (ESP32) 或立即返回 (主机)
+int halCoreId();
+
+// 二值信号量 (启动时创建，不释放)：take 在超时前等到 give 返回 true
+typedef void *HalSemaphore;
+HalSemaphore halSemaphoreCreate();
+void halSemaphoreGive(HalSemaphore sem);
+bool halSemaphoreTake(HalSemaphore sem, uint32_t timeout_ms);
+
+// ==================== 摄像头 ====================
+
+struct HalFrame {
+    uint8_t *buf;               // JPEG 数据
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    int64_t timestamp_us;       // 采集时间 (halNowUs 时钟)
+    void *priv;                 // 实现私有 (ESP32 上为 camera_fb_t*)
+};
+
+bool halCameraBegin();
+bool halCameraReady();
+bool halCameraGrab(HalFrame *frame);
+void halCameraRelease(HalFrame *frame);
+bool halCameraReinit();         // 完整的去初始化 + 初始化
+bool halCameraSoftReset();      // 通过 SCCB 复位传感器寄存器，驱动和帧缓冲保留
+bool halCameraPowerCycle();     // 去初始化，经 PWDN 引脚断电 (没有该引脚时只停 XCLK) 后重新初始化
+
+bool halCameraSetXclk(uint32_t mhz);    // 摄像头未初始化时记下，初始化时使用
+
+enum HalFrameSize {
+    HAL_FRAME_QQVGA,            // 160x120
+    HAL_FRAME_QVGA,             // 320x240
+    HAL_FRAME_VGA,              // 640x480
+    HAL_FRAME_SVGA,             // 800x600
+    HAL_FRAME_XGA,              // 1024x768
+    HAL_FRAME_SXGA,             // 1280x1024
+    HAL_FRAME_UXGA,             // 1600x1200
+    HAL_FRAME_SIZE_COUNT
+};
+
+// 传感器参数，通过 sensor_t 的 set_* 逐项写寄存器，不需要重新初始化
+struct HalCameraSettings {
+    uint8_t frame_size;         // HalFrameSize
+    uint8_t quality;            // JPEG 量化 4~63，越小质量越高
+    bool auto_exposure;
+    uint16_t exposure;          // 手动曝光值 0~1200 (auto_exposure 关闭时生效)
+    int8_t ae_level;            // 自动曝光补偿 -2~2
+    bool awb;
+    uint8_t wb_mode;            // 0 自动 / 1 晴天 / 2 阴天 / 3 办公室 / 4 家里 (awb 开启时生效)
+    bool auto_gain;
+    uint8_t gain;               // 手动增益 0~30 (auto_gain 关闭时生效)
+    uint8_t gain_ceiling;       // 自动增益上限 0~6 (2x ~ 128x)
+    // 数码变焦：传感器窗口 (UXGA 传感器坐标)，缩放到 frame_size 输出；zoom_w 为 0 表示全幅
+    uint16_t zoom_x;
+    uint16_t zoom_y;
+    uint16_t zoom_w;
+    uint16_t zoom_h;
+    // 双流：/capture 的静态照片分辨率 (HalFrameSize)，HAL_FRAME_SIZE_COUNT 表示关闭；
+    // HAL 不使用，由 still_capture.h 在取静态照片时临时替换 frame_size
+    uint8_t still_size;
+};
+
+#define HAL_SENSOR_WIDTH    1600    // OV2640 全幅 (UXGA)，数码变焦窗口的坐标范围
+#define HAL_SENSOR_HEIGHT   1200
+
+// 应用全部参数 (只能在视频任务中、两次取帧之间调用)；任一项失败返回 false
+bool halCameraApply(const HalCameraSettings &settings);
+// 帧缓冲按初始化时的分辨率分配，运行时只能切换到不超过它的分辨率
+HalFrameSize halCameraMaxFrameSize();
+
+// ==================== 麦克风 ====================
+
+bool halMicBegin(uint32_t sample_rate, uint32_t block_samples);
+bool halMicReady();
+// 阻塞读取，返回实际样本数 (16-bit 单声道)；出错返回 -1
+int halMicRead(int16_t *dst, size_t max_samples);
+
+// ==================== 存储 ====================
+
+bool halStorageBegin();         // 可选：其他存储函数在第一次调用时自动挂载
+bool halStorageWrite(const char *path, const uint8_t *data, size_t len);
+long halStorageSize(const char *path);     // 不存在返回 -1
+size_t halStorageRead(const char *path, size_t offset, uint8_t *buf, size_t len);
+bool halStorageUsage(uint64_t *used, uint64_t *total);     // 文件系统已用 / 总容量 (字节)
+
+// ==================== 电源 ====================
+
+enum HalWifiPowerSave {
+    HAL_WIFI_PS_NONE,           // 射频常开，延迟最低
+    HAL_WIFI_PS_MIN_MODEM,      // 每个 DTIM 醒来一次 (ESP32 Arduino 默认)
+    HAL_WIFI_PS_MAX_MODEM       // 每 listen_interval 个信标醒来一次
+};
+
+// listen_interval 只在 MAX_MODEM 下使用，下次关联时生效
+bool halWifiSetPowerSave(HalWifiPowerSave mode, uint8_t listen_interval);
+
+// 动态调频 + 自动 light sleep；固件未启用电源管理 (CONFIG_PM_ENABLE) 时
+// 退化为固定在 max_mhz，返回 false
+bool halCpuSetFrequency(uint32_t max_mhz, uint32_t min_mhz, bool light_sleep);
+uint32_t halCpuFrequencyMhz();
+
+// ==================== 系统 / 网络状态 ====================
+
+bool halWifiConnected();
+int halWifiRssi();
+void halLocalIp(char *buf, size_t len);
+bool halPsramFound();
+void *halAllocLarge(size_t size);   // 大块缓冲区：有 PSRAM 时分配在 PSRAM
+void *halAllocInternal(size_t size);    // 内部 RAM (不受 malloc 的 PSRAM 阈值影响)
+void halRestart();
+
+#endif // HAL_H
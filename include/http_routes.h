@@ -0,0 +1,34 @@
+#ifndef HTTP_ROUTES_H
+#define HTTP_ROUTES_H
+
+/**
+ * HTTP 路由与处理函数
+ *
+ * 只依赖 hal.h 和 http_server.h，ESP32 与主机构建共用。
+ */
+
+#include <stdint.h>
+#include "http_server.h"
+
+#ifndef HTTP_PORT
+#define HTTP_PORT 80
+#endif
+#ifndef HTTP_ARENA_BYTES
+#define HTTP_ARENA_BYTES (8 * 1024)     // 单个请求的临时缓冲区 (PSRAM)，请求结束后整体复位
+#endif
+#ifndef HTTP_META_ARENA_BYTES
+#define HTTP_META_ARENA_BYTES (5 * 1024) // 单个请求的 JSON 响应体 (内部 RAM)，同上
+#endif
+#ifndef HTTP_DEBUG_LOG
+#define HTTP_DEBUG_LOG 0                // 1 = 每个请求/流打印 [DEBUG] 日志 (串口输出会拖慢请求路径)
+#endif
+
+extern HttpServer server;
+
+// 注册路由、创建流任务并开始监听 (需先调用 memBegin())
+bool routesBegin(uint16_t port, const char *bind_addr);
+
+// HTTP 服务任务 (由 pipelineStartTasks() 创建)
+void httpServerTask(void *parameter);
+
+#endif // HTTP_ROUTES_H
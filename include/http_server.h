@@ -0,0 +1,196 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+/**
+ * 精简 HTTP/1.1 服务器 (BSD socket)
+ *
+ * 替代 Arduino WebServer：
+ * - ESP32 上 socket API 由 lwIP 提供，主机上是 Linux socket，同一份代码两边都能运行
+ * - 请求解析和响应头都使用固定缓冲区，不使用 String，处理请求时不分配堆内存
+ * - 处理函数可以 detach() 取走 socket，交给流任务长期持有
+ *
+ * 每个连接只处理一个请求 (Connection: close)，与原 WebServer 的行为一致。
+ *
+ * 发送路径尽量让每次 send() 都是整段：响应头和小响应体合并写出，chunked 响应和流
+ * 经 HttpStreamWriter 把 chunk 头、数据和 CRLF 拼进一个 MSS 整数倍的缓冲区再发送，
+ * 所有连接关闭 Nagle (TCP_NODELAY)，不再产生几字节的小包和等待 ACK 的延迟。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct Counter;
+struct iovec;
+
+#ifndef HTTP_MAX_ROUTES
+#define HTTP_MAX_ROUTES           28
+#endif
+#ifndef HTTP_REQUEST_BUFFER_SIZE
+#define HTTP_REQUEST_BUFFER_SIZE  2048    // 请求行 + 头 + 小请求体
+#endif
+#ifndef HTTP_RESPONSE_HEADER_SIZE
+#define HTTP_RESPONSE_HEADER_SIZE 512     // sendHeader() 追加的响应头
+#endif
+#ifndef HTTP_INLINE_BODY_SIZE
+#define HTTP_INLINE_BODY_SIZE     512     // 不超过此大小的响应体与响应头合并成一次写入
+#endif
+#ifndef HTTP_STREAM_MSS
+#define HTTP_STREAM_MSS           1436    // lwIP 默认 TCP_MSS (取不到协商值时使用)
+#endif
+#ifndef HTTP_STREAM_BUFFER_SIZE
+#define HTTP_STREAM_BUFFER_SIZE   (4 * HTTP_STREAM_MSS)   // 流发送缓冲区 (= lwIP 默认 TCP_SND_BUF)
+#endif
+#ifndef HTTP_AUDIO_SNDBUF
+#define HTTP_AUDIO_SNDBUF         (2 * HTTP_STREAM_BUFFER_SIZE)   // 音频流：小发送缓冲，积压留在采集环
+#endif
+#ifndef HTTP_VIDEO_SNDBUF
+#define HTTP_VIDEO_SNDBUF         32768   // 视频流：大发送缓冲，整帧尽快交给协议栈
+#endif
+#ifndef HTTP_STREAM_SEND_TIMEOUT_MS
+#define HTTP_STREAM_SEND_TIMEOUT_MS 10000 // 流连接单次 send() 超时 (timelapse 的 MAX_MODEM 下几秒的 WiFi 停顿属正常)
+#endif
+#define HTTP_MAX_ARGS             12
+#define HTTP_MAX_HEADERS          16
+#define HTTP_RECV_TIMEOUT_MS      2000
+
+class HttpRequest;
+typedef void (*HttpHandler)(HttpRequest &req);
+
+// ==================== 流式写入 ====================
+
+/**
+ * 合并写入器：把多次小写入攒成一次 send()，缓冲区满 (MSS 的整数倍) 或 flush() 时发出。
+ *
+ * 分块模式下每次 write() 自动加上 chunk 封装；reserve() / commit() 让调用者直接把数据
+ * 读进缓冲区 (chunk 头用定宽 4 位十六进制预留，协议允许前导 0)，不再额外复制。
+ * 超过缓冲区的大块数据 (如 JPEG) 先补满缓冲区发出，剩余部分直接发送。
+ * buf 为 NULL 时不缓冲，每次写入直接发送 (分块模式下 chunk 头、数据和 CRLF 仍是一次发送)。
+ */
+class HttpStreamWriter {
+public:
+    void begin(int fd, uint8_t *buf, size_t cap, bool chunked, Counter *sends = NULL);
+
+    uint8_t *reserve(size_t *room);             // 分块模式：返回下一个 chunk 的数据区
+    bool commit(size_t len);                    // 封装 reserve() 后写入的 len 字节
+    bool write(const void *data, size_t len);   // 分块模式下为一个完整的 chunk
+    bool flush();
+    bool finish();                              // 分块模式发送结束块，然后 flush
+
+    size_t buffered() const { return len_; }
+    bool ok() const { return ok_; }
+
+private:
+    bool append(const void *data, size_t len);
+    bool sendRaw(const void *data, size_t len);
+    bool sendVec(struct iovec *iov, int count);
+
+    int fd_ = -1;
+    uint8_t *buf_ = nullptr;
+    size_t cap_ = 0;
+    size_t len_ = 0;
+    bool chunked_ = false;
+    bool ok_ = true;
+    Counter *sends_ = nullptr;
+};
+
+// 按连接用途设置 socket：全部关闭 Nagle；音频流限制发送缓冲 (控制排队延迟)，
+// 视频流放大发送缓冲 (吞吐)。lwIP 未启用 LWIP_SO_SNDBUF 时发送缓冲设置无效。
+// 交给流任务的连接 (音频 / 视频 / 事件) 把接受连接时的 HTTP_RECV_TIMEOUT_MS 发送超时
+// 放宽到 HTTP_STREAM_SEND_TIMEOUT_MS，短暂的 WiFi 停顿不会结束长连接。
+// 返回连接的 MSS (取不到时为 HTTP_STREAM_MSS)
+enum HttpSocketProfile {
+    HTTP_SOCKET_RESPONSE,
+    HTTP_SOCKET_AUDIO,
+    HTTP_SOCKET_VIDEO,
+    HTTP_SOCKET_EVENTS,
+};
+size_t httpTuneSocket(int fd, HttpSocketProfile profile);
+
+class HttpRequest {
+public:
+    // ==================== 请求 ====================
+    const char *method() const { return method_; }
+    const char *path() const { return path_; }
+    bool hasArg(const char *name) const;
+    const char *arg(const char *name) const;          // 不存在时返回 ""
+    const char *header(const char *name) const;       // 不区分大小写，不存在时返回 NULL
+    const char *body() const { return body_; }
+    size_t bodyLength() const { return body_len_; }
+
+    // ==================== 响应 ====================
+    void sendHeader(const char *name, const char *value);
+    // 发送状态行和响应头；content_length < 0 时不输出 Content-Length
+    bool sendHeaders(int code, const char *content_type, long content_length);
+    bool write(const void *data, size_t len);
+    void send(int code, const char *content_type, const void *body, size_t len);
+    void send(int code, const char *content_type, const char *text);
+
+    // chunked 响应 (chunk 经合并写入器发送，endChunked() 时发出剩余数据)
+    bool beginChunked(int code, const char *content_type);
+    bool sendChunk(const void *data, size_t len);
+    void endChunked();
+
+    // 取走 socket，之后由调用者负责 close()
+    int detach();
+    int fd() const { return fd_; }
+    bool responded() const { return responded_; }
+
+private:
+    friend class HttpServer;
+
+    bool parse(int fd);
+    bool sendHead(int code, const char *content_type, long content_length,
+                  const void *body, size_t body_len);
+
+    int fd_ = -1;
+    int parse_error_ = 0;       // parse() 失败时应回复的状态码，0 表示直接关闭
+    bool responded_ = false;
+    bool chunked_ = false;
+    bool detached_ = false;
+    HttpStreamWriter chunk_writer_;
+    uint8_t *chunk_buf_ = nullptr;
+
+    char buf_[HTTP_REQUEST_BUFFER_SIZE];
+    const char *method_ = "";
+    const char *path_ = "";
+    const char *body_ = NULL;
+    size_t body_len_ = 0;
+
+    struct KeyValue { const char *key; const char *value; };
+    KeyValue args_[HTTP_MAX_ARGS];
+    uint8_t arg_count_ = 0;
+    KeyValue headers_[HTTP_MAX_HEADERS];
+    uint8_t header_count_ = 0;
+
+    char extra_headers_[HTTP_RESPONSE_HEADER_SIZE];
+    size_t extra_len_ = 0;
+};
+
+class HttpServer {
+public:
+    // bind_addr 为 NULL 时监听所有地址
+    bool begin(uint16_t port, const char *bind_addr = NULL);
+    void on(const char *path, HttpHandler handler);
+    void onNotFound(HttpHandler handler) { not_found_ = handler; }
+
+    // 等待最多 timeout_ms 接受一个连接并处理一个请求
+    void handleClient(uint32_t timeout_ms);
+
+private:
+    struct Route { const char *path; HttpHandler handler; };
+
+    int listen_fd_ = -1;
+    Route routes_[HTTP_MAX_ROUTES];
+    uint8_t route_count_ = 0;
+    HttpHandler not_found_ = NULL;
+    HttpRequest request_;   // 串行处理，复用同一个请求对象
+};
+
+// ==================== socket 工具 ====================
+
+bool httpWriteAll(int fd, const void *data, size_t len);
+bool httpWriteVec(int fd, struct iovec *iov, int count);   // 会修改 iov (部分发送时)
+bool httpPeerClosed(int fd);    // 非阻塞检查对端是否已关闭
+const char *httpStatusText(int code);
+
+#endif // HTTP_SERVER_H
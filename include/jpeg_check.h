@@ -0,0 +1,43 @@
+#ifndef JPEG_CHECK_H
+#define JPEG_CHECK_H
+
+/**
+ * JPEG 帧校验 (视频任务发布帧之前调用)
+ *
+ * 摄像头驱动偶尔交出损坏的帧：开头不是 SOI、DMA 中断导致缺少 EOI (截断)，
+ * 或者 EOI 之后跟着驱动填充的字节。这里只检查结构，不解码：
+ *
+ * 1. 开头是 SOI (FFD8)
+ * 2. 从 SOI 开始逐个跳过头部段 (按段长度)，必须在缓冲区内遇到 SOS (FFDA)，
+ *    段长度越界说明头部损坏或截断
+ * 3. 从缓冲区末尾向前找 EOI (FFD9)，最多向前 JPEG_EOI_SEARCH_BYTES 字节；
+ *    熵编码数据中的 0xFF 都以 FF00 填充，所以最后一个 FFD9 就是真正的 EOI
+ *
+ * 头部只有几百字节，EOI 通常就在末尾，因此耗时与帧大小基本无关。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef JPEG_EOI_SEARCH_BYTES
+#define JPEG_EOI_SEARCH_BYTES   4096    // EOI 之后允许的填充上限
+#endif
+
+enum JpegStatus {
+    JPEG_OK,
+    JPEG_NO_SOI,            // 不以 FFD8 开头
+    JPEG_BAD_HEADER,        // 头部段结构错误或在 SOS 之前截断
+    JPEG_NO_EOI,            // 末尾 JPEG_EOI_SEARCH_BYTES 内没有 EOI (截断)
+    JPEG_STATUS_COUNT
+};
+
+struct JpegCheck {
+    JpegStatus status;
+    size_t len;             // JPEG_OK 时为到 EOI 为止的长度 (去掉尾部填充)
+};
+
+JpegCheck jpegValidate(const uint8_t *buf, size_t len);
+
+const char *jpegStatusName(JpegStatus status);
+
+#endif // JPEG_CHECK_H
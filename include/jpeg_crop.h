@@ -0,0 +1,24 @@
+#ifndef JPEG_CROP_H
+#define JPEG_CROP_H
+
+/**
+ * JPEG 域 ROI 裁剪 (无损，不解码像素)
+ *
+ * 把区域向外对齐到 MCU 边界 (OV2640 的 4:2:2 为 16x8 像素)，只对区域内的块做
+ * Huffman 重新编码：AC 符号和附加位原样写出，只有 DC 差分按新的相邻块重新计算，
+ * 量化表和 Huffman 表沿用原帧。因此区域内的画质与原帧完全相同，输出只有区域的字节数。
+ *
+ * 输出不带重启间隔 (DRI)。原帧的 DC Huffman 表缺少某个类别时 (非标准表) 返回失败。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "jpeg_entropy.h"
+
+// 裁剪 roi (帧像素坐标，超出帧的部分截掉) 写入 out，aligned 为实际输出的区域；
+// work 为解析状态和编码表 (约 13 KB，jpeg_entropy.h)，不放在堆栈上；
+// 格式不支持、区域为空、输出空间不足或数据损坏时返回 0，否则返回输出长度
+size_t jpegCrop(const uint8_t *jpeg, size_t len, const JpegRect &roi, JpegRecodeWork *work,
+                uint8_t *out, size_t out_cap, JpegRect *aligned);
+
+#endif // JPEG_CROP_H
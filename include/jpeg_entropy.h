@@ -0,0 +1,210 @@
+#ifndef JPEG_ENTROPY_H
+#define JPEG_ENTROPY_H
+
+/**
+ * 基线 JPEG 头部解析与 Huffman 熵编解码 (缩略图、ROI 裁剪和隐私遮挡共用)
+ *
+ * 只处理基线顺序编码 (SOF0 / SOF1，8 位，1 或 3 个分量，单次交织扫描)，
+ * 与 OV2640 的输出一致；渐进式、无损、算术编码在解析头部时返回 false。
+ * 不做反量化和 IDCT：调用者按块读取 DC / AC 符号，自行决定保留或跳过。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define JPEG_MAX_COMPONENTS 3
+
+struct JpegHuffDecoder {
+    bool present;
+    uint8_t bits[16];           // 各码长的码字数 (DHT 原样保存，重新编码时用)
+    uint8_t vals[256];
+    int32_t maxcode[18];        // 每个码长的最大码字，-1 表示没有该长度
+    uint16_t mincode[17];
+    uint8_t valptr[17];
+    uint16_t look[256];         // 8 位前查表：(码长 << 8) | 符号，0 表示码长超过 8
+};
+
+struct JpegComponent {
+    uint8_t id;
+    uint8_t h;                  // 采样因子
+    uint8_t v;
+    uint8_t tq;                 // 量化表号
+    uint8_t td;                 // DC Huffman 表号
+    uint8_t ta;                 // AC Huffman 表号
+};
+
+struct JpegHeader {
+    uint16_t width;
+    uint16_t height;
+    uint8_t ncomp;
+    JpegComponent comp[JPEG_MAX_COMPONENTS];
+    uint16_t qdc[4];            // 各量化表的 DC 量化值
+    JpegHuffDecoder dc[4];
+    JpegHuffDecoder ac[4];
+    uint16_t restart_interval;
+    uint8_t hmax;
+    uint8_t vmax;
+    int mcux;                   // MCU 列数 / 行数
+    int mcuy;
+    size_t sof_pos;             // SOF 段的标记位置
+    size_t sos_pos;             // SOS 段的标记位置
+    size_t scan_start;          // 熵编码数据起点
+};
+
+// 解析到 SOS 为止；with_tables 为 false 时只取尺寸和采样因子 (遇到 SOF 即返回)
+bool jpegParseHeader(const uint8_t *buf, size_t len, JpegHeader *hdr, bool with_tables);
+
+// ==================== 解码 ====================
+
+struct JpegBitReader {
+    const uint8_t *p;
+    const uint8_t *end;
+    uint32_t acc;               // 左对齐
+    int nbits;
+    bool marker;                // 遇到标记，之后补 0
+};
+
+void jpegBitReaderBegin(JpegBitReader &br, const uint8_t *buf, size_t len, size_t pos);
+
+// 丢弃剩余位并跳过 RSTn (重启间隔边界处调用)
+void jpegBitReaderRestart(JpegBitReader &br);
+
+static inline void jpegFill(JpegBitReader &br) {
+    while (br.nbits <= 24) {
+        uint32_t b = 0;
+        if (!br.marker && br.p < br.end) {
+            b = *br.p;
+            if (b == 0xFF) {
+                if (br.p + 1 < br.end && br.p[1] == 0x00) {
+                    br.p += 2;
+                } else {
+                    br.marker = true;
+                    b = 0;
+                }
+            } else {
+                br.p++;
+            }
+        }
+        br.acc |= b << (24 - br.nbits);
+        br.nbits += 8;
+    }
+}
+
+static inline uint32_t jpegGetBits(JpegBitReader &br, int n) {
+    if (n == 0) return 0;
+    jpegFill(br);
+    uint32_t v = br.acc >> (32 - n);
+    br.acc <<= n;
+    br.nbits -= n;
+    return v;
+}
+
+// 返回符号，码字不存在时返回 -1
+static inline int jpegDecodeSymbol(JpegBitReader &br, const JpegHuffDecoder &h) {
+    jpegFill(br);
+    uint16_t entry = h.look[br.acc >> 24];
+    if (entry) {
+        int l = entry >> 8;
+        br.acc <<= l;
+        br.nbits -= l;
+        return entry & 0xFF;
+    }
+    for (int l = 9; l <= 16; l++) {
+        int32_t code = (int32_t)(br.acc >> (32 - l));
+        if (code <= h.maxcode[l]) {
+            int idx = h.valptr[l] + code - h.mincode[l];
+            br.acc <<= l;
+            br.nbits -= l;
+            return h.vals[idx];
+        }
+    }
+    return -1;
+}
+
+// 附加位 -> 有符号系数
+static inline int jpegExtend(uint32_t v, int s) {
+    return v < (1u << (s - 1)) ? (int)v - (1 << s) + 1 : (int)v;
+}
+
+// ==================== 编码 ====================
+
+struct JpegHuffEncoder {
+    uint16_t code[256];
+    uint8_t size[256];          // 0 表示该符号在表中没有码字
+};
+
+void jpegBuildEncoder(JpegHuffEncoder &e, const uint8_t *bits, const uint8_t *vals);
+
+struct JpegBitWriter {
+    uint8_t *out;
+    size_t cap;
+    size_t len;
+    uint32_t acc;
+    int nbits;
+    bool ok;                    // 输出空间不足时置 false，之后的写入全部丢弃
+};
+
+void jpegBitWriterBegin(JpegBitWriter &bw, uint8_t *out, size_t cap);
+void jpegPutByte(JpegBitWriter &bw, uint8_t b);
+void jpegPutBytes(JpegBitWriter &bw, const uint8_t *data, size_t n);
+void jpegPutBits(JpegBitWriter &bw, uint32_t value, int n);     // 熵编码数据，FF 自动填充 00
+void jpegPutMarker(JpegBitWriter &bw, uint8_t marker, uint16_t seg_len);
+void jpegFinishScan(JpegBitWriter &bw);                         // 补 1 对齐到字节并写 EOI
+
+// 系数的类别 (附加位数)
+static inline int jpegCategory(int v) {
+    int a = v < 0 ? -v : v;
+    int n = 0;
+    while (a) {
+        n++;
+        a >>= 1;
+    }
+    return n;
+}
+
+// ==================== 重新编码 ====================
+
+// 帧像素坐标的矩形
+struct JpegRect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+};
+
+// 重新编码 (裁剪 / 遮挡) 的解析状态和 Huffman 编码表 (约 13 KB)，由调用者提供，不放在堆栈上
+struct JpegRecodeWork {
+    JpegHeader hdr;
+    JpegHuffEncoder dc[4];
+    JpegHuffEncoder ac[4];
+};
+
+// 解析头部并按原帧的 Huffman 表建立编码表
+bool jpegRecodeBegin(const uint8_t *jpeg, size_t len, JpegRecodeWork *work);
+
+// 复制 SOS 之前的头部段和 SOS 段：SOF 改为 width x height，去掉 DRI (输出不带重启间隔)
+void jpegCopyHeader(const uint8_t *jpeg, const JpegHeader &hdr, uint16_t width, uint16_t height,
+                    JpegBitWriter &bw);
+
+// 读一个块的 DC 差分并累加到 pred；码字无效返回 false
+static inline bool jpegReadDc(JpegBitReader &br, const JpegHuffDecoder &dc, int *pred) {
+    int s = jpegDecodeSymbol(br, dc);
+    if (s < 0 || s > 11) return false;
+    *pred += s ? jpegExtend(jpegGetBits(br, s), s) : 0;
+    return true;
+}
+
+// 写 DC 差分；表中没有该类别 (非标准表) 时返回 false
+static inline bool jpegPutDc(JpegBitWriter &bw, const JpegHuffEncoder &dc, int diff) {
+    int cat = jpegCategory(diff);
+    if (dc.size[cat] == 0) return false;
+    jpegPutBits(bw, dc.code[cat], dc.size[cat]);
+    if (cat) jpegPutBits(bw, diff < 0 ? diff - 1 : diff, cat);
+    return true;
+}
+
+// 读完一个块的 AC 系数；bw 不为 NULL 时把符号和附加位原样写出 (同一张表，码字不变)
+bool jpegCopyAc(JpegBitReader &br, const JpegHuffDecoder &ac, JpegBitWriter *bw,
+                const JpegHuffEncoder &enc);
+
+#endif // JPEG_ENTROPY_H
@@ -0,0 +1,31 @@
+#ifndef JPEG_MASK_H
+#define JPEG_MASK_H
+
+/**
+ * JPEG 域隐私遮挡 (DCT 块置黑，不解码像素)
+ *
+ * OV2640 在传感器内部完成 JPEG 编码，拿不到编码前的 RGB / YUV，所以遮挡在 DCT 域完成：
+ * 与任一矩形有重叠的 MCU，每个块的 DC 改为黑色 (亮度) / 中性 (色度)，AC 只写 EOB；
+ * 其余块的 AC 符号和附加位原样复制，DC 差分按新的相邻块重新计算，画质不变。
+ * 矩形向外扩展到 MCU 边界 (宁多勿少)，遮挡区域不保留任何原始系数。
+ *
+ * 不反量化、不做 IDCT。没有重启间隔时，第一个遮挡 MCU 之前只解码、最后整段复制，
+ * 最后一个遮挡 MCU 之后不再解码、按位移位接上，逐块重新写出的只有两者之间的部分；
+ * 带 DRI 的帧整帧重新写出。基准见 scripts/test/jpeg_mask_bench.cpp。输出不带重启间隔。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "jpeg_entropy.h"
+
+#ifndef JPEG_MASK_MAX_RECTS
+#define JPEG_MASK_MAX_RECTS 8
+#endif
+
+// 按 rects (帧像素坐标，超出帧的部分截掉，最多 JPEG_MASK_MAX_RECTS 个) 遮挡并写入 out；
+// 没有矩形落在帧内时原样复制；
+// 格式不支持、输出空间不足、数据损坏或 Huffman 表缺少所需码字时返回 0，否则返回输出长度
+size_t jpegMask(const uint8_t *jpeg, size_t len, const JpegRect *rects, int count,
+                JpegRecodeWork *work, uint8_t *out, size_t out_cap);
+
+#endif // JPEG_MASK_H
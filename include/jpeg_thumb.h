@@ -0,0 +1,47 @@
+#ifndef JPEG_THUMB_H
+#define JPEG_THUMB_H
+
+/**
+ * 1/8 缩略图 (DC 系数提取)
+ *
+ * 8x8 块的 DC 系数就是块的平均值，所以 1/8 缩略图不需要完整解码：
+ * 只做 Huffman 解码 (AC 系数按长度跳过，不反量化、不做 IDCT)，取出每个块的 DC，
+ * 再把得到的 Y / Cb / Cr 平面直接编码为 4:4:4 基线 JPEG (不经过 RGB)。
+ *
+ * 只支持基线顺序编码 (SOF0 / SOF1，8 位，单次交织扫描)，与 OV2640 的输出一致；
+ * 渐进式等其他格式返回 false。VGA 帧的缩略图为 80x60，约 1.5~3 KB。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef JPEG_THUMB_QUALITY
+#define JPEG_THUMB_QUALITY  75
+#endif
+
+struct JpegThumb {
+    uint16_t width;
+    uint16_t height;
+    size_t len;
+};
+
+// 该尺寸的帧所需工作区上限 (解析状态约 7 KB + 各分量 DC 平面)，工作区需 4 字节对齐
+size_t jpegThumbWorkBytes(uint16_t width, uint16_t height);
+
+// 生成缩略图写入 out；工作区或输出空间不足、格式不支持或数据损坏时返回 false
+bool jpegThumbnail(const uint8_t *jpeg, size_t len, uint8_t *work, size_t work_cap,
+                   uint8_t *out, size_t out_cap, uint8_t quality, JpegThumb *thumb);
+
+// 各分量的 DC 平面 (每个块的平均值 0~255)，width / height 为画面内的块数 (不含 MCU 补齐)
+struct JpegDcPlanes {
+    int ncomp;
+    const uint8_t *plane[3];
+    int stride[3];
+    int width[3];
+    int height[3];
+};
+
+// jpegThumbnail 成功之后工作区中的 DC 平面 (场景统计用)，下一次调用前有效
+void jpegThumbPlanes(const uint8_t *work, JpegDcPlanes *planes);
+
+#endif // JPEG_THUMB_H
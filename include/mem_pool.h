@@ -0,0 +1,89 @@
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+/**
+ * 固定块内存池与请求级 arena
+ *
+ * 长时间运行时，处理函数里反复 malloc / free 不同大小的缓冲区会让内部 RAM 碎片化，
+ * 最终大块分配失败。这里的内存都在启动时一次性分配，运行中只在池内借还：
+ *
+ * - MemPool：固定大小的块 (最多 32 块)，位图 + CAS 管理，可在任意任务中借还
+ * - MemArena：顺序分配、整体复位，只属于一个任务 (HTTP 任务每个请求结束后复位)
+ *
+ * 媒体缓冲区 (音频块、文件块) 放在 PSRAM (MEM_PSRAM，没有 PSRAM 时退回内部 RAM)，
+ * 小而频繁访问的缓冲区 (JSON 响应体) 放在内部 RAM (MEM_INTERNAL)。
+ * 所有池和 arena 自动登记，统计通过 /metrics 导出。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "metrics.h"
+
+#ifndef MEM_MAX_REGISTERED
+#define MEM_MAX_REGISTERED 8
+#endif
+
+enum MemRegion {
+    MEM_INTERNAL,
+    MEM_PSRAM
+};
+
+class MemPool {
+public:
+    MemPool(const char *name, size_t block_size, uint8_t blocks, MemRegion region);
+
+    bool begin();               // 分配后备内存 (重复调用无副作用)
+    void *alloc();              // 没有空闲块时返回 NULL 并计入失败次数
+    void free(void *p);
+
+    const char *name() const { return name_; }
+    size_t blockSize() const { return block_size_; }
+    uint8_t blocks() const { return blocks_; }
+    uint8_t used() const;
+    uint8_t peak() const { return peak_.load(std::memory_order_relaxed); }
+    uint32_t failures() const { return failures_.load(std::memory_order_relaxed); }
+    MemRegion region() const { return region_; }
+    bool ready() const { return base_ != nullptr; }
+
+private:
+    const char *name_;
+    size_t block_size_;
+    uint8_t blocks_;
+    MemRegion region_;
+    uint8_t *base_ = nullptr;
+    std::atomic<uint32_t> used_mask_{0};
+    std::atomic<uint8_t> peak_{0};
+    std::atomic<uint32_t> failures_{0};
+};
+
+class MemArena {
+public:
+    MemArena(const char *name, size_t capacity, MemRegion region);
+
+    bool begin();
+    void *alloc(size_t size, size_t align = 4);     // 超出容量返回 NULL 并计入溢出次数
+    void reset();                                   // 释放本轮分配的全部内存
+
+    const char *name() const { return name_; }
+    size_t capacity() const { return capacity_; }
+    size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+    uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+    MemRegion region() const { return region_; }
+
+private:
+    const char *name_;
+    size_t capacity_;
+    MemRegion region_;
+    uint8_t *base_ = nullptr;
+    size_t offset_ = 0;
+    std::atomic<size_t> peak_{0};
+    std::atomic<uint32_t> overflows_{0};
+};
+
+// 分配所有已登记的池和 arena (启动时调用一次)
+bool memBegin();
+
+void memRenderMetrics(MetricsWriter &w);
+
+#endif // MEM_POOL_H
@@ -0,0 +1,173 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * 性能指标 (Prometheus 文本格式)
+ *
+ * 记录侧只做 32 位原子加法，不加锁、不分配内存，可以在采集任务和 HTTP 处理函数中直接调用。
+ * 渲染侧 (/metrics) 通过 MetricsWriter 把文本写入一块固定缓冲区，写满后交给回调发送。
+ *
+ * 本文件不依赖 Arduino，时间由调用者用 esp_timer_get_time() 测量后传入。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <atomic>
+
+#define HISTOGRAM_MAX_BUCKETS 12
+
+// ==================== 指标类型 ====================
+
+// 64 位计数器：低 32 位原子累加，溢出时进位到高 32 位
+struct Counter {
+    std::atomic<uint32_t> lo{0};
+    std::atomic<uint32_t> hi{0};
+
+    void add(uint32_t v) {
+        uint32_t old = lo.fetch_add(v, std::memory_order_relaxed);
+        if ((uint32_t)(old + v) < old) {
+            hi.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void inc() { add(1); }
+    uint64_t value() const {
+        return ((uint64_t)hi.load(std::memory_order_relaxed) << 32) | lo.load(std::memory_order_relaxed);
+    }
+};
+
+struct Gauge {
+    std::atomic<int32_t> v{0};
+
+    void set(int32_t value) { v.store(value, std::memory_order_relaxed); }
+    int32_t value() const { return v.load(std::memory_order_relaxed); }
+};
+
+// 固定桶直方图：bounds 为升序上界，最后一个桶为 +Inf
+struct Histogram {
+    const uint32_t *bounds;
+    uint8_t bucket_count;
+    std::atomic<uint32_t> buckets[HISTOGRAM_MAX_BUCKETS + 1];
+    Counter sum;
+    Counter count;
+
+    Histogram(const uint32_t *b, uint8_t n) : bounds(b), bucket_count(n) {
+        for (auto &bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    }
+
+    void observe(uint32_t v) {
+        uint8_t i = 0;
+        while (i < bucket_count && v > bounds[i]) i++;
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        sum.add(v);
+        count.inc();
+    }
+};
+
+// ==================== 标签枚举 ====================
+
+enum HttpRoute {
+    ROUTE_ROOT,
+    ROUTE_VIDEO,
+    ROUTE_CAPTURE,
+    ROUTE_SAVE,
+    ROUTE_SAVED_PHOTO,
+    ROUTE_AUDIO,
+    ROUTE_AUDIO_STREAM,
+    ROUTE_STATUS,
+    ROUTE_METRICS,
+    ROUTE_TRACE,
+    ROUTE_RESTART,
+    ROUTE_POWER,
+    ROUTE_TIME,
+    ROUTE_TRIGGER,
+    ROUTE_SEGMENT_AUDIO,
+    ROUTE_SEGMENT_FRAMES,
+    ROUTE_STREAM,
+    ROUTE_UI,
+    ROUTE_CAMERA_CONFIG,
+    ROUTE_THUMB,
+    ROUTE_FRAMES,
+    ROUTE_PRIVACY,
+    ROUTE_EVENTS,
+    ROUTE_NOT_FOUND,
+    ROUTE_COUNT
+};
+
+enum StreamKind {
+    STREAM_VIDEO,
+    STREAM_AUDIO,
+    STREAM_EVENTS,      // /events 的 Server-Sent Events 长连接
+    STREAM_COUNT
+};
+
+enum WifiConnectPath {
+    WIFI_PATH_FAST,     // 缓存的 BSSID / 信道 / 租约
+    WIFI_PATH_SCAN,     // 完整扫描 + DHCP
+    WIFI_PATH_COUNT
+};
+
+// ==================== 指标实例 ====================
+
+extern Histogram metric_capture_latency_us;        // esp_camera_fb_get() 耗时
+extern Histogram metric_jpeg_size_bytes;           // JPEG 帧大小
+extern std::array<Histogram, STREAM_COUNT> metric_send_time_us;   // 单次发送耗时
+extern std::array<Histogram, ROUTE_COUNT> metric_http_handler_us;
+extern Counter metric_stream_bytes_sent[STREAM_COUNT];
+extern Counter metric_stream_writes[STREAM_COUNT];      // 流任务的 send() 调用次数
+extern Counter metric_audio_overruns;
+extern Counter metric_audio_fetch_gap_samples;     // /audio?from= 游标落出采集环而跳过的样本
+extern Counter metric_audio_stream_gap_samples;    // /audio/stream 落后于采集环而结束时缺失的样本
+extern Counter metric_frames_captured;
+extern Counter metric_capture_failures;
+extern Counter metric_frames_dropped;              // 帧缓存无空闲槽位、帧过大或隐私遮挡失败
+extern Histogram metric_thumb_encode_us;           // 1/8 缩略图生成耗时
+extern Counter metric_thumb_failures;              // 缩略图生成失败 (格式不支持 / 空间不足)
+extern Histogram metric_crop_us;                   // ROI 裁剪耗时 (/video.jpg、/capture、/stream 的 ?roi=)
+extern Counter metric_crop_failures;               // ROI 裁剪失败 (回退为整帧)
+extern Histogram metric_privacy_mask_us;           // 隐私遮挡耗时 (有遮挡区域时每帧一次)
+extern Histogram metric_still_switch_us;           // 双流：切到静态照片分辨率到取得照片的耗时
+extern Histogram metric_still_preview_gap_us;      // 双流：从切换开始到预览恢复出帧的时长
+extern Counter metric_wifi_connect_attempts;
+extern Counter metric_wifi_disconnects;
+extern Gauge metric_wifi_rssi_dbm;
+extern Counter metric_wifi_connects[WIFI_PATH_COUNT];
+extern Counter metric_wifi_fast_connect_fallbacks;
+extern Gauge metric_wifi_boot_connect_ms;          // 开机到获得 IP
+extern Histogram metric_wifi_reconnect_ms;         // 断开到重新获得 IP
+extern Gauge metric_boot_first_frame_ms;           // 开机到第一帧捕获成功
+
+const char *metricsRouteName(HttpRoute route);
+const char *metricsStreamName(StreamKind kind);
+const char *metricsWifiPathName(WifiConnectPath path);
+
+// ==================== 文本输出 ====================
+
+class MetricsWriter {
+public:
+    typedef void (*FlushFn)(const char *data, size_t len, void *ctx);
+
+    MetricsWriter(char *buf, size_t cap, FlushFn flush, void *ctx)
+        : buf_(buf), cap_(cap), len_(0), flush_(flush), ctx_(ctx) {}
+
+    void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    void type(const char *name, const char *kind);
+    void counter(const char *name, const char *labels, uint64_t value);
+    void gauge(const char *name, const char *labels, double value);
+    void histogram(const char *name, const char *labels, const Histogram &h);
+    void finish();
+
+private:
+    void flush();
+
+    char *buf_;
+    size_t cap_;
+    size_t len_;
+    FlushFn flush_;
+    void *ctx_;
+};
+
+// 写出本模块的全部指标 (WiFi RSSI 由调用者在渲染前刷新)
+void metricsRender(MetricsWriter &w);
+
+#endif // METRICS_H
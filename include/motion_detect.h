@@ -0,0 +1,49 @@
+#ifndef MOTION_DETECT_H
+#define MOTION_DETECT_H
+
+/**
+ * 画面运动检测 (发布 motion 事件)
+ *
+ * 与场景检测 (scene_detect.h) 共用缩略图的 Y 分量 DC 平面，每 FRAME_PREROLL_INTERVAL_MS
+ * 采样一次：DC 平面按 MOTION_GRID_W x MOTION_GRID_H 网格取平均 (与分辨率无关，
+ * 切换分辨率后仍可比较)，与上一次采样逐格相减。先减去全部格的平均差
+ * (自动曝光 / 开关灯引起的整体亮度变化)，再统计差值超过 MOTION_CELL_DELTA 的格数：
+ *
+ * - 开始：变化面积达到 MOTION_AREA_PERMILLE 千分比
+ * - 结束：连续 MOTION_HOLD_MS 没有达到
+ *
+ * 场景检测看的是与参考画面的整体统计差异 (持续的变化)，运动检测看的是相邻两次采样
+ * 之间的局部变化 (有人走过、开门)，两者互补。只在视频任务中调用。
+ */
+
+#include <stdint.h>
+#include "jpeg_thumb.h"
+#include "metrics.h"
+
+#ifndef MOTION_GRID_W
+#define MOTION_GRID_W           32
+#endif
+#ifndef MOTION_GRID_H
+#define MOTION_GRID_H           24
+#endif
+#ifndef MOTION_CELL_DELTA
+#define MOTION_CELL_DELTA       16      // 单格亮度变化 (0~255)
+#endif
+#ifndef MOTION_AREA_PERMILLE
+#define MOTION_AREA_PERMILLE    20      // 变化格数占比
+#endif
+#ifndef MOTION_HOLD_MS
+#define MOTION_HOLD_MS          3000
+#endif
+#ifndef MOTION_PREROLL_TRIGGER
+#define MOTION_PREROLL_TRIGGER  1       // 画面开始变化时创建预录片段 (prerollTrigger)
+#endif
+
+// 视频任务：比较一帧的 DC 平面与上一次采样
+void motionObserve(const JpegDcPlanes &planes, int64_t timestamp_us);
+
+bool motionActive();
+
+void motionRenderMetrics(MetricsWriter &w);
+
+#endif // MOTION_DETECT_H
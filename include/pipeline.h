@@ -0,0 +1,80 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/**
+ * 采集流水线：共享状态与后台任务
+ *
+ * ESP32 的 setup() 和主机的 main() 都通过这里启动同一组任务，
+ * 任务布局见 task_config.h。
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include "audio_ring.h"
+
+// ==================== 音频配置 ====================
+
+#define AUDIO_SAMPLE_RATE     16000
+#define AUDIO_BUFFER_SIZE     512     // 每次读取 I2S 的样本数 (32 ms)
+#define AUDIO_CHANNELS        1
+#define AUDIO_CHUNK_SIZE      4096    // 每次传输的音频块大小 (字节)
+
+#ifndef AUDIO_RING_SAMPLES
+#define AUDIO_RING_SAMPLES    AUDIO_SAMPLE_RATE  // 采集环容量 (1 秒，流读者的余量)
+#endif
+#ifndef AUDIO_PREROLL_MS
+#define AUDIO_PREROLL_MS      5000    // 预录音频时长，有 PSRAM 时追加到采集环容量上
+#endif
+#ifndef AUDIO_FETCH_MAX_MS
+#define AUDIO_FETCH_MAX_MS    10000   // /audio?from= 单次响应的音频时长上限
+#endif
+
+// ==================== 视频配置 ====================
+
+#ifndef VIDEO_FRAME_INTERVAL_MS
+#define VIDEO_FRAME_INTERVAL_MS       0       // 两次捕获之间的间隔，0 表示按传感器帧率
+#endif
+#ifndef FRAME_STORE_SLOT_BYTES
+#define FRAME_STORE_SLOT_BYTES        (128 * 1024)  // 单帧上限 (PSRAM)
+#endif
+#ifndef FRAME_STORE_SLOT_BYTES_DRAM
+#define FRAME_STORE_SLOT_BYTES_DRAM   (24 * 1024)   // 单帧上限 (无 PSRAM，QVGA)
+#endif
+
+// ==================== 共享状态 ====================
+
+// 采集环：音频任务是唯一的麦克风读取者，HTTP 和流任务都从这里取数据
+extern AudioRing audio_ring;
+
+extern std::atomic<int> stream_clients;    // 当前活动的流连接数
+extern volatile bool audio_streaming;      // 是否正在流式传输音频
+
+extern unsigned long frame_count;
+extern unsigned long audio_bytes_captured;
+extern volatile unsigned long frame_latency_ms;      // 最近一次 /video.jpg 处理耗时
+extern volatile unsigned long frame_latency_max_ms;
+
+// 视频任务两次捕获之间的间隔 (ms)，初值 VIDEO_FRAME_INTERVAL_MS，由电源配置档 (power.h) 调整
+extern std::atomic<uint32_t> video_frame_interval_ms;
+
+// 任务句柄 (ESP32 上为 TaskHandle_t)
+extern void *videoTaskHandle;
+extern void *audioTaskHandle;
+extern void *httpTaskHandle;
+
+// ==================== 接口 ====================
+
+// 初始化麦克风和采集环
+bool pipelineBeginAudio();
+
+// 按 task_config.h 创建视频、音频、HTTP 任务
+// 摄像头尚未初始化时由视频任务初始化，之后持续把帧写入帧缓存 (frame_store.h)
+void pipelineStartTasks();
+
+void recordFrameLatency(unsigned long latency_ms);
+
+// 记录一次成功的捕获 (捕获耗时 / 帧大小 / 帧计数 / 开机到第一帧)
+struct HalFrame;
+void recordFrameCaptured(const HalFrame &frame, uint32_t capture_us);
+
+#endif // PIPELINE_H
@@ -0,0 +1,60 @@
+#ifndef POWER_H
+#define POWER_H
+
+/**
+ * 电源配置档
+ *
+ * 一个配置档同时决定 WiFi 省电模式、CPU 频率范围 (DFS)、自动 light sleep、
+ * 摄像头 XCLK 和视频任务的捕获间隔，通过 /power?profile=NAME 在运行时切换：
+ *
+ *   live       实时流：射频常开、CPU 固定 240 MHz、XCLK 20 MHz、按传感器帧率捕获
+ *   lifelog    日常记录：MIN_MODEM (每个 DTIM 醒来)、80~160 MHz、XCLK 10 MHz、1 fps
+ *   timelapse  延时摄影：MAX_MODEM (每 listen_interval 个信标醒来)、40~80 MHz、
+ *              XCLK 10 MHz、每 30 s 一帧，其余时间允许 light sleep
+ *
+ * DFS 和 light sleep 需要固件启用 CONFIG_PM_ENABLE (light sleep 还需要
+ * CONFIG_FREERTOS_USE_TICKLESS_IDLE)；未启用时 CPU 固定在 max 频率。
+ * I2S 驱动持有 APB 电源锁，音频任务运行期间不会进入 light sleep。
+ */
+
+#include <stdint.h>
+#include "hal.h"
+#include "metrics.h"
+
+enum PowerProfileId {
+    POWER_PROFILE_LIVE,
+    POWER_PROFILE_LIFELOG,
+    POWER_PROFILE_TIMELAPSE,
+    POWER_PROFILE_COUNT
+};
+
+#ifndef POWER_DEFAULT_PROFILE
+#define POWER_DEFAULT_PROFILE POWER_PROFILE_LIVE
+#endif
+
+struct PowerProfile {
+    const char *name;
+    HalWifiPowerSave wifi_ps;
+    uint8_t listen_interval;        // 信标间隔数，只在 MAX_MODEM 下使用
+    uint16_t cpu_max_mhz;
+    uint16_t cpu_min_mhz;
+    bool light_sleep;
+    uint8_t xclk_mhz;
+    uint32_t frame_interval_ms;     // 视频任务两次捕获之间的间隔，0 表示按传感器帧率
+};
+
+const PowerProfile &powerProfile(PowerProfileId id);
+PowerProfileId powerCurrentProfile();
+
+// 按名称查找，找不到返回 POWER_PROFILE_COUNT
+PowerProfileId powerProfileByName(const char *name);
+
+// 应用配置档 (WiFi 需已启动；摄像头未初始化时 XCLK 在初始化时生效)
+void powerApplyProfile(PowerProfileId id);
+
+// 最近一次应用时 DFS / light sleep 是否生效
+bool powerDfsActive();
+
+void powerRenderMetrics(MetricsWriter &w);
+
+#endif // POWER_H
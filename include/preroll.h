@@ -0,0 +1,51 @@
+#ifndef PREROLL_H
+#define PREROLL_H
+
+/**
+ * 触发录制与预录
+ *
+ * 采集环 (音频) 和帧缓存 (视频) 一直保留最近几秒的数据。触发时记录一个片段：
+ * 起点为触发时刻往前 AUDIO_PREROLL_MS (受实际保留的数据限制)，
+ * 片段只记录起点的样本序号和时刻，数据仍在采集环和帧缓存中，不复制。
+ *
+ *   /trigger                   创建片段，返回 id、起点样本序号和预录帧数
+ *   /segment/audio?id=N        从片段起点开始的音频流 (先追上预录，之后与 /audio/stream 相同)
+ *   /segment/frames?id=N       片段起点之后保留的预录帧 (multipart/mixed)
+ *
+ * 主机需在预录数据被覆盖前取走：音频约为采集环容量 - 预录时长 (默认 1 秒)，
+ * 预录帧按 FRAME_PREROLL_INTERVAL_MS 滚动淘汰。
+ */
+
+#include <stdint.h>
+#include "metrics.h"
+
+#ifndef PREROLL_MAX_SEGMENTS
+#define PREROLL_MAX_SEGMENTS 8      // 最近的片段数，更早的片段 id 失效
+#endif
+
+enum TriggerSource {
+    TRIGGER_HTTP,           // /trigger
+    TRIGGER_VAD,            // 语音起始
+    TRIGGER_MOTION,         // 画面变化
+    TRIGGER_COUNT
+};
+
+struct PrerollSegment {
+    uint32_t id;                // 从 1 开始
+    TriggerSource source;
+    int64_t trigger_us;         // 触发时刻 (halNowUs 时钟)
+    int64_t start_us;           // 片段起点 = 第一个样本的采集时刻
+    uint64_t audio_start;       // 第一个样本的绝对序号
+};
+
+// 创建片段，返回 id (任何任务都可调用)；采集环未就绪时返回 0
+uint32_t prerollTrigger(TriggerSource source);
+
+// 按 id 查找最近的片段，已被新片段挤出时返回 false
+bool prerollGetSegment(uint32_t id, PrerollSegment *segment);
+
+const char *prerollTriggerName(TriggerSource source);
+
+void prerollRenderMetrics(MetricsWriter &w);
+
+#endif // PREROLL_H
@@ -0,0 +1,56 @@
+#ifndef PRIVACY_MASK_H
+#define PRIVACY_MASK_H
+
+/**
+ * 隐私遮挡区域 (屏幕、白板等，在帧离开摄像头之前涂黑)
+ *
+ * 视频任务把帧写入帧缓存时遮挡 (jpeg_mask.h，代替原来的 memcpy)，之后的所有读者
+ * (/video.jpg、/stream、预录、缩略图、录制段) 拿到的都是遮挡后的帧，原始画面不出设备。
+ *
+ * - 区域用传感器坐标 (UXGA 1600x1200) 配置，按帧的实际尺寸和数码变焦窗口换算到帧坐标，
+ *   切换分辨率或变焦后仍遮挡同一处画面；换算时向外取整，再向外对齐到 MCU
+ * - 失败即丢帧：遮挡失败 (非基线 JPEG、工作区分配失败、数据损坏) 的帧不发布；
+ *   视频任务应用新的变焦窗口后的 PRIVACY_MASK_SETTLE_FRAMES 帧可能仍按旧窗口采集，同样不发布
+ * - 没有区域时只做 memcpy，与原来相同
+ * - 区域保存在 PRIVACY_MASK_PATH，开机时读取
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "jpeg_entropy.h"
+#include "jpeg_mask.h"
+#include "metrics.h"
+
+#ifndef PRIVACY_MASK_PATH
+#define PRIVACY_MASK_PATH           "/privacy.cfg"
+#endif
+#define PRIVACY_MASK_MAX            JPEG_MASK_MAX_RECTS
+#ifndef PRIVACY_MASK_SETTLE_FRAMES
+#define PRIVACY_MASK_SETTLE_FRAMES  2       // 驱动中排队的帧数 (fb_count)
+#endif
+
+// 读取保存的区域 (视频任务启动时调用一次)
+void privacyMaskBegin();
+
+// 当前区域 (传感器坐标)，返回数量
+int privacyMaskGet(JpegRect *rects, int max);
+
+// 范围检查，失败时返回说明文字，通过返回 NULL
+const char *privacyMaskValidate(const JpegRect *rects, int count);
+
+// 替换全部区域 (count 为 0 时清除) 并保存；persisted 为写入存储是否成功
+void privacyMaskSet(const JpegRect *rects, int count, bool *persisted);
+
+// 传感器坐标换算到 width x height 的帧 (当前变焦窗口)，完全在画面外的区域去掉，返回数量
+int privacyMaskToFrame(const JpegRect *rects, int count, uint16_t width, uint16_t height,
+                       JpegRect *out);
+
+// ==================== 视频任务调用 ====================
+
+// 遮挡后写入 out (没有区域时直接复制)；返回 0 表示该帧不能发布
+size_t privacyMaskCopy(const uint8_t *jpeg, size_t len, uint16_t width, uint16_t height,
+                       uint8_t *out, size_t out_cap);
+
+void privacyMaskRenderMetrics(MetricsWriter &w);
+
+#endif // PRIVACY_MASK_H
@@ -0,0 +1,52 @@
+#ifndef SCENE_DETECT_H
+#define SCENE_DETECT_H
+
+/**
+ * 场景切换检测 (日记按画面内容分段)
+ *
+ * 帧缓存生成缩略图时已经解出了每个 8x8 块的 DC (块平均值，jpeg_thumb.h)，
+ * 场景统计直接用这些 DC 平面，不再解码：
+ *
+ * - 亮度直方图：Y 块平均值分 SCENE_HIST_BINS 档，按千分比归一化 (与分辨率无关)
+ * - 颜色矩：Y / Cb / Cr 的均值和标准差
+ *
+ * 与参考统计比较得到 0~100 的距离 (直方图 L1 距离和颜色矩差各占一半)。
+ * 连续 SCENE_CONFIRM_SAMPLES 次超过 SCENE_THRESHOLD 时判定为场景切换：
+ * 发布 scene 事件 (events.h，时刻为第一次超过阈值的帧)，场景编号加一，参考统计换成当前帧。
+ * 距离低于阈值一半时参考统计缓慢跟随当前帧 (吸收光线的渐变)；
+ * 两次切换至少间隔 SCENE_MIN_INTERVAL_MS，避免有人走过时连续触发。
+ *
+ * 采样间隔与缩略图相同 (FRAME_PREROLL_INTERVAL_MS)，只在视频任务中调用。
+ */
+
+#include <stdint.h>
+#include "jpeg_thumb.h"
+#include "metrics.h"
+
+#ifndef SCENE_HIST_BINS
+#define SCENE_HIST_BINS             16
+#endif
+#ifndef SCENE_THRESHOLD
+#define SCENE_THRESHOLD             35      // 距离 0~100
+#endif
+#ifndef SCENE_CONFIRM_SAMPLES
+#define SCENE_CONFIRM_SAMPLES       2       // 连续超过阈值的采样次数 (500 ms 一次)
+#endif
+#ifndef SCENE_MIN_INTERVAL_MS
+#define SCENE_MIN_INTERVAL_MS       5000
+#endif
+
+struct SceneState {
+    uint32_t id;                // 场景编号，开机为 0，每次切换加一
+    int64_t start_us;           // 当前场景开始时刻 (0 表示开机以来没有切换)
+    uint8_t score;              // 最近一次采样的距离
+};
+
+// 视频任务：统计一帧的 DC 平面并判定是否切换
+void sceneObserve(const JpegDcPlanes &planes, int64_t timestamp_us, uint32_t frame_seq);
+
+SceneState sceneCurrent();
+
+void sceneRenderMetrics(MetricsWriter &w);
+
+#endif // SCENE_DETECT_H
@@ -0,0 +1,91 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+/**
+ * 跨任务共享的 64 位值
+ *
+ * ESP32-S3 (Xtensa) 只有 32 位原子指令，std::atomic<int64_t> 由 IDF 的 __atomic_*_8
+ * 在临界区 (关中断 + 自旋锁) 中实现，不是无锁的。这里把值拆成 32 位半字，
+ * 用顺序号 (奇数表示写入中) 保证读者取到同一次写入的所有半字：写者不等待，读者遇到写入中重试。
+ * 同一个值只能有一个写者 (或写者之间已互斥)。
+ *
+ *   SeqlockI64      单个 64 位值
+ *   SeqlockI64Pair  必须成对读出的两个 64 位值 (如音频环的写指针和它的时间锚点)，
+ *                   两个 SeqlockI64 各自一致，但读者可能取到不同写入的两个值
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "32 位原子操作必须无锁");
+
+// N 个 32 位字共用一个顺序号
+template <size_t N>
+class SeqlockWords {
+public:
+    constexpr SeqlockWords() : words_{} {}
+    constexpr SeqlockWords(uint32_t w0, uint32_t w1) : words_{{w0}, {w1}} {}
+
+    void load(uint32_t (&out)[N]) const {
+        uint32_t s1, s2;
+        do {
+            s1 = seq_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < N; i++) out[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s2 = seq_.load(std::memory_order_relaxed);
+        } while ((s1 & 1u) || s1 != s2);
+    }
+
+    void store(const uint32_t (&in)[N]) {
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < N; i++) words_[i].store(in[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> words_[N];
+};
+
+class SeqlockI64 {
+public:
+    constexpr SeqlockI64(int64_t v = 0) : words_((uint32_t)v, (uint32_t)((uint64_t)v >> 32)) {}
+
+    int64_t load() const {
+        uint32_t w[2];
+        words_.load(w);
+        return (int64_t)(((uint64_t)w[1] << 32) | w[0]);
+    }
+
+    void store(int64_t v) {
+        uint32_t w[2] = {(uint32_t)v, (uint32_t)((uint64_t)v >> 32)};
+        words_.store(w);
+    }
+
+private:
+    SeqlockWords<2> words_;
+};
+
+class SeqlockI64Pair {
+public:
+    void load(int64_t* a, int64_t* b) const {
+        uint32_t w[4];
+        words_.load(w);
+        *a = (int64_t)(((uint64_t)w[1] << 32) | w[0]);
+        *b = (int64_t)(((uint64_t)w[3] << 32) | w[2]);
+    }
+
+    void store(int64_t a, int64_t b) {
+        uint32_t w[4] = {(uint32_t)a, (uint32_t)((uint64_t)a >> 32),
+                         (uint32_t)b, (uint32_t)((uint64_t)b >> 32)};
+        words_.store(w);
+    }
+
+private:
+    SeqlockWords<4> words_;
+};
+
+#endif // SEQLOCK_H
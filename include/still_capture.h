@@ -0,0 +1,60 @@
+#ifndef STILL_CAPTURE_H
+#define STILL_CAPTURE_H
+
+/**
+ * 双流：低分辨率预览 + 全分辨率静态照片 (同一个传感器分时切换)
+ *
+ * 预览按 frame_size (如 QVGA) 持续采集进帧缓存，/stream、/video.jpg 照旧；
+ * /capture 在 still_size 不为 off 时请求一张静态照片，由视频任务在两次取帧之间：
+ *
+ * 1. halCameraApply 切到 still_size (其余参数、变焦窗口不变)
+ * 2. 取帧，丢弃尺寸不符 (驱动中排队的预览帧) 或损坏的帧，最多 STILL_SKIP_MAX 帧；
+ *    第一张正常帧经隐私遮挡复制到静态照片缓冲区
+ * 3. 切回预览参数；之后几帧可能还是静态照片尺寸，视频任务丢弃 (stillResyncDrop)
+ *
+ * 没有在 ESP32 上把 UXGA 帧缩小成预览：OV2640 直接输出 JPEG，缩小要整帧解码 + 重新编码，
+ * 每帧代价远高于偶尔切换一次分辨率。代价是切换期间预览暂停，切换耗时和预览中断时长
+ * 记在 autodiary_still_switch_us / autodiary_still_preview_gap_us。
+ *
+ * 静态照片缓冲区第一次使用时分配 (halAllocLarge)，只有 HTTP 任务一个读者：
+ * 视频任务只在处理请求时写入，请求方在序号到达后才读取，下一次请求前不会被覆盖。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hal.h"
+#include "metrics.h"
+
+#ifndef STILL_BUFFER_BYTES
+#define STILL_BUFFER_BYTES  (HAL_SENSOR_WIDTH * HAL_SENSOR_HEIGHT / 5)  // 与驱动 UXGA 帧缓冲相同
+#endif
+#ifndef STILL_SKIP_MAX
+#define STILL_SKIP_MAX      4       // 切换分辨率后最多丢弃的帧数
+#endif
+#ifndef STILL_TIMEOUT_MS
+#define STILL_TIMEOUT_MS    3000    // 请求等待视频任务取得静态照片的上限
+#endif
+
+struct StillFrame {
+    const uint8_t *buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    int64_t timestamp_us;       // 采集时间 (halNowUs 时钟)
+    uint32_t switch_us;         // 从切换分辨率到取得这张照片的耗时
+};
+
+// HTTP 任务：按 frame_size 取一张静态照片并等待；超时或失败返回 false (调用者回退为预览帧)
+bool stillCapture(uint8_t frame_size, uint32_t timeout_ms, StillFrame *still);
+
+// ==================== 视频任务调用 ====================
+
+bool stillPending();            // 有尚未处理的请求
+void stillServe();              // 处理最新请求 (没有请求时不做任何事)
+
+// 切回预览后，丢弃仍为静态照片尺寸的帧 (返回 true 时调用者不发布该帧)
+bool stillResyncDrop(const HalFrame &frame);
+
+void stillRenderMetrics(MetricsWriter &w);
+
+#endif // STILL_CAPTURE_H
@@ -0,0 +1,91 @@
+#ifndef SYS_MONITOR_H
+#define SYS_MONITOR_H
+
+/**
+ * 系统资源采样 (堆栈水位 / 堆碎片 / 分配失败)
+ *
+ * 后台低优先级任务每 SYS_MONITOR_INTERVAL_MS 采样一次，结果保存在快照中；
+ * 热路径和 HTTP 处理函数只读取快照，不再直接调用 ESP.getFreeHeap()。
+ *
+ * 每次采样后检查阈值并发布事件 (events.h)，进入状态时发布一次，恢复到
+ * 解除阈值以下后才会再次发布：
+ *   storage_full  文件系统已用超过 SYS_STORAGE_FULL_PERMILLE (低于 SYS_STORAGE_CLEAR_PERMILLE 解除)
+ *   low_heap      内部 RAM 空闲低于 SYS_LOW_HEAP_BYTES (高于其 5/4 解除)
+ *
+ * 主机构建没有 heap_caps / 任务水位，接口保留，指标输出为 0；存储用量照常采样。
+ */
+
+#include <stdint.h>
+#include "metrics.h"
+
+#ifndef SYS_MONITOR_INTERVAL_MS
+#define SYS_MONITOR_INTERVAL_MS   5000
+#endif
+
+#ifndef SYS_STORAGE_FULL_PERMILLE
+#define SYS_STORAGE_FULL_PERMILLE   900
+#endif
+#ifndef SYS_STORAGE_CLEAR_PERMILLE
+#define SYS_STORAGE_CLEAR_PERMILLE  850
+#endif
+#ifndef SYS_LOW_HEAP_BYTES
+#define SYS_LOW_HEAP_BYTES          32768
+#endif
+
+#ifndef SYS_MONITOR_MAX_TASKS
+#define SYS_MONITOR_MAX_TASKS     10
+#endif
+
+// 单个堆区域 (内部 RAM 或 PSRAM) 的采样结果
+struct HeapRegionStats {
+    uint32_t total;
+    uint32_t free;
+    uint32_t min_free;          // 开机以来的最低空闲量
+    uint32_t largest_block;     // 最大连续空闲块
+};
+
+// 单个任务的堆栈水位
+struct TaskStackStats {
+    const char *name;
+    void *handle;               // TaskHandle_t；为 NULL 表示任务自行上报 (短生命周期任务) 或已退出
+    uint32_t stack_size;
+    uint32_t free_min;          // 剩余堆栈最小值 (字节)
+    bool exited;                // 已调用 sysMonitorUnwatchTask，之后同名的登记被忽略
+};
+
+struct SysStats {
+    HeapRegionStats internal;
+    HeapRegionStats psram;
+    uint32_t alloc_failures;
+    uint32_t alloc_failure_last_size;
+    uint32_t alloc_failure_last_caps;
+    uint64_t storage_used;
+    uint64_t storage_total;     // 0 表示尚未采样或文件系统不可用
+    uint32_t samples;
+    TaskStackStats tasks[SYS_MONITOR_MAX_TASKS];
+    uint8_t task_count;
+};
+
+extern SysStats sys_stats;
+
+// 注册分配失败回调并启动采样任务
+void sysMonitorBegin();
+
+// 登记长期运行的任务，由采样任务定期读取水位
+void sysMonitorWatchTask(void *handle, const char *name, uint32_t stack_size);
+
+// 已登记的任务提前退出 (初始化失败等) 时在 halTaskExit() 之前调用：清除句柄，保留退出时的水位。
+// 采样任务正在读取该任务的水位时等它读完，返回后任务控制块可以安全释放；
+// 先于 sysMonitorWatchTask 调用时，之后的登记被忽略
+void sysMonitorUnwatchTask(const char *name);
+
+// 短生命周期任务在退出前调用，上报自身水位 (同名任务取最小值)
+void sysMonitorReportSelf(const char *name, uint32_t stack_size);
+
+// 碎片率 (0~1)：1 - 最大空闲块 / 空闲总量
+float sysMonitorFragmentation(const HeapRegionStats &region);
+
+// 写出资源类指标 (/metrics)
+void sysMonitorRenderMetrics(MetricsWriter &w);
+
+#endif // SYS_MONITOR_H
@@ -0,0 +1,122 @@
+#ifndef TASK_CONFIG_H
+#define TASK_CONFIG_H
+
+/**
+ * 任务布局 (优先级 / 核心亲和性 / 堆栈大小)
+ *
+ * ESP32-S3 双核分工：
+ *   核心 0 (PRO) - WiFi 驱动 (优先级 23)、lwIP tcpip (优先级 18)、HTTP 服务、流发送
+ *   核心 1 (APP) - 音频采集、视频采集、Arduino loop()
+ *
+ * 原则：
+ *   - 音频采集是唯一有硬实时要求的阶段 (I2S DMA 缓冲仅数十毫秒)，
+ *     放在不运行 WiFi 的核心 1 上，并使用应用层最高优先级。
+ *   - 视频采集同在核心 1，优先级低于音频，JPEG 由传感器硬件编码，CPU 占用很小。
+ *   - HTTP 与流发送都在调用 lwIP，放在核心 0 上与网络栈同核，
+ *     避免跨核唤醒；它们的优先级低于 lwIP，发送阻塞时自然让出 CPU。
+ *   - WiFi 连接管理任务大部分时间阻塞在事件组上，只在连接状态变化时运行。
+ *   - 资源采样任务以最低优先级运行，只在空闲时采样。
+ *   - Arduino loop() 由框架固定在 ARDUINO_RUNNING_CORE (默认核心 1)、优先级 1，
+ *     只做低频维护工作，不再处理 HTTP 请求。
+ *
+ * 所有值均可通过 platformio.ini 的 build_flags 覆盖，例如：
+ *   -DTASK_AUDIO_PRIORITY=6 -DTASK_HTTP_CORE=1
+ *
+ * 详细说明见 docs/ARCHITECTURE/TASK_LAYOUT.md
+ */
+
+// ==================== 核心分配 ====================
+
+#ifndef CORE_NET
+#define CORE_NET              0     // WiFi / lwIP 所在核心
+#endif
+
+#ifndef CORE_APP
+#define CORE_APP              1     // 采集任务所在核心
+#endif
+
+// ==================== 音频采集 ====================
+
+#ifndef TASK_AUDIO_PRIORITY
+#define TASK_AUDIO_PRIORITY   5
+#endif
+#ifndef TASK_AUDIO_CORE
+#define TASK_AUDIO_CORE       CORE_APP
+#endif
+#ifndef TASK_AUDIO_STACK
+#define TASK_AUDIO_STACK      4096
+#endif
+
+// ==================== 视频采集 ====================
+
+#ifndef TASK_VIDEO_PRIORITY
+#define TASK_VIDEO_PRIORITY   3
+#endif
+#ifndef TASK_VIDEO_CORE
+#define TASK_VIDEO_CORE       CORE_APP
+#endif
+#ifndef TASK_VIDEO_STACK
+#define TASK_VIDEO_STACK      8192
+#endif
+
+// ==================== HTTP 服务 ====================
+
+#ifndef TASK_HTTP_PRIORITY
+#define TASK_HTTP_PRIORITY    2
+#endif
+#ifndef TASK_HTTP_CORE
+#define TASK_HTTP_CORE        CORE_NET
+#endif
+#ifndef TASK_HTTP_STACK
+#define TASK_HTTP_STACK       8192
+#endif
+
+// ==================== 流发送 (启动时创建 MAX_STREAM_CLIENTS 个任务，每个服务一个长连接) ====================
+
+#ifndef TASK_STREAM_PRIORITY
+#define TASK_STREAM_PRIORITY  2
+#endif
+#ifndef TASK_STREAM_CORE
+#define TASK_STREAM_CORE      CORE_NET
+#endif
+#ifndef TASK_STREAM_STACK
+#define TASK_STREAM_STACK     4096  // 音频块缓冲区在 PSRAM 内存池中，视频帧直接从帧缓存发送，不占堆栈
+#endif
+#ifndef AUDIO_STREAM_LATENCY_MS
+#define AUDIO_STREAM_LATENCY_MS 100 // 音频流默认目标延迟 (决定 chunk 大小，可用 ?latency_ms= 覆盖)
+#endif
+#ifndef EVENT_STREAM_IDLE_CHECK_MS
+#define EVENT_STREAM_IDLE_CHECK_MS 500 // 事件流空闲时检查连接是否断开的间隔 (新事件由发布方唤醒，不轮询)
+#endif
+#ifndef EVENT_STREAM_KEEPALIVE_MS
+#define EVENT_STREAM_KEEPALIVE_MS 15000 // 事件流空闲时的注释行间隔 (穿过代理超时、发现断开的连接)
+#endif
+#ifndef MAX_STREAM_CLIENTS
+#define MAX_STREAM_CLIENTS    3     // 同时存在的流连接上限 (音频流、MJPEG 视频流和事件流共用)
+#endif
+
+// ==================== WiFi 连接管理 ====================
+
+#ifndef TASK_WIFI_PRIORITY
+#define TASK_WIFI_PRIORITY    2
+#endif
+#ifndef TASK_WIFI_CORE
+#define TASK_WIFI_CORE        CORE_NET
+#endif
+#ifndef TASK_WIFI_STACK
+#define TASK_WIFI_STACK       4096
+#endif
+
+// ==================== 资源采样 ====================
+
+#ifndef TASK_MONITOR_PRIORITY
+#define TASK_MONITOR_PRIORITY 1
+#endif
+#ifndef TASK_MONITOR_CORE
+#define TASK_MONITOR_CORE     CORE_NET
+#endif
+#ifndef TASK_MONITOR_STACK
+#define TASK_MONITOR_STACK    3072
+#endif
+
+#endif // TASK_CONFIG_H
@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * 热路径追踪 (Chrome trace-event 导出)
+ *
+ * 每个核心一个环形缓冲区，任务通过原子 fetch_add 预留槽位后写入，写完再发布序号，
+ * 同核任务互相抢占也不需要加锁。每个事件记录开始时间和持续时间 (Chrome "X" 事件)，
+ * 导出时 pid 为核心号、tid 为流水线阶段，在 chrome://tracing 或 Perfetto 中
+ * 可以直接看到每个核心上各阶段的时间线。
+ *
+ * 编译时设置 -DTRACE_ENABLED=0 可完全去掉记录代码。
+ */
+
+#include <stdint.h>
+#include "hal.h"
+#include "metrics.h"
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED       1
+#endif
+
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS   512     // 每个核心的事件数 (每个事件 24 字节)
+#endif
+
+#define TRACE_CORES         2
+
+// 流水线阶段，同时作为导出时的 tid
+enum TraceEvent {
+    TRACE_CAPTURE,      // esp_camera_fb_get()
+    TRACE_ENCODE,       // JPEG 域处理 (缩略图 / 隐私遮挡 / 裁剪)
+    TRACE_SEND,         // 写入 socket (lwIP + WiFi)
+    TRACE_I2S_READ,     // I2S.read()
+    TRACE_HTTP,         // HTTP 处理函数
+    TRACE_EVENT_COUNT
+};
+
+// 记录一个完整事件 (start_us 为 halNowUs() 时间戳)
+void traceRecord(TraceEvent event, int64_t start_us, uint32_t dur_us, uint32_t arg = 0);
+
+// 运行时开关 (/trace?enable=0|1)
+void traceSetEnabled(bool enabled);
+bool traceIsEnabled();
+
+// 按 Chrome trace-event JSON 格式写出两个核心的环
+void traceRenderJson(MetricsWriter &w);
+
+// 作用域追踪：构造时记录开始时间，析构时写入事件
+class TraceScope {
+public:
+    explicit TraceScope(TraceEvent event, uint32_t arg = 0)
+        : event_(event), arg_(arg), start_us_(halNowUs()) {}
+    ~TraceScope() {
+        traceRecord(event_, start_us_, (uint32_t)(halNowUs() - start_us_), arg_);
+    }
+    void setArg(uint32_t arg) { arg_ = arg; }
+
+private:
+    TraceEvent event_;
+    uint32_t arg_;
+    int64_t start_us_;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(event) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(event)
+#else
+#define TRACE_SCOPE(event) do {} while (0)
+#endif
+
+#endif // TRACE_H
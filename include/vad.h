@@ -0,0 +1,52 @@
+#ifndef VAD_H
+#define VAD_H
+
+/**
+ * 语音活动检测 (能量 VAD，发布 vad 事件)
+ *
+ * 音频任务每读到一块样本就交给 vadObserve，按 VAD_FRAME_MS 分帧：
+ *
+ * - 帧能量：去直流 (一阶高通，I2S 麦克风常带直流偏置) 后的均方值，换算为 dB
+ * - 噪声底：低于噪声底时快速跟随，高于时每秒最多上升 VAD_FLOOR_RISE_DB
+ *   (持续的背景噪声十几秒后被吸收，几秒的语音基本不抬高噪声底)
+ * - 起始：连续 VAD_ONSET_MS 高出噪声底 VAD_ONSET_DB，事件时刻为第一帧
+ * - 结束：连续 VAD_HANGOVER_MS 低于噪声底 + VAD_OFFSET_DB (句间停顿不拆段)，
+ *   事件时刻为安静开始的一帧
+ *
+ * 只做能量判定，不区分语音和其他声音 (敲击、音乐)；主机端仍用完整 VAD / ASR 确认，
+ * 设备事件只用来及时唤醒主机处理，不用再轮询音频能量。
+ */
+
+#include <stdint.h>
+#include "metrics.h"
+
+#ifndef VAD_FRAME_MS
+#define VAD_FRAME_MS            20
+#endif
+#ifndef VAD_ONSET_DB
+#define VAD_ONSET_DB            12      // 起始：高出噪声底
+#endif
+#ifndef VAD_OFFSET_DB
+#define VAD_OFFSET_DB           6       // 结束：低于噪声底 + 该值
+#endif
+#ifndef VAD_ONSET_MS
+#define VAD_ONSET_MS            100
+#endif
+#ifndef VAD_HANGOVER_MS
+#define VAD_HANGOVER_MS         600
+#endif
+#ifndef VAD_FLOOR_RISE_DB
+#define VAD_FLOOR_RISE_DB       1       // 噪声底每秒最多上升
+#endif
+#ifndef VAD_PREROLL_TRIGGER
+#define VAD_PREROLL_TRIGGER     1       // 语音起始时创建预录片段 (prerollTrigger)
+#endif
+
+// 音频任务：一块样本，end_us 为最后一个样本的采集时刻
+void vadObserve(const int16_t *samples, int count, uint32_t sample_rate, int64_t end_us);
+
+bool vadActive();
+
+void vadRenderMetrics(MetricsWriter &w);
+
+#endif // VAD_H
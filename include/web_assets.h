@@ -0,0 +1,36 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+/**
+ * 编译期嵌入的 Web UI 资源
+ *
+ * web/ 下的页面、脚本和样式由 scripts/tools/embed_web_assets.py 在编译前
+ * gzip 压缩 (级别 9) 并生成 src/web_assets.cpp，数据是常量数组，链接在 flash 中，
+ * 通过 cache 映射直接发送，不复制到 RAM。
+ *
+ * - ETag 为压缩后内容的 SHA-256 前缀 (强校验)，If-None-Match 命中时返回 304
+ * - 页面本身每次重新校验 (no-cache)；页面引用的脚本和样式 URL 带 ?v=<ETag>，
+ *   内容变化即换 URL，因此可以长期缓存 (immutable)
+ * - 只保存 gzip 版本，总是以 Content-Encoding: gzip 发送
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct WebAsset {
+    const char *path;
+    const char *content_type;
+    const char *cache_control;
+    const char *etag;           // 含引号
+    const uint8_t *data;        // gzip 数据 (flash)
+    size_t len;
+};
+
+// 按请求路径查找 ("/" 对应 index.html)，不存在时返回 NULL
+const WebAsset *webAssetFind(const char *path);
+
+// 遍历全部资源 (注册路由用)
+size_t webAssetCount();
+const WebAsset *webAssetAt(size_t index);
+
+#endif // WEB_ASSETS_H
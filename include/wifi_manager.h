@@ -0,0 +1,63 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+/**
+ * WiFi 连接管理 (快速连接 + 断线重连)
+ *
+ * - 每次连接成功后把 BSSID、信道和 DHCP 租约保存到 NVS (内容不变时不写 flash)
+ * - 下次连接先走快速路径：指定 BSSID / 信道跳过扫描，直接使用缓存的 IP 跳过 DHCP；
+ *   快速路径失败则清除缓存，回退到完整的扫描 + DHCP
+ * - 断线由事件驱动的状态机处理：立即重连一次，之后按指数退避重试
+ * - 开机连接耗时、断线到恢复的耗时都输出到 /metrics
+ *
+ * 只在 ESP32 上编译。
+ */
+
+#include <stdint.h>
+
+#ifndef WIFI_CONNECT_TIMEOUT_MS
+#define WIFI_CONNECT_TIMEOUT_MS       15000   // 完整扫描 + DHCP 的单次超时
+#endif
+#ifndef WIFI_FAST_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_CONNECT_TIMEOUT_MS  3000    // 快速路径的单次超时
+#endif
+#ifndef WIFI_BACKOFF_MIN_MS
+#define WIFI_BACKOFF_MIN_MS           500
+#endif
+#ifndef WIFI_BACKOFF_MAX_MS
+#define WIFI_BACKOFF_MAX_MS           30000
+#endif
+
+// 快速路径是否复用上次的 DHCP 租约 (跳过 DHCP 约 0.5~2 s)。
+// 路由器按 MAC 固定分配地址时可放心使用；否则租约过期后可能与其他设备冲突，可设为 0。
+#ifndef WIFI_CACHE_DHCP_LEASE
+#define WIFI_CACHE_DHCP_LEASE         1
+#endif
+
+// 静态 IP (可选)：在 build_flags 中定义后，两条路径都使用静态地址，例如
+//   -DWIFI_STATIC_IP=\"192.168.1.11\" -DWIFI_STATIC_GATEWAY=\"192.168.1.1\"
+//   -DWIFI_STATIC_SUBNET=\"255.255.255.0\" -DWIFI_STATIC_DNS=\"192.168.1.1\"
+
+enum WifiState {
+    WIFI_STATE_IDLE,
+    WIFI_STATE_CONNECTING,
+    WIFI_STATE_CONNECTED,
+    WIFI_STATE_BACKOFF
+};
+
+// 启动连接管理任务，立即返回
+void wifiManagerBegin(const char *ssid, const char *password);
+
+// 等待连接成功 (获得 IP)，超时返回 false
+bool wifiManagerWaitConnected(uint32_t timeout_ms);
+
+WifiState wifiManagerState();
+
+// 关联请求中携带的 listen interval (信标间隔数，0 为驱动默认 3)，
+// MAX_MODEM 省电模式下按此间隔醒来接收缓存的数据；下次关联时生效
+void wifiManagerSetListenInterval(uint8_t interval);
+
+// 清除 NVS 中的连接缓存 (更换路由器后使用)
+void wifiManagerForgetCache();
+
+#endif // WIFI_MANAGER_H
@@ -0,0 +1,72 @@
+#ifndef WIRE_WRITER_H
+#define WIRE_WRITER_H
+
+/**
+ * 无堆分配的扁平对象编码器 (JSON / CBOR / MessagePack)
+ *
+ * 调用者提供一块固定缓冲区 (通常在栈上)，按字段顺序直接编码，不建中间文档、
+ * 不产生 String。三种格式共用同一组调用，由请求的 Accept 头选择：
+ *
+ *   WireWriter w(buf, sizeof(buf), wireFormatFromAccept(req.header("Accept")));
+ *   w.beginObject(2);
+ *   w.fieldStr("device", "XIAO-ESP32S3-Sense");
+ *   w.fieldUint("frame_count", frame_count);
+ *   w.endObject();
+ *   if (w.ok()) req.send(200, wireContentType(w.format()), buf, w.length());
+ *
+ * 只支持一层对象 (值为字符串 / 布尔 / 整数)。CBOR 和 MessagePack 的 map 需要预先
+ * 给出字段数，beginObject() 的 fields 必须与实际写入的字段数一致，否则 ok() 为 false。
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum WireFormat {
+    WIRE_JSON,
+    WIRE_CBOR,          // RFC 8949, application/cbor
+    WIRE_MSGPACK,       // application/msgpack
+};
+
+// 按 Accept 头选择格式 (NULL 或未识别时为 JSON)
+WireFormat wireFormatFromAccept(const char *accept);
+
+// 按名称选择格式 ("json" / "cbor" / "msgpack")，未识别时返回 fallback
+WireFormat wireFormatByName(const char *name, WireFormat fallback);
+
+const char *wireContentType(WireFormat format);
+
+class WireWriter {
+public:
+    WireWriter(uint8_t *buf, size_t cap, WireFormat format)
+        : buf_(buf), cap_(cap), len_(0), format_(format), declared_(0), written_(0), ok_(true) {}
+
+    void beginObject(uint8_t fields);
+    void endObject();
+
+    void fieldStr(const char *key, const char *value);
+    void fieldBool(const char *key, bool value);
+    void fieldInt(const char *key, int64_t value);
+    void fieldUint(const char *key, uint64_t value);
+
+    bool ok() const { return ok_; }             // 缓冲区未溢出且字段数与声明一致
+    size_t length() const { return len_; }
+    WireFormat format() const { return format_; }
+
+private:
+    void put(uint8_t byte);
+    void putBytes(const void *data, size_t len);
+    void putBigEndian(uint64_t value, int bytes);
+    void cborHead(uint8_t major, uint64_t value);
+    void string(const char *s);
+    void key(const char *name);
+
+    uint8_t *buf_;
+    size_t cap_;
+    size_t len_;
+    WireFormat format_;
+    uint8_t declared_;
+    uint8_t written_;
+    bool ok_;
+};
+
+#endif // WIRE_WRITER_H
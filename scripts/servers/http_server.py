@@ -107,6 +107,81 @@ class ESPDevice:
         return None
 
 
+class IngestDevice:
+    """
+    通过采集服务 (tools/autodiary_ingest.cpp) 的输出目录读取设备数据
+
+    设备多时由采集服务统一连接设备，本类只读它写下的文件，接口与 ESPDevice 相同。
+    配置: "ingest": {"dir": "data/ingest", "device": "cam1"}
+    """
+
+    def __init__(self, ingest_dir: str, name: str, stale_seconds: float = 15):
+        """
+        Args:
+            ingest_dir: 采集服务的 --out 目录
+            name: 设备名（设备列表中的名称）
+            stale_seconds: 文件超过该时长未更新视为设备离线
+        """
+        self.ip = name
+        self.dir = Path(ingest_dir) / name
+        self.stale_seconds = stale_seconds
+        self.last_seen = 0.0
+        self.device_info = {}
+
+    def is_alive(self, timeout: int = 60) -> bool:
+        """检查设备是否在线"""
+        return time.time() - self.last_seen < timeout
+
+    def _fresh(self, path: Path) -> bool:
+        try:
+            mtime = path.stat().st_mtime
+        except OSError:
+            return False
+        if time.time() - mtime > self.stale_seconds:
+            return False
+        self.last_seen = max(self.last_seen, mtime)
+        return True
+
+    def ping(self) -> bool:
+        """采集服务最近写过 status.json 即视为在线"""
+        status = self.get_status()
+        if status is not None and self._fresh(self.dir / "status.json"):
+            self.device_info = status
+            return True
+        logger.warning(f"❌ 设备离线: {self.ip} (采集目录 {self.dir} 无更新)")
+        return False
+
+    def get_video_frame(self) -> Optional[bytes]:
+        """读取最新一帧：最新索引文件的最后一行给出帧在 .mjpeg 中的位置"""
+        try:
+            indexes = sorted(self.dir.glob("video-*.idx"))
+            if not indexes or not self._fresh(indexes[-1]):
+                return None
+            with open(indexes[-1], 'rb') as f:
+                f.seek(0, 2)
+                f.seek(max(0, f.tell() - 256))
+                lines = f.read().splitlines()
+            if not lines:
+                return None
+            _, _, _, offset, length = lines[-1].split()
+            with open(indexes[-1].with_suffix(".mjpeg"), 'rb') as f:
+                f.seek(int(offset))
+                frame = f.read(int(length))
+            return frame if len(frame) == int(length) else None
+        except Exception as e:
+            logger.warning(f"获取视频帧失败: {e}")
+        return None
+
+    def get_status(self) -> Optional[Dict]:
+        """获取设备状态（采集服务最近一次取到的 /status）"""
+        try:
+            with open(self.dir / "status.json", 'r', encoding='utf-8') as f:
+                return json.load(f)
+        except Exception as e:
+            logger.warning(f"获取状态失败: {e}")
+        return None
+
+
 class AutoDiaryHTTPServer:
     """AutoDiary HTTP 服务器"""
     
@@ -121,8 +196,12 @@ class AutoDiaryHTTPServer:
         self.config = self._load_config(config_file)
         self.esp32_ip = esp32_ip or self.config.get("esp32_ip", "192.168.1.11")
         
-        # 初始化 ESP32 设备
-        self.device = ESPDevice(self.esp32_ip)
+        # 初始化 ESP32 设备（配置了采集服务时从其输出目录读取）
+        ingest = self.config.get("ingest", {})
+        if ingest.get("dir") and ingest.get("device"):
+            self.device = IngestDevice(ingest["dir"], ingest["device"])
+        else:
+            self.device = ESPDevice(self.esp32_ip)
         
         # 服务器组件
         self.funasr_client: Optional[FunASRClient] = None
@@ -0,0 +1,566 @@
+/**
+ * AutoDiary 多设备采集服务 (tools/autodiary_ingest.cpp) 负载测试
+ *
+ * 在回环地址上模拟任意数量的设备 (每台一个端口)，协议与固件相同：
+ *
+ *   /video.jpg     Content-Length + X-Frame-Seq / X-Capture-Us / X-Clock-Offset-Us，
+ *                  帧序号按 --camera-fps 增长，发完即关闭连接 (与固件一样总是 Connection: close)
+ *   /audio/stream  chunked，每 ?latency_ms 发一块 16 kHz 16-bit 样本，按实时节奏
+ *   /status        JSON
+ *
+ * 帧内容和音频样本都可由设备号 / 序号推算，测试结束后逐帧、逐样本核对采集服务写下的文件。
+ *
+ *     g++ -std=gnu++17 -O2 -pthread tools/autodiary_ingest.cpp -o /tmp/autodiary_ingest
+ *     g++ -std=gnu++17 -O2 -pthread scripts/test/ingest_bench.cpp -o /tmp/ingest_bench
+ *     /tmp/ingest_bench run --daemon /tmp/autodiary_ingest --devices 300 --duration 20 --mode both
+ *     /tmp/ingest_bench serve --devices 50 --port 20000 > devices.txt
+ *
+ * run    启动模拟设备和采集服务 (--mode splice / copy / both)，运行 --duration 秒后 SIGTERM，
+ *        核对输出并报告：采集服务的 CPU 时间 (wait4)、折算每核可承载的设备数、
+ *        帧 / 音频的提供量与落盘量、内容错误数
+ * serve  只运行模拟设备，把设备列表 (autodiary_ingest --devices 的格式) 打印到标准输出
+ *
+ * 选项: --devices N  --port BASE (20000)  --sim-threads N (2)  --threads N (采集服务线程, 1)
+ *       --fps F (采集服务轮询, 5)  --camera-fps F (10)  --frame-bytes N (20000)
+ *       --latency-ms N (100)  --duration S (20)  --out DIR (/tmp/ingest_bench)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+    const char *daemon = NULL;
+    const char *out = "/tmp/ingest_bench";
+    const char *mode = "splice";
+    int devices = 100;
+    int port = 20000;
+    int sim_threads = 2;
+    int threads = 1;
+    double fps = 5.0;
+    double camera_fps = 10.0;
+    int frame_bytes = 20000;
+    int latency_ms = 100;
+    int duration_s = 20;
+};
+
+static Options opt;
+static std::atomic<bool> sim_stopping{false};
+
+#define SAMPLE_RATE 16000
+
+static int64_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ==================== 可核对的内容 ====================
+
+// 帧：SOI + COM("dev=D seq=S") + 填充 (不含 0xFF) + EOI，总长 frame_bytes
+static void buildFrame(std::string &out, int dev, uint32_t seq, int frame_bytes) {
+    char com[48];
+    int com_len = snprintf(com, sizeof(com), "dev=%d seq=%u", dev, (unsigned)seq);
+    size_t start = out.size();
+    out.append("\xFF\xD8\xFF\xFE", 4);
+    out.push_back((char)((com_len + 2) >> 8));
+    out.push_back((char)((com_len + 2) & 0xFF));
+    out.append(com, com_len);
+    int fill = frame_bytes - (int)(out.size() - start) - 2;
+    for (int i = 0; i < fill; i++) out.push_back((char)((seq + i) % 251));
+    out.append("\xFF\xD9", 2);
+}
+
+static int16_t sampleValue(int dev, uint64_t index) {
+    return (int16_t)(index * 7 + dev * 1000);
+}
+
+// ==================== 模拟设备 ====================
+
+struct SimDevice {
+    int index;
+    int listen_fd;
+    int64_t start_ms;
+    uint32_t last_served_seq = 0;
+    uint64_t frames_served = 0;         // 完整发出的不同帧
+    uint64_t audio_bytes_served = 0;
+};
+
+enum SimState { SIM_REQUEST, SIM_RESPONSE, SIM_AUDIO };
+
+struct SimConn {
+    SimDevice *dev;
+    int fd;
+    SimState state = SIM_REQUEST;
+    std::string in;
+    std::string out;
+    size_t out_off = 0;
+    uint32_t seq = 0;                   // 正在发送的帧
+    uint64_t next_sample = 0;
+    int64_t next_chunk_ms = 0;
+    int chunk_ms = 100;
+};
+
+struct SimWorker {
+    int ep;
+    std::vector<SimDevice *> devices;
+    std::vector<SimConn *> audio;
+};
+
+static void simClose(SimWorker &w, SimConn *c) {
+    epoll_ctl(w.ep, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    if (c->state == SIM_AUDIO) {
+        for (size_t i = 0; i < w.audio.size(); i++) {
+            if (w.audio[i] == c) {
+                w.audio[i] = w.audio.back();
+                w.audio.pop_back();
+                break;
+            }
+        }
+    }
+    delete c;
+}
+
+// 发送缓冲区中剩余的数据：返回 false 表示连接已关闭
+static bool simFlush(SimWorker &w, SimConn *c) {
+    while (c->out_off < c->out.size()) {
+        ssize_t n = send(c->fd, c->out.data() + c->out_off, c->out.size() - c->out_off, MSG_NOSIGNAL);
+        if (n < 0 && errno == EAGAIN) {
+            struct epoll_event ev;
+            ev.events = EPOLLOUT;
+            ev.data.ptr = c;
+            epoll_ctl(w.ep, EPOLL_CTL_MOD, c->fd, &ev);
+            return true;
+        }
+        if (n <= 0) {
+            simClose(w, c);
+            return false;
+        }
+        c->out_off += n;
+    }
+    c->out.clear();
+    c->out_off = 0;
+    if (c->state == SIM_RESPONSE) {
+        SimDevice *dev = c->dev;
+        if (c->seq != 0 && c->seq != dev->last_served_seq) {
+            dev->last_served_seq = c->seq;
+            dev->frames_served++;
+        }
+        simClose(w, c);
+        return false;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    epoll_ctl(w.ep, EPOLL_CTL_MOD, c->fd, &ev);
+    return true;
+}
+
+static void simRespond(SimWorker &w, SimConn *c) {
+    SimDevice *dev = c->dev;
+    int64_t now = nowMs();
+    int64_t uptime_us = (now - dev->start_ms) * 1000;
+    char head[512];
+    int len;
+    if (c->in.compare(0, 15, "GET /video.jpg ") == 0) {
+        c->seq = 1 + (uint32_t)((now - dev->start_ms) * opt.camera_fps / 1000);
+        len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nContent-Length: %d\r\n"
+                       "X-Frame-Seq: %u\r\nX-Frame-Age-Ms: 3\r\nX-Camera-State: ok\r\n"
+                       "X-Capture-Us: %lld\r\nX-Clock-Source: ntp\r\nX-Clock-Offset-Us: 1700000000000000\r\n"
+                       "Cache-Control: no-store\r\nConnection: close\r\n\r\n",
+                       opt.frame_bytes, (unsigned)c->seq, (long long)uptime_us);
+        c->out.assign(head, len);
+        buildFrame(c->out, dev->index, c->seq, opt.frame_bytes);
+        c->state = SIM_RESPONSE;
+    } else if (c->in.compare(0, 17, "GET /audio/stream") == 0) {
+        const char *q = strstr(c->in.c_str(), "latency_ms=");
+        c->chunk_ms = q ? atoi(q + 11) : 100;
+        if (c->chunk_ms < 10) c->chunk_ms = 10;
+        c->next_sample = (uint64_t)(now - dev->start_ms) * SAMPLE_RATE / 1000;
+        c->next_chunk_ms = now + c->chunk_ms;
+        len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 200 OK\r\nContent-Type: audio/raw\r\nTransfer-Encoding: chunked\r\n"
+                       "X-Audio-Format: pcm-16bit-16khz-mono\r\nX-Sample-Index: %llu\r\nX-Sample-Rate: %d\r\n"
+                       "X-Capture-Us: %lld\r\nX-Clock-Offset-Us: 1700000000000000\r\nConnection: close\r\n\r\n",
+                       (unsigned long long)c->next_sample, SAMPLE_RATE, (long long)uptime_us);
+        c->out.assign(head, len);
+        c->state = SIM_AUDIO;
+        w.audio.push_back(c);
+    } else if (c->in.compare(0, 12, "GET /status ") == 0) {
+        char body[256];
+        int body_len = snprintf(body, sizeof(body),
+                                "{\"device\":\"sim-%d\",\"uptime_ms\":%lld,\"camera\":{\"state\":\"ok\",\"frame_seq\":%u}}",
+                                dev->index, (long long)(now - dev->start_ms), (unsigned)dev->last_served_seq);
+        len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %d\r\n"
+                       "Connection: close\r\n\r\n%s", body_len, body);
+        c->out.assign(head, len);
+        c->state = SIM_RESPONSE;
+    } else {
+        c->out = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        c->state = SIM_RESPONSE;
+    }
+    simFlush(w, c);
+}
+
+static void simAudioTick(SimWorker &w, int64_t now) {
+    for (size_t i = 0; i < w.audio.size(); ) {
+        SimConn *c = w.audio[i];
+        // 上一块还没发完 (采集端跟不上) 时不追加，与固件的环形缓冲区一样丢弃最旧的数据
+        if (now < c->next_chunk_ms || !c->out.empty()) {
+            i++;
+            continue;
+        }
+        int samples = SAMPLE_RATE * c->chunk_ms / 1000;
+        char head[16];
+        int len = snprintf(head, sizeof(head), "%04X\r\n", samples * 2);
+        c->out.assign(head, len);
+        for (int k = 0; k < samples; k++) {
+            int16_t v = sampleValue(c->dev->index, c->next_sample + k);
+            c->out.append((const char *)&v, 2);
+        }
+        c->out.append("\r\n", 2);
+        c->next_sample += samples;
+        c->next_chunk_ms += c->chunk_ms;
+        c->dev->audio_bytes_served += samples * 2;
+        size_t before = w.audio.size();
+        simFlush(w, c);
+        if (w.audio.size() == before) i++;
+    }
+}
+
+static void simRun(SimWorker *w) {
+    struct epoll_event events[256];
+    while (!sim_stopping.load()) {
+        int n = epoll_wait(w->ep, events, 256, 5);
+        for (int i = 0; i < n; i++) {
+            void *ptr = events[i].data.ptr;
+            if ((uintptr_t)ptr < (uintptr_t)opt.devices + 1) {
+                // 监听 socket：data.ptr 存设备序号 + 1
+                SimDevice *dev = w->devices[(uintptr_t)ptr - 1];
+                int fd;
+                while ((fd = accept4(dev->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    SimConn *c = new SimConn();
+                    c->dev = dev;
+                    c->fd = fd;
+                    struct epoll_event ev;
+                    ev.events = EPOLLIN;
+                    ev.data.ptr = c;
+                    epoll_ctl(w->ep, EPOLL_CTL_ADD, fd, &ev);
+                }
+                continue;
+            }
+            SimConn *c = (SimConn *)ptr;
+            if (c->state != SIM_REQUEST) {
+                // 响应中途可读：对端关闭或发来多余数据
+                if (events[i].events & EPOLLOUT) {
+                    simFlush(*w, c);
+                    continue;
+                }
+                char buf[512];
+                ssize_t r = recv(c->fd, buf, sizeof(buf), 0);
+                if (r == 0 || (r < 0 && errno != EAGAIN)) simClose(*w, c);
+                continue;
+            }
+            char buf[1024];
+            ssize_t r = recv(c->fd, buf, sizeof(buf), 0);
+            if (r <= 0) {
+                if (r == 0 || errno != EAGAIN) simClose(*w, c);
+                continue;
+            }
+            c->in.append(buf, r);
+            if (c->in.find("\r\n\r\n") != std::string::npos) simRespond(*w, c);
+            else if (c->in.size() > 4096) simClose(*w, c);
+        }
+        simAudioTick(*w, nowMs());
+    }
+}
+
+static std::vector<SimDevice *> sim_devices;
+static std::vector<SimWorker *> sim_workers;
+static std::vector<std::thread> sim_threads;
+
+static bool simStart() {
+    int threads = opt.sim_threads < 1 ? 1 : opt.sim_threads;
+    for (int t = 0; t < threads; t++) {
+        SimWorker *w = new SimWorker();
+        w->ep = epoll_create1(EPOLL_CLOEXEC);
+        sim_workers.push_back(w);
+    }
+    int64_t now = nowMs();
+    for (int i = 0; i < opt.devices; i++) {
+        SimDevice *dev = new SimDevice();
+        dev->index = i;
+        dev->start_ms = now;
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons((uint16_t)(opt.port + i));
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+            fprintf(stderr, "无法监听端口 %d: %s\n", opt.port + i, strerror(errno));
+            return false;
+        }
+        dev->listen_fd = fd;
+        sim_devices.push_back(dev);
+        SimWorker *w = sim_workers[i % threads];
+        w->devices.push_back(dev);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = (void *)(uintptr_t)w->devices.size();
+        epoll_ctl(w->ep, EPOLL_CTL_ADD, fd, &ev);
+    }
+    for (SimWorker *w : sim_workers) sim_threads.emplace_back(simRun, w);
+    return true;
+}
+
+static void simStop() {
+    sim_stopping.store(true);
+    for (std::thread &t : sim_threads) t.join();
+}
+
+// ==================== 核对输出 ====================
+
+struct Check {
+    uint64_t frames = 0;
+    uint64_t frame_bytes = 0;
+    uint64_t bad_frames = 0;
+    uint64_t audio_bytes = 0;
+    uint64_t bad_samples = 0;
+    uint64_t audio_segments = 0;
+    int status_files = 0;
+};
+
+static std::vector<std::string> listFiles(const std::string &dir, const char *prefix, const char *ext) {
+    std::vector<std::string> files;
+    DIR *d = opendir(dir.c_str());
+    if (!d) return files;
+    while (struct dirent *e = readdir(d)) {
+        std::string name = e->d_name;
+        if (name.compare(0, strlen(prefix), prefix) == 0 && name.size() > strlen(ext) &&
+            name.compare(name.size() - strlen(ext), strlen(ext), ext) == 0) {
+            files.push_back(dir + "/" + name);
+        }
+    }
+    closedir(d);
+    return files;
+}
+
+static std::string readFile(const std::string &path) {
+    std::string data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+    fclose(f);
+    return data;
+}
+
+static void checkDevice(int index, const std::string &dir, Check &check) {
+    for (const std::string &idx : listFiles(dir, "video-", ".idx")) {
+        std::string data = readFile(idx.substr(0, idx.size() - 4) + ".mjpeg");
+        FILE *f = fopen(idx.c_str(), "r");
+        unsigned seq;
+        long long capture_us, offset_us, off, len;
+        while (f && fscanf(f, "%u %lld %lld %lld %lld", &seq, &capture_us, &offset_us, &off, &len) == 5) {
+            check.frames++;
+            check.frame_bytes += len;
+            std::string expect;
+            buildFrame(expect, index, seq, opt.frame_bytes);
+            if (off < 0 || off + len > (long long)data.size() || data.compare(off, len, expect) != 0) {
+                check.bad_frames++;
+            }
+        }
+        if (f) fclose(f);
+    }
+
+    for (const std::string &idx : listFiles(dir, "audio-", ".idx")) {
+        std::string data = readFile(idx.substr(0, idx.size() - 4) + ".pcm");
+        check.audio_bytes += data.size();
+        std::vector<std::pair<uint64_t, long long>> segments;
+        FILE *f = fopen(idx.c_str(), "r");
+        unsigned long long sample;
+        long long capture_us, offset_us, off;
+        unsigned rate;
+        while (f && fscanf(f, "%llu %lld %lld %lld %u", &sample, &capture_us, &offset_us, &off, &rate) == 5) {
+            segments.push_back({ sample, off });
+        }
+        if (f) fclose(f);
+        check.audio_segments += segments.size();
+        for (size_t s = 0; s < segments.size(); s++) {
+            long long end = s + 1 < segments.size() ? segments[s + 1].second : (long long)data.size();
+            for (long long b = segments[s].second; b + 1 < end; b += 2) {
+                int16_t v;
+                memcpy(&v, data.data() + b, 2);
+                if (v != sampleValue(index, segments[s].first + (b - segments[s].second) / 2)) check.bad_samples++;
+            }
+        }
+    }
+
+    struct stat st;
+    if (stat((dir + "/status.json").c_str(), &st) == 0 && st.st_size > 0) check.status_files++;
+}
+
+// ==================== 运行 ====================
+
+static int runOnce(bool copy) {
+    std::string out = std::string(opt.out) + (copy ? "/copy" : "/splice");
+    std::string cmd = "rm -rf '" + out + "' && mkdir -p '" + out + "'";
+    if (system(cmd.c_str()) != 0) return 1;
+    std::string list = out + "/devices.txt";
+    FILE *f = fopen(list.c_str(), "w");
+    for (int i = 0; i < opt.devices; i++) fprintf(f, "sim%03d 127.0.0.1:%d\n", i, opt.port + i);
+    fclose(f);
+
+    for (SimDevice *dev : sim_devices) {
+        dev->frames_served = 0;
+        dev->audio_bytes_served = 0;
+    }
+
+    char threads[16], fps[16];
+    snprintf(threads, sizeof(threads), "%d", opt.threads);
+    snprintf(fps, sizeof(fps), "%g", opt.fps);
+    std::string data_dir = out + "/data";
+    std::vector<const char *> args = { opt.daemon, "--out", data_dir.c_str(), "--devices", list.c_str(),
+                                       "--threads", threads, "--fps", fps, "--stats-interval", "5" };
+    if (copy) args.push_back("--copy");
+    args.push_back(NULL);
+
+    int64_t start = nowMs();
+    pid_t pid = fork();
+    if (pid == 0) {
+        execv(opt.daemon, (char *const *)args.data());
+        _exit(127);
+    }
+    sleep(opt.duration_s);
+    kill(pid, SIGTERM);
+    int status;
+    struct rusage ru;
+    wait4(pid, &status, 0, &ru);
+    double wall = (nowMs() - start) / 1000.0;
+
+    uint64_t served_frames = 0, served_audio = 0;
+    for (SimDevice *dev : sim_devices) {
+        served_frames += dev->frames_served;
+        served_audio += dev->audio_bytes_served;
+    }
+
+    Check check;
+    for (int i = 0; i < opt.devices; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "/sim%03d", i);
+        checkDevice(i, data_dir + name, check);
+    }
+
+    double cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    double cores = cpu / wall;
+    printf("\n== %s (%d 台设备, %d 线程, 视频 %.1f fps, 帧 %d 字节, %.1f s) ==\n", copy ? "recv + pwrite" : "splice",
+           opt.devices, opt.threads, opt.fps, opt.frame_bytes, wall);
+    printf("采集服务 CPU    %.2f s (用户 %.2f / 内核 %.2f), 平均 %.1f%% 核, 退出码 %d\n", cpu,
+           ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6, ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6,
+           cores * 100, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+    printf("每核设备数      %.0f\n", cores > 0 ? opt.devices / cores : 0.0);
+    printf("帧              提供 %llu, 落盘 %llu (%.1f/s, %.2f MB/s), 内容错误 %llu\n",
+           (unsigned long long)served_frames, (unsigned long long)check.frames, check.frames / wall,
+           check.frame_bytes / wall / 1e6, (unsigned long long)check.bad_frames);
+    printf("音频            提供 %.1f MB, 落盘 %.1f MB (%llu 段), 样本错误 %llu\n", served_audio / 1e6,
+           check.audio_bytes / 1e6, (unsigned long long)check.audio_segments, (unsigned long long)check.bad_samples);
+    printf("status.json     %d/%d\n", check.status_files, opt.devices);
+    fflush(stdout);
+    bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && check.bad_frames == 0 && check.bad_samples == 0;
+    return ok ? 0 : 1;
+}
+
+static void onSignal(int) {
+    sim_stopping.store(true);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "用法: %s run --daemon PATH [选项] | serve [选项]\n", argv[0]);
+        return 2;
+    }
+    const char *cmd = argv[1];
+    for (int i = 2; i < argc; i++) {
+        const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!next) {
+            fprintf(stderr, "缺少参数值: %s\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--daemon") == 0) opt.daemon = next;
+        else if (strcmp(argv[i], "--out") == 0) opt.out = next;
+        else if (strcmp(argv[i], "--mode") == 0) opt.mode = next;
+        else if (strcmp(argv[i], "--devices") == 0) opt.devices = atoi(next);
+        else if (strcmp(argv[i], "--port") == 0) opt.port = atoi(next);
+        else if (strcmp(argv[i], "--sim-threads") == 0) opt.sim_threads = atoi(next);
+        else if (strcmp(argv[i], "--threads") == 0) opt.threads = atoi(next);
+        else if (strcmp(argv[i], "--fps") == 0) opt.fps = atof(next);
+        else if (strcmp(argv[i], "--camera-fps") == 0) opt.camera_fps = atof(next);
+        else if (strcmp(argv[i], "--frame-bytes") == 0) opt.frame_bytes = atoi(next);
+        else if (strcmp(argv[i], "--latency-ms") == 0) opt.latency_ms = atoi(next);
+        else if (strcmp(argv[i], "--duration") == 0) opt.duration_s = atoi(next);
+        else {
+            fprintf(stderr, "未知选项: %s\n", argv[i]);
+            return 2;
+        }
+        i++;
+    }
+    if (opt.frame_bytes < 64) opt.frame_bytes = 64;
+    signal(SIGPIPE, SIG_IGN);
+
+    // 每台设备最多 3 个并发连接，外加采集服务自身的文件
+    struct rlimit rl;
+    getrlimit(RLIMIT_NOFILE, &rl);
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+
+    if (strcmp(cmd, "serve") == 0) {
+        if (!simStart()) return 1;
+        for (int i = 0; i < opt.devices; i++) printf("sim%03d 127.0.0.1:%d\n", i, opt.port + i);
+        fflush(stdout);
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        while (!sim_stopping.load()) usleep(100 * 1000);
+        simStop();
+        return 0;
+    }
+    if (strcmp(cmd, "run") != 0 || !opt.daemon) {
+        fprintf(stderr, "run 需要 --daemon PATH\n");
+        return 2;
+    }
+    if (!simStart()) return 1;
+
+    int rc = 0;
+    if (strcmp(opt.mode, "copy") != 0) rc |= runOnce(false);
+    if (strcmp(opt.mode, "splice") != 0) rc |= runOnce(true);
+
+    struct rusage self;
+    getrusage(RUSAGE_SELF, &self);
+    simStop();
+    printf("\n模拟设备 CPU    %.2f s\n", self.ru_utime.tv_sec + self.ru_utime.tv_usec / 1e6 +
+                                           self.ru_stime.tv_sec + self.ru_stime.tv_usec / 1e6);
+    return rc;
+}
@@ -0,0 +1,411 @@
+/**
+ * AutoDiary 隐私遮挡 (src/jpeg_mask.cpp) 基准测试与正确性检查
+ *
+ * 只依赖 jpeg_mask.cpp 和 jpeg_entropy.cpp，直接用主机编译器构建：
+ *
+ *     g++ -std=gnu++17 -O2 -Iinclude scripts/test/jpeg_mask_bench.cpp \
+ *         src/jpeg_mask.cpp src/jpeg_entropy.cpp -o /tmp/jpeg_mask_bench
+ *     /tmp/jpeg_mask_bench bench frames/a.jpg frames/b.jpg
+ *     /tmp/jpeg_mask_bench check 2000 frames/a.jpg
+ *
+ * 不给文件时使用内置的合成 VGA 帧 (4:2:2、Annex K 表，与 OV2640 的输出结构相同)。
+ * 文件须为基线 JPEG (设备 /video.jpg 取下的帧即可)。
+ *
+ * bench [JPEG...]          每帧分别测量：整帧 memcpy (不遮挡时发布的开销)、矩形都在帧外 (原样复制)、
+ *                          1 个 / 4 个小矩形、遮挡半帧，输出每帧耗时和输出字节数
+ * check [次数] [JPEG...]   随机矩形遮挡后逐块解码比较：遮挡的 MCU 只剩黑色 DC、没有 AC 系数，
+ *                          其余块的系数与原帧完全相同 (建议带 -fsanitize=address,undefined 构建)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "jpeg_mask.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+struct Frame {
+    std::string name;
+    Bytes data;
+};
+
+static int failures = 0;
+
+#define EXPECT(cond, ...) do { \
+    if (!(cond)) { \
+        if (failures++ < 20) { fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+                               fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } \
+    } \
+} while (0)
+
+// ==================== 合成帧 ====================
+
+// ITU-T T.81 Annex K 的标准表
+static const uint8_t STD_Q_LUMA[64] = {
+    16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+    14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+    18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99,
+};
+static const uint8_t STD_Q_CHROMA[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+};
+static const uint8_t DC_LUMA_BITS[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t DC_CHROMA_BITS[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+static const uint8_t DC_VALS[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+static const uint8_t AC_LUMA_BITS[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+static const uint8_t AC_LUMA_VALS[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+static const uint8_t AC_CHROMA_BITS[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+static const uint8_t AC_CHROMA_VALS[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+static void putDht(JpegBitWriter &bw, uint8_t cls_id, const uint8_t *bits, const uint8_t *vals) {
+    int n = 0;
+    for (int i = 0; i < 16; i++) n += bits[i];
+    jpegPutMarker(bw, 0xC4, (uint16_t)(3 + 16 + n));
+    jpegPutByte(bw, cls_id);
+    jpegPutBytes(bw, bits, 16);
+    jpegPutBytes(bw, vals, n);
+}
+
+static void putCoef(JpegBitWriter &bw, const JpegHuffEncoder &enc, int run, int v) {
+    int cat = jpegCategory(v);
+    int rs = (run << 4) | cat;
+    jpegPutBits(bw, enc.code[rs], enc.size[rs]);
+    if (cat) jpegPutBits(bw, v < 0 ? v - 1 : v, cat);
+}
+
+// 640x480 4:2:2 (Y 为 2x1)：DC 缓慢变化，AC 按频率递减随机出现，
+// 量化表为 Annex K x 1/2 (约 OV2640 质量 10 时的帧大小)
+static Frame syntheticVga(std::mt19937 &rng) {
+    const int width = 640, height = 480;
+    Frame frame;
+    frame.name = "synthetic-vga-422";
+    frame.data.resize(256 * 1024);
+    JpegBitWriter bw;
+    jpegBitWriterBegin(bw, frame.data.data(), frame.data.size());
+
+    jpegPutByte(bw, 0xFF);
+    jpegPutByte(bw, 0xD8);
+    for (int t = 0; t < 2; t++) {
+        jpegPutMarker(bw, 0xDB, 67);
+        jpegPutByte(bw, (uint8_t)t);
+        for (int i = 0; i < 64; i++) {
+            int q = ((t ? STD_Q_CHROMA : STD_Q_LUMA)[i] + 1) / 2;
+            jpegPutByte(bw, (uint8_t)(q < 1 ? 1 : q));
+        }
+    }
+    jpegPutMarker(bw, 0xC0, 17);
+    const uint8_t sof[15] = { 8, height >> 8, height & 0xFF, width >> 8, width & 0xFF, 3,
+                              1, 0x21, 0, 2, 0x11, 1, 3, 0x11, 1 };
+    jpegPutBytes(bw, sof, sizeof(sof));
+    putDht(bw, 0x00, DC_LUMA_BITS, DC_VALS);
+    putDht(bw, 0x10, AC_LUMA_BITS, AC_LUMA_VALS);
+    putDht(bw, 0x01, DC_CHROMA_BITS, DC_VALS);
+    putDht(bw, 0x11, AC_CHROMA_BITS, AC_CHROMA_VALS);
+    jpegPutMarker(bw, 0xDA, 12);
+    const uint8_t sos[10] = { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 };
+    jpegPutBytes(bw, sos, sizeof(sos));
+
+    JpegHuffEncoder dc[2], ac[2];
+    jpegBuildEncoder(dc[0], DC_LUMA_BITS, DC_VALS);
+    jpegBuildEncoder(dc[1], DC_CHROMA_BITS, DC_VALS);
+    jpegBuildEncoder(ac[0], AC_LUMA_BITS, AC_LUMA_VALS);
+    jpegBuildEncoder(ac[1], AC_CHROMA_BITS, AC_CHROMA_VALS);
+
+    int level[3] = { 0, 0, 0 };
+    int pred[3] = { 0, 0, 0 };
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int m = 0; m < (width / 16) * (height / 8); m++) {
+        for (int ci = 0; ci < 3; ci++) {
+            int table = ci ? 1 : 0;
+            for (int b = 0; b < (ci ? 1 : 2); b++) {
+                level[ci] += (int)(rng() % 7) - 3;
+                if (level[ci] > 60) level[ci] = 60;
+                if (level[ci] < -60) level[ci] = -60;
+                putCoef(bw, dc[table], 0, level[ci] - pred[ci]);
+                pred[ci] = level[ci];
+
+                int run = 0;
+                for (int k = 1; k < 64; k++) {
+                    if (unit(rng) > (ci ? 0.6 : 1.2) / (k + 1)) {
+                        run++;
+                        continue;
+                    }
+                    while (run > 15) {
+                        jpegPutBits(bw, ac[table].code[0xF0], ac[table].size[0xF0]);
+                        run -= 16;
+                    }
+                    int v = 1 + (int)(rng() % (k < 6 ? 12 : 3));
+                    putCoef(bw, ac[table], run, rng() % 2 ? v : -v);
+                    run = 0;
+                }
+                if (run) jpegPutBits(bw, ac[table].code[0x00], ac[table].size[0x00]);
+            }
+        }
+    }
+    jpegFinishScan(bw);
+    frame.data.resize(bw.ok ? bw.len : 0);
+    return frame;
+}
+
+static bool fileFrame(const char *path, Frame *frame) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "无法读取 %s\n", path);
+        return false;
+    }
+    uint8_t block[65536];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), f)) > 0) frame->data.insert(frame->data.end(), block, block + n);
+    fclose(f);
+    frame->name = path;
+    return true;
+}
+
+// ==================== 逐块解码 ====================
+
+struct Block {
+    int dc;
+    int16_t ac[63];
+};
+
+// 按扫描顺序解码全部块 (DC 已累加)，mcu 为每个块所属的 MCU 序号
+static bool decodeBlocks(const Bytes &jpeg, JpegHeader *hdr, std::vector<Block> *blocks,
+                         std::vector<int> *mcu) {
+    if (!jpegParseHeader(jpeg.data(), jpeg.size(), hdr, true)) return false;
+    JpegBitReader br;
+    jpegBitReaderBegin(br, jpeg.data(), jpeg.size(), hdr->scan_start);
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };
+    int restart_left = hdr->restart_interval;
+    blocks->clear();
+    mcu->clear();
+    for (int m = 0; m < hdr->mcux * hdr->mcuy; m++) {
+        if (hdr->restart_interval) {
+            if (restart_left == 0) {
+                jpegBitReaderRestart(br);
+                for (int i = 0; i < hdr->ncomp; i++) pred[i] = 0;
+                restart_left = hdr->restart_interval;
+            }
+            restart_left--;
+        }
+        for (int ci = 0; ci < hdr->ncomp; ci++) {
+            const JpegComponent &c = hdr->comp[ci];
+            for (int b = 0; b < c.h * c.v; b++) {
+                Block blk;
+                memset(&blk, 0, sizeof(blk));
+                if (!jpegReadDc(br, hdr->dc[c.td], &pred[ci])) return false;
+                blk.dc = pred[ci];
+                for (int k = 1; k < 64;) {
+                    int rs = jpegDecodeSymbol(br, hdr->ac[c.ta]);
+                    if (rs < 0) return false;
+                    int r = rs >> 4, size = rs & 15;
+                    if (size == 0) {
+                        if (r != 15) break;
+                        k += 16;
+                        continue;
+                    }
+                    k += r;
+                    if (k > 63) return false;
+                    blk.ac[k - 1] = (int16_t)jpegExtend(jpegGetBits(br, size), size);
+                    k++;
+                }
+                blocks->push_back(blk);
+                mcu->push_back(m);
+            }
+        }
+    }
+    return true;
+}
+
+// ==================== 正确性检查 ====================
+
+static void checkMask(const Frame &frame, const std::vector<JpegRect> &rects, JpegRecodeWork *work,
+                      Bytes &out) {
+    size_t len = jpegMask(frame.data.data(), frame.data.size(), rects.data(), (int)rects.size(),
+                          work, out.data(), out.size());
+    EXPECT(len > 0, "%s: 遮挡失败", frame.name.c_str());
+    if (len == 0) return;
+
+    JpegHeader src_hdr, dst_hdr;
+    std::vector<Block> src, dst;
+    std::vector<int> src_mcu, dst_mcu;
+    Bytes masked(out.begin(), out.begin() + len);
+    if (!decodeBlocks(frame.data, &src_hdr, &src, &src_mcu) ||
+        !decodeBlocks(masked, &dst_hdr, &dst, &dst_mcu)) {
+        EXPECT(false, "%s: 解码失败", frame.name.c_str());
+        return;
+    }
+    EXPECT(src.size() == dst.size() && dst_hdr.width == src_hdr.width &&
+           dst_hdr.height == src_hdr.height, "%s: 块数或尺寸不同", frame.name.c_str());
+    if (src.size() != dst.size()) return;
+
+    int mcu_w = 8 * src_hdr.hmax, mcu_h = 8 * src_hdr.vmax;
+    size_t i = 0;
+    for (int m = 0; m < src_hdr.mcux * src_hdr.mcuy; m++) {
+        // MCU 与任一矩形的帧内部分有重叠即应被遮挡 (右 / 下边缘 MCU 的填充区不算)
+        int x0 = (m % src_hdr.mcux) * mcu_w, y0 = (m / src_hdr.mcux) * mcu_h;
+        bool masked_mcu = false;
+        for (const JpegRect &r : rects) {
+            if (r.x >= src_hdr.width || r.y >= src_hdr.height) continue;
+            masked_mcu = masked_mcu || (r.w && r.h && r.x < x0 + mcu_w && r.x + r.w > x0 &&
+                                        r.y < y0 + mcu_h && r.y + r.h > y0);
+        }
+        for (int ci = 0; ci < src_hdr.ncomp; ci++) {
+            const JpegComponent &c = src_hdr.comp[ci];
+            for (int b = 0; b < c.h * c.v; b++, i++) {
+                bool no_ac = true;
+                for (int k = 0; k < 63; k++) no_ac = no_ac && dst[i].ac[k] == 0;
+                if (masked_mcu) {
+                    int q = src_hdr.qdc[c.tq];
+                    int black = ci == 0 ? -((1024 + q / 2) / q) : 0;
+                    EXPECT(dst[i].dc == black && no_ac, "%s: MCU %d 分量 %d 未遮挡 (dc %d)",
+                           frame.name.c_str(), m, ci, dst[i].dc);
+                } else {
+                    EXPECT(dst[i].dc == src[i].dc && memcmp(dst[i].ac, src[i].ac, sizeof(src[i].ac)) == 0,
+                           "%s: MCU %d 分量 %d 被改动", frame.name.c_str(), m, ci);
+                }
+            }
+        }
+    }
+}
+
+static int runCheck(int iterations, const std::vector<Frame> &frames, JpegRecodeWork *work,
+                    std::mt19937 &rng) {
+    for (const Frame &frame : frames) {
+        JpegHeader hdr;
+        if (!jpegParseHeader(frame.data.data(), frame.data.size(), &hdr, false)) continue;
+        Bytes out(frame.data.size() * 2 + 4096);
+        for (int it = 0; it < iterations / (int)frames.size(); it++) {
+            std::vector<JpegRect> rects(1 + rng() % JPEG_MASK_MAX_RECTS);
+            for (JpegRect &r : rects) {
+                r.x = (uint16_t)(rng() % (hdr.width + 40));
+                r.y = (uint16_t)(rng() % (hdr.height + 40));
+                r.w = (uint16_t)(rng() % (hdr.width / 2 + 1));
+                r.h = (uint16_t)(rng() % (hdr.height / 2 + 1));
+            }
+            checkMask(frame, rects, work, out);
+        }
+        printf("%-32s %8zu 字节  完成\n", frame.name.c_str(), frame.data.size());
+    }
+    printf("\n%d 次遮挡，%d 处失败\n", iterations, failures);
+    return failures ? 1 : 0;
+}
+
+// ==================== 基准测试 ====================
+
+template <typename Fn>
+static double usPerCall(Fn fn, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+}
+
+static int runBench(const std::vector<Frame> &frames, JpegRecodeWork *work) {
+    printf("%-32s %-14s %10s %10s %10s\n", "帧", "遮挡", "us/帧", "输出字节", "遮挡 MCU%");
+    for (const Frame &frame : frames) {
+        JpegHeader hdr;
+        if (!jpegParseHeader(frame.data.data(), frame.data.size(), &hdr, false)) {
+            fprintf(stderr, "%s 不是基线 JPEG，跳过\n", frame.name.c_str());
+            continue;
+        }
+        uint16_t w = hdr.width, h = hdr.height;
+        struct Case {
+            const char *name;
+            std::vector<JpegRect> rects;
+        };
+        const Case cases[] = {
+            { "帧外", { { w, h, 16, 16 } } },
+            { "1x 160x120", { { (uint16_t)(w / 4), (uint16_t)(h / 4), 160, 120 } } },
+            { "4x 96x64", { { 0, 0, 96, 64 }, { (uint16_t)(w - 96), 0, 96, 64 },
+                            { 0, (uint16_t)(h - 64), 96, 64 }, { (uint16_t)(w - 96), (uint16_t)(h - 64), 96, 64 } } },
+            { "半帧", { { 0, 0, (uint16_t)(w / 2), h } } },
+        };
+
+        Bytes out(frame.data.size() * 2 + 4096);
+        int rounds = (int)(20000000 / (frame.data.size() + 1000)) + 20;
+        volatile size_t sink = 0;
+        double copy_us = usPerCall([&] {
+            memcpy(out.data(), frame.data.data(), frame.data.size());
+            sink = sink + out[frame.data.size() / 2];
+        }, rounds * 10);
+        printf("%-32s %-14s %10.1f %10zu %10s\n", frame.name.c_str(), "memcpy", copy_us,
+               frame.data.size(), "-");
+
+        int mcu_w = 8 * hdr.hmax, mcu_h = 8 * hdr.vmax;
+        for (const Case &c : cases) {
+            size_t len = 0;
+            double us = usPerCall([&] {
+                len = jpegMask(frame.data.data(), frame.data.size(), c.rects.data(), (int)c.rects.size(),
+                               work, out.data(), out.size());
+            }, rounds);
+            int masked = 0;
+            for (int m = 0; m < hdr.mcux * hdr.mcuy; m++) {
+                int x0 = (m % hdr.mcux) * mcu_w, y0 = (m / hdr.mcux) * mcu_h;
+                bool hit = false;
+                for (const JpegRect &r : c.rects) {
+                    hit = hit || (r.x < x0 + mcu_w && r.x + r.w > x0 && r.y < y0 + mcu_h && r.y + r.h > y0);
+                }
+                masked += hit;
+            }
+            printf("%-32s %-14s %10.1f %10zu %9.1f%%\n", frame.name.c_str(), c.name, us, len,
+                   100.0 * masked / (hdr.mcux * hdr.mcuy));
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || (strcmp(argv[1], "check") != 0 && strcmp(argv[1], "bench") != 0)) {
+        fprintf(stderr, "用法: %s bench [JPEG...] | check [次数] [JPEG...]\n", argv[0]);
+        return 2;
+    }
+    bool check = strcmp(argv[1], "check") == 0;
+    int arg = 2;
+    int iterations = 1000;
+    if (check && arg < argc && argv[arg][0] >= '0' && argv[arg][0] <= '9') iterations = atoi(argv[arg++]);
+
+    std::mt19937 rng(12345);
+    std::vector<Frame> frames;
+    for (; arg < argc; arg++) {
+        Frame frame;
+        if (fileFrame(argv[arg], &frame)) frames.push_back(frame);
+    }
+    if (frames.empty()) frames.push_back(syntheticVga(rng));
+
+    JpegRecodeWork *work = new JpegRecodeWork;
+    int rc = check ? runCheck(iterations, frames, work, rng) : runBench(frames, work);
+    delete work;
+    return rc;
+}
@@ -0,0 +1,252 @@
+/**
+ * AutoDiary JPEG 帧校验 (src/jpeg_check.cpp) 模糊测试与基准测试
+ *
+ * 只依赖 jpeg_check.cpp，直接用主机编译器构建 (建议带 AddressSanitizer，越界读取会立即报错)：
+ *
+ *     g++ -std=gnu++17 -O2 -g -fsanitize=address,undefined -Iinclude \
+ *         scripts/test/jpeg_validate_fuzz.cpp src/jpeg_check.cpp -o /tmp/jpeg_validate_fuzz
+ *     /tmp/jpeg_validate_fuzz fuzz 200000 frames/a.jpg frames/b.jpg
+ *     /tmp/jpeg_validate_fuzz bench frames/a.jpg frames/b.jpg
+ *
+ * fuzz [次数] [JPEG...]   以给定文件和内置合成帧为种子，随机截断 / 翻转比特 / 追加填充 /
+ *                         覆盖随机字节，检查：
+ *                         - 正常帧追加不超过 JPEG_EOI_SEARCH_BYTES 的填充后仍为 ok，长度截回原长
+ *                         - 在熵编码数据中截断必为 no_eoi，在头部截断必为 bad_header / no_soi
+ *                         - 任意输入的结果都满足：ok 时以 FFD8 开头、以 FFD9 结尾、长度不超过输入
+ * bench [JPEG...]         每个文件带 / 不带 1 KB 填充各校验若干次，输出平均耗时，
+ *                         并与 "从头扫描整帧找 FFD9" 的朴素做法对比
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "jpeg_check.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+struct Seed {
+    std::string name;
+    Bytes data;             // 到 EOI 为止的有效帧
+    size_t data_start;      // 熵编码数据起点 (SOS 段之后)
+};
+
+static int failures = 0;
+
+#define EXPECT(cond, ...) do { \
+    if (!(cond)) { \
+        if (failures++ < 20) { fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+                               fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } \
+    } \
+} while (0)
+
+// ==================== 种子 ====================
+
+static bool readFile(const char *path, Bytes *out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t block[65536];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), f)) > 0) out->insert(out->end(), block, block + n);
+    fclose(f);
+    return true;
+}
+
+static void appendSegment(Bytes &b, uint8_t marker, size_t payload, std::mt19937 &rng) {
+    b.push_back(0xFF);
+    b.push_back(marker);
+    b.push_back((uint8_t)((payload + 2) >> 8));
+    b.push_back((uint8_t)(payload + 2));
+    for (size_t i = 0; i < payload; i++) b.push_back((uint8_t)rng());
+}
+
+// 结构与 OV2640 输出相同 (APP0 / DQT / SOF0 / DHT / SOS)，熵编码数据中的 FF 按规范填充为 FF00
+static Seed syntheticSeed(size_t entropy_bytes, std::mt19937 &rng) {
+    Seed seed;
+    Bytes &b = seed.data;
+    b.push_back(0xFF);
+    b.push_back(0xD8);
+    appendSegment(b, 0xE0, 14, rng);
+    appendSegment(b, 0xDB, 65, rng);
+    appendSegment(b, 0xDB, 65, rng);
+    appendSegment(b, 0xC0, 15, rng);
+    appendSegment(b, 0xC4, 27, rng);
+    appendSegment(b, 0xC4, 177, rng);
+    appendSegment(b, 0xDA, 10, rng);
+    seed.data_start = b.size();
+    for (size_t i = 0; i < entropy_bytes; i++) {
+        uint8_t v = (uint8_t)rng();
+        b.push_back(v);
+        if (v == 0xFF) b.push_back(0x00);
+    }
+    b.push_back(0xFF);
+    b.push_back(0xD9);
+    seed.name = "synthetic-" + std::to_string(entropy_bytes);
+    return seed;
+}
+
+static bool fileSeed(const char *path, Seed *seed) {
+    Bytes raw;
+    if (!readFile(path, &raw)) {
+        fprintf(stderr, "无法读取 %s\n", path);
+        return false;
+    }
+    JpegCheck check = jpegValidate(raw.data(), raw.size());
+    if (check.status != JPEG_OK) {
+        fprintf(stderr, "%s 本身未通过校验 (%s)，跳过\n", path, jpegStatusName(check.status));
+        return false;
+    }
+    seed->name = path;
+    seed->data.assign(raw.begin(), raw.begin() + check.len);
+    // SOS 位置：从头找 FFDA 后跳过段长度
+    for (size_t i = 2; i + 3 < seed->data.size(); i++) {
+        if (seed->data[i] == 0xFF && seed->data[i + 1] == 0xDA) {
+            seed->data_start = i + 2 + ((seed->data[i + 2] << 8) | seed->data[i + 3]);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================== 模糊测试 ====================
+
+// 对任意输入都必须成立的性质；数据复制到精确大小的堆缓冲区，越界读取由 ASan 捕获
+static JpegCheck checkInvariants(const Bytes &input) {
+    uint8_t *copy = (uint8_t *)malloc(input.size() ? input.size() : 1);
+    memcpy(copy, input.data(), input.size());
+    JpegCheck r = jpegValidate(copy, input.size());
+    free(copy);
+
+    EXPECT(r.status < JPEG_STATUS_COUNT, "状态越界 %d", (int)r.status);
+    if (r.status == JPEG_OK) {
+        EXPECT(r.len >= 4 && r.len <= input.size(), "长度 %zu / 输入 %zu", r.len, input.size());
+        EXPECT(input[0] == 0xFF && input[1] == 0xD8, "ok 但没有 SOI");
+        EXPECT(input[r.len - 2] == 0xFF && input[r.len - 1] == 0xD9, "ok 但不以 EOI 结尾");
+    } else {
+        EXPECT(r.len == 0, "失败时长度应为 0");
+    }
+    return r;
+}
+
+static void fuzzSeed(const Seed &seed, int iterations, std::mt19937 &rng) {
+    const Bytes &good = seed.data;
+    EXPECT(jpegValidate(good.data(), good.size()).len == good.size(), "%s: 种子本身", seed.name.c_str());
+
+    for (int it = 0; it < iterations; it++) {
+        Bytes b = good;
+        switch (rng() % 5) {
+            case 0: {   // EOI 之后追加填充 (驱动的 DMA 尾部)，应截回原长
+                size_t pad = rng() % (JPEG_EOI_SEARCH_BYTES + 1);
+                uint8_t fill = rng() % 2 ? 0x00 : (uint8_t)rng();
+                for (size_t i = 0; i < pad; i++) {
+                    b.push_back(fill == 0xFF ? 0x00 : fill);
+                }
+                JpegCheck r = checkInvariants(b);
+                EXPECT(r.status == JPEG_OK && r.len == good.size(),
+                       "%s: 填充 %zu 字节后 %s / %zu", seed.name.c_str(), pad, jpegStatusName(r.status), r.len);
+                break;
+            }
+            case 1: {   // 在熵编码数据中截断 (丢失 EOI)
+                size_t cut = seed.data_start + rng() % (good.size() - seed.data_start - 1);
+                b.resize(cut);
+                JpegCheck r = checkInvariants(b);
+                EXPECT(r.status == JPEG_NO_EOI, "%s: 截断到 %zu 后 %s", seed.name.c_str(), cut,
+                       jpegStatusName(r.status));
+                break;
+            }
+            case 2: {   // 在头部截断
+                size_t cut = rng() % seed.data_start;
+                b.resize(cut);
+                JpegCheck r = checkInvariants(b);
+                EXPECT(r.status == JPEG_NO_SOI || r.status == JPEG_BAD_HEADER,
+                       "%s: 头部截断到 %zu 后 %s", seed.name.c_str(), cut, jpegStatusName(r.status));
+                break;
+            }
+            case 3: {   // 随机翻转比特
+                int flips = 1 + rng() % 8;
+                for (int i = 0; i < flips; i++) b[rng() % b.size()] ^= (uint8_t)(1u << (rng() % 8));
+                checkInvariants(b);
+                break;
+            }
+            default: {  // 随机长度的随机字节 (偶尔带上 SOI)
+                b.assign(rng() % 512, 0);
+                for (auto &v : b) v = (uint8_t)rng();
+                if (b.size() >= 2 && rng() % 2) { b[0] = 0xFF; b[1] = 0xD8; }
+                checkInvariants(b);
+                break;
+            }
+        }
+    }
+}
+
+static int runFuzz(int iterations, const std::vector<Seed> &seeds, std::mt19937 &rng) {
+    for (const Seed &seed : seeds) {
+        fuzzSeed(seed, iterations / (int)seeds.size(), rng);
+        printf("%-32s %8zu 字节  完成\n", seed.name.c_str(), seed.data.size());
+    }
+    printf("\n%d 次变异，%d 处失败\n", iterations, failures);
+    return failures ? 1 : 0;
+}
+
+// ==================== 基准测试 ====================
+
+// 朴素做法：从头扫描整帧，取最后一个 FFD9
+static size_t naiveEoi(const uint8_t *buf, size_t len) {
+    size_t eoi = 0;
+    for (size_t i = 1; i < len; i++) {
+        if (buf[i - 1] == 0xFF && buf[i] == 0xD9) eoi = i + 1;
+    }
+    return eoi;
+}
+
+template <typename Fn>
+static double nsPerCall(Fn fn, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+static int runBench(const std::vector<Seed> &seeds) {
+    volatile size_t sink = 0;
+    printf("%-32s %8s %6s %12s %12s %12s\n", "帧", "字节", "填充", "校验 ns", "朴素 ns", "校验 MB/s");
+    for (const Seed &seed : seeds) {
+        for (size_t pad : { (size_t)0, (size_t)1024 }) {
+            Bytes b = seed.data;
+            b.resize(b.size() + pad, 0x00);
+            int rounds = (int)(200000000 / (b.size() + 1000));
+            if (rounds < 100) rounds = 100;
+            double validate_ns = nsPerCall([&] { sink = sink + jpegValidate(b.data(), b.size()).len; }, rounds);
+            double naive_ns = nsPerCall([&] { sink = sink + naiveEoi(b.data(), b.size()); }, rounds / 10 + 1);
+            printf("%-32s %8zu %6zu %12.0f %12.0f %12.0f\n", seed.name.c_str(), b.size(), pad,
+                   validate_ns, naive_ns, b.size() / validate_ns * 1000.0);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || (strcmp(argv[1], "fuzz") != 0 && strcmp(argv[1], "bench") != 0)) {
+        fprintf(stderr, "用法: %s fuzz [次数] [JPEG...] | bench [JPEG...]\n", argv[0]);
+        return 2;
+    }
+    bool fuzz = strcmp(argv[1], "fuzz") == 0;
+    int arg = 2;
+    int iterations = 100000;
+    if (fuzz && arg < argc && argv[arg][0] >= '0' && argv[arg][0] <= '9') iterations = atoi(argv[arg++]);
+
+    std::mt19937 rng(12345);
+    std::vector<Seed> seeds;
+    for (size_t size : { (size_t)0, (size_t)1, (size_t)4000, (size_t)60000 }) {
+        seeds.push_back(syntheticSeed(size, rng));
+    }
+    for (; arg < argc; arg++) {
+        Seed seed;
+        if (fileSeed(argv[arg], &seed)) seeds.push_back(seed);
+    }
+
+    return fuzz ? runFuzz(iterations, seeds, rng) : runBench(seeds);
+}
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+AutoDiary 电源配置档对比测试
+
+依次切换 /power?profile=live|lifelog|timelapse，每个配置档稳定 --settle 秒后测量：
+- /status 往返延迟 (反映 WiFi 省电模式带来的唤醒延迟)
+- /video.jpg 延迟与帧率
+- /audio/stream 字节率
+
+功耗需用外部电流表 (如 USB 功率计) 在每个配置档的测量窗口内读数，
+脚本在每段开始和结束时打印时间，便于对齐。结束后恢复到 --restore 配置档。
+
+注意：timelapse 的 listen interval 在下次 WiFi 关联时才生效，
+要测量该配置档的完整效果需在切换后断开重连一次 (或重启后以该配置档启动)。
+"""
+
+import argparse
+import threading
+import time
+
+import requests
+
+PROFILES = ["live", "lifelog", "timelapse"]
+
+
+def percentile(values, p):
+    """简单百分位数"""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+class ProfileRun:
+    """在当前配置档下测量一段时间"""
+
+    def __init__(self, base_url: str, duration: float):
+        self.base_url = base_url
+        self.duration = duration
+        self.stop_event = threading.Event()
+        self.audio_bytes = 0
+        self.audio_start = None
+        self.frame_latencies = []
+        self.frame_seqs = set()
+        self.status_rtts = []
+        self.errors = 0
+
+    def audio_worker(self):
+        """保持一个音频流连接并统计字节数"""
+        try:
+            with requests.get(f"{self.base_url}/audio/stream", stream=True, timeout=5) as resp:
+                resp.raise_for_status()
+                for chunk in resp.iter_content(chunk_size=4096):
+                    if self.audio_start is None:
+                        self.audio_start = time.time()
+                    self.audio_bytes += len(chunk)
+                    if self.stop_event.is_set():
+                        break
+        except requests.RequestException:
+            self.errors += 1
+
+    def video_worker(self):
+        """每 200 ms 拉取一帧，内容变化即计为新帧"""
+        session = requests.Session()
+        while not self.stop_event.is_set():
+            start = time.time()
+            try:
+                resp = session.get(f"{self.base_url}/video.jpg", timeout=10)
+                if resp.status_code == 200:
+                    self.frame_latencies.append((time.time() - start) * 1000.0)
+                    self.frame_seqs.add(hash(resp.content))
+                else:
+                    self.errors += 1
+            except requests.RequestException:
+                self.errors += 1
+            self.stop_event.wait(0.2)
+
+    def status_worker(self):
+        """每秒一次 /status，测量往返延迟"""
+        session = requests.Session()
+        while not self.stop_event.is_set():
+            start = time.time()
+            try:
+                session.get(f"{self.base_url}/status", timeout=10).raise_for_status()
+                self.status_rtts.append((time.time() - start) * 1000.0)
+            except requests.RequestException:
+                self.errors += 1
+            self.stop_event.wait(1.0)
+
+    def run(self) -> dict:
+        workers = [
+            threading.Thread(target=self.audio_worker, daemon=True),
+            threading.Thread(target=self.video_worker, daemon=True),
+            threading.Thread(target=self.status_worker, daemon=True),
+        ]
+        for worker in workers:
+            worker.start()
+
+        time.sleep(self.duration)
+        self.stop_event.set()
+        audio_elapsed = time.time() - (self.audio_start or time.time())
+        for worker in workers:
+            worker.join(timeout=10)
+
+        return {
+            "audio_rate": self.audio_bytes / audio_elapsed if audio_elapsed > 0 else 0.0,
+            "distinct_frames_per_min": len(self.frame_seqs) * 60.0 / self.duration,
+            "frame_p50_ms": percentile(self.frame_latencies, 50),
+            "frame_p99_ms": percentile(self.frame_latencies, 99),
+            "status_p50_ms": percentile(self.status_rtts, 50),
+            "status_p99_ms": percentile(self.status_rtts, 99),
+            "errors": self.errors,
+        }
+
+
+def switch_profile(base_url: str, profile: str) -> dict:
+    resp = requests.get(f"{base_url}/power", params={"profile": profile}, timeout=10)
+    resp.raise_for_status()
+    return resp.json()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AutoDiary 电源配置档对比测试")
+    parser.add_argument("--host", default="192.168.1.11", help="设备 IP 地址")
+    parser.add_argument("--port", type=int, default=80, help="HTTP 端口")
+    parser.add_argument("--duration", type=float, default=60.0, help="每个配置档的测量时长 (秒)")
+    parser.add_argument("--settle", type=float, default=5.0, help="切换后等待稳定的时间 (秒)")
+    parser.add_argument("--profiles", default=",".join(PROFILES), help="逗号分隔的配置档列表")
+    parser.add_argument("--restore", default="live", help="测试结束后恢复的配置档")
+    args = parser.parse_args()
+
+    base_url = f"http://{args.host}:{args.port}"
+    results = {}
+    for profile in args.profiles.split(","):
+        info = switch_profile(base_url, profile)
+        print(f"🔋 {profile}: CPU {info['cpu_min_mhz']}~{info['cpu_max_mhz']} MHz "
+              f"(DFS {'是' if info['dfs'] else '否'}), XCLK {info['xclk_mhz']} MHz, "
+              f"间隔 {info['frame_interval_ms']} ms")
+        time.sleep(args.settle)
+        print(f"   测量开始 {time.strftime('%H:%M:%S')} (现在读取功率计)")
+        results[profile] = ProfileRun(base_url, args.duration).run()
+        print(f"   测量结束 {time.strftime('%H:%M:%S')}")
+
+    switch_profile(base_url, args.restore)
+
+    print("\n📊 测试结果:")
+    print(f"  {'配置档':<10} {'音频 B/s':>9} {'帧/分':>7} {'帧 p50':>8} {'帧 p99':>8} "
+          f"{'状态 p50':>9} {'状态 p99':>9} {'错误':>5}")
+    for profile, r in results.items():
+        print(f"  {profile:<10} {r['audio_rate']:>9.0f} {r['distinct_frames_per_min']:>7.1f} "
+              f"{r['frame_p50_ms']:>7.1f}ms {r['frame_p99_ms']:>7.1f}ms "
+              f"{r['status_p50_ms']:>8.1f}ms {r['status_p99_ms']:>8.1f}ms {r['errors']:>5}")
+
+
+if __name__ == "__main__":
+    main()
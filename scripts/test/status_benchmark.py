@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""
+AutoDiary /status 编码开销测试
+
+对每种格式 (json / cbor / msgpack) 连续请求 /status --count 次：
+- 设备端处理耗时：请求前后读取 /metrics 中
+  autodiary_http_handler_us{route="/status"} 的 _sum / _count 差值
+- 主机端往返延迟 (p50 / p99) 和响应字节数
+- 设备空闲堆的变化 (autodiary_heap_free_bytes，检查是否有泄漏)
+- 二进制格式解码后与 JSON 逐字段比较 (内置最小解码器，不依赖 cbor2 / msgpack)
+
+改动前后各运行一次 (旧固件只支持 json)，用 --label 区分输出：
+
+    python scripts/test/status_benchmark.py --host 192.168.1.11 --label before
+    python scripts/test/status_benchmark.py --host 192.168.1.11 --label after
+"""
+
+import argparse
+import re
+import struct
+import time
+
+import requests
+
+FORMATS = {
+    "json": "application/json",
+    "cbor": "application/cbor",
+    "msgpack": "application/msgpack",
+}
+
+
+def percentile(values, p):
+    """简单百分位数"""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+# ==================== 最小解码器 (只覆盖 /status 用到的类型) ====================
+
+def decode_cbor(data, pos=0):
+    """返回 (值, 下一位置)"""
+    head = data[pos]
+    major, info = head >> 5, head & 0x1F
+    pos += 1
+    if info < 24:
+        arg = info
+    else:
+        size = {24: 1, 25: 2, 26: 4, 27: 8}[info]
+        arg = int.from_bytes(data[pos:pos + size], "big")
+        pos += size
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major == 3:
+        return data[pos:pos + arg].decode("utf-8"), pos + arg
+    if major == 5:
+        obj = {}
+        for _ in range(arg):
+            key, pos = decode_cbor(data, pos)
+            obj[key], pos = decode_cbor(data, pos)
+        return obj, pos
+    if major == 7 and info in (20, 21):
+        return info == 21, pos
+    raise ValueError(f"不支持的 CBOR 类型 0x{head:02x}")
+
+
+def decode_msgpack(data, pos=0):
+    """返回 (值, 下一位置)"""
+    b = data[pos]
+    pos += 1
+    if b < 0x80:
+        return b, pos
+    if b >= 0xE0:
+        return b - 0x100, pos
+    if 0x80 <= b <= 0x8F or b == 0xDE:
+        if b == 0xDE:
+            count = struct.unpack_from(">H", data, pos)[0]
+            pos += 2
+        else:
+            count = b & 0x0F
+        obj = {}
+        for _ in range(count):
+            key, pos = decode_msgpack(data, pos)
+            obj[key], pos = decode_msgpack(data, pos)
+        return obj, pos
+    if 0xA0 <= b <= 0xBF or b in (0xD9, 0xDA):
+        if b == 0xD9:
+            n = data[pos]
+            pos += 1
+        elif b == 0xDA:
+            n = struct.unpack_from(">H", data, pos)[0]
+            pos += 2
+        else:
+            n = b & 0x1F
+        return data[pos:pos + n].decode("utf-8"), pos + n
+    if b in (0xC2, 0xC3):
+        return b == 0xC3, pos
+    fmt = {0xCC: ">B", 0xCD: ">H", 0xCE: ">I", 0xCF: ">Q",
+           0xD0: ">b", 0xD1: ">h", 0xD2: ">i", 0xD3: ">q"}.get(b)
+    if fmt:
+        return struct.unpack_from(fmt, data, pos)[0], pos + struct.calcsize(fmt)
+    raise ValueError(f"不支持的 MessagePack 类型 0x{b:02x}")
+
+
+def decode(fmt, resp):
+    if fmt == "json":
+        return resp.json()
+    if fmt == "cbor":
+        return decode_cbor(resp.content)[0]
+    return decode_msgpack(resp.content)[0]
+
+
+# ==================== 设备端指标 ====================
+
+def read_metrics(session, base_url):
+    """返回 (status 处理耗时总和 us, 请求数, 内部 RAM 空闲字节)"""
+    text = session.get(f"{base_url}/metrics", timeout=10).text
+
+    def value(pattern):
+        m = re.search(pattern, text, re.MULTILINE)
+        return float(m.group(1)) if m else 0.0
+
+    return (value(r'^autodiary_http_handler_us_sum\{route="/status"\} (\S+)'),
+            value(r'^autodiary_http_handler_us_count\{route="/status"\} (\S+)'),
+            value(r'^autodiary_heap_free_bytes\{region="internal"\} (\S+)'))
+
+
+def run_format(session, base_url, fmt, count):
+    """请求 count 次，返回统计结果；设备不支持该格式时返回 None"""
+    headers = {"Accept": FORMATS[fmt]}
+    resp = session.get(f"{base_url}/status", headers=headers, timeout=10)
+    if not resp.headers.get("Content-Type", "").startswith(FORMATS[fmt]):
+        return None
+    sample = decode(fmt, resp)
+
+    sum0, count0, heap0 = read_metrics(session, base_url)
+    rtts = []
+    sizes = []
+    for _ in range(count):
+        start = time.time()
+        resp = session.get(f"{base_url}/status", headers=headers, timeout=10)
+        rtts.append((time.time() - start) * 1000.0)
+        sizes.append(len(resp.content))
+    sum1, count1, heap1 = read_metrics(session, base_url)
+
+    handled = max(1.0, count1 - count0)
+    return {
+        "sample": sample,
+        "handler_us": (sum1 - sum0) / handled,
+        "rtt_p50": percentile(rtts, 50),
+        "rtt_p99": percentile(rtts, 99),
+        "bytes": sum(sizes) / len(sizes),
+        "heap_delta": heap1 - heap0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AutoDiary /status 编码开销测试")
+    parser.add_argument("--host", default="192.168.1.11", help="设备 IP 或 host:port")
+    parser.add_argument("--count", type=int, default=200, help="每种格式的请求次数")
+    parser.add_argument("--label", default="", help="输出标签 (如 before / after)")
+    args = parser.parse_args()
+
+    base_url = f"http://{args.host}"
+    session = requests.Session()
+    results = {}
+    for fmt in FORMATS:
+        result = run_format(session, base_url, fmt, args.count)
+        if result is None:
+            print(f"{fmt:8s} 设备不支持，跳过")
+            continue
+        results[fmt] = result
+
+    tag = f"[{args.label}] " if args.label else ""
+    print(f"\n{tag}/status x {args.count}")
+    print(f"{'格式':8s} {'处理 us':>10s} {'RTT p50':>10s} {'RTT p99':>10s} {'字节':>8s} {'堆变化':>10s}")
+    for fmt, r in results.items():
+        print(f"{fmt:8s} {r['handler_us']:10.1f} {r['rtt_p50']:10.1f} {r['rtt_p99']:10.1f} "
+              f"{r['bytes']:8.0f} {r['heap_delta']:10.0f}")
+
+    # 二进制格式与 JSON 字段一致 (计数类字段在两次请求之间会变化，只比较键和类型)
+    if "json" in results:
+        reference = results["json"]["sample"]
+        for fmt, r in results.items():
+            sample = r["sample"]
+            same_keys = set(sample) == set(reference)
+            same_types = all(type(sample[k]) is type(reference[k]) for k in reference if k in sample)
+            print(f"{fmt:8s} 字段{'一致' if same_keys and same_types else '不一致'}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+AutoDiary 流发送包数 / 吞吐测试
+
+依次打开 /audio/stream?latency_ms=... 和 /stream，每种各测 --duration 秒：
+- 吞吐 (B/s) 和主机端相邻两次收到数据的间隔 p50 / p99 (≈ 实际发送延迟)
+- TCP 段数 / 秒：读取主机 /proc/net/snmp 的 Tcp InSegs / OutSegs 差值 (仅 Linux)
+  对回环地址，两个方向的段 (数据和 ACK) 都计入 InSegs
+- 设备端每秒 send() 次数和平均每次写入字节数 (/metrics 的 autodiary_stream_writes_total)
+
+回环测试 (主机构建，见 docs/ARCHITECTURE/NATIVE_BUILD.md)：
+
+    .pio/build/native/program --port 8080 &
+    python scripts/test/stream_tcp_benchmark.py --host 127.0.0.1:8080
+
+也可以直接对设备运行 (--host 192.168.1.11)，此时 InSegs 为设备发来的段数，OutSegs 为主机回的 ACK。
+测量期间主机上的其他 TCP 流量会计入段数，结果以相对比较为主。
+"""
+
+import argparse
+import re
+import socket
+import time
+
+AUDIO_LATENCIES_MS = [20, 100, 500]
+
+
+def percentile(values, p):
+    """简单百分位数"""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def tcp_segments():
+    """返回 (InSegs, OutSegs)，不可用时返回 None"""
+    try:
+        with open("/proc/net/snmp") as f:
+            lines = [line.split() for line in f if line.startswith("Tcp:")]
+        header, values = lines[0], lines[1]
+        return int(values[header.index("InSegs")]), int(values[header.index("OutSegs")])
+    except (OSError, IndexError, ValueError):
+        return None
+
+
+def http_get(host, port, path, timeout=5.0):
+    """发送 GET 请求，返回已读过响应头的 socket 和响应头之后已收到的数据"""
+    sock = socket.create_connection((host, port), timeout=timeout)
+    sock.sendall(f"GET {path} HTTP/1.1\r\nHost: {host}\r\n\r\n".encode())
+    data = b""
+    while b"\r\n\r\n" not in data:
+        chunk = sock.recv(4096)
+        if not chunk:
+            raise ConnectionError("连接在响应头之前关闭")
+        data += chunk
+    head, rest = data.split(b"\r\n\r\n", 1)
+    status = head.split(b" ", 2)[1]
+    if status != b"200":
+        sock.close()
+        raise ConnectionError(f"{path} 返回 {status.decode()}")
+    return sock, rest
+
+
+def stream_writes(host, port, stream):
+    """设备端 autodiary_stream_writes_total{stream=...}"""
+    sock, rest = http_get(host, port, "/metrics")
+    data = rest
+    while True:
+        chunk = sock.recv(65536)
+        if not chunk:
+            break
+        data += chunk
+    sock.close()
+    m = re.search(rf'autodiary_stream_writes_total\{{stream="{stream}"\}} (\d+)', data.decode(errors="ignore"))
+    return int(m.group(1)) if m else 0
+
+
+def measure(host, port, path, stream, duration):
+    writes0 = stream_writes(host, port, stream)
+    segs0 = tcp_segments()
+
+    sock, first = http_get(host, port, path)
+    sock.settimeout(2.0)
+    received = len(first)
+    gaps = []
+    recvs = 0
+    last = None
+    start = time.time()
+    while time.time() - start < duration:
+        try:
+            chunk = sock.recv(65536)
+        except socket.timeout:
+            break
+        if not chunk:
+            break
+        now = time.time()
+        if last is not None:
+            gaps.append((now - last) * 1000.0)
+        last = now
+        received += len(chunk)
+        recvs += 1
+    elapsed = time.time() - start
+    sock.close()
+
+    segs1 = tcp_segments()
+    time.sleep(0.3)     # 等流任务发现断开后再读计数
+    writes1 = stream_writes(host, port, stream)
+    writes = max(1, writes1 - writes0)
+
+    result = {
+        "path": path,
+        "throughput": received / elapsed,
+        "gap_p50": percentile(gaps, 50),
+        "gap_p99": percentile(gaps, 99),
+        "recvs": recvs / elapsed,
+        "writes": writes / elapsed,
+        "write_bytes": received / writes,
+        "in_segs": None,
+        "out_segs": None,
+    }
+    if segs0 and segs1:
+        result["in_segs"] = (segs1[0] - segs0[0]) / elapsed
+        result["out_segs"] = (segs1[1] - segs0[1]) / elapsed
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AutoDiary 流发送包数 / 吞吐测试")
+    parser.add_argument("--host", default="127.0.0.1:8080", help="设备或主机构建的 host:port")
+    parser.add_argument("--duration", type=float, default=10.0, help="每种配置的测量时长 (秒)")
+    args = parser.parse_args()
+
+    host, _, port = args.host.partition(":")
+    port = int(port or 80)
+
+    runs = [(f"/audio/stream?latency_ms={ms}", "audio") for ms in AUDIO_LATENCIES_MS]
+    runs.append(("/stream", "video"))
+
+    results = []
+    for path, stream in runs:
+        print(f"测量 {path} ({args.duration:.0f} s)...")
+        try:
+            results.append(measure(host, port, path, stream, args.duration))
+        except (OSError, ConnectionError) as e:
+            print(f"  失败: {e}")
+
+    def fmt(value):
+        return f"{value:10.1f}" if value is not None else f"{'-':>10s}"
+
+    print(f"\n{'路径':32s} {'吞吐 B/s':>10s} {'间隔p50':>8s} {'间隔p99':>8s} "
+          f"{'send/s':>8s} {'B/send':>8s} {'InSegs/s':>10s} {'OutSegs/s':>10s}")
+    for r in results:
+        print(f"{r['path']:32s} {r['throughput']:10.0f} {r['gap_p50']:8.1f} {r['gap_p99']:8.1f} "
+              f"{r['writes']:8.1f} {r['write_bytes']:8.0f} {fmt(r['in_segs'])} {fmt(r['out_segs'])}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+AutoDiary 设备端压力测试
+
+同时打开所有数据流，验证任务布局 (docs/ARCHITECTURE/TASK_LAYOUT.md)：
+- 一个 /audio/stream 长连接，统计收到的音频字节率
+- 一个线程循环拉取 /video.jpg，统计帧延迟
+- 一个线程轮询 /status，记录设备端 audio_overruns
+
+通过标准：
+- 测试期间 audio_overruns 不增加
+- 音频字节率 >= 期望值的 99%
+- 帧延迟 p99 <= --max-frame-ms
+"""
+
+import argparse
+import sys
+import threading
+import time
+
+import requests
+
+AUDIO_BYTES_PER_SEC = 16000 * 2  # 16kHz, 16-bit, 单声道
+
+
+def percentile(values, p):
+    """简单百分位数"""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+class StressBenchmark:
+    """设备端压力测试"""
+
+    def __init__(self, host: str, port: int, duration: float):
+        self.base_url = f"http://{host}:{port}"
+        self.duration = duration
+        self.stop_event = threading.Event()
+        self.audio_bytes = 0
+        self.audio_start = None
+        self.frame_latencies = []
+        self.frame_errors = 0
+        self.status_samples = []
+
+    def audio_worker(self):
+        """保持一个音频流连接并统计字节数"""
+        try:
+            with requests.get(f"{self.base_url}/audio/stream", stream=True, timeout=5) as resp:
+                resp.raise_for_status()
+                for chunk in resp.iter_content(chunk_size=4096):
+                    if self.audio_start is None:
+                        self.audio_start = time.time()
+                    self.audio_bytes += len(chunk)
+                    if self.stop_event.is_set():
+                        break
+        except requests.RequestException as e:
+            print(f"❌ 音频流异常: {e}")
+
+    def video_worker(self):
+        """循环拉取 JPEG 帧"""
+        session = requests.Session()
+        while not self.stop_event.is_set():
+            start = time.time()
+            try:
+                resp = session.get(f"{self.base_url}/video.jpg", timeout=5)
+                if resp.status_code == 200:
+                    self.frame_latencies.append((time.time() - start) * 1000.0)
+                else:
+                    self.frame_errors += 1
+            except requests.RequestException:
+                self.frame_errors += 1
+
+    def status_worker(self):
+        """轮询设备状态"""
+        session = requests.Session()
+        while not self.stop_event.is_set():
+            try:
+                self.status_samples.append(session.get(f"{self.base_url}/status", timeout=3).json())
+            except (requests.RequestException, ValueError):
+                pass
+            self.stop_event.wait(2.0)
+
+    def run(self) -> dict:
+        """运行测试并返回汇总结果"""
+        workers = [
+            threading.Thread(target=self.audio_worker, daemon=True),
+            threading.Thread(target=self.video_worker, daemon=True),
+            threading.Thread(target=self.status_worker, daemon=True),
+        ]
+        for worker in workers:
+            worker.start()
+
+        time.sleep(self.duration)
+        self.stop_event.set()
+        audio_elapsed = time.time() - (self.audio_start or time.time())
+        for worker in workers:
+            worker.join(timeout=5)
+
+        overruns = [s.get("audio_overruns", 0) for s in self.status_samples]
+        return {
+            "audio_rate": self.audio_bytes / audio_elapsed if audio_elapsed > 0 else 0.0,
+            "audio_overruns_delta": (overruns[-1] - overruns[0]) if len(overruns) >= 2 else None,
+            "frames": len(self.frame_latencies),
+            "frame_errors": self.frame_errors,
+            "frame_p50_ms": percentile(self.frame_latencies, 50),
+            "frame_p99_ms": percentile(self.frame_latencies, 99),
+            "frame_max_ms": max(self.frame_latencies) if self.frame_latencies else 0.0,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AutoDiary 设备端压力测试")
+    parser.add_argument("--host", default="192.168.1.11", help="设备 IP 地址")
+    parser.add_argument("--port", type=int, default=80, help="HTTP 端口")
+    parser.add_argument("--duration", type=float, default=60.0, help="测试时长 (秒)")
+    parser.add_argument("--max-frame-ms", type=float, default=500.0, help="帧延迟 p99 上限")
+    args = parser.parse_args()
+
+    print(f"🚀 压力测试: {args.host}:{args.port}, 时长 {args.duration:.0f}s")
+    result = StressBenchmark(args.host, args.port, args.duration).run()
+
+    print("\n📊 测试结果:")
+    print(f"  音频速率: {result['audio_rate']:.0f} B/s (期望 {AUDIO_BYTES_PER_SEC} B/s)")
+    print(f"  音频溢出: {result['audio_overruns_delta']}")
+    print(f"  帧数: {result['frames']} (失败 {result['frame_errors']})")
+    print(f"  帧延迟: p50={result['frame_p50_ms']:.1f}ms "
+          f"p99={result['frame_p99_ms']:.1f}ms max={result['frame_max_ms']:.1f}ms")
+
+    passed = (
+        result["audio_overruns_delta"] == 0
+        and result["audio_rate"] >= AUDIO_BYTES_PER_SEC * 0.99
+        and result["frames"] > 0
+        and result["frame_p99_ms"] <= args.max_frame_ms
+    )
+    print("\n✅ 通过" if passed else "\n❌ 未通过")
+    sys.exit(0 if passed else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+把 web/ 下的 UI 资源压缩后生成 src/web_assets.cpp
+
+- 每个文件 gzip -9 (mtime 固定为 0，输出只取决于内容)
+- ETag = 压缩后内容 SHA-256 的前 16 个十六进制字符
+- index.html 对应 "/"，每次重新校验；其余文件对应 /ui/<文件名>，长期缓存
+- index.html 中的 {{/ui/xxx}} 替换为 /ui/xxx?v=<ETag>，资源内容变化即换 URL
+
+作为 PlatformIO 的 pre 脚本在每次编译前运行 (见 platformio.ini 的 extra_scripts)，
+内容未变化时不改写输出文件，避免触发重新编译。也可以直接运行：
+
+    python scripts/tools/embed_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821  在 PlatformIO (SCons) 中运行
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "web_assets.cpp")
+
+CONTENT_TYPES = {
+    ".html": "text/html; charset=utf-8",
+    ".js": "application/javascript; charset=utf-8",
+    ".css": "text/css; charset=utf-8",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+CACHE_PAGE = "no-cache"
+CACHE_ASSET = "public, max-age=31536000, immutable"
+
+
+def compress(data):
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def etag_of(blob):
+    return hashlib.sha256(blob).hexdigest()[:16]
+
+
+def c_identifier(path):
+    return "asset_" + re.sub(r"[^0-9A-Za-z]", "_", path.strip("/") or "index")
+
+
+def load_assets():
+    """返回 [(url, content_type, cache_control, etag, gzip 数据, 原始大小)]，页面排在最前"""
+    names = sorted(n for n in os.listdir(WEB_DIR) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    assets = []
+    versions = {}
+    for name in names:
+        if name == "index.html":
+            continue
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            raw = f.read()
+        blob = compress(raw)
+        url = "/ui/" + name
+        versions[url] = etag_of(blob)
+        assets.append((url, CONTENT_TYPES[os.path.splitext(name)[1]], CACHE_ASSET,
+                       versions[url], blob, len(raw)))
+
+    with open(os.path.join(WEB_DIR, "index.html"), "r", encoding="utf-8") as f:
+        page = f.read()
+
+    def versioned(match):
+        url = match.group(1)
+        if url not in versions:
+            raise SystemExit(f"index.html 引用了不存在的资源 {url}")
+        return f"{url}?v={versions[url]}"
+
+    raw = re.sub(r"\{\{(/ui/[^}]+)\}\}", versioned, page).encode("utf-8")
+    blob = compress(raw)
+    assets.insert(0, ("/", CONTENT_TYPES[".html"], CACHE_PAGE, etag_of(blob), blob, len(raw)))
+    return assets
+
+
+def render(assets):
+    out = [
+        "/**",
+        " * Web UI 资源 (由 scripts/tools/embed_web_assets.py 从 web/ 生成，不要手动修改)",
+        " */",
+        "",
+        '#include "web_assets.h"',
+        "#include <string.h>",
+        "",
+        "#ifdef ARDUINO",
+        "#include <pgmspace.h>",
+        "#endif",
+        "#ifndef PROGMEM",
+        "#define PROGMEM",
+        "#endif",
+        "",
+    ]
+    for url, _, _, _, blob, raw_len in assets:
+        out.append(f"// {url}: {raw_len} -> {len(blob)} 字节")
+        out.append(f"static const uint8_t {c_identifier(url)}[] PROGMEM = {{")
+        for i in range(0, len(blob), 16):
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in blob[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+
+    out.append("static const WebAsset web_assets[] = {")
+    for url, content_type, cache, etag, _, _ in assets:
+        ident = c_identifier(url)
+        out.append(f'    {{ "{url}", "{content_type}", "{cache}", "\\"{etag}\\"", {ident}, sizeof({ident}) }},')
+    out.append("};")
+    out.append("")
+    out.append("const WebAsset *webAssetFind(const char *path) {")
+    out.append("    for (size_t i = 0; i < webAssetCount(); i++) {")
+    out.append("        if (strcmp(web_assets[i].path, path) == 0) return &web_assets[i];")
+    out.append("    }")
+    out.append("    return NULL;")
+    out.append("}")
+    out.append("")
+    out.append("size_t webAssetCount() {")
+    out.append("    return sizeof(web_assets) / sizeof(web_assets[0]);")
+    out.append("}")
+    out.append("")
+    out.append("const WebAsset *webAssetAt(size_t index) {")
+    out.append("    return index < webAssetCount() ? &web_assets[index] : NULL;")
+    out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    assets = load_assets()
+    text = render(assets)
+    try:
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    except FileNotFoundError:
+        pass
+    with open(OUTPUT, "w", encoding="utf-8") as f:
+        f.write(text)
+    total_raw = sum(a[5] for a in assets)
+    total_gz = sum(len(a[4]) for a in assets)
+    print(f"web_assets.cpp: {len(assets)} 个资源, {total_raw} -> {total_gz} 字节")
+
+
+main()
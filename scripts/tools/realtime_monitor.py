@@ -3,7 +3,7 @@
 AutoDiary v3.0 实时监控系统
 功能：
 - 实时监控设备状态和埋点数据
-- WebSocket 实时推送
+- 设备事件推送 (/events 的 Server-Sent Events：WiFi、摄像头恢复、语音、运动、存储、内存)
 - 性能告警
 - 设备健康度检测
 """
@@ -46,7 +46,8 @@ class RealtimeMonitor:
 
     def __init__(self, esp32_ip: str = "192.168.1.11",
                  esp32_port: int = 80,
-                 check_interval: int = 5):
+                 check_interval: int = 5,
+                 events: bool = True):
         self.esp32_ip = esp32_ip
         self.esp32_port = esp32_port
         self.base_url = f"http://{esp32_ip}:{esp32_port}"
@@ -61,6 +62,11 @@ class RealtimeMonitor:
         self.alert_callbacks: List[Callable] = []
         self.last_checkpoint_count = 0
 
+        self.events_enabled = events
+        self.events_thread = None
+        self.last_event_id: Optional[str] = None
+        self.events_history: List[Dict] = []
+
     def log(self, message: str, level: str = "INFO"):
         """记录日志"""
         timestamp = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
@@ -185,7 +191,10 @@ class RealtimeMonitor:
                 "message": f"内存使用率较高: {metrics.memory_usage:.1f}%"
             })
 
-        # 触发告警
+        self.raise_alerts(alerts)
+
+    def raise_alerts(self, alerts: List[Dict]):
+        """记录并分发告警"""
         for alert in alerts:
             self.log(
                 f"{alert['level']}: {alert['message']}",
@@ -197,6 +206,94 @@ class RealtimeMonitor:
                 except Exception as e:
                     self.log(f"告警回调异常: {str(e)}", "ERROR")
 
+    def event_to_alert(self, event_type: str, data: Dict) -> Optional[Dict]:
+        """设备事件转换为告警 (不需要告警的事件返回 None)"""
+        if event_type == "wifi" and data.get("state") == "disconnected":
+            return {"level": "WARNING", "message": f"WiFi 断开 (reason {data.get('reason')})"}
+        if event_type == "wifi" and data.get("state") == "connected":
+            return {"level": "INFO", "message": f"WiFi 已重连 (断开 {data.get('down_ms')} ms)"}
+        if event_type == "camera":
+            state = data.get("state")
+            if state == "failed":
+                return {"level": "CRITICAL", "message": "摄像头恢复失败，退避等待中"}
+            if state == "recovering":
+                return {"level": "WARNING", "message": f"摄像头恢复中 ({data.get('action')})"}
+            if state == "ok":
+                return {"level": "INFO", "message": f"摄像头已恢复 (故障 {data.get('outage_ms')} ms)"}
+        if event_type == "storage_full":
+            return {"level": "CRITICAL",
+                    "message": f"存储将满: 已用 {data.get('used_permille', 0) / 10:.1f}%, "
+                               f"剩余 {data.get('free_kb')} KB"}
+        if event_type == "low_heap":
+            return {"level": "CRITICAL",
+                    "message": f"内部堆不足: 空闲 {data.get('free_bytes')} bytes, "
+                               f"最大块 {data.get('largest_block')} bytes"}
+        if event_type == "dropped":
+            return {"level": "WARNING", "message": "事件流中断期间有事件被覆盖"}
+        return None
+
+    def handle_event(self, event_type: str, event_id: Optional[str], payload: str):
+        """处理一条设备事件"""
+        try:
+            data = json.loads(payload) if payload else {}
+        except ValueError:
+            data = {"raw": payload}
+        if event_id is not None:
+            self.last_event_id = event_id
+        if event_type == "clock":
+            return
+        self.events_history.append({"type": event_type, **data})
+
+        alert = self.event_to_alert(event_type, data)
+        if alert:
+            self.raise_alerts([alert])
+        else:
+            self.log(f"事件 {event_type}: {payload}")
+
+    def read_event_stream(self):
+        """连接一次 /events 事件流，逐条处理直到断开"""
+        headers = {"Accept": "text/event-stream"}
+        if self.last_event_id:
+            headers["Last-Event-ID"] = self.last_event_id
+        # 读超时大于设备的保活间隔 (15 s)
+        with requests.get(f"{self.base_url}/events", headers=headers,
+                          stream=True, timeout=(5, 30)) as response:
+            if response.status_code != 200:
+                raise RuntimeError(f"HTTP {response.status_code}")
+            self.log("✅ 已连接设备事件流")
+            event_type, event_id, data_lines = "message", None, []
+            for line in response.iter_lines(decode_unicode=True):
+                if not self.is_running:
+                    return
+                if line is None:
+                    continue
+                if line == "":
+                    if data_lines:
+                        self.handle_event(event_type, event_id, "\n".join(data_lines))
+                    event_type, event_id, data_lines = "message", None, []
+                elif line.startswith(":"):
+                    continue    # 保活注释
+                else:
+                    field, _, value = line.partition(":")
+                    value = value[1:] if value.startswith(" ") else value
+                    if field == "event":
+                        event_type = value
+                    elif field == "id":
+                        event_id = value
+                    elif field == "data":
+                        data_lines.append(value)
+
+    def event_loop(self):
+        """事件推送循环：断开后按 Last-Event-ID 重连，不丢中间的事件"""
+        while self.is_running:
+            try:
+                self.read_event_stream()
+            except Exception as e:
+                if self.is_running:
+                    self.log(f"事件流断开: {str(e)}", "WARNING")
+            if self.is_running:
+                time.sleep(3)
+
     def monitor_loop(self):
         """监控循环"""
         self.log("启动实时监控...")
@@ -246,6 +343,12 @@ class RealtimeMonitor:
             daemon=True
         )
         self.monitor_thread.start()
+        if self.events_enabled:
+            self.events_thread = threading.Thread(
+                target=self.event_loop,
+                daemon=True
+            )
+            self.events_thread.start()
         self.log(f"✅ 实时监控已启动 (间隔 {self.check_interval}s)")
 
     def stop(self):
@@ -278,7 +381,8 @@ class RealtimeMonitor:
                     "status": m.status.value
                 }
                 for m in self.metrics_history
-            ]
+            ],
+            "events": self.events_history
         }
 
         with open(metrics_file, "w", encoding="utf-8") as f:
@@ -317,7 +421,8 @@ class RealtimeMonitor:
             "warning_alerts": sum(
                 1 for m in self.metrics_history
                 if m.status == HealthStatus.WARNING
-            )
+            ),
+            "device_events": len(self.events_history)
         }
 
 
@@ -349,6 +454,11 @@ def main():
         default=5,
         help="检查间隔（秒）"
     )
+    parser.add_argument(
+        "--no-events",
+        action="store_true",
+        help="不订阅设备事件流 (/events)"
+    )
     parser.add_argument(
         "--duration",
         type=int,
@@ -361,7 +471,8 @@ def main():
     monitor = RealtimeMonitor(
         esp32_ip=args.ip,
         esp32_port=args.port,
-        check_interval=args.interval
+        check_interval=args.interval,
+        events=not args.no_events
     )
 
     # 注册告警处理器
@@ -0,0 +1,79 @@
+/**
+ * 启动阶段计时实现
+ */
+
+#include "boot.h"
+#include "hal.h"
+#include "seqlock.h"
+#include <stdio.h>
+#include <atomic>
+
+struct BootPhaseTimes {
+    SeqlockI64 start_us{-1};
+    SeqlockI64 end_us{-1};
+    std::atomic<bool> marked{false};    // bootMark() 只记录第一次
+};
+
+static BootPhaseTimes boot_phases[BOOT_PHASE_COUNT];
+static std::atomic<bool> boot_summary_printed{false};
+
+static const char *const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "setup", "wifi_start", "mic", "http", "camera", "first_frame", "first_audio", "wifi_connected"
+};
+
+void bootPhaseStart(BootPhase phase) {
+    boot_phases[phase].start_us.store(halNowUs());
+}
+
+void bootPhaseEnd(BootPhase phase) {
+    boot_phases[phase].end_us.store(halNowUs());
+}
+
+void bootMark(BootPhase phase) {
+    if (boot_phases[phase].marked.exchange(true)) return;
+    boot_phases[phase].end_us.store(halNowUs());
+    boot_phases[phase].start_us.store(0);
+}
+
+bool bootComplete() {
+    return boot_phases[BOOT_PHASE_FIRST_FRAME].end_us.load() >= 0 &&
+           boot_phases[BOOT_PHASE_FIRST_AUDIO].end_us.load() >= 0 &&
+           boot_phases[BOOT_PHASE_WIFI_CONNECTED].end_us.load() >= 0;
+}
+
+bool bootLogSummary() {
+    if (boot_summary_printed.exchange(true)) return false;
+
+    halLog("\n⏱️ 启动时间表 (相对开机, ms):\n");
+    halLog("  %-16s %8s %8s %8s\n", "阶段", "开始", "结束", "耗时");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        int64_t start = boot_phases[i].start_us.load();
+        int64_t end = boot_phases[i].end_us.load();
+        if (start < 0 || end < 0) {
+            halLog("  %-16s %8s\n", BOOT_PHASE_NAMES[i], "-");
+            continue;
+        }
+        halLog("  %-16s %8lld %8lld %8lld\n", BOOT_PHASE_NAMES[i],
+               (long long)(start / 1000), (long long)(end / 1000), (long long)((end - start) / 1000));
+    }
+    return true;
+}
+
+void bootRenderMetrics(MetricsWriter &w) {
+    char labels[40];
+
+    w.type("autodiary_boot_phase_start_ms", "gauge");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        int64_t start = boot_phases[i].start_us.load();
+        if (start < 0 || boot_phases[i].end_us.load() < 0) continue;
+        snprintf(labels, sizeof(labels), "phase=\"%s\"", BOOT_PHASE_NAMES[i]);
+        w.gauge("autodiary_boot_phase_start_ms", labels, (double)(start / 1000));
+    }
+    w.type("autodiary_boot_phase_end_ms", "gauge");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        int64_t end = boot_phases[i].end_us.load();
+        if (end < 0 || boot_phases[i].start_us.load() < 0) continue;
+        snprintf(labels, sizeof(labels), "phase=\"%s\"", BOOT_PHASE_NAMES[i]);
+        w.gauge("autodiary_boot_phase_end_ms", labels, (double)(end / 1000));
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * 摄像头参数实现
+ */
+
+#include "camera_config.h"
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+
+#define CAMERA_CONFIG_MAGIC     0x43464743u     // "CGFC"
+#define CAMERA_CONFIG_VERSION   3
+// 新字段都追加在参数结构体末尾：版本 1 没有数码变焦 (读取时为全幅)，
+// 版本 2 没有静态照片分辨率 (读取时关闭双流)
+#define CAMERA_CONFIG_V1_SIZE   offsetof(HalCameraSettings, zoom_x)
+#define CAMERA_CONFIG_V2_SIZE   offsetof(HalCameraSettings, still_size)
+
+struct FrameSizeInfo {
+    const char *name;
+    uint16_t width;
+    uint16_t height;
+};
+
+static const FrameSizeInfo FRAME_SIZE_INFO[HAL_FRAME_SIZE_COUNT] = {
+    { "qqvga", 160,  120  },
+    { "qvga",  320,  240  },
+    { "vga",   640,  480  },
+    { "svga",  800,  600  },
+    { "xga",   1024, 768  },
+    { "sxga",  1280, 1024 },
+    { "uxga",  1600, 1200 },
+};
+
+// 存储格式：头部 + 参数结构体原样写入，结构变化时增加版本号
+struct CameraConfigFile {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    HalCameraSettings settings;
+};
+
+// 与原 halCameraBegin 中的设置一致：VGA、质量 10、自动曝光 / 白平衡 / 增益
+static HalCameraSettings camera_settings = {
+    HAL_FRAME_VGA, 10, true, 300, 0, true, 0, true, 0, 2, 0, 0, 0, 0, CAMERA_STILL_OFF,
+};
+static HalCameraSettings camera_applied_settings = camera_settings;     // 只由视频任务写入
+static std::mutex camera_settings_mutex;
+
+static std::atomic<uint32_t> camera_requested{0};   // 最新提交的序号
+static std::atomic<uint32_t> camera_applied{0};     // 视频任务已应用的序号
+static std::atomic<bool> camera_applied_ok{true};
+static std::atomic<uint32_t> camera_zoom_generation{0};
+
+static Counter camera_applies;
+static Counter camera_apply_failures;
+static Counter camera_reapplies;
+
+// ==================== 分辨率 ====================
+
+const char *cameraFrameSizeName(uint8_t frame_size) {
+    return frame_size < HAL_FRAME_SIZE_COUNT ? FRAME_SIZE_INFO[frame_size].name : "unknown";
+}
+
+HalFrameSize cameraFrameSizeByName(const char *name) {
+    for (int i = 0; i < HAL_FRAME_SIZE_COUNT; i++) {
+        if (strcmp(name, FRAME_SIZE_INFO[i].name) == 0) return (HalFrameSize)i;
+    }
+    return HAL_FRAME_SIZE_COUNT;
+}
+
+const char *cameraStillSizeName(uint8_t still_size) {
+    return still_size == CAMERA_STILL_OFF ? "off" : cameraFrameSizeName(still_size);
+}
+
+void cameraFrameSizeDims(uint8_t frame_size, uint16_t *width, uint16_t *height) {
+    if (frame_size >= HAL_FRAME_SIZE_COUNT) frame_size = HAL_FRAME_VGA;
+    const FrameSizeInfo &info = FRAME_SIZE_INFO[frame_size];
+    *width = info.width;
+    *height = info.height;
+}
+
+// ==================== 读取 / 提交 ====================
+
+void cameraConfigBegin() {
+    CameraConfigFile file;
+    memset(&file, 0, sizeof(file));
+    size_t n = halStorageRead(CAMERA_CONFIG_PATH, 0, (uint8_t *)&file, sizeof(file));
+    bool current = file.version == CAMERA_CONFIG_VERSION && file.size == sizeof(HalCameraSettings);
+    bool v1 = file.version == 1 && file.size == CAMERA_CONFIG_V1_SIZE;
+    bool v2 = file.version == 2 && file.size == CAMERA_CONFIG_V2_SIZE;
+    if (v1 || v2) file.settings.still_size = CAMERA_STILL_OFF;
+    if (n != offsetof(CameraConfigFile, settings) + file.size || file.magic != CAMERA_CONFIG_MAGIC ||
+        !(current || v1 || v2) || cameraConfigValidate(file.settings) != NULL) {
+        if (!halPsramFound()) {
+            std::lock_guard<std::mutex> lock(camera_settings_mutex);
+            camera_settings.frame_size = HAL_FRAME_QVGA;    // 无 PSRAM 时的原有设置
+            camera_settings.quality = 12;
+        }
+        halLog("📷 摄像头参数: 使用默认值\n");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(camera_settings_mutex);
+    camera_settings = file.settings;
+    halLog("📷 摄像头参数: 读取 %s (%s, 质量 %u, 变焦窗口 %ux%u, 静态照片 %s)\n", CAMERA_CONFIG_PATH,
+           cameraFrameSizeName(file.settings.frame_size), file.settings.quality,
+           file.settings.zoom_w, file.settings.zoom_h, cameraStillSizeName(file.settings.still_size));
+}
+
+HalCameraSettings cameraConfigCurrent() {
+    std::lock_guard<std::mutex> lock(camera_settings_mutex);
+    return camera_settings;
+}
+
+// 传感器只能缩小：窗口不小于输出分辨率，宽高比与输出一致 (误差 2% 以内)
+static const char *checkZoom(const HalCameraSettings &s, uint8_t frame_size) {
+    uint16_t width, height;
+    cameraFrameSizeDims(frame_size, &width, &height);
+    if (s.zoom_w < width || s.zoom_h < height) return "zoom 窗口小于输出分辨率";
+    long cross = (long)s.zoom_w * height - (long)s.zoom_h * width;
+    if (cross < 0) cross = -cross;
+    if (cross * 50 > (long)s.zoom_w * height) return "zoom 宽高比须与分辨率一致";
+    return NULL;
+}
+
+const char *cameraConfigValidate(const HalCameraSettings &s) {
+    if (s.frame_size >= HAL_FRAME_SIZE_COUNT) return "frame_size 无效";
+    if (halCameraReady() && s.frame_size > halCameraMaxFrameSize()) return "frame_size 超过帧缓冲上限";
+    if (s.still_size > CAMERA_STILL_OFF) return "still 无效";
+    if (s.still_size != CAMERA_STILL_OFF && halCameraReady() && s.still_size > halCameraMaxFrameSize()) {
+        return "still 超过帧缓冲上限";
+    }
+    if (s.quality < 4 || s.quality > 63) return "quality 范围 4~63";
+    if (s.exposure > 1200) return "exposure 范围 0~1200";
+    if (s.ae_level < -2 || s.ae_level > 2) return "ae_level 范围 -2~2";
+    if (s.wb_mode > 4) return "wb_mode 范围 0~4";
+    if (s.gain > 30) return "gain 范围 0~30";
+    if (s.gain_ceiling > 6) return "gain_ceiling 范围 0~6";
+    if (s.zoom_w || s.zoom_h) {
+        if (s.zoom_x % 8 || s.zoom_y % 8 || s.zoom_w % 8 || s.zoom_h % 8) return "zoom 须为 8 的倍数";
+        if (s.zoom_x + s.zoom_w > HAL_SENSOR_WIDTH || s.zoom_y + s.zoom_h > HAL_SENSOR_HEIGHT) {
+            return "zoom 超出传感器范围 (1600x1200)";
+        }
+        const char *error = checkZoom(s, s.frame_size);
+        if (error) return error;
+        // 静态照片沿用同一变焦窗口
+        if (s.still_size != CAMERA_STILL_OFF && checkZoom(s, s.still_size) != NULL) {
+            return "zoom 窗口与 still 分辨率不符 (窗口须不小于 still 且宽高比一致)";
+        }
+    }
+    return NULL;
+}
+
+uint32_t cameraConfigSubmit(const HalCameraSettings &settings, bool *persisted) {
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(camera_settings_mutex);
+        camera_settings = settings;
+        generation = camera_requested.load() + 1;
+        camera_requested.store(generation);
+    }
+
+    CameraConfigFile file;
+    memset(&file, 0, sizeof(file));
+    file.magic = CAMERA_CONFIG_MAGIC;
+    file.version = CAMERA_CONFIG_VERSION;
+    file.size = sizeof(HalCameraSettings);
+    file.settings = settings;
+    // 只写到参数结构体末尾 (不含结构体对齐的填充)，与读取时的长度检查一致
+    *persisted = halStorageWrite(CAMERA_CONFIG_PATH, (const uint8_t *)&file,
+                                 offsetof(CameraConfigFile, settings) + sizeof(HalCameraSettings));
+    return generation;
+}
+
+bool cameraConfigWaitApplied(uint32_t generation, uint32_t timeout_ms, bool *ok) {
+    uint32_t waited_ms = 0;
+    while ((int32_t)(camera_applied.load() - generation) < 0) {
+        if (waited_ms >= timeout_ms) return false;
+        halDelayMs(10);
+        waited_ms += 10;
+    }
+    *ok = camera_applied_ok.load();
+    return true;
+}
+
+// ==================== 视频任务调用 ====================
+
+HalCameraSettings cameraConfigEffective() {
+    HalCameraSettings settings = cameraConfigCurrent();
+    // 保存的分辨率超过本机帧缓冲 (如换到无 PSRAM 的板子) 时降到上限
+    if (settings.frame_size > halCameraMaxFrameSize()) {
+        settings.frame_size = halCameraMaxFrameSize();
+    }
+    if (settings.still_size != CAMERA_STILL_OFF && settings.still_size > halCameraMaxFrameSize()) {
+        settings.still_size = halCameraMaxFrameSize();
+    }
+    return settings;
+}
+
+HalCameraSettings cameraConfigApplied() {
+    std::lock_guard<std::mutex> lock(camera_settings_mutex);
+    return camera_applied_settings;
+}
+
+uint32_t cameraConfigZoomGeneration() {
+    return camera_zoom_generation.load();
+}
+
+// reinit：摄像头刚 (重新) 初始化，驱动按全幅窗口开始采集
+static bool applyCurrent(bool reinit) {
+    HalCameraSettings settings = cameraConfigEffective();
+    bool ok = halCameraApply(settings);
+    if (!ok) {
+        camera_apply_failures.inc();
+        halLog("⚠️ 摄像头参数应用失败 (%s, 质量 %u)\n", cameraFrameSizeName(settings.frame_size),
+               settings.quality);
+    }
+
+    HalCameraSettings previous;
+    {
+        std::lock_guard<std::mutex> lock(camera_settings_mutex);
+        previous = camera_applied_settings;
+        camera_applied_settings = settings;
+    }
+    if (reinit) previous.zoom_x = previous.zoom_y = previous.zoom_w = previous.zoom_h = 0;
+    if (previous.zoom_x != settings.zoom_x || previous.zoom_y != settings.zoom_y ||
+        previous.zoom_w != settings.zoom_w || previous.zoom_h != settings.zoom_h) {
+        camera_zoom_generation.fetch_add(1);
+    }
+    return ok;
+}
+
+bool cameraConfigPending() {
+    return camera_applied.load() != camera_requested.load();
+}
+
+void cameraConfigApplyPending() {
+    uint32_t generation = camera_requested.load();
+    if (generation == camera_applied.load()) return;
+    camera_applies.inc();
+    camera_applied_ok.store(applyCurrent(false));
+    camera_applied.store(generation);
+}
+
+void cameraConfigReapply() {
+    camera_reapplies.inc();
+    uint32_t generation = camera_requested.load();
+    camera_applied_ok.store(applyCurrent(true));
+    camera_applied.store(generation);
+}
+
+void cameraConfigRenderMetrics(MetricsWriter &w) {
+    HalCameraSettings s = cameraConfigCurrent();
+    uint16_t width, height;
+    cameraFrameSizeDims(s.frame_size, &width, &height);
+
+    w.type("autodiary_camera_config_applies_total", "counter");
+    w.counter("autodiary_camera_config_applies_total", "reason=\"request\"", camera_applies.value());
+    w.counter("autodiary_camera_config_applies_total", "reason=\"recovery\"", camera_reapplies.value());
+    w.type("autodiary_camera_config_failures_total", "counter");
+    w.counter("autodiary_camera_config_failures_total", NULL, camera_apply_failures.value());
+    w.type("autodiary_camera_frame_width", "gauge");
+    w.gauge("autodiary_camera_frame_width", NULL, width);
+    w.type("autodiary_camera_jpeg_quality", "gauge");
+    w.gauge("autodiary_camera_jpeg_quality", NULL, s.quality);
+    // 数码变焦倍数 x100 (全幅为 100)
+    w.type("autodiary_camera_zoom_ratio_x100", "gauge");
+    w.gauge("autodiary_camera_zoom_ratio_x100", NULL,
+            s.zoom_w ? (uint32_t)HAL_SENSOR_WIDTH * 100 / s.zoom_w : 100);
+}
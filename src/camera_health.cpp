@@ -0,0 +1,210 @@
+/**
+ * 摄像头健康监督实现
+ */
+
+#include "camera_health.h"
+#include "camera_config.h"
+#include "jpeg_check.h"
+#include "pipeline.h"
+#include "events.h"
+#include "seqlock.h"
+#include <stdio.h>
+#include <atomic>
+
+static const uint32_t RECOVERY_MS_BOUNDS[] = {
+    10, 50, 100, 250, 500, 1000, 2000, 5000, 10000, 30000
+};
+#define RECOVERY_HISTOGRAM { RECOVERY_MS_BOUNDS, sizeof(RECOVERY_MS_BOUNDS) / sizeof(RECOVERY_MS_BOUNDS[0]) }
+
+static const char *const STATE_NAMES[CAMERA_HEALTH_STATE_COUNT] = {
+    "ok", "degraded", "recovering", "failed"
+};
+static const char *const FAULT_NAMES[CAMERA_FAULT_COUNT] = {
+    "none", "grab_failed", "bad_jpeg", "slow"
+};
+static const char *const ACTION_NAMES[CAMERA_ACTION_COUNT] = {
+    "soft_reset", "reinit", "power_cycle"
+};
+
+// 以下只由视频任务修改
+static uint32_t health_strikes = 0;             // 连续异常次数 (决定恢复级别，退避后回退)
+static uint32_t health_outage_faults = 0;       // 本次故障期间的异常总数
+static int64_t health_outage_start_us = -1;     // 第一次异常的时刻
+static uint32_t health_grab_avg_us = 0;         // 取帧耗时的指数移动平均 (1/8)
+
+static std::atomic<int> health_state{CAMERA_HEALTH_OK};
+static SeqlockI64 health_last_good_us{-1};
+
+static Counter health_faults[CAMERA_FAULT_COUNT];
+static Counter health_jpeg_invalid[JPEG_STATUS_COUNT];
+static Counter health_jpeg_trimmed_bytes;
+static Counter health_recoveries[CAMERA_ACTION_COUNT];
+static Counter health_recovery_failures[CAMERA_ACTION_COUNT];
+static Histogram health_recovery_ms[CAMERA_ACTION_COUNT] = {
+    RECOVERY_HISTOGRAM, RECOVERY_HISTOGRAM, RECOVERY_HISTOGRAM
+};
+static Histogram health_outage_ms RECOVERY_HISTOGRAM;
+
+// ==================== 判定 ====================
+
+CameraFault cameraHealthCheck(HalFrame *frame, uint32_t capture_us) {
+    CameraFault fault = CAMERA_FAULT_NONE;
+    JpegCheck jpeg = { JPEG_OK, 0 };
+    if (frame) jpeg = jpegValidate(frame->buf, frame->len);
+
+    if (!frame) {
+        fault = CAMERA_FAULT_GRAB_FAILED;
+    } else if (jpeg.status != JPEG_OK) {
+        fault = CAMERA_FAULT_BAD_JPEG;
+        health_jpeg_invalid[jpeg.status].inc();
+    } else {
+        // 驱动按 DMA 块交付，EOI 之后可能还有填充字节，不发给客户端
+        health_jpeg_trimmed_bytes.add(frame->len - jpeg.len);
+        frame->len = jpeg.len;
+        if (health_grab_avg_us > 0 && capture_us > CAMERA_SLOW_GRAB_MIN_US &&
+            capture_us > CAMERA_SLOW_GRAB_FACTOR * health_grab_avg_us) {
+            fault = CAMERA_FAULT_SLOW;
+        }
+        // 慢帧也计入平均值：持续变慢 (如切换到更高分辨率) 时不再算作异常
+        health_grab_avg_us = health_grab_avg_us == 0
+            ? capture_us : health_grab_avg_us - health_grab_avg_us / 8 + capture_us / 8;
+        health_last_good_us.store(frame->timestamp_us);
+    }
+
+    if (fault == CAMERA_FAULT_NONE) {
+        if (health_strikes > 0) {
+            int64_t outage_ms = (halNowUs() - health_outage_start_us) / 1000;
+            health_outage_ms.observe((uint32_t)outage_ms);
+            halLog("✅ 摄像头恢复 (%u 次异常, %lld ms)\n", (unsigned)health_outage_faults, (long long)outage_ms);
+            eventPublish(EVENT_CAMERA, halNowUs(), CAMERA_HEALTH_OK, (uint32_t)outage_ms);
+            health_strikes = 0;
+            health_outage_faults = 0;
+            health_outage_start_us = -1;
+        }
+        health_state.store(CAMERA_HEALTH_OK);
+        return fault;
+    }
+
+    health_faults[fault].inc();
+    health_outage_faults++;
+    if (health_strikes++ == 0) health_outage_start_us = halNowUs();
+    if (health_state.load() == CAMERA_HEALTH_OK) health_state.store(CAMERA_HEALTH_DEGRADED);
+    return fault;
+}
+
+// ==================== 恢复 ====================
+
+static void runAction(CameraRecoveryAction action) {
+    halLog("🩺 摄像头连续 %u 次异常，执行 %s\n", (unsigned)health_strikes, ACTION_NAMES[action]);
+    health_state.store(CAMERA_HEALTH_RECOVERING);
+    eventPublish(EVENT_CAMERA, halNowUs(), CAMERA_HEALTH_RECOVERING, action);
+
+    int64_t start_us = halNowUs();
+    bool ok;
+    switch (action) {
+        case CAMERA_ACTION_SOFT_RESET:  ok = halCameraSoftReset(); break;
+        case CAMERA_ACTION_REINIT:      ok = halCameraReinit(); break;
+        default:                        ok = halCameraPowerCycle(); break;
+    }
+    // 复位后传感器寄存器回到默认值，重新写入保存的参数
+    if (ok) cameraConfigReapply();
+    uint32_t dur_ms = (uint32_t)((halNowUs() - start_us) / 1000);
+
+    health_recoveries[action].inc();
+    health_recovery_ms[action].observe(dur_ms);
+    if (!ok) {
+        health_recovery_failures[action].inc();
+        halLog("⚠️ %s 失败 (%lu ms)\n", ACTION_NAMES[action], (unsigned long)dur_ms);
+    }
+}
+
+void cameraHealthRecover() {
+    if (health_strikes == 0) return;
+
+    if (health_strikes == CAMERA_SOFT_RESET_AFTER) {
+        runAction(CAMERA_ACTION_SOFT_RESET);
+    } else if (health_strikes == CAMERA_REINIT_AFTER) {
+        runAction(CAMERA_ACTION_REINIT);
+    } else if (health_strikes == CAMERA_POWER_CYCLE_AFTER) {
+        runAction(CAMERA_ACTION_POWER_CYCLE);
+    } else if (health_strikes >= CAMERA_BACKOFF_AFTER) {
+        // 断电重启也没有恢复：退避一段时间后从重新初始化一级再来
+        halLog("❌ 摄像头恢复失败，%d ms 后重试\n", CAMERA_BACKOFF_MS);
+        health_state.store(CAMERA_HEALTH_FAILED);
+        eventPublish(EVENT_CAMERA, halNowUs(), CAMERA_HEALTH_FAILED, 0);
+        halDelayMs(CAMERA_BACKOFF_MS);
+        health_strikes = CAMERA_REINIT_AFTER - 1;
+    } else {
+        halDelayMs(10);         // 重试
+    }
+}
+
+// ==================== 状态 ====================
+
+CameraHealthState cameraHealthState() {
+    return (CameraHealthState)health_state.load();
+}
+
+const char *cameraHealthStateName(CameraHealthState state) {
+    return state < CAMERA_HEALTH_STATE_COUNT ? STATE_NAMES[state] : "unknown";
+}
+
+const char *cameraHealthActionName(CameraRecoveryAction action) {
+    return action < CAMERA_ACTION_COUNT ? ACTION_NAMES[action] : "unknown";
+}
+
+int64_t cameraHealthLastGoodUs() {
+    return health_last_good_us.load();
+}
+
+bool cameraHealthStale(int64_t frame_timestamp_us) {
+    // 延时摄影等低帧率配置档下按两个捕获间隔放宽
+    int64_t limit_ms = 2LL * video_frame_interval_ms.load();
+    if (limit_ms < CAMERA_STALE_AFTER_MS) limit_ms = CAMERA_STALE_AFTER_MS;
+    return (halNowUs() - frame_timestamp_us) / 1000 > limit_ms;
+}
+
+void cameraHealthRenderMetrics(MetricsWriter &w) {
+    char labels[32];
+    int state = health_state.load();
+
+    w.type("autodiary_camera_health_state", "gauge");
+    for (int i = 0; i < CAMERA_HEALTH_STATE_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "state=\"%s\"", STATE_NAMES[i]);
+        w.gauge("autodiary_camera_health_state", labels, i == state ? 1 : 0);
+    }
+    w.type("autodiary_camera_faults_total", "counter");
+    for (int i = CAMERA_FAULT_GRAB_FAILED; i < CAMERA_FAULT_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "kind=\"%s\"", FAULT_NAMES[i]);
+        w.counter("autodiary_camera_faults_total", labels, health_faults[i].value());
+    }
+    w.type("autodiary_jpeg_invalid_total", "counter");
+    for (int i = JPEG_NO_SOI; i < JPEG_STATUS_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "reason=\"%s\"", jpegStatusName((JpegStatus)i));
+        w.counter("autodiary_jpeg_invalid_total", labels, health_jpeg_invalid[i].value());
+    }
+    w.type("autodiary_jpeg_trimmed_bytes_total", "counter");
+    w.counter("autodiary_jpeg_trimmed_bytes_total", NULL, health_jpeg_trimmed_bytes.value());
+    w.type("autodiary_camera_recoveries_total", "counter");
+    for (int i = 0; i < CAMERA_ACTION_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "action=\"%s\"", ACTION_NAMES[i]);
+        w.counter("autodiary_camera_recoveries_total", labels, health_recoveries[i].value());
+    }
+    w.type("autodiary_camera_recovery_failures_total", "counter");
+    for (int i = 0; i < CAMERA_ACTION_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "action=\"%s\"", ACTION_NAMES[i]);
+        w.counter("autodiary_camera_recovery_failures_total", labels, health_recovery_failures[i].value());
+    }
+    w.type("autodiary_camera_recovery_ms", "histogram");
+    for (int i = 0; i < CAMERA_ACTION_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "action=\"%s\"", ACTION_NAMES[i]);
+        w.histogram("autodiary_camera_recovery_ms", labels, health_recovery_ms[i]);
+    }
+    w.type("autodiary_camera_outage_ms", "histogram");
+    w.histogram("autodiary_camera_outage_ms", NULL, health_outage_ms);
+
+    int64_t last_good_us = health_last_good_us.load();
+    w.type("autodiary_camera_last_good_age_ms", "gauge");
+    w.gauge("autodiary_camera_last_good_age_ms", NULL,
+            last_good_us < 0 ? -1 : (double)((halNowUs() - last_good_us) / 1000));
+}
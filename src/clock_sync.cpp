@@ -0,0 +1,51 @@
+/**
+ * 设备时钟到墙上时间的映射实现
+ */
+
+#include "clock_sync.h"
+#include "hal.h"
+#include "seqlock.h"
+
+// 只由 HTTP 任务 (/time) 写入
+static SeqlockI64 host_offset_us{0};
+static SeqlockI64 host_sync_us{-1};
+
+void clockSyncBegin() {
+    halTimeSyncBegin(CLOCK_SNTP_SERVER);
+}
+
+ClockSource clockWallOffset(int64_t *offset_us) {
+    if (host_sync_us.load() >= 0) {
+        *offset_us = host_offset_us.load();
+        return CLOCK_SOURCE_HOST;
+    }
+    int64_t wall_us;
+    int64_t mono_us = halNowUs();
+    if (halWallClockUs(&wall_us)) {
+        *offset_us = wall_us - mono_us;
+        return CLOCK_SOURCE_SYSTEM;
+    }
+    *offset_us = 0;
+    return CLOCK_SOURCE_NONE;
+}
+
+bool clockSetHostTime(int64_t host_unix_us) {
+    if (host_unix_us < CLOCK_HOST_MIN_UNIX_US || host_unix_us > CLOCK_HOST_MAX_UNIX_US) return false;
+    int64_t now_us = halNowUs();
+    host_offset_us.store(host_unix_us - now_us);
+    host_sync_us.store(now_us);
+    return true;
+}
+
+int64_t clockHostSyncAgeMs() {
+    int64_t synced = host_sync_us.load();
+    return synced < 0 ? -1 : (halNowUs() - synced) / 1000;
+}
+
+const char *clockSourceName(ClockSource source) {
+    switch (source) {
+        case CLOCK_SOURCE_SYSTEM: return "system";
+        case CLOCK_SOURCE_HOST: return "host";
+        default: return "none";
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * 设备事件队列实现
+ */
+
+#include "events.h"
+#include "camera_health.h"
+#include <stdio.h>
+#include <atomic>
+
+static const char *const EVENT_TYPE_NAMES[EVENT_TYPE_COUNT] = {
+    "scene", "wifi", "camera", "vad", "motion", "storage_full", "low_heap"
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "槽位字段必须是无锁原子");
+
+// 槽位序号即顺序锁：0 表示写入中，内容字段用 relaxed 原子读写，由序号的 release / acquire 发布。
+// 时刻拆成两个 32 位半字 (Xtensa 上 64 位原子不是无锁的)，由同一个序号保证两半一致
+struct EventSlot {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> type{0};
+    std::atomic<uint32_t> time_lo{0};
+    std::atomic<uint32_t> time_hi{0};
+    std::atomic<int32_t> value{0};
+    std::atomic<uint32_t> ref{0};
+    std::atomic<uint32_t> segment{0};
+};
+
+static EventSlot event_ring[EVENT_QUEUE_SIZE];
+static std::atomic<uint32_t> event_last{0};         // 最新分配的序号
+static std::atomic<HalSemaphore> event_waiters[EVENT_MAX_WAITERS];
+
+static Counter event_counts[EVENT_TYPE_COUNT];
+static Counter event_read_retries;                  // 读者遇到正在写入 / 被覆盖的槽位
+
+const char *eventTypeName(EventType type) {
+    return type < EVENT_TYPE_COUNT ? EVENT_TYPE_NAMES[type] : "unknown";
+}
+
+void eventPublish(EventType type, int64_t timestamp_us, int32_t value, uint32_t ref, uint32_t segment) {
+    uint32_t seq = event_last.fetch_add(1) + 1;
+    EventSlot &slot = event_ring[seq % EVENT_QUEUE_SIZE];
+
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.type.store((uint32_t)type, std::memory_order_relaxed);
+    slot.time_lo.store((uint32_t)timestamp_us, std::memory_order_relaxed);
+    slot.time_hi.store((uint32_t)((uint64_t)timestamp_us >> 32), std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.ref.store(ref, std::memory_order_relaxed);
+    slot.segment.store(segment, std::memory_order_relaxed);
+    slot.seq.store(seq, std::memory_order_release);
+
+    event_counts[type].inc();
+    for (auto &waiter : event_waiters) {
+        HalSemaphore sem = waiter.load();
+        if (sem) halSemaphoreGive(sem);
+    }
+}
+
+// 复制一个槽位：返回复制前后一致时的槽位序号，写入中返回 0
+static uint32_t readSlot(const EventSlot &slot, Event *out) {
+    uint32_t before = slot.seq.load(std::memory_order_acquire);
+    if (before == 0) return 0;
+    out->type = (EventType)slot.type.load(std::memory_order_relaxed);
+    uint32_t lo = slot.time_lo.load(std::memory_order_relaxed);
+    uint32_t hi = slot.time_hi.load(std::memory_order_relaxed);
+    out->timestamp_us = (int64_t)(((uint64_t)hi << 32) | lo);
+    out->value = slot.value.load(std::memory_order_relaxed);
+    out->ref = slot.ref.load(std::memory_order_relaxed);
+    out->segment = slot.segment.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = slot.seq.load(std::memory_order_relaxed);
+    if (after != before) return 0;
+    out->seq = before;
+    return before;
+}
+
+int eventsRead(uint32_t after, Event *out, int max, uint32_t *oldest) {
+    uint32_t last = event_last.load(std::memory_order_acquire);
+    uint32_t first = last > EVENT_QUEUE_SIZE ? last - EVENT_QUEUE_SIZE + 1 : 1;
+    *oldest = last ? first : 0;
+    if (after + 1 > first) first = after + 1;
+
+    int n = 0;
+    for (uint32_t seq = first; seq <= last && n < max; seq++) {
+        uint32_t got = readSlot(event_ring[seq % EVENT_QUEUE_SIZE], &out[n]);
+        if (got == seq) {
+            n++;
+            continue;
+        }
+        event_read_retries.inc();
+        // 槽位已是更新一圈的事件：这一条被覆盖，跳过；否则 (写入中) 停在这里，下次再读
+        if (got != 0 && (int32_t)(got - seq) > 0) {
+            *oldest = seq + 1;
+            continue;
+        }
+        break;
+    }
+    return n;
+}
+
+uint32_t eventsLastSeq() {
+    return event_last.load(std::memory_order_acquire);
+}
+
+bool eventsAddWaiter(HalSemaphore sem) {
+    for (auto &waiter : event_waiters) {
+        HalSemaphore expected = NULL;
+        if (waiter.compare_exchange_strong(expected, sem)) return true;
+    }
+    return false;
+}
+
+void eventsRemoveWaiter(HalSemaphore sem) {
+    for (auto &waiter : event_waiters) {
+        HalSemaphore expected = sem;
+        waiter.compare_exchange_strong(expected, NULL);
+    }
+}
+
+int eventFormatJson(const Event &e, char *buf, size_t cap) {
+    int len = snprintf(buf, cap, "{\"seq\":%u,\"type\":\"%s\",\"capture_us\":%lld",
+                       (unsigned)e.seq, eventTypeName(e.type), (long long)e.timestamp_us);
+    if (len < 0 || (size_t)len >= cap) return len;
+    char *p = buf + len;
+    size_t room = cap - len;
+    int extra;
+    switch (e.type) {
+        case EVENT_SCENE:
+            extra = snprintf(p, room, ",\"score\":%d,\"frame\":%u}", (int)e.value, (unsigned)e.ref);
+            break;
+        case EVENT_WIFI:
+            extra = e.value ? snprintf(p, room, ",\"state\":\"connected\",\"down_ms\":%u}", (unsigned)e.ref)
+                            : snprintf(p, room, ",\"state\":\"disconnected\",\"reason\":%u}", (unsigned)e.ref);
+            break;
+        case EVENT_CAMERA:
+            if (e.value == CAMERA_HEALTH_RECOVERING) {
+                extra = snprintf(p, room, ",\"state\":\"%s\",\"action\":\"%s\"}",
+                                 cameraHealthStateName((CameraHealthState)e.value),
+                                 cameraHealthActionName((CameraRecoveryAction)e.ref));
+            } else if (e.value == CAMERA_HEALTH_OK) {
+                extra = snprintf(p, room, ",\"state\":\"%s\",\"outage_ms\":%u}",
+                                 cameraHealthStateName((CameraHealthState)e.value), (unsigned)e.ref);
+            } else {
+                extra = snprintf(p, room, ",\"state\":\"%s\"}", cameraHealthStateName((CameraHealthState)e.value));
+            }
+            break;
+        case EVENT_VAD:
+        case EVENT_MOTION:
+            if (!e.value) {
+                extra = snprintf(p, room, ",\"active\":false,\"duration_ms\":%u}", (unsigned)e.ref);
+            } else if (e.segment) {
+                extra = snprintf(p, room, ",\"active\":true,\"%s\":%u,\"segment\":%u}",
+                                 e.type == EVENT_VAD ? "level_db" : "area_permille", (unsigned)e.ref,
+                                 (unsigned)e.segment);
+            } else {
+                extra = snprintf(p, room, ",\"active\":true,\"%s\":%u}",
+                                 e.type == EVENT_VAD ? "level_db" : "area_permille", (unsigned)e.ref);
+            }
+            break;
+        case EVENT_STORAGE_FULL:
+            extra = snprintf(p, room, ",\"used_permille\":%d,\"free_kb\":%u}", (int)e.value, (unsigned)e.ref);
+            break;
+        case EVENT_LOW_HEAP:
+            extra = snprintf(p, room, ",\"free_bytes\":%d,\"largest_block\":%u}", (int)e.value, (unsigned)e.ref);
+            break;
+        default:
+            extra = snprintf(p, room, "}");
+            break;
+    }
+    return extra < 0 ? extra : len + extra;
+}
+
+void eventsRenderMetrics(MetricsWriter &w) {
+    char labels[32];
+    w.type("autodiary_events_total", "counter");
+    for (int i = 0; i < EVENT_TYPE_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "type=\"%s\"", EVENT_TYPE_NAMES[i]);
+        w.counter("autodiary_events_total", labels, event_counts[i].value());
+    }
+    w.type("autodiary_event_read_retries_total", "counter");
+    w.counter("autodiary_event_read_retries_total", NULL, event_read_retries.value());
+}
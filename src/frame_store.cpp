@@ -0,0 +1,383 @@
+/**
+ * 最新帧缓存实现
+ *
+ * 引用计数与最新槽位号都使用 seq_cst 原子操作：读者先增加引用计数再确认槽位仍是最新，
+ * 生产者先发布新的最新槽位再检查旧槽位的引用计数，两边的顺序保证生产者不会覆盖
+ * 读者已经确认持有的槽位。预录槽位同理：生产者先清除 kept 再检查引用计数，
+ * 读者先增加引用计数再确认 kept 仍为 true。缩略图槽位同理：生产者先把 seq 清零再检查
+ * 引用计数，读者先增加引用计数再确认 seq 仍是要找的帧。
+ */
+
+#include "frame_store.h"
+#include "metrics.h"
+#include "trace.h"
+#include "jpeg_thumb.h"
+#include "scene_detect.h"
+#include "motion_detect.h"
+#include "privacy_mask.h"
+#include "hal.h"
+#include "seqlock.h"
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+
+struct FrameSlot {
+    uint8_t *buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    int64_t timestamp_us;
+    uint32_t seq;
+    std::atomic<int> refs{0};
+    std::atomic<bool> kept{false};      // 预录保留中，生产者不会覆盖
+};
+
+static FrameSlot frame_slots[FRAME_STORE_MAX_SLOTS];
+static int frame_slot_count = 0;
+static size_t frame_slot_bytes = 0;
+static std::atomic<int> frame_latest{-1};
+static std::atomic<uint32_t> frame_seq{0};
+
+// 预录 FIFO (槽位下标)，只由生产者修改
+static int history[FRAME_PREROLL_FRAMES > 0 ? FRAME_PREROLL_FRAMES : 1];
+static int history_cap = 0;
+static int history_head = 0;
+static int history_len = 0;
+static int64_t history_last_us = -1;
+static std::atomic<int> history_count{0};
+static SeqlockI64 history_oldest_us{-1};
+
+struct ThumbSlot {
+    uint8_t *buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    uint16_t src_width;
+    uint16_t src_height;
+    int64_t timestamp_us;
+    std::atomic<uint32_t> seq{0};       // 0 表示空 / 正在写
+    std::atomic<int> refs{0};
+};
+
+static ThumbSlot thumb_slots[FRAME_THUMB_MAX_SLOTS];
+static int thumb_slot_count = 0;
+static size_t thumb_slot_bytes = 0;
+static int thumb_next = 0;                  // 下一个写入位置，只由生产者修改
+static uint8_t *thumb_work = NULL;          // DC 平面工作区，按需分配 (随分辨率增长)
+static size_t thumb_work_bytes = 0;
+static int64_t thumb_last_us = -1;
+
+bool frameStoreBegin(size_t slot_bytes, int preroll_frames) {
+    if (preroll_frames > FRAME_PREROLL_FRAMES) preroll_frames = FRAME_PREROLL_FRAMES;
+    if (preroll_frames < 0) preroll_frames = 0;
+    int count = FRAME_STORE_SLOTS + preroll_frames;
+    for (int i = 0; i < count; i++) {
+        frame_slots[i].buf = (uint8_t *)halAllocLarge(slot_bytes);
+        if (!frame_slots[i].buf) {
+            halLog("❌ 帧缓存分配失败 (%u 字节 x %d)\n", (unsigned)slot_bytes, count);
+            return false;
+        }
+    }
+    frame_slot_count = count;
+    history_cap = preroll_frames;
+    frame_slot_bytes = slot_bytes;
+    halLog("🎞️ 帧缓存: %d 个槽位 x %u KB (预录 %d 帧)\n",
+           count, (unsigned)(slot_bytes / 1024), preroll_frames);
+
+    // 缩略图分配失败不影响帧缓存本身
+    int thumbs = preroll_frames + FRAME_THUMB_SPARE;
+    size_t thumb_bytes = slot_bytes / 8;
+    for (int i = 0; i < thumbs; i++) {
+        thumb_slots[i].buf = (uint8_t *)halAllocLarge(thumb_bytes);
+        if (!thumb_slots[i].buf) {
+            halLog("⚠️ 缩略图缓存分配失败，仅保留 %d 个\n", i);
+            thumbs = i;
+            break;
+        }
+    }
+    thumb_slot_count = thumbs;
+    thumb_slot_bytes = thumb_bytes;
+    return true;
+}
+
+bool frameStoreReady() {
+    return frame_slot_bytes > 0;
+}
+
+size_t frameStoreSlotBytes() {
+    return frame_slot_bytes;
+}
+
+size_t frameStoreBytes() {
+    return frame_slot_bytes * frame_slot_count + thumb_slot_bytes * thumb_slot_count;
+}
+
+// 把刚发布的槽位加入预录 FIFO，满了先淘汰最旧的一帧
+static void keepForPreroll(int target, int64_t timestamp_us) {
+    if (history_cap == 0) return;
+    if (history_last_us >= 0 && timestamp_us - history_last_us < FRAME_PREROLL_INTERVAL_MS * 1000LL) {
+        return;
+    }
+    if (history_len == history_cap) {
+        frame_slots[history[history_head]].kept.store(false);
+        history_head = (history_head + 1) % history_cap;
+        history_len--;
+    }
+    frame_slots[target].kept.store(true);
+    history[(history_head + history_len) % history_cap] = target;
+    history_len++;
+    history_last_us = timestamp_us;
+
+    history_oldest_us.store(frame_slots[history[history_head]].timestamp_us);
+    history_count.store(history_len);
+}
+
+// 为刚发布的帧生成缩略图，写入环中下一个没有读者持有的槽位
+static void makeThumb(const FrameSlot &src) {
+    if (thumb_slot_count == 0) return;
+    if (thumb_last_us >= 0 && src.timestamp_us - thumb_last_us < FRAME_PREROLL_INTERVAL_MS * 1000LL) {
+        return;
+    }
+    thumb_last_us = src.timestamp_us;
+
+    size_t need = jpegThumbWorkBytes(src.width, src.height);
+    if (need > thumb_work_bytes) {
+        free(thumb_work);                       // halAllocLarge 的内存 (ps_malloc / malloc) 可直接 free
+        thumb_work = (uint8_t *)halAllocLarge(need);
+        thumb_work_bytes = thumb_work ? need : 0;
+        if (!thumb_work) {
+            metric_thumb_failures.inc();
+            return;
+        }
+    }
+
+    ThumbSlot *slot = NULL;
+    for (int i = 0; i < thumb_slot_count && !slot; i++) {
+        ThumbSlot &t = thumb_slots[(thumb_next + i) % thumb_slot_count];
+        if (t.refs.load() != 0) continue;
+        t.seq.store(0);
+        if (t.refs.load() != 0) continue;       // 清零前刚被读者持有，换下一个
+        slot = &t;
+        thumb_next = (int)(&t - thumb_slots + 1) % thumb_slot_count;
+    }
+    if (!slot) {
+        metric_thumb_failures.inc();
+        return;
+    }
+
+    int64_t start_us = halNowUs();
+    JpegThumb thumb;
+    bool ok = jpegThumbnail(src.buf, src.len, thumb_work, thumb_work_bytes, slot->buf, thumb_slot_bytes,
+                            JPEG_THUMB_QUALITY, &thumb);
+    uint32_t encode_us = (uint32_t)(halNowUs() - start_us);
+    traceRecord(TRACE_ENCODE, start_us, encode_us, ok ? (uint32_t)thumb.len : 0);
+    if (!ok) {
+        metric_thumb_failures.inc();
+        return;
+    }
+    metric_thumb_encode_us.observe(encode_us);
+
+    // 场景统计和运动检测沿用刚解出的 DC 平面
+    JpegDcPlanes planes;
+    jpegThumbPlanes(thumb_work, &planes);
+    sceneObserve(planes, src.timestamp_us, src.seq);
+    motionObserve(planes, src.timestamp_us);
+
+    slot->len = thumb.len;
+    slot->width = thumb.width;
+    slot->height = thumb.height;
+    slot->src_width = src.width;
+    slot->src_height = src.height;
+    slot->timestamp_us = src.timestamp_us;
+    slot->seq.store(src.seq);
+}
+
+bool frameStorePublish(const HalFrame &frame) {
+    if (frame.len > frame_slot_bytes) {
+        metric_frames_dropped.inc();
+        return false;
+    }
+
+    int latest = frame_latest.load();
+    int target = -1;
+    for (int i = 0; i < frame_slot_count; i++) {
+        if (i != latest && !frame_slots[i].kept.load() && frame_slots[i].refs.load() == 0) {
+            target = i;
+            break;
+        }
+    }
+    if (target < 0) {
+        metric_frames_dropped.inc();
+        return false;
+    }
+
+    // 隐私遮挡在复制时完成 (没有遮挡区域时就是 memcpy)，遮挡失败的帧不发布
+    FrameSlot &slot = frame_slots[target];
+    size_t len = privacyMaskCopy(frame.buf, frame.len, frame.width, frame.height, slot.buf,
+                                 frame_slot_bytes);
+    if (len == 0) {
+        metric_frames_dropped.inc();
+        return false;
+    }
+    slot.len = len;
+    slot.width = frame.width;
+    slot.height = frame.height;
+    slot.timestamp_us = frame.timestamp_us;
+    slot.seq = frame_seq.load() + 1;
+
+    frame_latest.store(target);
+    frame_seq.store(slot.seq);
+    keepForPreroll(target, slot.timestamp_us);
+    makeThumb(slot);
+    return true;
+}
+
+static void fillRef(FrameRef *ref, int idx) {
+    const FrameSlot &slot = frame_slots[idx];
+    ref->buf = slot.buf;
+    ref->len = slot.len;
+    ref->width = slot.width;
+    ref->height = slot.height;
+    ref->timestamp_us = slot.timestamp_us;
+    ref->seq = slot.seq;
+    ref->slot = (uint8_t)idx;
+}
+
+bool frameStoreAcquire(FrameRef *ref) {
+    while (1) {
+        int idx = frame_latest.load();
+        if (idx < 0) return false;
+
+        FrameSlot &slot = frame_slots[idx];
+        slot.refs.fetch_add(1);
+        if (frame_latest.load() != idx) {
+            // 期间已发布了新帧，该槽位可能正在被覆盖，重试
+            slot.refs.fetch_sub(1);
+            continue;
+        }
+
+        fillRef(ref, idx);
+        return true;
+    }
+}
+
+void frameStoreRelease(FrameRef *ref) {
+    if (ref->buf) {
+        frame_slots[ref->slot].refs.fetch_sub(1);
+        ref->buf = NULL;
+    }
+}
+
+uint32_t frameStoreSeq() {
+    return frame_seq.load();
+}
+
+int frameStoreAcquireHistory(int64_t since_us, FrameRef *refs, int max) {
+    int n = 0;
+    for (int i = 0; i < frame_slot_count && n < max; i++) {
+        FrameSlot &slot = frame_slots[i];
+        if (!slot.kept.load()) continue;
+        slot.refs.fetch_add(1);
+        if (!slot.kept.load() || slot.timestamp_us < since_us) {
+            slot.refs.fetch_sub(1);
+            continue;
+        }
+        fillRef(&refs[n++], i);
+    }
+
+    // 按帧序号排序 (最多 FRAME_PREROLL_FRAMES 个，插入排序)
+    for (int i = 1; i < n; i++) {
+        FrameRef key = refs[i];
+        int j = i - 1;
+        while (j >= 0 && refs[j].seq > key.seq) {
+            refs[j + 1] = refs[j];
+            j--;
+        }
+        refs[j + 1] = key;
+    }
+    return n;
+}
+
+int frameStoreHistoryCount() {
+    return history_count.load();
+}
+
+int64_t frameStoreHistoryOldestUs() {
+    return history_oldest_us.load();
+}
+
+// ==================== 缩略图 ====================
+
+bool frameStoreAcquireThumb(uint32_t seq, FrameRef *ref) {
+    // seq 为 0 时先找当前最新的缩略图序号
+    if (seq == 0) {
+        for (int i = 0; i < thumb_slot_count; i++) {
+            uint32_t s = thumb_slots[i].seq.load();
+            if (s > seq) seq = s;
+        }
+        if (seq == 0) return false;
+    }
+
+    for (int i = 0; i < thumb_slot_count; i++) {
+        ThumbSlot &slot = thumb_slots[i];
+        if (slot.seq.load() != seq) continue;
+        slot.refs.fetch_add(1);
+        if (slot.seq.load() != seq) {
+            slot.refs.fetch_sub(1);
+            return false;
+        }
+        ref->buf = slot.buf;
+        ref->len = slot.len;
+        ref->width = slot.width;
+        ref->height = slot.height;
+        ref->timestamp_us = slot.timestamp_us;
+        ref->seq = seq;
+        ref->slot = (uint8_t)i;
+        return true;
+    }
+    return false;
+}
+
+void frameStoreReleaseThumb(FrameRef *ref) {
+    if (ref->buf) {
+        thumb_slots[ref->slot].refs.fetch_sub(1);
+        ref->buf = NULL;
+    }
+}
+
+static bool frameKept(uint32_t seq) {
+    for (int i = 0; i < frame_slot_count; i++) {
+        if (frame_slots[i].kept.load() && frame_slots[i].seq == seq) return true;
+    }
+    return false;
+}
+
+int frameStoreListThumbs(FrameThumbInfo *infos, int max) {
+    int n = 0;
+    for (int i = 0; i < thumb_slot_count && n < max; i++) {
+        FrameRef ref;
+        uint32_t seq = thumb_slots[i].seq.load();
+        if (seq == 0 || !frameStoreAcquireThumb(seq, &ref)) continue;
+        FrameThumbInfo &info = infos[n++];
+        info.seq = seq;
+        info.timestamp_us = ref.timestamp_us;
+        info.width = ref.width;
+        info.height = ref.height;
+        info.src_width = thumb_slots[i].src_width;
+        info.src_height = thumb_slots[i].src_height;
+        info.len = ref.len;
+        info.kept = frameKept(seq);
+        frameStoreReleaseThumb(&ref);
+    }
+
+    for (int i = 1; i < n; i++) {
+        FrameThumbInfo key = infos[i];
+        int j = i - 1;
+        while (j >= 0 && infos[j].seq > key.seq) {
+            infos[j + 1] = infos[j];
+            j--;
+        }
+        infos[j + 1] = key;
+    }
+    return n;
+}
@@ -0,0 +1,497 @@
+/**
+ * HAL - ESP32-S3 实现 (esp_camera / I2S / esp_timer / FreeRTOS / SPIFFS)
+ *
+ * 只在 ESP32 环境编译 (见 platformio.ini 的 build_src_filter)。
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_camera.h>
+#include <esp_timer.h>
+#include <esp_wifi.h>
+#include <esp_pm.h>
+#include <esp_heap_caps.h>
+#include <I2S.h>
+#include <SPIFFS.h>
+#include <FS.h>
+#include <stdarg.h>
+#include <sys/time.h>
+#include "camera_pins.h"
+#include "hal.h"
+#include "wifi_manager.h"
+
+// 摄像头配置
+static camera_config_t config;
+static bool camera_ready = false;
+static uint32_t camera_xclk_hz = 20000000;
+static bool mic_ready = false;
+
+// ==================== 日志 ====================
+
+void halLog(const char *fmt, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    Serial.print(line);
+}
+
+// ==================== 时钟 ====================
+
+int64_t halNowUs() {
+    return esp_timer_get_time();
+}
+
+uint32_t halMillis() {
+    return millis();
+}
+
+void halDelayMs(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+bool halWallClockUs(int64_t *unix_us) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if (tv.tv_sec < 1600000000) return false;   // 仍在 1970 年附近，SNTP 尚未完成
+    *unix_us = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+    return true;
+}
+
+void halTimeSyncBegin(const char *server) {
+    // lwIP SNTP 在后台运行，WiFi 连上后自动完成首次同步，之后每小时校准一次
+    configTime(0, 0, server);
+}
+
+// ==================== 任务 ====================
+
+bool halTaskCreate(HalTaskFn fn, const char *name, uint32_t stack_size,
+                   void *arg, int priority, int core, void **handle_out) {
+    TaskHandle_t handle = NULL;
+    BaseType_t ok = xTaskCreatePinnedToCore(fn, name, stack_size, arg, priority, &handle, core);
+    if (handle_out) *handle_out = handle;
+    return ok == pdPASS;
+}
+
+void halTaskExit() {
+    vTaskDelete(NULL);
+}
+
+int halCoreId() {
+    return xPortGetCoreID();
+}
+
+HalSemaphore halSemaphoreCreate() {
+    return xSemaphoreCreateBinary();
+}
+
+void halSemaphoreGive(HalSemaphore sem) {
+    xSemaphoreGive((SemaphoreHandle_t)sem);
+}
+
+bool halSemaphoreTake(HalSemaphore sem, uint32_t timeout_ms) {
+    return xSemaphoreTake((SemaphoreHandle_t)sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+// ==================== 摄像头 ====================
+
+bool halCameraBegin() {
+    Serial.println("========== 摄像头初始化开始 ==========");
+
+    // [DEBUG] 检查 PSRAM
+    Serial.printf("[DEBUG] PSRAM 可用: %s\n", psramFound() ? "是" : "否");
+    if (psramFound()) {
+        Serial.printf("[DEBUG] PSRAM 大小: %d bytes\n", ESP.getPsramSize());
+        Serial.printf("[DEBUG] PSRAM 空闲: %d bytes\n", ESP.getFreePsram());
+    }
+    Serial.printf("[DEBUG] 堆内存空闲: %d bytes\n", ESP.getFreeHeap());
+
+    Serial.println("[DEBUG] 配置摄像头引脚...");
+    Serial.printf("[DEBUG] XCLK=%d, PCLK=%d, VSYNC=%d, HREF=%d\n",
+                  XCLK_GPIO_NUM, PCLK_GPIO_NUM, VSYNC_GPIO_NUM, HREF_GPIO_NUM);
+    Serial.printf("[DEBUG] SIOD=%d, SIOC=%d, PWDN=%d, RESET=%d\n",
+                  SIOD_GPIO_NUM, SIOC_GPIO_NUM, PWDN_GPIO_NUM, RESET_GPIO_NUM);
+    Serial.printf("[DEBUG] Y2-Y9: %d,%d,%d,%d,%d,%d,%d,%d\n",
+                  Y2_GPIO_NUM, Y3_GPIO_NUM, Y4_GPIO_NUM, Y5_GPIO_NUM,
+                  Y6_GPIO_NUM, Y7_GPIO_NUM, Y8_GPIO_NUM, Y9_GPIO_NUM);
+
+    // 按照参考项目的配置顺序
+    config.ledc_channel = LEDC_CHANNEL_0;
+    config.ledc_timer = LEDC_TIMER_0;
+    config.pin_d0 = Y2_GPIO_NUM;
+    config.pin_d1 = Y3_GPIO_NUM;
+    config.pin_d2 = Y4_GPIO_NUM;
+    config.pin_d3 = Y5_GPIO_NUM;
+    config.pin_d4 = Y6_GPIO_NUM;
+    config.pin_d5 = Y7_GPIO_NUM;
+    config.pin_d6 = Y8_GPIO_NUM;
+    config.pin_d7 = Y9_GPIO_NUM;
+    config.pin_xclk = XCLK_GPIO_NUM;
+    config.pin_pclk = PCLK_GPIO_NUM;
+    config.pin_vsync = VSYNC_GPIO_NUM;
+    config.pin_href = HREF_GPIO_NUM;
+    config.pin_sccb_sda = SIOD_GPIO_NUM;  // 新版 API
+    config.pin_sccb_scl = SIOC_GPIO_NUM;  // 新版 API
+    config.pin_pwdn = PWDN_GPIO_NUM;
+    config.pin_reset = RESET_GPIO_NUM;
+    config.xclk_freq_hz = camera_xclk_hz;
+
+    // 摄像头配置 - 使用较低分辨率确保稳定性
+    config.pixel_format = PIXFORMAT_JPEG;
+    // DRAM 单缓冲时用 WHEN_EMPTY：只有一块缓冲，取走之后驱动才写入下一帧
+    config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
+
+    // 根据 PSRAM 可用性选择配置
+    // frame_size 决定帧缓冲大小，是运行时可切换的分辨率上限；实际分辨率由 halCameraApply 设置
+    if (psramFound()) {
+        // UXGA (1600x1200) 的缓冲，默认工作在 VGA；双流的静态照片可以切到全分辨率
+        config.frame_size = FRAMESIZE_UXGA;
+        config.fb_location = CAMERA_FB_IN_PSRAM;
+        config.jpeg_quality = 10;  // 更高质量
+        config.fb_count = 2;
+        // 视频任务持续取帧，双缓冲时用 GRAB_LATEST 保证拿到的总是最新一帧
+        config.grab_mode = CAMERA_GRAB_LATEST;
+        Serial.println("[DEBUG] 使用 PSRAM 配置");
+    } else {
+        config.frame_size = FRAMESIZE_QVGA;  // 320x240，无 PSRAM 时使用
+        config.fb_location = CAMERA_FB_IN_DRAM;
+        config.jpeg_quality = 12;
+        config.fb_count = 1;
+        Serial.println("[DEBUG] 使用 DRAM 配置 (无 PSRAM)");
+    }
+
+    Serial.println("[DEBUG] 正在调用 esp_camera_init()...");
+    esp_err_t err = esp_camera_init(&config);
+
+    if (err == ESP_OK) {
+        camera_ready = true;
+        Serial.println("✅ 摄像头初始化成功！");
+
+        sensor_t * s = esp_camera_sensor_get();
+        if (s) {
+            Serial.printf("[DEBUG] 摄像头 PID: 0x%X\n", s->id.PID);
+            Serial.printf("摄像头型号: %s\n", s->id.PID == OV2640_PID ? "OV2640" : "Unknown");
+
+            // 调整摄像头参数以获得更好的图像质量
+            s->set_brightness(s, 0);     // 亮度 (-2 to 2)
+            s->set_contrast(s, 0);       // 对比度 (-2 to 2)
+            s->set_saturation(s, 0);     // 饱和度 (-2 to 2)
+            s->set_whitebal(s, 1);       // 自动白平衡
+            s->set_awb_gain(s, 1);       // 自动白平衡增益
+            s->set_exposure_ctrl(s, 1);  // 自动曝光
+            s->set_aec2(s, 0);           // AEC DSP
+            s->set_gain_ctrl(s, 1);      // 自动增益
+        }
+
+        // 测试拍照
+        Serial.println("[DEBUG] 测试摄像头捕获...");
+        camera_fb_t * test_fb = esp_camera_fb_get();
+        if (test_fb) {
+            Serial.printf("[DEBUG] 测试帧捕获成功: %d bytes, %dx%d\n",
+                          test_fb->len, test_fb->width, test_fb->height);
+            esp_camera_fb_return(test_fb);
+        } else {
+            Serial.println("[ERROR] 测试帧捕获失败！");
+            Serial.printf("[DEBUG] 当前堆内存: %d bytes\n", ESP.getFreeHeap());
+            if (psramFound()) {
+                Serial.printf("[DEBUG] 当前 PSRAM: %d bytes\n", ESP.getFreePsram());
+            }
+        }
+    } else {
+        Serial.printf("❌ 摄像头初始化失败: 0x%x\n", err);
+        Serial.println("[DEBUG] 错误代码说明:");
+        switch(err) {
+            case ESP_ERR_NOT_FOUND:
+                Serial.println("  - ESP_ERR_NOT_FOUND: 未检测到摄像头");
+                break;
+            case ESP_ERR_NOT_SUPPORTED:
+                Serial.println("  - ESP_ERR_NOT_SUPPORTED: 摄像头不支持");
+                break;
+            case ESP_ERR_NO_MEM:
+                Serial.println("  - ESP_ERR_NO_MEM: 内存不足");
+                break;
+            case ESP_ERR_INVALID_STATE:
+                Serial.println("  - ESP_ERR_INVALID_STATE: 无效状态");
+                break;
+            default:
+                Serial.printf("  - 未知错误: 0x%x\n", err);
+        }
+    }
+
+    Serial.printf("[DEBUG] 初始化后堆内存: %d bytes\n", ESP.getFreeHeap());
+    Serial.println("========== 摄像头初始化结束 ==========\n");
+    return camera_ready;
+}
+
+bool halCameraReady() {
+    return camera_ready;
+}
+
+bool halCameraGrab(HalFrame *frame) {
+    camera_fb_t *fb = esp_camera_fb_get();
+    if (!fb) return false;
+    frame->buf = fb->buf;
+    frame->len = fb->len;
+    frame->width = fb->width;
+    frame->height = fb->height;
+    // 驱动在帧 DMA 完成 (VSYNC) 时用 esp_timer_get_time() 填写 fb->timestamp，
+    // 比取到帧的时刻更接近曝光时间 (GRAB_LATEST 下帧可能已在队列中等待一个帧周期)
+    int64_t now_us = esp_timer_get_time();
+    int64_t vsync_us = (int64_t)fb->timestamp.tv_sec * 1000000LL + fb->timestamp.tv_usec;
+    frame->timestamp_us = vsync_us > 0 && vsync_us <= now_us ? vsync_us : now_us;
+    frame->priv = fb;
+    return true;
+}
+
+void halCameraRelease(HalFrame *frame) {
+    if (frame->priv) {
+        esp_camera_fb_return((camera_fb_t *)frame->priv);
+        frame->priv = NULL;
+    }
+}
+
+// 按 halCameraBegin 保存的 config 重新初始化；传感器寄存器回到默认值，调用者随后用 halCameraApply 恢复参数
+static bool cameraInitAgain(const char *what) {
+    esp_err_t err = esp_camera_init(&config);
+    if (err != ESP_OK) {
+        Serial.printf("[ERROR] %s失败: 0x%x\n", what, err);
+        camera_ready = false;
+        return false;
+    }
+    camera_ready = true;
+    return true;
+}
+
+bool halCameraReinit() {
+    esp_camera_deinit();
+    camera_ready = false;
+    delay(100);
+    return cameraInitAgain("重新初始化");
+}
+
+bool halCameraSoftReset() {
+    sensor_t * s = esp_camera_sensor_get();
+    return camera_ready && s && s->reset(s) == 0;
+}
+
+bool halCameraPowerCycle() {
+    esp_camera_deinit();
+    camera_ready = false;
+    // PWDN 高电平时传感器断电；esp_camera_init 会重新拉低 PWDN 并脉冲 RESET
+    if (PWDN_GPIO_NUM >= 0) {
+        pinMode(PWDN_GPIO_NUM, OUTPUT);
+        digitalWrite(PWDN_GPIO_NUM, HIGH);
+    }
+    delay(500);
+    return cameraInitAgain("断电重启");
+}
+
+bool halCameraSetXclk(uint32_t mhz) {
+    camera_xclk_hz = mhz * 1000000;
+    config.xclk_freq_hz = camera_xclk_hz;   // 重新初始化时沿用
+    if (!camera_ready) return true;
+    sensor_t * s = esp_camera_sensor_get();
+    return s && s->set_xclk(s, LEDC_TIMER_0, mhz) == 0;
+}
+
+static const framesize_t FRAME_SIZES[HAL_FRAME_SIZE_COUNT] = {
+    FRAMESIZE_QQVGA, FRAMESIZE_QVGA, FRAMESIZE_VGA, FRAMESIZE_SVGA,
+    FRAMESIZE_XGA, FRAMESIZE_SXGA, FRAMESIZE_UXGA,
+};
+
+bool halCameraApply(const HalCameraSettings &settings) {
+    sensor_t * s = esp_camera_sensor_get();
+    if (!camera_ready || !s || settings.frame_size > halCameraMaxFrameSize()) return false;
+
+    // set_* 返回 0 表示成功；逐项执行，某一项失败不影响其余项
+    int failed = 0;
+    failed += s->set_framesize(s, FRAME_SIZES[settings.frame_size]) != 0;
+    if (settings.zoom_w) {
+        // 数码变焦：set_framesize 已把窗口恢复为全幅，这里改为 UXGA 模式下的子窗口，
+        // 由传感器的 DSP 缩放到输出分辨率 (UXGA 模式帧率低于 SVGA / CIF 模式)
+        const resolution_info_t &out = resolution[FRAME_SIZES[settings.frame_size]];
+        failed += s->set_res_raw(s, 0, 0, 0, 0, settings.zoom_x, settings.zoom_y,
+                                 settings.zoom_w, settings.zoom_h, out.width, out.height,
+                                 false, false) != 0;
+    }
+    failed += s->set_quality(s, settings.quality) != 0;
+    failed += s->set_exposure_ctrl(s, settings.auto_exposure ? 1 : 0) != 0;
+    failed += s->set_ae_level(s, settings.ae_level) != 0;
+    if (!settings.auto_exposure) failed += s->set_aec_value(s, settings.exposure) != 0;
+    failed += s->set_whitebal(s, settings.awb ? 1 : 0) != 0;
+    failed += s->set_awb_gain(s, settings.awb ? 1 : 0) != 0;
+    if (settings.awb) failed += s->set_wb_mode(s, settings.wb_mode) != 0;
+    failed += s->set_gain_ctrl(s, settings.auto_gain ? 1 : 0) != 0;
+    failed += s->set_gainceiling(s, (gainceiling_t)settings.gain_ceiling) != 0;
+    if (!settings.auto_gain) failed += s->set_agc_gain(s, settings.gain) != 0;
+    return failed == 0;
+}
+
+HalFrameSize halCameraMaxFrameSize() {
+    for (int i = HAL_FRAME_SIZE_COUNT - 1; i >= 0; i--) {
+        if (FRAME_SIZES[i] == config.frame_size) return (HalFrameSize)i;
+    }
+    return HAL_FRAME_QVGA;
+}
+
+// ==================== 麦克风 ====================
+
+bool halMicBegin(uint32_t sample_rate, uint32_t block_samples) {
+    Serial.println("配置 I2S...");
+    Serial.printf("WS (Word Select): GPIO 42\n");
+    Serial.printf("SCK (Serial Clock): GPIO 41\n");
+
+    I2S.setAllPins(-1, 42, 41, -1, -1);
+    I2S.setBufferSize(block_samples);  // DMA 缓冲 (帧数)
+
+    if (!I2S.begin(PDM_MONO_MODE, sample_rate, 16)) {
+        Serial.println("❌ I2S 初始化失败");
+        return false;
+    }
+
+    mic_ready = true;
+    Serial.println("✅ I2S 麦克风初始化成功");
+    Serial.printf("采样率: %u Hz\n", sample_rate);
+    Serial.printf("通道: 单声道\n");
+    return true;
+}
+
+bool halMicReady() {
+    return mic_ready;
+}
+
+int halMicRead(int16_t *dst, size_t max_samples) {
+    int bytes = I2S.read(dst, max_samples * sizeof(int16_t));
+    if (bytes < 0) return -1;
+    return bytes / (int)sizeof(int16_t);
+}
+
+// ==================== 存储 ====================
+
+// SPIFFS 在第一次访问时才挂载，不占用启动时间 (挂载 / 首次格式化可达数百毫秒)
+static SemaphoreHandle_t storage_mutex = NULL;
+static portMUX_TYPE storage_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool storage_mounted = false;
+
+static bool ensureMounted() {
+    if (storage_mounted) return true;
+    if (storage_mutex == NULL) {
+        // 临界区内不能分配内存：先创建，再只让第一个调用者的互斥量生效
+        SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+        portENTER_CRITICAL(&storage_mux);
+        if (storage_mutex == NULL) {
+            storage_mutex = mutex;
+            mutex = NULL;
+        }
+        portEXIT_CRITICAL(&storage_mux);
+        if (mutex) vSemaphoreDelete(mutex);
+    }
+    xSemaphoreTake(storage_mutex, portMAX_DELAY);
+    if (!storage_mounted) {
+        int64_t start_us = esp_timer_get_time();
+        storage_mounted = SPIFFS.begin(true);
+        Serial.printf("%s SPIFFS 挂载 (%lld ms)\n", storage_mounted ? "✅" : "❌",
+                      (long long)((esp_timer_get_time() - start_us) / 1000));
+    }
+    xSemaphoreGive(storage_mutex);
+    return storage_mounted;
+}
+
+bool halStorageBegin() {
+    return ensureMounted();
+}
+
+bool halStorageWrite(const char *path, const uint8_t *data, size_t len) {
+    if (!ensureMounted()) return false;
+    File file = SPIFFS.open(path, FILE_WRITE);
+    if (!file) return false;
+    size_t written = file.write(data, len);
+    file.close();
+    return written == len;
+}
+
+long halStorageSize(const char *path) {
+    if (!ensureMounted()) return -1;
+    File file = SPIFFS.open(path, "r");
+    if (!file) return -1;
+    long size = (long)file.size();
+    file.close();
+    return size;
+}
+
+size_t halStorageRead(const char *path, size_t offset, uint8_t *buf, size_t len) {
+    if (!ensureMounted()) return 0;
+    File file = SPIFFS.open(path, "r");
+    if (!file) return 0;
+    size_t n = 0;
+    if (file.seek(offset)) {
+        n = file.read(buf, len);
+    }
+    file.close();
+    return n;
+}
+
+bool halStorageUsage(uint64_t *used, uint64_t *total) {
+    if (!ensureMounted()) return false;
+    *used = SPIFFS.usedBytes();
+    *total = SPIFFS.totalBytes();
+    return *total > 0;
+}
+
+// ==================== 电源 ====================
+
+bool halWifiSetPowerSave(HalWifiPowerSave mode, uint8_t listen_interval) {
+    wifi_ps_type_t ps = mode == HAL_WIFI_PS_NONE ? WIFI_PS_NONE :
+                        mode == HAL_WIFI_PS_MIN_MODEM ? WIFI_PS_MIN_MODEM : WIFI_PS_MAX_MODEM;
+    // listen interval 写在关联请求里，由 WiFi 管理任务在下次关联时带上
+    wifiManagerSetListenInterval(mode == HAL_WIFI_PS_MAX_MODEM ? listen_interval : 0);
+    return esp_wifi_set_ps(ps) == ESP_OK;
+}
+
+bool halCpuSetFrequency(uint32_t max_mhz, uint32_t min_mhz, bool light_sleep) {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32s3_t pm;
+    pm.max_freq_mhz = max_mhz;
+    pm.min_freq_mhz = min_mhz;
+    pm.light_sleep_enable = light_sleep;
+    if (esp_pm_configure(&pm) == ESP_OK) return true;
+#endif
+    setCpuFrequencyMhz(max_mhz);
+    return false;
+}
+
+uint32_t halCpuFrequencyMhz() {
+    return getCpuFrequencyMhz();
+}
+
+// ==================== 系统 / 网络状态 ====================
+
+bool halWifiConnected() {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+int halWifiRssi() {
+    return WiFi.RSSI();
+}
+
+void halLocalIp(char *buf, size_t len) {
+    IPAddress ip = WiFi.localIP();      // 不经过 String，避免每次请求都在堆上分配
+    snprintf(buf, len, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+bool halPsramFound() {
+    return psramFound();
+}
+
+void *halAllocLarge(size_t size) {
+    return psramFound() ? ps_malloc(size) : malloc(size);
+}
+
+void *halAllocInternal(size_t size) {
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+void halRestart() {
+    ESP.restart();
+}
@@ -0,0 +1,508 @@
+/**
+ * HAL - 主机实现 (JPEG 文件回放 / WAV 文件回放 / CLOCK_MONOTONIC / std::thread)
+ *
+ * 只在 native 环境编译 (见 platformio.ini 的 build_src_filter)。
+ * 摄像头和麦克风都按真实速率回放，HTTP、采集环、流任务的行为与设备上一致，
+ * 可以直接用 scripts/test/ 下的基准脚本对 127.0.0.1 做测试。
+ */
+
+#include "hal.h"
+#include "hal_native.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+static HalNativeConfig native_config = { "test/fixtures/scene_vga_422.jpg", NULL, 10, ".native_fs", 0, 0 };
+
+// ==================== 日志 ====================
+
+void halLog(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+// ==================== 时钟 ====================
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+// 与 esp_timer 一样从 "开机" (进程启动) 开始计时
+static const int64_t process_start_us = monotonicUs();
+
+int64_t halNowUs() {
+    return monotonicUs() - process_start_us;
+}
+
+uint32_t halMillis() {
+    return (uint32_t)(halNowUs() / 1000);
+}
+
+void halDelayMs(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool halWallClockUs(int64_t *unix_us) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    *unix_us = (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+    return true;
+}
+
+void halTimeSyncBegin(const char *server) {
+}
+
+static void sleepUntilUs(int64_t deadline_us) {
+    int64_t now = halNowUs();
+    if (deadline_us > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(deadline_us - now));
+    }
+}
+
+// ==================== 任务 ====================
+
+bool halTaskCreate(HalTaskFn fn, const char *name, uint32_t stack_size,
+                   void *arg, int priority, int core, void **handle_out) {
+    // 主机上不绑核、不设优先级，任务就是分离的线程
+    std::thread(fn, arg).detach();
+    if (handle_out) *handle_out = NULL;
+    return true;
+}
+
+void halTaskExit() {
+}
+
+int halCoreId() {
+    // 映射到两个 "核心"，追踪导出的 pid 与设备上的含义一致
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : cpu % 2;
+}
+
+struct NativeSemaphore {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool given = false;
+};
+
+HalSemaphore halSemaphoreCreate() {
+    return new NativeSemaphore;
+}
+
+void halSemaphoreGive(HalSemaphore sem) {
+    NativeSemaphore *s = (NativeSemaphore *)sem;
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->given = true;
+    }
+    s->cv.notify_one();
+}
+
+bool halSemaphoreTake(HalSemaphore sem, uint32_t timeout_ms) {
+    NativeSemaphore *s = (NativeSemaphore *)sem;
+    std::unique_lock<std::mutex> lock(s->mutex);
+    if (!s->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [s] { return s->given; })) {
+        return false;
+    }
+    s->given = false;
+    return true;
+}
+
+// ==================== 摄像头 ====================
+
+struct NativeFrame {
+    std::vector<uint8_t> data;
+    uint16_t width;
+    uint16_t height;
+};
+
+static std::vector<NativeFrame> camera_frames;
+static std::mutex camera_mutex;
+static size_t camera_next = 0;
+static int64_t camera_next_us = 0;
+static bool camera_ready = false;
+static uint16_t camera_width = 0;       // halCameraApply 设置的分辨率 (0 表示不限)
+static uint16_t camera_height = 0;
+
+static bool readFile(const std::string &path, std::vector<uint8_t> &out) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(f);
+        return false;
+    }
+    out.resize((size_t)size);
+    size_t n = fread(out.data(), 1, out.size(), f);
+    fclose(f);
+    return n == out.size();
+}
+
+// 从 SOF0/SOF2 段读取图像尺寸
+static void jpegDimensions(const std::vector<uint8_t> &jpg, uint16_t *width, uint16_t *height) {
+    *width = 0;
+    *height = 0;
+    size_t i = 2;
+    while (i + 9 < jpg.size()) {
+        if (jpg[i] != 0xFF) { i++; continue; }
+        uint8_t marker = jpg[i + 1];
+        uint16_t seg_len = (uint16_t)((jpg[i + 2] << 8) | jpg[i + 3]);
+        if (marker == 0xC0 || marker == 0xC2) {
+            *height = (uint16_t)((jpg[i + 5] << 8) | jpg[i + 6]);
+            *width = (uint16_t)((jpg[i + 7] << 8) | jpg[i + 8]);
+            return;
+        }
+        i += 2 + seg_len;
+    }
+}
+
+static void addFrame(const std::string &path) {
+    NativeFrame frame;
+    if (!readFile(path, frame.data) || frame.data.size() < 4 ||
+        frame.data[0] != 0xFF || frame.data[1] != 0xD8) {
+        halLog("[WARN] 跳过非 JPEG 文件: %s\n", path.c_str());
+        return;
+    }
+    jpegDimensions(frame.data, &frame.width, &frame.height);
+    camera_frames.push_back(std::move(frame));
+}
+
+bool halCameraBegin() {
+    const char *path = native_config.jpeg_path;
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        halLog("❌ 摄像头回放源不存在: %s\n", path);
+        return false;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        std::vector<std::string> names;
+        DIR *dir = opendir(path);
+        if (dir) {
+            struct dirent *e;
+            while ((e = readdir(dir)) != NULL) {
+                const char *dot = strrchr(e->d_name, '.');
+                if (dot && (strcasecmp(dot, ".jpg") == 0 || strcasecmp(dot, ".jpeg") == 0)) {
+                    names.push_back(e->d_name);
+                }
+            }
+            closedir(dir);
+        }
+        std::sort(names.begin(), names.end());
+        for (const std::string &name : names) {
+            addFrame(std::string(path) + "/" + name);
+        }
+    } else {
+        addFrame(path);
+    }
+
+    camera_ready = !camera_frames.empty();
+    if (camera_ready) {
+        halLog("✅ 摄像头回放: %u 帧, %u fps (%s)\n",
+               (unsigned)camera_frames.size(), native_config.fps, path);
+    } else {
+        halLog("❌ 摄像头回放源中没有 JPEG: %s\n", path);
+    }
+    return camera_ready;
+}
+
+bool halCameraReady() {
+    return camera_ready;
+}
+
+// 在 --camera-fault 指定的时间窗口内模拟取帧失败
+static bool cameraFaultActive() {
+    if (native_config.camera_fault_ms == 0) return false;
+    int64_t now_ms = halNowUs() / 1000;
+    return now_ms >= native_config.camera_fault_after_ms &&
+           now_ms < (int64_t)native_config.camera_fault_after_ms + native_config.camera_fault_ms;
+}
+
+bool halCameraGrab(HalFrame *frame) {
+    if (!camera_ready) return false;
+    if (cameraFaultActive()) {
+        halDelayMs(100);
+        return false;
+    }
+
+    // 按帧率节拍出帧，模拟 CAMERA_GRAB_WHEN_EMPTY 下等待下一帧的延迟
+    int64_t due_us;
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(camera_mutex);
+        int64_t period_us = 1000000LL / (native_config.fps ? native_config.fps : 1);
+        int64_t now = halNowUs();
+        if (camera_next_us < now) camera_next_us = now;
+        due_us = camera_next_us;
+        camera_next_us += period_us;
+        // 回放源中有当前分辨率的帧时只回放这些帧 (模拟切换分辨率)，否则按顺序回放全部
+        index = camera_next++ % camera_frames.size();
+        for (size_t i = 0; i < camera_frames.size(); i++) {
+            size_t k = (index + i) % camera_frames.size();
+            if (camera_frames[k].width == camera_width && camera_frames[k].height == camera_height) {
+                camera_next = k + 1;
+                index = k;
+                break;
+            }
+        }
+    }
+    sleepUntilUs(due_us);
+
+    NativeFrame &f = camera_frames[index];
+    frame->buf = f.data.data();
+    frame->len = f.data.size();
+    frame->width = f.width;
+    frame->height = f.height;
+    frame->timestamp_us = halNowUs();
+    frame->priv = NULL;
+    return true;
+}
+
+void halCameraRelease(HalFrame *frame) {
+    frame->priv = NULL;
+}
+
+bool halCameraReinit() {
+    return camera_ready;
+}
+
+bool halCameraSoftReset() {
+    return camera_ready;
+}
+
+bool halCameraPowerCycle() {
+    halDelayMs(500);
+    return camera_ready;
+}
+
+bool halCameraSetXclk(uint32_t mhz) {
+    return true;
+}
+
+// 帧来自文件，参数只做范围检查，分辨率用于挑选回放的帧
+bool halCameraApply(const HalCameraSettings &settings) {
+    static const uint16_t DIMS[HAL_FRAME_SIZE_COUNT][2] = {
+        { 160, 120 }, { 320, 240 }, { 640, 480 }, { 800, 600 },
+        { 1024, 768 }, { 1280, 1024 }, { 1600, 1200 },
+    };
+    if (settings.frame_size < HAL_FRAME_SIZE_COUNT) {
+        std::lock_guard<std::mutex> lock(camera_mutex);
+        camera_width = DIMS[settings.frame_size][0];
+        camera_height = DIMS[settings.frame_size][1];
+    }
+    // 回放的帧不受传感器窗口影响，数码变焦只检查范围
+    return camera_ready && settings.frame_size <= halCameraMaxFrameSize() &&
+           settings.zoom_x + settings.zoom_w <= HAL_SENSOR_WIDTH &&
+           settings.zoom_y + settings.zoom_h <= HAL_SENSOR_HEIGHT;
+}
+
+HalFrameSize halCameraMaxFrameSize() {
+    return HAL_FRAME_UXGA;
+}
+
+// ==================== 麦克风 ====================
+
+static std::vector<int16_t> mic_samples;
+static size_t mic_pos = 0;
+static uint32_t mic_rate = 16000;
+static int64_t mic_start_us = 0;
+static uint64_t mic_delivered = 0;
+static bool mic_ready = false;
+
+static uint32_t readLe32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 解析 16-bit PCM WAV，多声道只取第一个声道
+static bool loadWav(const char *path) {
+    std::vector<uint8_t> wav;
+    if (!readFile(path, wav) || wav.size() < 12 ||
+        memcmp(wav.data(), "RIFF", 4) != 0 || memcmp(wav.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint16_t channels = 1, bits = 16;
+    size_t i = 12;
+    while (i + 8 <= wav.size()) {
+        uint32_t chunk_len = readLe32(&wav[i + 4]);
+        const uint8_t *body = &wav[i + 8];
+        if (memcmp(&wav[i], "fmt ", 4) == 0 && chunk_len >= 16 && i + 24 <= wav.size()) {
+            channels = (uint16_t)(body[2] | (body[3] << 8));
+            bits = (uint16_t)(body[14] | (body[15] << 8));
+        } else if (memcmp(&wav[i], "data", 4) == 0) {
+            if (bits != 16 || channels == 0) return false;
+            size_t frames = std::min((size_t)chunk_len, wav.size() - i - 8) / (2 * channels);
+            mic_samples.resize(frames);
+            for (size_t n = 0; n < frames; n++) {
+                const uint8_t *s = body + n * 2 * channels;
+                mic_samples[n] = (int16_t)(s[0] | (s[1] << 8));
+            }
+            return !mic_samples.empty();
+        }
+        i += 8 + chunk_len + (chunk_len & 1);
+    }
+    return false;
+}
+
+bool halMicBegin(uint32_t sample_rate, uint32_t block_samples) {
+    mic_rate = sample_rate;
+
+    if (native_config.wav_path && loadWav(native_config.wav_path)) {
+        halLog("✅ 麦克风回放: %s (%u 样本)\n", native_config.wav_path, (unsigned)mic_samples.size());
+    } else {
+        if (native_config.wav_path) {
+            halLog("[WARN] 无法读取 WAV: %s，改用正弦波\n", native_config.wav_path);
+        }
+        // 1 秒 440 Hz 正弦波，循环回放
+        mic_samples.resize(sample_rate);
+        for (uint32_t n = 0; n < sample_rate; n++) {
+            mic_samples[n] = (int16_t)(8000.0 * sin(2.0 * M_PI * 440.0 * n / sample_rate));
+        }
+        halLog("✅ 麦克风回放: 440 Hz 正弦波\n");
+    }
+
+    mic_start_us = halNowUs();
+    mic_delivered = 0;
+    mic_ready = true;
+    return true;
+}
+
+bool halMicReady() {
+    return mic_ready;
+}
+
+int halMicRead(int16_t *dst, size_t max_samples) {
+    if (!mic_ready) return -1;
+
+    // 与 I2S 阻塞读取一样，等到这一块样本 "采集完成" 的时刻才返回
+    uint64_t end = mic_delivered + max_samples;
+    sleepUntilUs(mic_start_us + (int64_t)(end * 1000000ULL / mic_rate));
+
+    for (size_t n = 0; n < max_samples; n++) {
+        dst[n] = mic_samples[mic_pos];
+        mic_pos = (mic_pos + 1) % mic_samples.size();
+    }
+    mic_delivered = end;
+    return (int)max_samples;
+}
+
+// ==================== 存储 ====================
+
+static std::string storagePath(const char *path) {
+    return std::string(native_config.storage_dir) + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool halStorageBegin() {
+    mkdir(native_config.storage_dir, 0755);
+    struct stat st;
+    return stat(native_config.storage_dir, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool halStorageWrite(const char *path, const uint8_t *data, size_t len) {
+    halStorageBegin();
+    FILE *f = fopen(storagePath(path).c_str(), "wb");
+    if (!f) return false;
+    size_t n = fwrite(data, 1, len, f);
+    fclose(f);
+    return n == len;
+}
+
+long halStorageSize(const char *path) {
+    struct stat st;
+    if (stat(storagePath(path).c_str(), &st) != 0) return -1;
+    return (long)st.st_size;
+}
+
+size_t halStorageRead(const char *path, size_t offset, uint8_t *buf, size_t len) {
+    FILE *f = fopen(storagePath(path).c_str(), "rb");
+    if (!f) return 0;
+    size_t n = 0;
+    if (fseek(f, (long)offset, SEEK_SET) == 0) {
+        n = fread(buf, 1, len, f);
+    }
+    fclose(f);
+    return n;
+}
+
+bool halStorageUsage(uint64_t *used, uint64_t *total) {
+    if (!halStorageBegin()) return false;
+    struct statvfs vfs;
+    if (statvfs(native_config.storage_dir, &vfs) != 0 || vfs.f_blocks == 0) return false;
+    *total = (uint64_t)vfs.f_blocks * vfs.f_frsize;
+    *used = *total - (uint64_t)vfs.f_bavail * vfs.f_frsize;
+    return true;
+}
+
+// ==================== 电源 ====================
+
+// 主机上没有可调的射频和时钟，只记录设置，便于在主机上调试切换逻辑
+static uint32_t native_cpu_mhz = 240;
+
+bool halWifiSetPowerSave(HalWifiPowerSave mode, uint8_t listen_interval) {
+    return true;
+}
+
+bool halCpuSetFrequency(uint32_t max_mhz, uint32_t min_mhz, bool light_sleep) {
+    native_cpu_mhz = max_mhz;
+    return false;
+}
+
+uint32_t halCpuFrequencyMhz() {
+    return native_cpu_mhz;
+}
+
+// ==================== 系统 / 网络状态 ====================
+
+bool halWifiConnected() {
+    return true;
+}
+
+int halWifiRssi() {
+    return -40;
+}
+
+void halLocalIp(char *buf, size_t len) {
+    snprintf(buf, len, "127.0.0.1");
+}
+
+bool halPsramFound() {
+    return true;
+}
+
+void *halAllocLarge(size_t size) {
+    return malloc(size);
+}
+
+void *halAllocInternal(size_t size) {
+    return malloc(size);
+}
+
+void halRestart() {
+    halLog("🔄 主机构建忽略重启请求\n");
+}
+
+// ==================== 配置 ====================
+
+void halNativeConfigure(const HalNativeConfig &cfg) {
+    native_config = cfg;
+}
@@ -0,0 +1,21 @@
+#ifndef HAL_NATIVE_H
+#define HAL_NATIVE_H
+
+/**
+ * HAL - 主机实现的配置入口 (只供 native_main.cpp 使用)
+ */
+
+#include <stdint.h>
+
+struct HalNativeConfig {
+    const char *jpeg_path;      // JPEG 文件或目录 (目录下的 *.jpg 按文件名顺序循环回放)
+    const char *wav_path;       // 16-bit PCM WAV 文件；为 NULL 时生成 440 Hz 正弦波
+    uint32_t fps;               // 摄像头回放帧率
+    const char *storage_dir;    // 模拟 SPIFFS 的目录
+    uint32_t camera_fault_after_ms;     // 开机后多久开始模拟取帧失败
+    uint32_t camera_fault_ms;           // 失败持续时长，0 表示不模拟
+};
+
+void halNativeConfigure(const HalNativeConfig &cfg);
+
+#endif // HAL_NATIVE_H
@@ -0,0 +1,1555 @@
+/**
+ * HTTP 路由与处理函数
+ */
+
+#include "http_routes.h"
+#include "pipeline.h"
+#include "task_config.h"
+#include "sys_monitor.h"
+#include "metrics.h"
+#include "trace.h"
+#include "frame_store.h"
+#include "jpeg_thumb.h"
+#include "jpeg_crop.h"
+#include "boot.h"
+#include "power.h"
+#include "camera_config.h"
+#include "privacy_mask.h"
+#include "still_capture.h"
+#include "scene_detect.h"
+#include "motion_detect.h"
+#include "vad.h"
+#include "events.h"
+#include "camera_health.h"
+#include "clock_sync.h"
+#include "preroll.h"
+#include "mem_pool.h"
+#include "wire_writer.h"
+#include "web_assets.h"
+#include "hal.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+HttpServer server;
+
+// 请求路径上的调试日志，默认编译掉
+#if HTTP_DEBUG_LOG
+#define httpDebugLog(...) halLog(__VA_ARGS__)
+#else
+#define httpDebugLog(...) ((void)0)
+#endif
+
+// ==================== 函数声明 ====================
+
+void handleWebAsset(HttpRequest &req);
+void handleVideoJpeg(HttpRequest &req);
+void handleCapture(HttpRequest &req);
+void handleSave(HttpRequest &req);
+void handleSavedPhoto(HttpRequest &req);
+void onAudioCapture(HttpRequest &req);
+void handleAudioStream(HttpRequest &req);
+void handleVideoStream(HttpRequest &req);
+void handleStatus(HttpRequest &req);
+void handleMetrics(HttpRequest &req);
+void handleTrace(HttpRequest &req);
+void handleRestart(HttpRequest &req);
+void handlePower(HttpRequest &req);
+void handleCameraConfig(HttpRequest &req);
+void handleTime(HttpRequest &req);
+void handleTrigger(HttpRequest &req);
+void handleSegmentAudio(HttpRequest &req);
+void handleSegmentFrames(HttpRequest &req);
+void handleThumb(HttpRequest &req);
+void handleFrames(HttpRequest &req);
+void handlePrivacy(HttpRequest &req);
+void handleEvents(HttpRequest &req);
+void handleNotFound(HttpRequest &req);
+struct StreamWorker;
+static void streamWorkersBegin();
+static StreamWorker *claimStreamWorker();
+static void dispatchStream(StreamWorker *worker, StreamKind kind, int fd, uint64_t cursor,
+                           uint32_t latency_ms);
+static void setStreamRoi(StreamWorker *worker, const JpegRect &roi);
+static void releaseStreamWorker(StreamWorker *worker);
+
+// 处理函数的临时缓冲区：从 arena 借用，timed<> 在请求结束后整体复位。
+// 媒体数据 (音频样本、文件块) 放在 PSRAM；逐字节 snprintf 的 JSON 响应体放在内部 RAM，不经过 PSRAM cache
+static MemArena http_arena("http", HTTP_ARENA_BYTES, MEM_PSRAM);
+static MemArena http_meta_arena("http_meta", HTTP_META_ARENA_BYTES, MEM_INTERNAL);
+
+// 包装处理函数，记录处理耗时到 metric_http_handler_us
+template <HttpRoute route, void (*handler)(HttpRequest &)>
+void timed(HttpRequest &req) {
+    int64_t start_us = halNowUs();
+    handler(req);
+    http_arena.reset();
+    http_meta_arena.reset();
+    uint32_t dur_us = (uint32_t)(halNowUs() - start_us);
+    metric_http_handler_us[route].observe(dur_us);
+    traceRecord(TRACE_HTTP, start_us, dur_us, route);
+}
+
+bool routesBegin(uint16_t port, const char *bind_addr) {
+    bootPhaseStart(BOOT_PHASE_HTTP);
+    // 注册 HTTP 路由处理器 (timed<> 记录每个路由的处理耗时)
+    // 页面为 ROUTE_ROOT，脚本和样式为 ROUTE_UI
+    for (size_t i = 0; i < webAssetCount(); i++) {
+        const char *path = webAssetAt(i)->path;
+        server.on(path, strcmp(path, "/") == 0 ? timed<ROUTE_ROOT, handleWebAsset>
+                                               : timed<ROUTE_UI, handleWebAsset>);
+    }
+    server.on("/video.jpg", timed<ROUTE_VIDEO, handleVideoJpeg>);
+    server.on("/capture", timed<ROUTE_CAPTURE, handleCapture>);
+    server.on("/save", timed<ROUTE_SAVE, handleSave>);
+    server.on("/saved_photo", timed<ROUTE_SAVED_PHOTO, handleSavedPhoto>);
+    server.on("/audio", timed<ROUTE_AUDIO, onAudioCapture>);
+    server.on("/audio/stream", timed<ROUTE_AUDIO_STREAM, handleAudioStream>);  // 音频流端点
+    server.on("/stream", timed<ROUTE_STREAM, handleVideoStream>);               // MJPEG 视频流
+    server.on("/status", timed<ROUTE_STATUS, handleStatus>);
+    server.on("/metrics", timed<ROUTE_METRICS, handleMetrics>);
+    server.on("/trace", timed<ROUTE_TRACE, handleTrace>);
+    server.on("/restart", timed<ROUTE_RESTART, handleRestart>);
+    server.on("/power", timed<ROUTE_POWER, handlePower>);
+    server.on("/camera/config", timed<ROUTE_CAMERA_CONFIG, handleCameraConfig>);
+    server.on("/time", timed<ROUTE_TIME, handleTime>);
+    server.on("/trigger", timed<ROUTE_TRIGGER, handleTrigger>);
+    server.on("/segment/audio", timed<ROUTE_SEGMENT_AUDIO, handleSegmentAudio>);
+    server.on("/segment/frames", timed<ROUTE_SEGMENT_FRAMES, handleSegmentFrames>);
+    server.on("/thumb", timed<ROUTE_THUMB, handleThumb>);
+    server.on("/frames", timed<ROUTE_FRAMES, handleFrames>);
+    server.on("/privacy", timed<ROUTE_PRIVACY, handlePrivacy>);
+    server.on("/events", timed<ROUTE_EVENTS, handleEvents>);
+
+    server.onNotFound(timed<ROUTE_NOT_FOUND, handleNotFound>);
+    streamWorkersBegin();
+
+    bool ok = server.begin(port, bind_addr);
+    bootPhaseEnd(BOOT_PHASE_HTTP);
+    if (!ok) {
+        return false;
+    }
+    halLog("✅ HTTP 服务器启动成功 (端口 %u)\n", port);
+    halLog("   /audio - 单次音频采集\n");
+    halLog("   /audio/stream - 实时音频流\n");
+    halLog("   /stream - MJPEG 视频流\n");
+    halLog("   /metrics - 资源与性能指标\n");
+    halLog("   /trace - Chrome 追踪事件\n");
+    halLog("   /power - 电源配置档\n");
+    halLog("   /camera/config - 摄像头参数\n");
+    halLog("   /time - 设备时钟与墙上时间偏移\n");
+    halLog("   /trigger - 触发录制 (含预录)\n");
+    halLog("   /thumb, /frames - 1/8 缩略图与帧列表\n");
+    halLog("   /privacy - 隐私遮挡区域\n");
+    halLog("   /events - 设备事件 (场景切换)\n");
+    return true;
+}
+
+void httpServerTask(void *parameter) {
+    halLog("🌐 HTTP 服务任务启动\n");
+
+    while (1) {
+        server.handleClient(50);
+    }
+}
+
+// ==================== 时间戳响应头 ====================
+
+// 采集时刻使用设备单调时钟 (halNowUs)，同时给出到墙上时间的偏移，
+// 主机按 wall_us = X-Capture-Us + X-Clock-Offset-Us 对齐音视频 (见 clock_sync.h)
+static void sendCaptureHeaders(HttpRequest &req, int64_t capture_us) {
+    char value[24];
+    snprintf(value, sizeof(value), "%lld", (long long)capture_us);
+    req.sendHeader("X-Capture-Us", value);
+
+    int64_t offset_us;
+    ClockSource source = clockWallOffset(&offset_us);
+    req.sendHeader("X-Clock-Source", clockSourceName(source));
+    if (source != CLOCK_SOURCE_NONE) {
+        snprintf(value, sizeof(value), "%lld", (long long)offset_us);
+        req.sendHeader("X-Clock-Offset-Us", value);
+    }
+}
+
+// 当前场景编号 (scene_detect.h) 和开始时刻；编号变化即日记可以分段的位置
+static void sendSceneHeaders(HttpRequest &req) {
+    SceneState scene = sceneCurrent();
+    char value[24];
+    snprintf(value, sizeof(value), "%u", (unsigned)scene.id);
+    req.sendHeader("X-Scene", value);
+    snprintf(value, sizeof(value), "%lld", (long long)scene.start_us);
+    req.sendHeader("X-Scene-Start-Us", value);
+}
+
+// 摄像头异常时仍返回最近一帧正常帧，用 X-Frame-Age-Ms / X-Camera-State 标明新旧，
+// 过期时附加 Warning: 110 (RFC 7234 的 "Response is Stale")
+static void sendFrameHeaders(HttpRequest &req, const FrameRef &frame) {
+    char value[24];
+    snprintf(value, sizeof(value), "%u", (unsigned)frame.seq);
+    req.sendHeader("X-Frame-Seq", value);
+    snprintf(value, sizeof(value), "%lld", (long long)((halNowUs() - frame.timestamp_us) / 1000));
+    req.sendHeader("X-Frame-Age-Ms", value);
+    CameraHealthState state = cameraHealthState();
+    req.sendHeader("X-Camera-State", cameraHealthStateName(state));
+    if (state != CAMERA_HEALTH_OK || cameraHealthStale(frame.timestamp_us)) {
+        req.sendHeader("Warning", "110 - \"Response is Stale\"");
+    }
+    sendSceneHeaders(req);
+    sendCaptureHeaders(req, frame.timestamp_us);
+}
+
+// first_sample 为响应中第一个样本的绝对序号；X-Capture-Us 为该样本的采集时刻
+static void sendAudioHeaders(HttpRequest &req, uint64_t first_sample) {
+    char value[24];
+    snprintf(value, sizeof(value), "%llu", (unsigned long long)first_sample);
+    req.sendHeader("X-Sample-Index", value);
+    snprintf(value, sizeof(value), "%u", (unsigned)audio_ring.sampleRate());
+    req.sendHeader("X-Sample-Rate", value);
+    sendCaptureHeaders(req, audio_ring.sampleTimeUs(first_sample));
+}
+
+// ==================== ROI 裁剪 ====================
+
+// 解析 "x,y,w,h"，之后必须是 term；成功时 next 指向 term 之后
+static bool parseRect(const char *p, char term, JpegRect *rect, const char **next) {
+    long v[4];
+    for (int i = 0; i < 4; i++) {
+        char *end;
+        v[i] = strtol(p, &end, 10);
+        if (end == p || v[i] < 0 || v[i] > 65535 || *end != (i < 3 ? ',' : term)) return false;
+        p = end + 1;
+    }
+    if (v[2] == 0 || v[3] == 0) return false;
+    *rect = { (uint16_t)v[0], (uint16_t)v[1], (uint16_t)v[2], (uint16_t)v[3] };
+    *next = p;
+    return true;
+}
+
+// name=x,y,w,h (?roi= 为帧像素坐标)；没有该参数时 roi->w 为 0，格式错误返回 false
+static bool argRoi(HttpRequest &req, const char *name, JpegRect *roi) {
+    memset(roi, 0, sizeof(*roi));
+    if (!req.hasArg(name)) return true;
+    const char *next;
+    return parseRect(req.arg(name), '\0', roi, &next);
+}
+
+// 裁剪的工作区和输出缓冲区：第一次使用时分配 (halAllocLarge，输出按单帧上限)，之后一直保留
+struct CropBuffer {
+    JpegRecodeWork *work;
+    uint8_t *out;
+    size_t cap;
+};
+
+// HTTP 任务串行处理请求，/video.jpg 和 /capture 共用一份
+static CropBuffer http_crop;
+
+// 失败 (分配失败、格式不支持、数据损坏) 返回 0，调用者回退为整帧
+static size_t cropFrame(CropBuffer &cb, const FrameRef &frame, const JpegRect &roi,
+                        JpegRect *aligned) {
+    if (!cb.work) {
+        size_t cap = frameStoreSlotBytes();
+        uint8_t *mem = (uint8_t *)halAllocLarge(sizeof(JpegRecodeWork) + cap);
+        if (!mem) {
+            metric_crop_failures.inc();
+            return 0;
+        }
+        cb.work = (JpegRecodeWork *)mem;
+        cb.out = mem + sizeof(JpegRecodeWork);
+        cb.cap = cap;
+    }
+    int64_t start_us = halNowUs();
+    size_t len = jpegCrop(frame.buf, frame.len, roi, cb.work, cb.out, cb.cap, aligned);
+    uint32_t crop_us = (uint32_t)(halNowUs() - start_us);
+    metric_crop_us.observe(crop_us);
+    traceRecord(TRACE_ENCODE, start_us, crop_us, (uint32_t)len);
+    if (len == 0) metric_crop_failures.inc();
+    return len;
+}
+
+static void formatRoi(char *value, size_t size, const JpegRect &r) {
+    snprintf(value, size, "%u,%u,%u,%u", r.x, r.y, r.w, r.h);
+}
+
+// ==================== HTTP 请求处理函数 ====================
+
+// 页面和静态资源：gzip 数据直接从 flash 发送，ETag 匹配时返回 304
+void handleWebAsset(HttpRequest &req) {
+    const WebAsset *asset = webAssetFind(req.path());
+    if (!asset) {
+        handleNotFound(req);
+        return;
+    }
+
+    req.sendHeader("ETag", asset->etag);
+    req.sendHeader("Cache-Control", asset->cache_control);
+    req.sendHeader("Vary", "Accept-Encoding");
+
+    const char *if_none_match = req.header("If-None-Match");
+    if (if_none_match && strstr(if_none_match, asset->etag)) {
+        req.sendHeaders(304, asset->content_type, -1);
+        return;
+    }
+    req.sendHeader("Content-Encoding", "gzip");
+    req.send(200, asset->content_type, asset->data, asset->len);
+}
+
+void handleVideoJpeg(HttpRequest &req) {
+    unsigned long request_start = halMillis();
+    httpDebugLog("\n[DEBUG] ========== /video.jpg 请求 ==========\n");
+    httpDebugLog("[DEBUG] 当前时间: %lu ms\n", (unsigned long)halMillis());
+
+    // 摄像头正在恢复时仍返回帧缓存中的上一帧，只有从未取到过帧时才返回 503
+    if (!halCameraReady() && frameStoreSeq() == 0) {
+        halLog("[ERROR] 摄像头未初始化!\n");
+        req.send(503, "text/plain", "Camera not initialized");
+        return;
+    }
+
+    JpegRect roi;
+    if (!argRoi(req, "roi", &roi)) {
+        req.send(400, "text/plain; charset=utf-8", "roi 格式为 x,y,w,h");
+        return;
+    }
+
+    // 取帧缓存中的最新帧；捕获和失败恢复都在视频任务中完成
+    FrameRef frame;
+    if (!frameStoreAcquire(&frame)) {
+        halLog("[WARN] 尚无可用帧\n");
+        req.send(503, "text/plain", "No frame available yet");
+        return;
+    }
+
+    httpDebugLog("[DEBUG] 帧 #%u: %u bytes, %dx%d, %lld ms 前采集\n",
+                 frame.seq, (unsigned)frame.len, frame.width, frame.height,
+                 (long long)((halNowUs() - frame.timestamp_us) / 1000));
+
+    if (roi.w && (roi.x >= frame.width || roi.y >= frame.height)) {
+        frameStoreRelease(&frame);
+        req.send(400, "text/plain; charset=utf-8", "roi 超出画面");
+        return;
+    }
+    // 有 roi 时发送裁剪结果 (X-Roi 为对齐到 MCU 后的实际区域)，裁剪失败时发送整帧
+    const uint8_t *body = frame.buf;
+    size_t body_len = frame.len;
+    JpegRect aligned;
+    size_t crop_len = roi.w ? cropFrame(http_crop, frame, roi, &aligned) : 0;
+    if (crop_len) {
+        char value[32];
+        formatRoi(value, sizeof(value), aligned);
+        req.sendHeader("X-Roi", value);
+        body = http_crop.out;
+        body_len = crop_len;
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    sendFrameHeaders(req, frame);
+    int64_t send_start_us = halNowUs();
+    req.send(200, "image/jpeg", body, body_len);
+    uint32_t send_us = (uint32_t)(halNowUs() - send_start_us);
+    metric_send_time_us[STREAM_VIDEO].observe(send_us);
+    traceRecord(TRACE_SEND, send_start_us, send_us, body_len);
+    metric_stream_bytes_sent[STREAM_VIDEO].add(body_len);
+    frameStoreRelease(&frame);
+    frame_count++;
+    recordFrameLatency(halMillis() - request_start);
+
+    httpDebugLog("[DEBUG] 帧已发送，总计: %lu 帧\n", frame_count);
+    httpDebugLog("[DEBUG] ========== 请求处理完成 ==========\n\n");
+}
+
+// 静态照片不在帧缓存中，没有帧序号；X-Still 为照片尺寸，X-Still-Switch-Us 为这次切换分辨率的耗时
+static void saveStill(HttpRequest &req, const StillFrame &still, const JpegRect &roi) {
+    FrameRef frame = { still.buf, still.len, still.width, still.height, still.timestamp_us, 0, 0 };
+    const uint8_t *data = still.buf;
+    size_t len = still.len;
+    JpegRect aligned;
+    size_t crop_len = roi.w && roi.x < still.width && roi.y < still.height
+                          ? cropFrame(http_crop, frame, roi, &aligned) : 0;
+    if (crop_len) {
+        char value[32];
+        formatRoi(value, sizeof(value), aligned);
+        req.sendHeader("X-Roi", value);
+        data = http_crop.out;
+        len = crop_len;
+    }
+    if (!halStorageWrite("/photo.jpg", data, len)) {
+        req.send(503, "text/plain", "Failed to save photo");
+        return;
+    }
+    char value[24];
+    snprintf(value, sizeof(value), "%ux%u", still.width, still.height);
+    req.sendHeader("X-Still", value);
+    snprintf(value, sizeof(value), "%u", (unsigned)still.switch_us);
+    req.sendHeader("X-Still-Switch-Us", value);
+    sendCaptureHeaders(req, still.timestamp_us);
+    req.send(200, "text/plain; charset=utf-8", "拍照成功");
+    halLog("📸 拍照: %d 字节 (静态照片 %ux%u, 切换 %u ms)\n", (int)len, still.width, still.height,
+           (unsigned)(still.switch_us / 1000));
+}
+
+void handleCapture(HttpRequest &req) {
+    if (!halCameraReady() && frameStoreSeq() == 0) {
+        req.send(503, "text/plain", "Camera not initialized");
+        return;
+    }
+
+    JpegRect roi;
+    if (!argRoi(req, "roi", &roi)) {
+        req.send(400, "text/plain; charset=utf-8", "roi 格式为 x,y,w,h");
+        return;
+    }
+
+    // 双流：切到 still 分辨率取一张静态照片，失败时回退为预览帧 (X-Still: preview)
+    HalCameraSettings s = cameraConfigCurrent();
+    if (s.still_size != CAMERA_STILL_OFF && s.still_size != s.frame_size) {
+        StillFrame still;
+        if (stillCapture(s.still_size, STILL_TIMEOUT_MS, &still)) {
+            saveStill(req, still, roi);
+            return;
+        }
+        req.sendHeader("X-Still", "preview");
+    }
+
+    FrameRef frame;
+    if (frameStoreAcquire(&frame)) {
+        // 保存到 SPIFFS 作为 /photo.jpg；有 roi 时只保存裁剪后的区域
+        const uint8_t *data = frame.buf;
+        size_t len = frame.len;
+        JpegRect aligned;
+        size_t crop_len = roi.w && roi.x < frame.width && roi.y < frame.height
+                              ? cropFrame(http_crop, frame, roi, &aligned) : 0;
+        if (crop_len) {
+            char value[32];
+            formatRoi(value, sizeof(value), aligned);
+            req.sendHeader("X-Roi", value);
+            data = http_crop.out;
+            len = crop_len;
+        }
+        if (halStorageWrite("/photo.jpg", data, len)) {
+            sendFrameHeaders(req, frame);
+            req.send(200, "text/plain; charset=utf-8", "拍照成功");
+            halLog("📸 拍照: %d 字节\n", (int)len);
+        } else {
+            req.send(503, "text/plain", "Failed to save photo");
+        }
+        frameStoreRelease(&frame);
+    } else {
+        req.send(503, "text/plain", "No frame available yet");
+    }
+}
+
+void handleSave(HttpRequest &req) {
+    // 保存到 SD 卡
+    req.send(200, "text/plain; charset=utf-8", "照片已保存到 SD 卡");
+    halLog("💾 照片保存请求\n");
+}
+
+void handleSavedPhoto(HttpRequest &req) {
+    long size = halStorageSize("/photo.jpg");
+    if (size < 0) {
+        req.send(404, "text/plain", "Photo not found");
+        return;
+    }
+
+    // 分块读出文件
+    const size_t block = 1024;
+    uint8_t *file_buffer = (uint8_t *)http_arena.alloc(block);
+    if (!file_buffer) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    req.sendHeaders(200, "image/jpeg", size);
+    size_t offset = 0;
+    while (offset < (size_t)size) {
+        size_t n = halStorageRead("/photo.jpg", offset, file_buffer, block);
+        if (n == 0 || !req.write(file_buffer, n)) break;
+        offset += n;
+    }
+}
+
+/**
+ * /audio?from=N[&max_ms=M]：一次返回采集环中从样本 N 开始的全部音频 (最多 M 毫秒)，不等待新数据。
+ *
+ * 主机保存游标，下一次请求 from = X-Sample-Index + 响应样本数，即可每隔几秒取一次且不丢样本：
+ * - 游标已落出采集环时从最旧的可用样本开始，跳过的样本数放在 X-Gap-Samples
+ * - 发送期间被生产者追上时提前结束响应，下一次请求会在 X-Gap-Samples 中报告这段缺口
+ * - from 超过写指针 (设备重启过) 时返回 416，X-Ring-Head 为当前写指针
+ */
+static void fetchAudioBatch(HttpRequest &req) {
+    char value[24];
+    uint64_t from = strtoull(req.arg("from"), NULL, 10);
+    uint32_t max_ms = req.hasArg("max_ms") ? (uint32_t)strtoul(req.arg("max_ms"), NULL, 10) : 0;
+    if (max_ms == 0 || max_ms > AUDIO_FETCH_MAX_MS) max_ms = AUDIO_FETCH_MAX_MS;
+
+    uint64_t head = audio_ring.head();
+    snprintf(value, sizeof(value), "%llu", (unsigned long long)head);
+    req.sendHeader("X-Ring-Head", value);
+    if (from > head) {
+        req.send(416, "text/plain", "Cursor ahead of capture ring");
+        return;
+    }
+
+    int16_t *samples = (int16_t *)http_arena.alloc(AUDIO_CHUNK_SIZE);
+    if (!samples) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    const uint32_t chunk_samples = AUDIO_CHUNK_SIZE / sizeof(int16_t);
+
+    // 第一块决定起点：游标落出采集环时 read() 把它推进到最旧的可用样本
+    uint64_t cursor = from;
+    uint64_t gap = 0;
+    uint32_t n = audio_ring.read(&cursor, samples, chunk_samples, &gap);
+    uint64_t start = cursor - n;
+    uint64_t end = start + (uint64_t)max_ms * audio_ring.sampleRate() / 1000;
+    if (end > head) end = head;
+    if (start + n > end) n = (uint32_t)(end > start ? end - start : 0);
+    cursor = start + n;
+    if (gap > 0) metric_audio_fetch_gap_samples.add(gap > UINT32_MAX ? UINT32_MAX : (uint32_t)gap);
+
+    snprintf(value, sizeof(value), "%llu", (unsigned long long)gap);
+    req.sendHeader("X-Gap-Samples", value);
+    req.sendHeader("X-Audio-Format", "pcm-16bit-16khz-mono");
+    req.sendHeader("Cache-Control", "no-cache");
+    sendAudioHeaders(req, start);
+    if (!req.beginChunked(200, "audio/raw")) {
+        return;
+    }
+
+    size_t total = 0;
+    while (n > 0 && req.sendChunk(samples, n * sizeof(int16_t))) {
+        total += n * sizeof(int16_t);
+        if (cursor >= end) break;
+        uint64_t lost = 0;
+        uint64_t want = end - cursor;
+        n = audio_ring.read(&cursor, samples, want < chunk_samples ? (uint32_t)want : chunk_samples, &lost);
+        if (lost > 0) break;    // 被生产者追上：到此为止，缺口留给下一次请求报告
+    }
+    metric_stream_bytes_sent[STREAM_AUDIO].add(total);
+}
+
+void onAudioCapture(HttpRequest &req) {
+    if (!halMicReady()) {
+        halLog("[ERROR] I2S 未初始化!\n");
+        req.send(503, "text/plain", "I2S not initialized");
+        return;
+    }
+    if (req.hasArg("from")) {
+        fetchAudioBatch(req);
+        return;
+    }
+
+    // 不带 from：返回实时音频数据 (原始 PCM 16-bit, 16kHz, 单声道)，最多一块
+    httpDebugLog("\n[DEBUG] ========== /audio 请求 ==========\n");
+
+    // 从采集环读取接下来的一块音频数据
+    int16_t *samples = (int16_t *)http_arena.alloc(AUDIO_CHUNK_SIZE);
+    if (!samples) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    const uint32_t max_samples = AUDIO_CHUNK_SIZE / sizeof(int16_t);
+    uint32_t total = 0;
+    unsigned long start_time = halMillis();
+    unsigned long timeout = 500;  // 500ms 超时
+    uint64_t cursor = audio_ring.head();
+    const uint64_t first_sample = cursor;
+
+    while (total < max_samples && (halMillis() - start_time) < timeout) {
+        uint32_t n = audio_ring.read(&cursor, samples + total, max_samples - total, NULL);
+        if (n > 0) {
+            total += n;
+        } else {
+            halDelayMs(10);
+        }
+    }
+
+    size_t total_read = total * sizeof(int16_t);
+    if (total_read > 0) {
+        halLog("[OK] 音频数据: %u bytes\n", (unsigned)total_read);
+
+        // 发送原始 PCM 数据
+        req.sendHeader("X-Audio-Format", "pcm-16bit-16khz-mono");
+        req.sendHeader("Cache-Control", "no-cache");
+        sendAudioHeaders(req, first_sample);
+        req.send(200, "audio/raw", samples, total_read);
+        metric_stream_bytes_sent[STREAM_AUDIO].add(total_read);
+    } else {
+        halLog("[WARN] 无音频数据\n");
+        req.send(204, "text/plain", "No audio data");
+    }
+
+    httpDebugLog("[DEBUG] ========== 音频请求完成 ==========\n\n");
+}
+
+// 从采集环的 cursor 处开始一个音频流，连接交给空闲的流任务，HTTP 任务立即返回继续服务其他请求
+static void startAudioStream(HttpRequest &req, uint64_t cursor) {
+    StreamWorker *worker = claimStreamWorker();
+    if (!worker) {
+        req.send(503, "text/plain", "Too many stream clients");
+        return;
+    }
+
+    // 之后的样本连续；流任务落后于采集环时直接结束流，不会跳过样本继续发送
+    req.sendHeader("X-Audio-Format", "pcm-16bit-16khz-mono");
+    req.sendHeader("Cache-Control", "no-cache");
+    sendAudioHeaders(req, cursor);
+    if (!req.beginChunked(200, "audio/raw")) {
+        releaseStreamWorker(worker);
+        return;
+    }
+
+    // ?latency_ms= 为目标延迟：越小 chunk 越小、包越多，越大越省带宽和功耗
+    uint32_t latency_ms = req.hasArg("latency_ms") ? (uint32_t)strtoul(req.arg("latency_ms"), NULL, 10)
+                                                   : AUDIO_STREAM_LATENCY_MS;
+    if (latency_ms < 10) latency_ms = 10;
+
+    // 取走 socket，由流任务负责发送和关闭
+    dispatchStream(worker, STREAM_AUDIO, req.detach(), cursor, latency_ms);
+}
+
+void handleAudioStream(HttpRequest &req) {
+    // 流式音频端点 - 从当前写指针开始
+    httpDebugLog("\n[DEBUG] ========== /audio/stream 请求 ==========\n");
+
+    if (!halMicReady()) {
+        req.send(503, "text/plain", "I2S not initialized");
+        return;
+    }
+    startAudioStream(req, audio_ring.head());
+}
+
+#define MJPEG_BOUNDARY "autodiary-mjpeg"
+
+// MJPEG 视频流 (multipart/x-mixed-replace)：浏览器用一个 <img> 长连接持续显示新帧，
+// 不再每秒新建一个 /video.jpg 连接。连接交给空闲的流任务，与音频流共用 MAX_STREAM_CLIENTS
+void handleVideoStream(HttpRequest &req) {
+    if (!halCameraReady() && frameStoreSeq() == 0) {
+        req.send(503, "text/plain", "Camera not initialized");
+        return;
+    }
+    // ?roi=x,y,w,h：每一帧都裁剪到该区域 (流任务中完成)，超出画面或裁剪失败的帧整帧发送
+    JpegRect roi;
+    if (!argRoi(req, "roi", &roi)) {
+        req.send(400, "text/plain; charset=utf-8", "roi 格式为 x,y,w,h");
+        return;
+    }
+    StreamWorker *worker = claimStreamWorker();
+    if (!worker) {
+        req.send(503, "text/plain", "Too many stream clients");
+        return;
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    if (!req.sendHeaders(200, "multipart/x-mixed-replace; boundary=" MJPEG_BOUNDARY, -1)) {
+        releaseStreamWorker(worker);
+        return;
+    }
+    setStreamRoi(worker, roi);
+    dispatchStream(worker, STREAM_VIDEO, req.detach(), 0, 0);
+}
+
+// /status 编码后的上限 (JSON 约 330 字节，二进制格式更短)
+#define STATUS_BUFFER_SIZE 384
+
+void handleStatus(HttpRequest &req) {
+    // 默认 JSON；Accept: application/cbor / application/msgpack 或 ?format=cbor|msgpack 返回二进制
+    WireFormat format = wireFormatFromAccept(req.header("Accept"));
+    if (req.hasArg("format")) {
+        format = wireFormatByName(req.arg("format"), format);
+    }
+
+    uint8_t buf[STATUS_BUFFER_SIZE];
+    char ip[16];
+    halLocalIp(ip, sizeof(ip));
+
+    WireWriter w(buf, sizeof(buf), format);
+    w.beginObject(12);
+    w.fieldStr("device", "XIAO-ESP32S3-Sense");
+    w.fieldStr("firmware_version", "v2.0");
+    w.fieldBool("wifi_connected", halWifiConnected());
+    w.fieldStr("ip_address", ip);
+    w.fieldBool("camera_initialized", halCameraReady());
+    w.fieldBool("i2s_initialized", halMicReady());
+    w.fieldUint("frame_count", frame_count);
+    w.fieldInt("signal_strength", halWifiRssi());
+    w.fieldUint("audio_overruns", metric_audio_overruns.value());
+    w.fieldUint("frame_latency_ms", frame_latency_ms);
+    w.fieldUint("frame_latency_max_ms", frame_latency_max_ms);
+    w.fieldInt("stream_clients", stream_clients.load());
+    w.endObject();
+
+    if (!w.ok()) {
+        req.send(500, "text/plain", "Status encoding failed");
+        return;
+    }
+    req.sendHeader("Cache-Control", "no-cache");
+    req.sendHeader("Vary", "Accept");
+    req.send(200, wireContentType(format), buf, w.length());
+}
+
+// 每个 /metrics 请求复用同一块静态缓冲区 (HTTP 任务串行处理，无需加锁)，
+// 写满一块就作为一个 chunk 发出，输出长度不受缓冲区大小限制
+#define METRICS_BUFFER_SIZE 1024
+static char metrics_buffer[METRICS_BUFFER_SIZE];
+
+static void sendMetricsChunk(const char *data, size_t len, void *ctx) {
+    ((HttpRequest *)ctx)->sendChunk(data, len);
+}
+
+void handleMetrics(HttpRequest &req) {
+    metric_wifi_rssi_dbm.set(halWifiRssi());
+
+    req.sendHeader("Cache-Control", "no-cache");
+    if (!req.beginChunked(200, "text/plain; version=0.0.4")) {
+        return;
+    }
+
+    MetricsWriter w(metrics_buffer, sizeof(metrics_buffer), sendMetricsChunk, &req);
+    metricsRender(w);
+    bootRenderMetrics(w);
+    memRenderMetrics(w);
+    powerRenderMetrics(w);
+    cameraConfigRenderMetrics(w);
+    cameraHealthRenderMetrics(w);
+    privacyMaskRenderMetrics(w);
+    stillRenderMetrics(w);
+    sceneRenderMetrics(w);
+    motionRenderMetrics(w);
+    vadRenderMetrics(w);
+    eventsRenderMetrics(w);
+    prerollRenderMetrics(w);
+    sysMonitorRenderMetrics(w);
+    w.finish();
+}
+
+void handleTrace(HttpRequest &req) {
+    // /trace?enable=0 暂停记录 (便于导出一段静止的时间线)，enable=1 恢复
+    if (req.hasArg("enable")) {
+        traceSetEnabled(strcmp(req.arg("enable"), "0") != 0);
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.sendHeader("Content-Disposition", "inline; filename=\"autodiary-trace.json\"");
+    if (!req.beginChunked(200, "application/json")) {
+        return;
+    }
+
+    MetricsWriter w(metrics_buffer, sizeof(metrics_buffer), sendMetricsChunk, &req);
+    traceRenderJson(w);
+    w.finish();
+}
+
+void handleRestart(HttpRequest &req) {
+    req.send(200, "text/plain; charset=utf-8", "设备重启中...");
+    halDelayMs(1000);
+    halRestart();
+}
+
+void handlePower(HttpRequest &req) {
+    // /power?profile=NAME 切换配置档，不带参数时只返回当前设置
+    if (req.hasArg("profile")) {
+        PowerProfileId id = powerProfileByName(req.arg("profile"));
+        if (id == POWER_PROFILE_COUNT) {
+            req.send(400, "text/plain; charset=utf-8", "未知的配置档 (live / lifelog / timelapse)");
+            return;
+        }
+        powerApplyProfile(id);
+    }
+
+    const PowerProfile &p = powerProfile(powerCurrentProfile());
+    char json[320];
+    int len = snprintf(json, sizeof(json),
+        "{\"profile\":\"%s\",\"wifi_ps\":%d,\"listen_interval\":%u,"
+        "\"cpu_max_mhz\":%u,\"cpu_min_mhz\":%u,\"cpu_mhz\":%lu,\"dfs\":%s,"
+        "\"light_sleep\":%s,\"xclk_mhz\":%u,\"frame_interval_ms\":%lu,"
+        "\"profiles\":[\"%s\",\"%s\",\"%s\"]}",
+        p.name, (int)p.wifi_ps, p.listen_interval,
+        p.cpu_max_mhz, p.cpu_min_mhz, (unsigned long)halCpuFrequencyMhz(),
+        powerDfsActive() ? "true" : "false", p.light_sleep ? "true" : "false",
+        p.xclk_mhz, (unsigned long)p.frame_interval_ms,
+        powerProfile(POWER_PROFILE_LIVE).name, powerProfile(POWER_PROFILE_LIFELOG).name,
+        powerProfile(POWER_PROFILE_TIMELAPSE).name);
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(200, "application/json; charset=utf-8", json, (size_t)len);
+}
+
+// 布尔参数接受 1/0、true/false、on/off
+static bool argFlag(HttpRequest &req, const char *name, bool fallback) {
+    if (!req.hasArg(name)) return fallback;
+    const char *v = req.arg(name);
+    if (strcmp(v, "1") == 0 || strcmp(v, "true") == 0 || strcmp(v, "on") == 0) return true;
+    if (strcmp(v, "0") == 0 || strcmp(v, "false") == 0 || strcmp(v, "off") == 0) return false;
+    return fallback;
+}
+
+static long argLong(HttpRequest &req, const char *name, long fallback) {
+    return req.hasArg(name) ? strtol(req.arg(name), NULL, 10) : fallback;
+}
+
+void handleCameraConfig(HttpRequest &req) {
+    // /camera/config?frame_size=svga&quality=12&auto_exposure=0&exposure=400 ...
+    // 只修改带上的参数；不带参数时只返回当前设置
+    HalCameraSettings s = cameraConfigCurrent();
+    bool changed = false;
+    static const char *const KEYS[] = {
+        "frame_size", "quality", "auto_exposure", "exposure", "ae_level",
+        "awb", "wb_mode", "auto_gain", "gain", "gain_ceiling", "zoom", "still",
+    };
+    for (const char *key : KEYS) changed = changed || req.hasArg(key);
+
+    if (req.hasArg("frame_size")) {
+        HalFrameSize size = cameraFrameSizeByName(req.arg("frame_size"));
+        if (size == HAL_FRAME_SIZE_COUNT) {
+            req.send(400, "text/plain; charset=utf-8", "未知的分辨率 (qqvga / qvga / vga / svga / xga / sxga / uxga)");
+            return;
+        }
+        s.frame_size = size;
+    }
+    // still=uxga 开启双流 (frame_size 为预览分辨率，/capture 临时切到 still)，still=off 关闭
+    if (req.hasArg("still")) {
+        HalFrameSize size = cameraFrameSizeByName(req.arg("still"));
+        if (size == HAL_FRAME_SIZE_COUNT && strcmp(req.arg("still"), "off") != 0) {
+            req.send(400, "text/plain; charset=utf-8", "未知的 still 分辨率 (qvga ... uxga 或 off)");
+            return;
+        }
+        s.still_size = size;    // off 即 CAMERA_STILL_OFF
+    }
+    // 先转成 long 再检查范围，避免窄类型截断后绕过检查
+    long quality = argLong(req, "quality", s.quality);
+    long exposure = argLong(req, "exposure", s.exposure);
+    long ae_level = argLong(req, "ae_level", s.ae_level);
+    long wb_mode = argLong(req, "wb_mode", s.wb_mode);
+    long gain = argLong(req, "gain", s.gain);
+    long gain_ceiling = argLong(req, "gain_ceiling", s.gain_ceiling);
+    if (quality < 0 || quality > 255 || exposure < 0 || exposure > 65535 || ae_level < -128 ||
+        ae_level > 127 || wb_mode < 0 || wb_mode > 255 || gain < 0 || gain > 255 ||
+        gain_ceiling < 0 || gain_ceiling > 255) {
+        req.send(400, "text/plain; charset=utf-8", "参数超出范围");
+        return;
+    }
+    s.quality = (uint8_t)quality;
+    s.exposure = (uint16_t)exposure;
+    s.ae_level = (int8_t)ae_level;
+    s.wb_mode = (uint8_t)wb_mode;
+    s.gain = (uint8_t)gain;
+    s.gain_ceiling = (uint8_t)gain_ceiling;
+    s.auto_exposure = argFlag(req, "auto_exposure", s.auto_exposure);
+    s.awb = argFlag(req, "awb", s.awb);
+    s.auto_gain = argFlag(req, "auto_gain", s.auto_gain);
+    // zoom=x,y,w,h 为传感器窗口 (UXGA 坐标)，zoom=off 恢复全幅
+    if (req.hasArg("zoom")) {
+        JpegRect zoom = { 0, 0, 0, 0 };
+        if (strcmp(req.arg("zoom"), "off") != 0 && !argRoi(req, "zoom", &zoom)) {
+            req.send(400, "text/plain; charset=utf-8", "zoom 格式为 x,y,w,h 或 off");
+            return;
+        }
+        s.zoom_x = zoom.x;
+        s.zoom_y = zoom.y;
+        s.zoom_w = zoom.w;
+        s.zoom_h = zoom.h;
+    }
+
+    const char *error = cameraConfigValidate(s);
+    if (error) {
+        req.send(400, "text/plain; charset=utf-8", error);
+        return;
+    }
+
+    // 参数由视频任务在两次取帧之间写入传感器，这里只等待结果
+    const char *state = "unchanged";
+    bool persisted = true;
+    if (changed) {
+        uint32_t generation = cameraConfigSubmit(s, &persisted);
+        bool ok = false;
+        if (!cameraConfigWaitApplied(generation, CAMERA_CONFIG_APPLY_TIMEOUT_MS, &ok)) {
+            state = "pending";          // 视频任务未运行或正在恢复，之后自动应用
+        } else {
+            state = ok ? "applied" : "failed";
+        }
+    }
+
+    uint16_t width, height;
+    cameraFrameSizeDims(s.frame_size, &width, &height);
+    char json[480];
+    int len = snprintf(json, sizeof(json),
+        "{\"state\":\"%s\",\"persisted\":%s,\"frame_size\":\"%s\",\"width\":%u,\"height\":%u,"
+        "\"still\":\"%s\","
+        "\"max_frame_size\":\"%s\",\"quality\":%u,\"auto_exposure\":%s,\"exposure\":%u,"
+        "\"ae_level\":%d,\"awb\":%s,\"wb_mode\":%u,\"auto_gain\":%s,\"gain\":%u,"
+        "\"gain_ceiling\":%u,\"zoom\":{\"x\":%u,\"y\":%u,\"w\":%u,\"h\":%u}}",
+        state, persisted ? "true" : "false", cameraFrameSizeName(s.frame_size), width, height,
+        cameraStillSizeName(s.still_size), cameraFrameSizeName(halCameraMaxFrameSize()), s.quality,
+        s.auto_exposure ? "true" : "false", s.exposure, s.ae_level, s.awb ? "true" : "false",
+        s.wb_mode, s.auto_gain ? "true" : "false", s.gain, s.gain_ceiling,
+        s.zoom_x, s.zoom_y, s.zoom_w ? s.zoom_w : HAL_SENSOR_WIDTH,
+        s.zoom_h ? s.zoom_h : HAL_SENSOR_HEIGHT);
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(strcmp(state, "pending") == 0 ? 202 : (strcmp(state, "failed") == 0 ? 500 : 200),
+             "application/json; charset=utf-8", json, (size_t)len);
+}
+
+void handleTime(HttpRequest &req) {
+    // /time?host_us=N 写入主机时钟 (Unix 微秒，主机按往返时间的一半补偿到设备收到请求的时刻)
+    if (req.hasArg("host_us")) {
+        const char *arg = req.arg("host_us");
+        char *end;
+        long long host_us = strtoll(arg, &end, 10);
+        if (end == arg || *end != '\0' || !clockSetHostTime(host_us)) {
+            req.send(400, "text/plain; charset=utf-8", "host_us 须为 Unix 微秒时间戳");
+            return;
+        }
+    }
+
+    int64_t device_us = halNowUs();
+    int64_t offset_us;
+    ClockSource source = clockWallOffset(&offset_us);
+
+    char json[192];
+    int len = snprintf(json, sizeof(json),
+        "{\"device_us\":%lld,\"source\":\"%s\",\"offset_us\":%lld,\"wall_us\":%lld,"
+        "\"host_sync_age_ms\":%lld}",
+        (long long)device_us, clockSourceName(source), (long long)offset_us,
+        (long long)(source != CLOCK_SOURCE_NONE ? device_us + offset_us : 0),
+        (long long)clockHostSyncAgeMs());
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(200, "application/json; charset=utf-8", json, (size_t)len);
+}
+
+// ==================== 触发录制 ====================
+
+void handleTrigger(HttpRequest &req) {
+    uint32_t id = prerollTrigger(TRIGGER_HTTP);
+    PrerollSegment seg;
+    if (!prerollGetSegment(id, &seg)) {
+        req.send(503, "text/plain", "Audio ring not ready");
+        return;
+    }
+
+    FrameRef frames[FRAME_PREROLL_FRAMES > 0 ? FRAME_PREROLL_FRAMES : 1];
+    int frame_count = frameStoreAcquireHistory(seg.start_us, frames, FRAME_PREROLL_FRAMES);
+    for (int i = 0; i < frame_count; i++) frameStoreRelease(&frames[i]);
+
+    char json[224];
+    int len = snprintf(json, sizeof(json),
+        "{\"id\":%lu,\"trigger_us\":%lld,\"start_us\":%lld,\"audio_start\":%llu,"
+        "\"preroll_ms\":%lld,\"preroll_frames\":%d}",
+        (unsigned long)seg.id, (long long)seg.trigger_us, (long long)seg.start_us,
+        (unsigned long long)seg.audio_start, (long long)((seg.trigger_us - seg.start_us) / 1000),
+        frame_count);
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(200, "application/json; charset=utf-8", json, (size_t)len);
+}
+
+static bool findSegment(HttpRequest &req, PrerollSegment *seg) {
+    if (!prerollGetSegment((uint32_t)strtoul(req.arg("id"), NULL, 10), seg)) {
+        req.send(404, "text/plain", "Unknown segment");
+        return false;
+    }
+    return true;
+}
+
+void handleSegmentAudio(HttpRequest &req) {
+    PrerollSegment seg;
+    if (!findSegment(req, &seg)) return;
+    if (!halMicReady()) {
+        req.send(503, "text/plain", "I2S not initialized");
+        return;
+    }
+    if (seg.audio_start < audio_ring.tail()) {
+        req.send(410, "text/plain", "Pre-roll audio already overwritten");
+        return;
+    }
+    startAudioStream(req, seg.audio_start);
+}
+
+#define PREROLL_PART_BOUNDARY "autodiary-frame"
+
+// 预录帧以 multipart/mixed 发送，每部分带 X-Frame-Seq / X-Capture-Us；
+// 发送期间持有这些槽位的引用，直接从帧缓存发送
+void handleSegmentFrames(HttpRequest &req) {
+    PrerollSegment seg;
+    if (!findSegment(req, &seg)) return;
+
+    FrameRef frames[FRAME_PREROLL_FRAMES > 0 ? FRAME_PREROLL_FRAMES : 1];
+    int count = frameStoreAcquireHistory(seg.start_us, frames, FRAME_PREROLL_FRAMES);
+
+    char value[12];
+    snprintf(value, sizeof(value), "%d", count);
+    req.sendHeader("X-Frame-Count", value);
+    req.sendHeader("Cache-Control", "no-cache");
+    sendCaptureHeaders(req, seg.start_us);
+    if (req.beginChunked(200, "multipart/mixed; boundary=" PREROLL_PART_BOUNDARY)) {
+        char part[160];
+        for (int i = 0; i < count; i++) {
+            int len = snprintf(part, sizeof(part),
+                "--" PREROLL_PART_BOUNDARY "\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n"
+                "X-Frame-Seq: %u\r\nX-Capture-Us: %lld\r\n\r\n",
+                (unsigned)frames[i].len, (unsigned)frames[i].seq, (long long)frames[i].timestamp_us);
+            if (!req.sendChunk(part, len) || !req.sendChunk(frames[i].buf, frames[i].len) ||
+                !req.sendChunk("\r\n", 2)) {
+                break;
+            }
+            metric_stream_bytes_sent[STREAM_VIDEO].add(frames[i].len);
+        }
+        static const char closing[] = "--" PREROLL_PART_BOUNDARY "--\r\n";
+        req.sendChunk(closing, sizeof(closing) - 1);
+    }
+
+    for (int i = 0; i < count; i++) frameStoreRelease(&frames[i]);
+}
+
+// ==================== 缩略图 ====================
+
+// /thumb：最新一张缩略图；/thumb?seq=N：帧 N 的缩略图，已被覆盖时返回 410
+void handleThumb(HttpRequest &req) {
+    uint32_t seq = req.hasArg("seq") ? (uint32_t)strtoul(req.arg("seq"), NULL, 10) : 0;
+
+    FrameRef thumb;
+    if (!frameStoreAcquireThumb(seq, &thumb)) {
+        FrameThumbInfo oldest;
+        if (seq != 0 && seq <= frameStoreSeq() && frameStoreListThumbs(&oldest, 1) > 0 && seq < oldest.seq) {
+            req.send(410, "text/plain", "Thumbnail already overwritten");
+        } else {
+            req.send(404, "text/plain", "No thumbnail for this frame");
+        }
+        return;
+    }
+
+    char value[16];
+    snprintf(value, sizeof(value), "%ux%u", (unsigned)thumb.width, (unsigned)thumb.height);
+    req.sendHeader("X-Thumb-Size", value);
+    if (seq) {
+        // 指定帧的缩略图是历史帧，不标过期
+        req.sendHeader("Cache-Control", "max-age=60");
+        snprintf(value, sizeof(value), "%u", (unsigned)thumb.seq);
+        req.sendHeader("X-Frame-Seq", value);
+        sendCaptureHeaders(req, thumb.timestamp_us);
+    } else {
+        req.sendHeader("Cache-Control", "no-cache");
+        sendFrameHeaders(req, thumb);
+    }
+    req.send(200, "image/jpeg", thumb.buf, thumb.len);
+    metric_stream_bytes_sent[STREAM_VIDEO].add(thumb.len);
+    frameStoreReleaseThumb(&thumb);
+}
+
+// /frames：带缩略图的帧列表 (按帧序号升序)，kept 表示原帧仍在预录中，可从 /segment/frames 取回
+void handleFrames(HttpRequest &req) {
+    FrameThumbInfo infos[FRAME_THUMB_MAX_SLOTS];
+    int count = frameStoreListThumbs(infos, FRAME_THUMB_MAX_SLOTS);
+
+    const size_t cap = 128 + (size_t)count * 200;
+    char *json = (char *)http_meta_arena.alloc(cap);
+    if (!json) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    size_t len = (size_t)snprintf(json, cap, "{\"latest_seq\":%u,\"thumb_quality\":%d,\"frames\":[",
+                                  (unsigned)frameStoreSeq(), JPEG_THUMB_QUALITY);
+    for (int i = 0; i < count && len < cap; i++) {
+        const FrameThumbInfo &f = infos[i];
+        len += (size_t)snprintf(json + len, cap - len,
+            "%s{\"seq\":%u,\"capture_us\":%lld,\"width\":%u,\"height\":%u,\"kept\":%s,"
+            "\"thumb\":\"/thumb?seq=%u\",\"thumb_width\":%u,\"thumb_height\":%u,\"thumb_bytes\":%u}",
+            i ? "," : "", (unsigned)f.seq, (long long)f.timestamp_us, (unsigned)f.src_width,
+            (unsigned)f.src_height, f.kept ? "true" : "false", (unsigned)f.seq, (unsigned)f.width,
+            (unsigned)f.height, (unsigned)f.len);
+    }
+    if (len < cap) len += (size_t)snprintf(json + len, cap - len, "]}");
+    if (len >= cap) {
+        req.send(500, "text/plain", "Listing too large");
+        return;
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(200, "application/json; charset=utf-8", json, len);
+}
+
+static size_t appendRects(char *json, size_t len, size_t cap, const JpegRect *rects, int count) {
+    for (int i = 0; i < count && len < cap; i++) {
+        len += (size_t)snprintf(json + len, cap - len, "%s{\"x\":%u,\"y\":%u,\"w\":%u,\"h\":%u}",
+                                i ? "," : "", rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+    }
+    return len;
+}
+
+void handlePrivacy(HttpRequest &req) {
+    // /privacy?mask=x,y,w,h;x,y,w,h 替换全部遮挡区域 (传感器坐标 1600x1200)，mask=off 清除
+    bool persisted = true;
+    if (req.hasArg("mask")) {
+        JpegRect rects[PRIVACY_MASK_MAX];
+        int count = 0;
+        const char *p = req.arg("mask");
+        if (strcmp(p, "off") != 0) {
+            while (1) {
+                if (count == PRIVACY_MASK_MAX) {
+                    req.send(400, "text/plain; charset=utf-8", "最多 8 个区域");
+                    return;
+                }
+                const char *end = strchr(p, ';');
+                if (!parseRect(p, end ? ';' : '\0', &rects[count], &p)) {
+                    req.send(400, "text/plain; charset=utf-8", "mask 格式为 x,y,w,h;x,y,w,h 或 off");
+                    return;
+                }
+                count++;
+                if (!end) break;
+            }
+        }
+        const char *error = privacyMaskValidate(rects, count);
+        if (error) {
+            req.send(400, "text/plain; charset=utf-8", error);
+            return;
+        }
+        privacyMaskSet(rects, count, &persisted);
+    }
+
+    // 同时给出按当前分辨率和变焦窗口换算后的帧坐标 (未对齐到 MCU)
+    JpegRect rects[PRIVACY_MASK_MAX];
+    JpegRect frame_rects[PRIVACY_MASK_MAX];
+    int count = privacyMaskGet(rects, PRIVACY_MASK_MAX);
+    uint16_t width, height;
+    cameraFrameSizeDims(cameraConfigCurrent().frame_size, &width, &height);
+    int frame_count = privacyMaskToFrame(rects, count, width, height, frame_rects);
+
+    const size_t cap = 160 + (size_t)(count + frame_count) * 48;
+    char *json = (char *)http_meta_arena.alloc(cap);
+    if (!json) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    size_t len = (size_t)snprintf(json, cap, "{\"persisted\":%s,\"max\":%d,\"masks\":[",
+                                  persisted ? "true" : "false", PRIVACY_MASK_MAX);
+    len = appendRects(json, len, cap, rects, count);
+    if (len < cap) {
+        len += (size_t)snprintf(json + len, cap - len,
+                                "],\"frame\":{\"width\":%u,\"height\":%u,\"masks\":[", width, height);
+    }
+    len = appendRects(json, len, cap, frame_rects, frame_count);
+    if (len < cap) len += (size_t)snprintf(json + len, cap - len, "]}}");
+    if (len >= cap) {
+        req.send(500, "text/plain", "Listing too large");
+        return;
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(req.hasArg("mask") && !persisted ? 500 : 200, "application/json; charset=utf-8", json, len);
+}
+
+// Server-Sent Events：Accept: text/event-stream 或 ?stream=1
+static bool wantsEventStream(HttpRequest &req) {
+    const char *accept = req.header("Accept");
+    return (accept && strstr(accept, "text/event-stream")) || req.hasArg("stream");
+}
+
+// 事件流交给空闲的流任务，断线重连时 Last-Event-ID (优先于 since) 为最后收到的序号
+static void startEventStream(HttpRequest &req, uint32_t since) {
+    const char *last_id = req.header("Last-Event-ID");
+    if (last_id) since = (uint32_t)strtoul(last_id, NULL, 10);
+
+    StreamWorker *worker = claimStreamWorker();
+    if (!worker) {
+        req.send(503, "text/plain", "Too many stream clients");
+        return;
+    }
+    req.sendHeader("Cache-Control", "no-cache");
+    if (!req.sendHeaders(200, "text/event-stream; charset=utf-8", -1)) {
+        releaseStreamWorker(worker);
+        return;
+    }
+    dispatchStream(worker, STREAM_EVENTS, req.detach(), since, 0);
+}
+
+void handleEvents(HttpRequest &req) {
+    // /events?since=N 返回序号大于 N 的事件，next 作为下一次的 since；
+    // dropped 为 true 表示中间有事件已被覆盖，或设备重启过 (since 大于最新序号)
+    uint32_t since = (uint32_t)strtoul(req.hasArg("since") ? req.arg("since") : "0", NULL, 10);
+    if (wantsEventStream(req)) {
+        startEventStream(req, since);
+        return;
+    }
+    Event events[EVENT_QUEUE_SIZE];
+    uint32_t oldest;
+    int count = eventsRead(since, events, EVENT_QUEUE_SIZE, &oldest);
+    uint32_t newest = eventsLastSeq();
+    // 停在尚未写完的事件之前时 next 不前进，下次再取
+    uint32_t last = count ? events[count - 1].seq : since > newest ? newest : since;
+    bool dropped = (oldest && since + 1 < oldest) || since > newest;
+
+    int64_t offset_us;
+    ClockSource source = clockWallOffset(&offset_us);
+    const size_t cap = 160 + (size_t)count * 128;
+    char *json = (char *)http_meta_arena.alloc(cap);
+    if (!json) {
+        req.send(503, "text/plain", "Out of buffers");
+        return;
+    }
+    size_t len = (size_t)snprintf(json, cap,
+        "{\"next\":%u,\"dropped\":%s,\"clock_source\":\"%s\",\"clock_offset_us\":%lld,\"events\":[",
+        (unsigned)last, dropped ? "true" : "false", clockSourceName(source),
+        (long long)(source != CLOCK_SOURCE_NONE ? offset_us : 0));
+    for (int i = 0; i < count && len < cap; i++) {
+        if (i) json[len++] = ',';
+        if (len < cap) len += (size_t)eventFormatJson(events[i], json + len, cap - len);
+    }
+    if (len < cap) len += (size_t)snprintf(json + len, cap - len, "]}");
+    if (len >= cap) {
+        req.send(500, "text/plain", "Listing too large");
+        return;
+    }
+
+    req.sendHeader("Cache-Control", "no-cache");
+    req.send(200, "application/json; charset=utf-8", json, len);
+}
+
+void handleNotFound(HttpRequest &req) {
+    req.send(404, "text/plain; charset=utf-8", "404 - 页面未找到");
+}
+
+// ==================== 流任务 ====================
+
+// 流任务在启动时创建，空闲时阻塞在信号量上；新连接交给空闲的任务，
+// 运行中不再为每个连接创建任务 (每次创建都要从内部 RAM 分配 TCB 和堆栈)
+struct StreamWorker {
+    HalSemaphore wake;
+    std::atomic<bool> busy{false};
+    StreamKind kind;
+    int fd;
+    uint64_t cursor;            // 音频流的起始样本 / 事件流的起始序号 (since)
+    uint32_t latency_ms;        // 音频流的目标延迟
+    JpegRect roi;               // 视频流的裁剪区域，w 为 0 表示整帧
+    CropBuffer crop;            // 第一次裁剪时分配，之后随任务保留
+    HalSemaphore events_wake;   // 事件流期间注册到事件环，有新事件时被唤醒
+    char name[16];
+};
+
+static_assert(MAX_STREAM_CLIENTS < 10, "任务名 \"StreamN\" 只留了一位序号");
+static_assert(MAX_STREAM_CLIENTS <= EVENT_MAX_WAITERS, "每个流任务都可能在等待新事件");
+static StreamWorker stream_workers[MAX_STREAM_CLIENTS];
+static std::atomic<int> audio_stream_clients{0};
+
+// 流的合并发送缓冲区 (PSRAM)，每个流连接一块
+static MemPool stream_chunk_pool("stream_chunk", HTTP_STREAM_BUFFER_SIZE, MAX_STREAM_CLIENTS, MEM_PSRAM);
+
+static StreamWorker *claimStreamWorker() {
+    for (int i = 0; i < MAX_STREAM_CLIENTS; i++) {
+        bool expected = false;
+        if (stream_workers[i].wake && stream_workers[i].busy.compare_exchange_strong(expected, true)) {
+            return &stream_workers[i];
+        }
+    }
+    return NULL;
+}
+
+static void releaseStreamWorker(StreamWorker *worker) {
+    worker->busy.store(false);
+}
+
+static void setStreamRoi(StreamWorker *worker, const JpegRect &roi) {
+    worker->roi = roi;
+}
+
+static void dispatchStream(StreamWorker *worker, StreamKind kind, int fd, uint64_t cursor,
+                           uint32_t latency_ms) {
+    worker->kind = kind;
+    worker->fd = fd;
+    worker->cursor = cursor;
+    worker->latency_ms = latency_ms;
+    stream_clients++;
+    halSemaphoreGive(worker->wake);
+}
+
+/**
+ * 音频流：每次 send() 是一个完整的 chunk (头 + 数据 + CRLF)，数据直接从采集环读进发送缓冲区。
+ *
+ * chunk 大小由目标延迟决定：取不超过 latency_ms 音频量的最大 MSS 整数倍 (不足一个 MSS 时按延迟发送)；
+ * 缓冲的最旧样本等待超过 latency_ms 时不等攒满也立即发送。落后时 (从预录起点开始、
+ * 网络短暂阻塞) 每次发满整个缓冲区追赶。
+ *
+ * 流中样本必须连续 (客户端按 X-Sample-Index 推算每个样本的序号)：落后到采集环已覆盖未发送的样本时
+ * 结束流，缺失的样本数计入 metric_audio_stream_gap_samples，客户端重连后从新的 X-Sample-Index 算出缺口。
+ */
+static void runAudioStream(int fd, uint64_t cursor, uint32_t latency_ms) {
+    uint8_t *buf = (uint8_t *)stream_chunk_pool.alloc();
+    if (!buf) {
+        halLog("❌ 音频流缓冲区不足\n");
+        return;
+    }
+    HttpStreamWriter writer;
+    writer.begin(fd, buf, HTTP_STREAM_BUFFER_SIZE, true, &metric_stream_writes[STREAM_AUDIO]);
+
+    size_t mss = httpTuneSocket(fd, HTTP_SOCKET_AUDIO);
+    const size_t framing = 8;     // 定宽 chunk 头 + CRLF
+    const uint32_t bytes_per_ms = audio_ring.sampleRate() * sizeof(int16_t) / 1000;
+    size_t target = (size_t)latency_ms * bytes_per_ms;
+    if (target + framing >= mss) {
+        target = (target + framing) / mss * mss - framing;
+    }
+    if (target > HTTP_STREAM_BUFFER_SIZE - framing) target = HTTP_STREAM_BUFFER_SIZE - framing;
+    if (target < sizeof(int16_t)) target = sizeof(int16_t);
+
+    unsigned long last_send = halMillis();
+    int chunks_sent = 0;
+    uint64_t dropped = 0;
+
+    httpDebugLog("[DEBUG] 开始音频流传输 (目标延迟 %u ms, chunk %u 字节, MSS %u)...\n",
+                 (unsigned)latency_ms, (unsigned)target, (unsigned)mss);
+
+    while (!httpPeerClosed(fd)) {
+        uint64_t avail = audio_ring.head() - cursor;
+        int64_t age_us = avail > 0 ? halNowUs() - audio_ring.sampleTimeUs(cursor) : 0;
+        if (avail * sizeof(int16_t) < target && age_us < (int64_t)latency_ms * 1000) {
+            // 等到攒满一个 chunk 或最旧样本到期，最多睡 50 ms 以便及时发现断开
+            int64_t fill_ms = (int64_t)(target - avail * sizeof(int16_t)) / bytes_per_ms;
+            int64_t due_ms = avail > 0 ? latency_ms - age_us / 1000 : latency_ms;
+            int64_t wait_ms = fill_ms < due_ms ? fill_ms : due_ms;
+            halDelayMs(wait_ms < 5 ? 5 : wait_ms > 50 ? 50 : (uint32_t)wait_ms);
+            continue;
+        }
+
+        size_t room;
+        int16_t *samples = (int16_t *)writer.reserve(&room);
+        if (!samples) break;
+        uint32_t n = audio_ring.read(&cursor, samples, room / sizeof(int16_t), &dropped);
+        if (dropped > 0) {
+            // 刚读到的样本接在缺口之后，不提交
+            metric_audio_stream_gap_samples.add(dropped > UINT32_MAX ? UINT32_MAX : (uint32_t)dropped);
+            halLog("⚠️ 音频流落后于采集环，缺失 %llu 样本，结束流\n", (unsigned long long)dropped);
+            break;
+        }
+        if (n == 0) {
+            halDelayMs(5);
+            continue;
+        }
+
+        size_t total_read = n * sizeof(int16_t);
+        int64_t send_start_us = halNowUs();
+        bool ok = writer.commit(total_read) && writer.flush();
+        uint32_t send_us = (uint32_t)(halNowUs() - send_start_us);
+        if (!ok) break;
+        metric_send_time_us[STREAM_AUDIO].observe(send_us);
+        traceRecord(TRACE_SEND, send_start_us, send_us, total_read);
+        metric_stream_bytes_sent[STREAM_AUDIO].add(total_read);
+
+        chunks_sent++;
+
+        if (halMillis() - last_send > 5000) {
+            httpDebugLog("[DEBUG] 音频流: 已发送 %d 块\n", chunks_sent);
+            last_send = halMillis();
+        }
+    }
+
+    // 发送结束标记
+    writer.finish();
+    stream_chunk_pool.free(buf);
+    httpDebugLog("[DEBUG] 音频流结束，共发送 %d 块\n", chunks_sent);
+}
+
+// 每个新帧作为 multipart 的一部分发送：分隔行和部分头与帧的开头合并成一次 send()，
+// 帧的其余部分直接从帧缓存槽位发送 (发送期间持有帧引用)
+static void runVideoStream(int fd, const JpegRect &roi, CropBuffer &crop) {
+    uint8_t *buf = (uint8_t *)stream_chunk_pool.alloc();
+    HttpStreamWriter writer;
+    writer.begin(fd, buf, HTTP_STREAM_BUFFER_SIZE, false, &metric_stream_writes[STREAM_VIDEO]);
+    httpTuneSocket(fd, HTTP_SOCKET_VIDEO);
+
+    uint32_t last_seq = 0;
+    int frames_sent = 0;
+
+    while (!httpPeerClosed(fd)) {
+        if (frameStoreSeq() == last_seq) {
+            halDelayMs(20);
+            continue;
+        }
+        FrameRef frame;
+        if (!frameStoreAcquire(&frame)) {
+            halDelayMs(20);
+            continue;
+        }
+
+        // 裁剪的帧从流任务自己的缓冲区发送，部分头带 X-Roi
+        const uint8_t *body = frame.buf;
+        size_t frame_len = frame.len;
+        JpegRect aligned;
+        char roi_header[48] = "";
+        size_t crop_len = roi.w && roi.x < frame.width && roi.y < frame.height
+                              ? cropFrame(crop, frame, roi, &aligned) : 0;
+        if (crop_len) {
+            body = crop.out;
+            frame_len = crop_len;
+            snprintf(roi_header, sizeof(roi_header), "X-Roi: %u,%u,%u,%u\r\n",
+                     aligned.x, aligned.y, aligned.w, aligned.h);
+        }
+
+        // 每部分之前的 CRLF 属于分隔符，帧末尾不再单独发送两个字节
+        SceneState scene = sceneCurrent();
+        char part[288];
+        int len = snprintf(part, sizeof(part),
+            "%s--" MJPEG_BOUNDARY "\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n"
+            "X-Frame-Seq: %u\r\nX-Capture-Us: %lld\r\nX-Scene: %u\r\nX-Scene-Start-Us: %lld\r\n%s\r\n",
+            frames_sent > 0 ? "\r\n" : "",
+            (unsigned)frame_len, (unsigned)frame.seq, (long long)frame.timestamp_us,
+            (unsigned)scene.id, (long long)scene.start_us, roi_header);
+        int64_t send_start_us = halNowUs();
+        bool ok = writer.write(part, len) && writer.write(body, frame_len) && writer.flush();
+        uint32_t send_us = (uint32_t)(halNowUs() - send_start_us);
+        last_seq = frame.seq;
+        frameStoreRelease(&frame);
+        if (!ok) break;
+
+        metric_send_time_us[STREAM_VIDEO].observe(send_us);
+        traceRecord(TRACE_SEND, send_start_us, send_us, frame_len);
+        metric_stream_bytes_sent[STREAM_VIDEO].add(frame_len);
+        frames_sent++;
+    }
+
+    if (buf) stream_chunk_pool.free(buf);
+    httpDebugLog("[DEBUG] 视频流结束，共发送 %d 帧\n", frames_sent);
+}
+
+// 一条 SSE 消息 (id / event / data + 空行)，返回写入的字节数，发送失败返回 -1
+static int writeSseEvent(HttpStreamWriter &writer, const Event &e) {
+    char msg[256];
+    int head = snprintf(msg, sizeof(msg), "id: %u\nevent: %s\ndata: ", (unsigned)e.seq, eventTypeName(e.type));
+    int body = eventFormatJson(e, msg + head, sizeof(msg) - head - 2);
+    if (body < 0 || head + body + 2 >= (int)sizeof(msg)) return 0;      // 放不下的事件跳过，不断开
+    msg[head + body] = '\n';
+    msg[head + body + 1] = '\n';
+    return writer.write(msg, head + body + 2) ? head + body + 2 : -1;
+}
+
+/**
+ * 事件流 (Server-Sent Events)：先发一条 clock 消息 (设备时钟到墙上时间的偏移)，
+ * 之后阻塞在 wake 上，发布方写完一条事件即唤醒，立即推送；空闲时每 EVENT_STREAM_IDLE_CHECK_MS
+ * 醒来一次检查连接是否已断开。
+ * 中间的事件已被覆盖 (读者落后一整圈，或设备重启后 Last-Event-ID 大于最新序号) 时
+ * 先发一条 dropped 消息。空闲 EVENT_STREAM_KEEPALIVE_MS 发一行注释保活。
+ */
+static void runEventStream(int fd, uint32_t cursor, HalSemaphore wake) {
+    uint8_t *buf = (uint8_t *)stream_chunk_pool.alloc();
+    HttpStreamWriter writer;
+    writer.begin(fd, buf, HTTP_STREAM_BUFFER_SIZE, false, &metric_stream_writes[STREAM_EVENTS]);
+    httpTuneSocket(fd, HTTP_SOCKET_EVENTS);
+
+    int64_t offset_us;
+    ClockSource source = clockWallOffset(&offset_us);
+    char msg[160];
+    int len = snprintf(msg, sizeof(msg),
+        "retry: 3000\nevent: clock\ndata: {\"clock_source\":\"%s\",\"clock_offset_us\":%lld}\n\n",
+        clockSourceName(source), (long long)(source != CLOCK_SOURCE_NONE ? offset_us : 0));
+    bool ok = writer.write(msg, len) && writer.flush();
+
+    // 先注册再读最新序号：之后写完的事件一定会 give，不会漏掉唤醒
+    eventsAddWaiter(wake);
+
+    // 设备重启过：主机的序号属于上一次开机，从头发送本次开机的事件
+    bool rebooted = cursor > eventsLastSeq();
+    uint32_t events_sent = 0;
+    unsigned long last_send = halMillis();
+
+    while (ok && !httpPeerClosed(fd)) {
+        if (!rebooted && eventsLastSeq() == cursor) {
+            unsigned long idle_ms = halMillis() - last_send;
+            if (idle_ms >= EVENT_STREAM_KEEPALIVE_MS) {
+                ok = writer.write(": keepalive\n\n", 13) && writer.flush();
+                last_send = halMillis();
+                idle_ms = 0;
+            }
+            unsigned long keepalive_ms = EVENT_STREAM_KEEPALIVE_MS - idle_ms;
+            halSemaphoreTake(wake, keepalive_ms < EVENT_STREAM_IDLE_CHECK_MS ? keepalive_ms
+                                                                             : EVENT_STREAM_IDLE_CHECK_MS);
+            continue;
+        }
+
+        Event events[8];
+        uint32_t oldest;
+        uint32_t after = rebooted ? 0 : cursor;
+        int n = eventsRead(after, events, 8, &oldest);
+        if (rebooted || (oldest && after + 1 < oldest)) {
+            len = snprintf(msg, sizeof(msg), "event: dropped\ndata: {\"after\":%u,\"oldest\":%u}\n\n",
+                           (unsigned)cursor, (unsigned)oldest);
+            ok = writer.write(msg, len);
+            rebooted = false;
+            cursor = oldest ? oldest - 1 : 0;
+        }
+        if (n == 0) {
+            // 最新一条还在写入，写完后发布方会 give
+            ok = ok && writer.flush();
+            halSemaphoreTake(wake, EVENT_STREAM_IDLE_CHECK_MS);
+            continue;
+        }
+
+        size_t bytes = 0;
+        for (int i = 0; i < n && ok; i++) {
+            int written = writeSseEvent(writer, events[i]);
+            ok = written >= 0;
+            bytes += written > 0 ? written : 0;
+            cursor = events[i].seq;
+        }
+        int64_t send_start_us = halNowUs();
+        ok = ok && writer.flush();
+        if (!ok) break;
+        uint32_t send_us = (uint32_t)(halNowUs() - send_start_us);
+        metric_send_time_us[STREAM_EVENTS].observe(send_us);
+        metric_stream_bytes_sent[STREAM_EVENTS].add(bytes);
+        events_sent += n;
+        last_send = halMillis();
+    }
+
+    eventsRemoveWaiter(wake);
+    if (buf) stream_chunk_pool.free(buf);
+    httpDebugLog("[DEBUG] 事件流结束，共推送 %u 条\n", (unsigned)events_sent);
+}
+
+static void streamWorkerTask(void *parameter) {
+    StreamWorker *worker = (StreamWorker *)parameter;
+
+    while (1) {
+        if (!halSemaphoreTake(worker->wake, 1000)) continue;
+
+        if (worker->kind == STREAM_AUDIO) {
+            audio_stream_clients++;
+            audio_streaming = true;
+            runAudioStream(worker->fd, worker->cursor, worker->latency_ms);
+            if (--audio_stream_clients == 0) {
+                audio_streaming = false;
+            }
+        } else if (worker->kind == STREAM_EVENTS) {
+            runEventStream(worker->fd, (uint32_t)worker->cursor, worker->events_wake);
+        } else {
+            runVideoStream(worker->fd, worker->roi, worker->crop);
+        }
+        shutdown(worker->fd, SHUT_WR);
+        close(worker->fd);
+
+        stream_clients--;
+        releaseStreamWorker(worker);
+    }
+}
+
+static void streamWorkersBegin() {
+    for (int i = 0; i < MAX_STREAM_CLIENTS; i++) {
+        StreamWorker &worker = stream_workers[i];
+        if (worker.wake) continue;
+        snprintf(worker.name, sizeof(worker.name), "Stream%u", (unsigned)i);
+        worker.wake = halSemaphoreCreate();
+        worker.events_wake = halSemaphoreCreate();
+
+        void *handle = NULL;
+        if (!halTaskCreate(streamWorkerTask, worker.name, TASK_STREAM_STACK, &worker,
+                           TASK_STREAM_PRIORITY, TASK_STREAM_CORE, &handle)) {
+            halLog("❌ 流任务创建失败!\n");
+            worker.wake = NULL;     // 不再分配给这个槽位
+            continue;
+        }
+        sysMonitorWatchTask(handle, worker.name, TASK_STREAM_STACK);
+    }
+}
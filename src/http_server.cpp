@@ -0,0 +1,599 @@
+/**
+ * 精简 HTTP/1.1 服务器实现
+ */
+
+#include "http_server.h"
+#include "metrics.h"
+#include "mem_pool.h"
+#include "hal.h"
+
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// ==================== socket 工具 ====================
+
+bool httpWriteAll(int fd, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+bool httpWriteVec(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // 部分发送：跳过已发出的段，调整剩余段的起点
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return true;
+}
+
+size_t httpTuneSocket(int fd, HttpSocketProfile profile) {
+    // 写入都已在应用层合并成整段，不需要 Nagle 再等 ACK
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    int sndbuf = 0;
+    if (profile == HTTP_SOCKET_AUDIO) sndbuf = HTTP_AUDIO_SNDBUF;
+    if (profile == HTTP_SOCKET_VIDEO) sndbuf = HTTP_VIDEO_SNDBUF;
+    if (sndbuf > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    }
+    if (profile != HTTP_SOCKET_RESPONSE) {
+        struct timeval snd;
+        snd.tv_sec = HTTP_STREAM_SEND_TIMEOUT_MS / 1000;
+        snd.tv_usec = (HTTP_STREAM_SEND_TIMEOUT_MS % 1000) * 1000;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+    }
+
+#ifdef TCP_MAXSEG
+    int mss = 0;
+    socklen_t len = sizeof(mss);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_MAXSEG, &mss, &len) == 0 && mss > 0) {
+        return (size_t)mss;
+    }
+#endif
+    return HTTP_STREAM_MSS;
+}
+
+bool httpPeerClosed(int fd) {
+    char c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return true;
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return true;
+    return false;
+}
+
+const char *httpStatusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 410: return "Gone";
+        case 413: return "Payload Too Large";
+        case 416: return "Range Not Satisfiable";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 原地 URL 解码 (%XX 和 '+')
+static void urlDecode(char *s) {
+    char *out = s;
+    while (*s) {
+        if (*s == '%' && hexValue(s[1]) >= 0 && hexValue(s[2]) >= 0) {
+            *out++ = (char)(hexValue(s[1]) * 16 + hexValue(s[2]));
+            s += 3;
+        } else if (*s == '+') {
+            *out++ = ' ';
+            s++;
+        } else {
+            *out++ = *s++;
+        }
+    }
+    *out = '\0';
+}
+
+// ==================== HttpStreamWriter ====================
+
+#define CHUNK_HEAD_LEN 6    // "XXXX\r\n"
+#define CHUNK_MAX      0xFFFF
+
+static_assert(HTTP_STREAM_BUFFER_SIZE <= CHUNK_MAX, "chunk 头为定宽 4 位十六进制");
+
+void HttpStreamWriter::begin(int fd, uint8_t *buf, size_t cap, bool chunked, Counter *sends) {
+    fd_ = fd;
+    buf_ = buf;
+    cap_ = buf ? cap : 0;
+    len_ = 0;
+    chunked_ = chunked;
+    ok_ = true;
+    sends_ = sends;
+}
+
+bool HttpStreamWriter::sendRaw(const void *data, size_t len) {
+    if (!ok_) return false;
+    if (sends_) sends_->inc();
+    ok_ = httpWriteAll(fd_, data, len);
+    return ok_;
+}
+
+bool HttpStreamWriter::sendVec(struct iovec *iov, int count) {
+    if (!ok_) return false;
+    if (sends_) sends_->inc();
+    ok_ = httpWriteVec(fd_, iov, count);
+    return ok_;
+}
+
+bool HttpStreamWriter::flush() {
+    if (len_ == 0) return ok_;
+    size_t n = len_;
+    len_ = 0;
+    return sendRaw(buf_, n);
+}
+
+bool HttpStreamWriter::append(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0 && ok_) {
+        if (len_ == 0 && len >= cap_) {
+            return sendRaw(p, len);     // 缓冲区已空且剩余数据不小于缓冲区：直接发送
+        }
+        size_t n = cap_ - len_ < len ? cap_ - len_ : len;
+        memcpy(buf_ + len_, p, n);
+        len_ += n;
+        p += n;
+        len -= n;
+        if (len_ == cap_ && !flush()) return false;
+    }
+    return ok_;
+}
+
+uint8_t *HttpStreamWriter::reserve(size_t *room) {
+    *room = 0;
+    if (!chunked_ || cap_ < CHUNK_HEAD_LEN + 2 + 1) return NULL;
+    if (cap_ - len_ < CHUNK_HEAD_LEN + 2 + 1) {
+        if (!flush()) return NULL;
+    }
+    size_t n = cap_ - len_ - CHUNK_HEAD_LEN - 2;
+    *room = n < CHUNK_MAX ? n : CHUNK_MAX;
+    return buf_ + len_ + CHUNK_HEAD_LEN;
+}
+
+bool HttpStreamWriter::commit(size_t len) {
+    if (len == 0) return ok_;
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t *head = buf_ + len_;
+    for (int i = 0; i < 4; i++) {
+        head[i] = hex[(len >> ((3 - i) * 4)) & 0xF];
+    }
+    head[4] = '\r';
+    head[5] = '\n';
+    len_ += CHUNK_HEAD_LEN + len;
+    buf_[len_++] = '\r';
+    buf_[len_++] = '\n';
+    if (len_ == cap_) return flush();
+    return ok_;
+}
+
+bool HttpStreamWriter::write(const void *data, size_t len) {
+    if (!chunked_) return append(data, len);
+    if (len == 0) return ok_;
+    char head[12];
+    int n = snprintf(head, sizeof(head), "%X\r\n", (unsigned)len);
+    if (!buf_) {
+        // 不缓冲时 chunk 头、数据和 CRLF 仍然一次交给协议栈 (TCP_NODELAY 下分开发送就是三个小包)：
+        // 小块拷进栈上缓冲区，大块用 iovec 避免复制
+        if (len <= HTTP_INLINE_BODY_SIZE) {
+            uint8_t out[sizeof(head) + HTTP_INLINE_BODY_SIZE + 2];
+            memcpy(out, head, n);
+            memcpy(out + n, data, len);
+            memcpy(out + n + len, "\r\n", 2);
+            return sendRaw(out, n + len + 2);
+        }
+        struct iovec iov[3] = {
+            { head, (size_t)n },
+            { const_cast<void *>(data), len },
+            { const_cast<char *>("\r\n"), 2 },
+        };
+        return sendVec(iov, 3);
+    }
+    return append(head, n) && append(data, len) && append("\r\n", 2);
+}
+
+bool HttpStreamWriter::finish() {
+    if (chunked_) {
+        if (buf_) {
+            append("0\r\n\r\n", 5);
+        } else {
+            sendRaw("0\r\n\r\n", 5);
+        }
+    }
+    return flush();
+}
+
+// chunked 响应的合并缓冲区 (HTTP 任务串行处理，一块即可)
+static MemPool chunk_pool("http_chunked", HTTP_STREAM_BUFFER_SIZE, 1, MEM_PSRAM);
+
+// ==================== HttpRequest ====================
+
+bool HttpRequest::parse(int fd) {
+    fd_ = fd;
+    responded_ = false;
+    chunked_ = false;
+    detached_ = false;
+    method_ = "";
+    path_ = "";
+    body_ = NULL;
+    body_len_ = 0;
+    arg_count_ = 0;
+    header_count_ = 0;
+    extra_len_ = 0;
+    parse_error_ = 0;
+
+    // 读取到空行为止
+    size_t len = 0;
+    char *header_end = NULL;
+    while (len < sizeof(buf_) - 1) {
+        ssize_t n = recv(fd, buf_ + len, sizeof(buf_) - 1 - len, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        len += (size_t)n;
+        buf_[len] = '\0';
+        header_end = strstr(buf_, "\r\n\r\n");
+        if (header_end) break;
+    }
+    if (!header_end) return false;
+    *header_end = '\0';
+    char *body_start = header_end + 4;
+
+    // 请求行: METHOD SP target SP version
+    char *line_end = strstr(buf_, "\r\n");
+    if (line_end) *line_end = '\0';
+    char *sp1 = strchr(buf_, ' ');
+    if (!sp1) return false;
+    *sp1 = '\0';
+    char *target = sp1 + 1;
+    char *sp2 = strchr(target, ' ');
+    if (sp2) *sp2 = '\0';
+    method_ = buf_;
+    path_ = target;
+
+    // 查询参数
+    char *query = strchr(target, '?');
+    if (query) {
+        *query++ = '\0';
+        while (query && *query && arg_count_ < HTTP_MAX_ARGS) {
+            char *next = strchr(query, '&');
+            if (next) *next++ = '\0';
+            char *eq = strchr(query, '=');
+            if (eq) *eq++ = '\0';
+            urlDecode(query);
+            if (eq) urlDecode(eq);
+            args_[arg_count_].key = query;
+            args_[arg_count_].value = eq ? eq : "";
+            arg_count_++;
+            query = next;
+        }
+    }
+    urlDecode(target);
+
+    // 请求头
+    char *line = line_end ? line_end + 2 : NULL;
+    while (line && *line && header_count_ < HTTP_MAX_HEADERS) {
+        char *next = strstr(line, "\r\n");
+        if (next) { *next = '\0'; next += 2; }
+        char *colon = strchr(line, ':');
+        if (colon) {
+            *colon = '\0';
+            char *value = colon + 1;
+            while (*value == ' ') value++;
+            headers_[header_count_].key = line;
+            headers_[header_count_].value = value;
+            header_count_++;
+        }
+        line = next;
+    }
+
+    // 请求体 (仅支持能放进缓冲区的小请求体)：放不下回复 413，读不全回复 400，
+    // 不把截断的请求体交给处理函数 (截断的 JSON 可能仍能解析)
+    const char *content_length = header("Content-Length");
+    if (content_length) {
+        char *end;
+        unsigned long want = strtoul(content_length, &end, 10);
+        if (end == content_length) {
+            parse_error_ = 400;
+            return false;
+        }
+        size_t have = len - (size_t)(body_start - buf_);
+        size_t room = sizeof(buf_) - 1 - (size_t)(body_start - buf_);
+        if (want > room) {
+            parse_error_ = 413;
+            return false;
+        }
+        while (have < want) {
+            ssize_t n = recv(fd, body_start + have, want - have, 0);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                parse_error_ = 400;
+                return false;
+            }
+            have += (size_t)n;
+        }
+        body_start[want] = '\0';
+        body_ = body_start;
+        body_len_ = want;
+    }
+    return true;
+}
+
+bool HttpRequest::hasArg(const char *name) const {
+    for (uint8_t i = 0; i < arg_count_; i++) {
+        if (strcmp(args_[i].key, name) == 0) return true;
+    }
+    return false;
+}
+
+const char *HttpRequest::arg(const char *name) const {
+    for (uint8_t i = 0; i < arg_count_; i++) {
+        if (strcmp(args_[i].key, name) == 0) return args_[i].value;
+    }
+    return "";
+}
+
+const char *HttpRequest::header(const char *name) const {
+    for (uint8_t i = 0; i < header_count_; i++) {
+        if (strcasecmp(headers_[i].key, name) == 0) return headers_[i].value;
+    }
+    return NULL;
+}
+
+void HttpRequest::sendHeader(const char *name, const char *value) {
+    int n = snprintf(extra_headers_ + extra_len_, sizeof(extra_headers_) - extra_len_,
+                     "%s: %s\r\n", name, value);
+    if (n > 0 && extra_len_ + (size_t)n < sizeof(extra_headers_)) {
+        extra_len_ += (size_t)n;
+    } else {
+        extra_headers_[extra_len_] = '\0';
+        halLog("[WARN] HTTP 响应头缓冲区已满，丢弃 %s\n", name);
+    }
+}
+
+bool HttpRequest::sendHeaders(int code, const char *content_type, long content_length) {
+    return sendHead(code, content_type, content_length, NULL, 0);
+}
+
+// 状态行、自定义头、空行和不超过 HTTP_INLINE_BODY_SIZE 的响应体合并成一次写入
+bool HttpRequest::sendHead(int code, const char *content_type, long content_length,
+                           const void *body, size_t body_len) {
+    if (responded_ || fd_ < 0) return false;
+    responded_ = true;
+
+    char head[160];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n",
+                     code, httpStatusText(code), content_type);
+    if (content_length >= 0) {
+        n += snprintf(head + n, sizeof(head) - n, "Content-Length: %ld\r\n", content_length);
+    }
+    n += snprintf(head + n, sizeof(head) - n, "Connection: close\r\n");
+
+    char out[sizeof(head) + HTTP_RESPONSE_HEADER_SIZE + 2 + HTTP_INLINE_BODY_SIZE];
+    memcpy(out, head, n);
+    memcpy(out + n, extra_headers_, extra_len_);
+    memcpy(out + n + extra_len_, "\r\n", 2);
+    size_t total = n + extra_len_ + 2;
+    if (body_len > 0) {
+        memcpy(out + total, body, body_len);
+        total += body_len;
+    }
+    return httpWriteAll(fd_, out, total);
+}
+
+bool HttpRequest::write(const void *data, size_t len) {
+    if (fd_ < 0) return false;
+    return httpWriteAll(fd_, data, len);
+}
+
+void HttpRequest::send(int code, const char *content_type, const void *body, size_t len) {
+    if (len <= HTTP_INLINE_BODY_SIZE) {
+        sendHead(code, content_type, (long)len, body, len);
+        return;
+    }
+    if (sendHeaders(code, content_type, (long)len)) {
+        write(body, len);
+    }
+}
+
+void HttpRequest::send(int code, const char *content_type, const char *text) {
+    send(code, content_type, text, strlen(text));
+}
+
+bool HttpRequest::beginChunked(int code, const char *content_type) {
+    sendHeader("Transfer-Encoding", "chunked");
+    if (!sendHeaders(code, content_type, -1)) return false;
+    chunked_ = true;
+    // 合并缓冲区不可用时退回不缓冲的写入
+    chunk_buf_ = (uint8_t *)chunk_pool.alloc();
+    chunk_writer_.begin(fd_, chunk_buf_, HTTP_STREAM_BUFFER_SIZE, true);
+    return true;
+}
+
+bool HttpRequest::sendChunk(const void *data, size_t len) {
+    if (!chunked_) return false;
+    return chunk_writer_.write(data, len);
+}
+
+void HttpRequest::endChunked() {
+    if (chunked_) {
+        chunk_writer_.finish();
+        chunked_ = false;
+    }
+    if (chunk_buf_) {
+        chunk_pool.free(chunk_buf_);
+        chunk_buf_ = nullptr;
+    }
+}
+
+int HttpRequest::detach() {
+    // 发出已缓冲的数据但不发送结束块，流任务接着用自己的写入器继续分块
+    if (chunked_) {
+        chunk_writer_.flush();
+        chunked_ = false;
+    }
+    endChunked();
+    int fd = fd_;
+    detached_ = true;
+    responded_ = true;
+    fd_ = -1;
+    return fd;
+}
+
+// ==================== HttpServer ====================
+
+bool HttpServer::begin(uint16_t port, const char *bind_addr) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listen_fd_ < 0) {
+        halLog("❌ 创建监听 socket 失败: %d\n", errno);
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = bind_addr ? inet_addr(bind_addr) : htonl(INADDR_ANY);
+
+    if (bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd_, 4) < 0) {
+        halLog("❌ 监听端口 %u 失败: %d\n", port, errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::on(const char *path, HttpHandler handler) {
+    if (route_count_ >= HTTP_MAX_ROUTES) {
+        halLog("❌ 路由表已满，忽略 %s\n", path);
+        return;
+    }
+    routes_[route_count_].path = path;
+    routes_[route_count_].handler = handler;
+    route_count_++;
+}
+
+void HttpServer::handleClient(uint32_t timeout_ms) {
+    if (listen_fd_ < 0) {
+        halDelayMs(timeout_ms);
+        return;
+    }
+
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(listen_fd_, &readfds);
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    if (select(listen_fd_ + 1, &readfds, NULL, NULL, &tv) <= 0) return;
+
+    int fd = accept(listen_fd_, NULL, NULL);
+    if (fd < 0) return;
+
+    struct timeval rcv;
+    rcv.tv_sec = HTTP_RECV_TIMEOUT_MS / 1000;
+    rcv.tv_usec = (HTTP_RECV_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rcv, sizeof(rcv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &rcv, sizeof(rcv));
+    httpTuneSocket(fd, HTTP_SOCKET_RESPONSE);
+
+    HttpRequest &req = request_;
+    if (!req.parse(fd)) {
+        // 请求体过大或不完整时回复状态码，请求头不完整 (连接错误、超时) 直接关闭
+        if (req.parse_error_) {
+            req.send(req.parse_error_, "text/plain", httpStatusText(req.parse_error_));
+            shutdown(fd, SHUT_WR);
+        }
+        close(fd);
+        req.fd_ = -1;
+        return;
+    }
+
+    HttpHandler handler = not_found_;
+    for (uint8_t i = 0; i < route_count_; i++) {
+        if (strcmp(routes_[i].path, req.path()) == 0) {
+            handler = routes_[i].handler;
+            break;
+        }
+    }
+
+    if (handler) {
+        handler(req);
+    }
+    if (!req.responded()) {
+        req.send(404, "text/plain", "Not Found");
+    }
+    if (!req.detached_) {
+        req.endChunked();
+        // 半关闭后再关闭，避免对端尚未读完时收到 RST
+        shutdown(fd, SHUT_WR);
+        close(fd);
+    }
+    req.fd_ = -1;
+}
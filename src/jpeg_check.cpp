@@ -0,0 +1,59 @@
+/**
+ * JPEG 帧校验实现
+ */
+
+#include "jpeg_check.h"
+
+static const char *const STATUS_NAMES[JPEG_STATUS_COUNT] = {
+    "ok", "no_soi", "bad_header", "no_eoi"
+};
+
+const char *jpegStatusName(JpegStatus status) {
+    return status < JPEG_STATUS_COUNT ? STATUS_NAMES[status] : "unknown";
+}
+
+// 跳过 SOS 之前的头部段，返回 SOS 段之后的位置；结构错误返回 0
+static size_t skipHeader(const uint8_t *buf, size_t len) {
+    size_t pos = 2;
+    while (pos + 1 < len) {
+        if (buf[pos] != 0xFF) return 0;
+        uint8_t marker = buf[pos + 1];
+        pos += 2;
+        if (marker == 0xFF) {               // 填充字节：marker 前允许任意个 FF
+            pos--;
+            continue;
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;    // 无长度的标记
+        if (marker == 0xD8 || marker == 0xD9 || marker == 0x00) return 0;      // 头部中不应出现
+        if (pos + 2 > len) return 0;
+        size_t seg_len = ((size_t)buf[pos] << 8) | buf[pos + 1];
+        if (seg_len < 2 || pos + seg_len > len) return 0;
+        pos += seg_len;
+        if (marker == 0xDA) return pos;     // SOS：之后是熵编码数据
+    }
+    return 0;
+}
+
+JpegCheck jpegValidate(const uint8_t *buf, size_t len) {
+    JpegCheck result = { JPEG_NO_SOI, 0 };
+    if (len < 4 || buf[0] != 0xFF || buf[1] != 0xD8) return result;
+
+    size_t data_start = skipHeader(buf, len);
+    if (data_start == 0) {
+        result.status = JPEG_BAD_HEADER;
+        return result;
+    }
+
+    // 从末尾向前找 FFD9，不越过熵编码数据的起点
+    size_t stop = len > JPEG_EOI_SEARCH_BYTES + 2 ? len - JPEG_EOI_SEARCH_BYTES - 2 : 0;
+    if (stop < data_start) stop = data_start;
+    for (size_t i = len - 1; i > stop; i--) {
+        if (buf[i] == 0xD9 && buf[i - 1] == 0xFF) {
+            result.status = JPEG_OK;
+            result.len = i + 1;
+            return result;
+        }
+    }
+    result.status = JPEG_NO_EOI;
+    return result;
+}
@@ -0,0 +1,68 @@
+/**
+ * JPEG 域 ROI 裁剪实现
+ */
+
+#include "jpeg_crop.h"
+
+size_t jpegCrop(const uint8_t *jpeg, size_t len, const JpegRect &roi, JpegRecodeWork *work,
+                uint8_t *out, size_t out_cap, JpegRect *aligned) {
+    if (!jpegRecodeBegin(jpeg, len, work)) return 0;
+    const JpegHeader &hdr = work->hdr;
+    if (roi.w == 0 || roi.h == 0 || roi.x >= hdr.width || roi.y >= hdr.height) return 0;
+
+    // 向外对齐到 MCU，右 / 下边超出帧时截到帧边缘
+    int mcu_w = 8 * hdr.hmax;
+    int mcu_h = 8 * hdr.vmax;
+    int right = roi.x + roi.w < hdr.width ? roi.x + roi.w : hdr.width;
+    int bottom = roi.y + roi.h < hdr.height ? roi.y + roi.h : hdr.height;
+    int mx0 = roi.x / mcu_w;
+    int my0 = roi.y / mcu_h;
+    int mx1 = (right + mcu_w - 1) / mcu_w;
+    int my1 = (bottom + mcu_h - 1) / mcu_h;
+    aligned->x = (uint16_t)(mx0 * mcu_w);
+    aligned->y = (uint16_t)(my0 * mcu_h);
+    aligned->w = (uint16_t)((mx1 * mcu_w < hdr.width ? mx1 * mcu_w : hdr.width) - aligned->x);
+    aligned->h = (uint16_t)((my1 * mcu_h < hdr.height ? my1 * mcu_h : hdr.height) - aligned->y);
+
+    JpegBitWriter bw;
+    jpegBitWriterBegin(bw, out, out_cap);
+    jpegCopyHeader(jpeg, hdr, aligned->w, aligned->h, bw);
+
+    JpegBitReader br;
+    jpegBitReaderBegin(br, jpeg, len, hdr.scan_start);
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };        // 原帧的 DC 预测值
+    int out_pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };    // 输出的 DC 预测值
+    int restart_left = hdr.restart_interval;
+    // 区域最后一个 MCU 之后的数据不需要读
+    int last = (my1 - 1) * hdr.mcux + mx1 - 1;
+
+    for (int m = 0; m <= last; m++) {
+        if (hdr.restart_interval) {
+            if (restart_left == 0) {
+                jpegBitReaderRestart(br);
+                for (int i = 0; i < hdr.ncomp; i++) pred[i] = 0;
+                restart_left = hdr.restart_interval;
+            }
+            restart_left--;
+        }
+
+        int mx = m % hdr.mcux;
+        int my = m / hdr.mcux;
+        bool inside = mx >= mx0 && mx < mx1 && my >= my0;
+        for (int ci = 0; ci < hdr.ncomp; ci++) {
+            const JpegComponent &c = hdr.comp[ci];
+            for (int b = 0; b < c.h * c.v; b++) {
+                if (!jpegReadDc(br, hdr.dc[c.td], &pred[ci])) return 0;
+                if (inside) {
+                    if (!jpegPutDc(bw, work->dc[c.td], pred[ci] - out_pred[ci])) return 0;
+                    out_pred[ci] = pred[ci];
+                }
+                if (!jpegCopyAc(br, hdr.ac[c.ta], inside ? &bw : NULL, work->ac[c.ta])) return 0;
+            }
+        }
+        if (!bw.ok) return 0;
+    }
+
+    jpegFinishScan(bw);
+    return bw.ok ? bw.len : 0;
+}
@@ -0,0 +1,274 @@
+/**
+ * 基线 JPEG 头部解析与熵编解码实现
+ */
+
+#include "jpeg_entropy.h"
+#include <string.h>
+
+// ==================== 头部解析 ====================
+
+// 码长表不合法 (某一码长的码字超出该长度能表示的范围) 时返回 false
+static bool buildDecoder(JpegHuffDecoder &h, const uint8_t *bits, const uint8_t *vals, int count) {
+    memset(&h, 0, sizeof(h));
+    memcpy(h.bits, bits, 16);
+    memcpy(h.vals, vals, count);
+    int code = 0;
+    int k = 0;
+    for (int l = 1; l <= 16; l++) {
+        h.valptr[l] = (uint8_t)k;
+        h.mincode[l] = (uint16_t)code;
+        if (code + bits[l - 1] > (1 << l)) return false;
+        for (int i = 0; i < bits[l - 1]; i++) {
+            if (l <= 8) {
+                int first = code << (8 - l);
+                for (int j = 0; j < (1 << (8 - l)); j++) {
+                    h.look[first | j] = (uint16_t)((l << 8) | vals[k]);
+                }
+            }
+            code++;
+            k++;
+        }
+        h.maxcode[l] = bits[l - 1] ? code - 1 : -1;
+        code <<= 1;
+    }
+    h.maxcode[17] = 0x7FFFFFFF;
+    h.present = true;
+    return true;
+}
+
+static inline uint16_t be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+bool jpegParseHeader(const uint8_t *buf, size_t len, JpegHeader *out, bool with_tables) {
+    memset(out, 0, sizeof(*out));
+    JpegHeader &hdr = *out;
+    if (len < 4 || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+    size_t pos = 2;
+    bool have_sof = false;
+    while (pos + 4 <= len) {
+        if (buf[pos] != 0xFF) return false;
+        uint8_t marker = buf[pos + 1];
+        if (marker == 0xFF) {
+            pos++;
+            continue;
+        }
+        size_t seg_len = be16(buf + pos + 2);
+        if (seg_len < 2 || pos + 2 + seg_len > len) return false;
+        const uint8_t *p = buf + pos + 4;
+        size_t n = seg_len - 2;
+
+        if (marker == 0xC0 || marker == 0xC1) {
+            if (n < 6 || p[0] != 8) return false;
+            hdr.height = be16(p + 1);
+            hdr.width = be16(p + 3);
+            hdr.ncomp = p[5];
+            if ((hdr.ncomp != 1 && hdr.ncomp != 3) || n < 6u + hdr.ncomp * 3u) return false;
+            if (hdr.width == 0 || hdr.height == 0) return false;
+            hdr.hmax = hdr.vmax = 1;
+            for (int i = 0; i < hdr.ncomp; i++) {
+                JpegComponent &c = hdr.comp[i];
+                c.id = p[6 + i * 3];
+                c.h = p[7 + i * 3] >> 4;
+                c.v = p[7 + i * 3] & 15;
+                c.tq = p[8 + i * 3] & 3;
+                if (c.h < 1 || c.h > 2 || c.v < 1 || c.v > 2) return false;
+                if (c.h > hdr.hmax) hdr.hmax = c.h;
+                if (c.v > hdr.vmax) hdr.vmax = c.v;
+            }
+            hdr.mcux = (hdr.width + 8 * hdr.hmax - 1) / (8 * hdr.hmax);
+            hdr.mcuy = (hdr.height + 8 * hdr.vmax - 1) / (8 * hdr.vmax);
+            hdr.sof_pos = pos;
+            have_sof = true;
+            if (!with_tables) return true;
+        } else if ((marker >= 0xC2 && marker <= 0xCF) && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            return false;           // 渐进式 / 无损 / 算术编码
+        } else if (marker == 0xDB && with_tables) {
+            size_t i = 0;
+            while (i < n) {
+                uint8_t pq = p[i] >> 4;
+                uint8_t tq = p[i] & 3;
+                size_t size = pq ? 129 : 65;
+                if (i + size > n) return false;
+                hdr.qdc[tq] = pq ? be16(p + i + 1) : p[i + 1];
+                i += size;
+            }
+        } else if (marker == 0xC4 && with_tables) {
+            size_t i = 0;
+            while (i + 17 <= n) {
+                uint8_t tc = p[i] >> 4;
+                uint8_t th = p[i] & 3;
+                int count = 0;
+                for (int l = 0; l < 16; l++) count += p[i + 1 + l];
+                if (count > 256 || i + 17 + count > n) return false;
+                if (!buildDecoder(tc ? hdr.ac[th] : hdr.dc[th], p + i + 1, p + i + 17, count)) return false;
+                i += 17 + count;
+            }
+        } else if (marker == 0xDD && with_tables) {
+            if (n < 2) return false;
+            hdr.restart_interval = be16(p);
+        } else if (marker == 0xDA) {
+            if (!have_sof || n < 1 || p[0] != hdr.ncomp || n < 1u + hdr.ncomp * 2u) return false;
+            for (int i = 0; i < hdr.ncomp; i++) {
+                uint8_t id = p[1 + i * 2];
+                JpegComponent *c = NULL;
+                for (int j = 0; j < hdr.ncomp; j++) {
+                    if (hdr.comp[j].id == id) c = &hdr.comp[j];
+                }
+                if (!c) return false;
+                c->td = p[2 + i * 2] >> 4 & 3;
+                c->ta = p[2 + i * 2] & 3;
+                if (!hdr.dc[c->td].present || !hdr.ac[c->ta].present) return false;
+            }
+            hdr.sos_pos = pos;
+            hdr.scan_start = pos + 2 + seg_len;
+            return true;
+        }
+        pos += 2 + seg_len;
+    }
+    return false;
+}
+
+// ==================== 解码 ====================
+
+void jpegBitReaderBegin(JpegBitReader &br, const uint8_t *buf, size_t len, size_t pos) {
+    br.p = buf + pos;
+    br.end = buf + len;
+    br.acc = 0;
+    br.nbits = 0;
+    br.marker = false;
+}
+
+void jpegBitReaderRestart(JpegBitReader &br) {
+    br.acc = 0;
+    br.nbits = 0;
+    br.marker = false;
+    if (br.p + 1 < br.end && br.p[0] == 0xFF && (br.p[1] & 0xF8) == 0xD0) br.p += 2;
+}
+
+// ==================== 编码 ====================
+
+void jpegBuildEncoder(JpegHuffEncoder &e, const uint8_t *bits, const uint8_t *vals) {
+    memset(&e, 0, sizeof(e));
+    int code = 0;
+    int k = 0;
+    for (int l = 1; l <= 16; l++) {
+        for (int i = 0; i < bits[l - 1]; i++) {
+            e.code[vals[k]] = (uint16_t)code++;
+            e.size[vals[k]] = (uint8_t)l;
+            k++;
+        }
+        code <<= 1;
+    }
+}
+
+void jpegBitWriterBegin(JpegBitWriter &bw, uint8_t *out, size_t cap) {
+    bw.out = out;
+    bw.cap = cap;
+    bw.len = 0;
+    bw.acc = 0;
+    bw.nbits = 0;
+    bw.ok = true;
+}
+
+void jpegPutByte(JpegBitWriter &bw, uint8_t b) {
+    if (bw.len < bw.cap) {
+        bw.out[bw.len++] = b;
+    } else {
+        bw.ok = false;
+    }
+}
+
+void jpegPutBytes(JpegBitWriter &bw, const uint8_t *data, size_t n) {
+    if (bw.len + n > bw.cap) {
+        bw.ok = false;
+        bw.len = bw.cap;
+        return;
+    }
+    memcpy(bw.out + bw.len, data, n);
+    bw.len += n;
+}
+
+void jpegPutBits(JpegBitWriter &bw, uint32_t value, int n) {
+    bw.acc = (bw.acc << n) | (value & ((1u << n) - 1));
+    bw.nbits += n;
+    while (bw.nbits >= 8) {
+        uint8_t b = (uint8_t)(bw.acc >> (bw.nbits - 8));
+        jpegPutByte(bw, b);
+        if (b == 0xFF) jpegPutByte(bw, 0x00);   // 熵编码数据中的 FF 填充
+        bw.nbits -= 8;
+    }
+}
+
+void jpegPutMarker(JpegBitWriter &bw, uint8_t marker, uint16_t seg_len) {
+    jpegPutByte(bw, 0xFF);
+    jpegPutByte(bw, marker);
+    jpegPutByte(bw, (uint8_t)(seg_len >> 8));
+    jpegPutByte(bw, (uint8_t)seg_len);
+}
+
+void jpegFinishScan(JpegBitWriter &bw) {
+    if (bw.nbits > 0) jpegPutBits(bw, 0x7F, 8 - bw.nbits);
+    jpegPutByte(bw, 0xFF);
+    jpegPutByte(bw, 0xD9);
+}
+
+// ==================== 重新编码 ====================
+
+bool jpegRecodeBegin(const uint8_t *jpeg, size_t len, JpegRecodeWork *work) {
+    JpegHeader &hdr = work->hdr;
+    if (!jpegParseHeader(jpeg, len, &hdr, true)) return false;
+    for (int i = 0; i < hdr.ncomp; i++) {
+        const JpegComponent &c = hdr.comp[i];
+        jpegBuildEncoder(work->dc[c.td], hdr.dc[c.td].bits, hdr.dc[c.td].vals);
+        jpegBuildEncoder(work->ac[c.ta], hdr.ac[c.ta].bits, hdr.ac[c.ta].vals);
+    }
+    return true;
+}
+
+void jpegCopyHeader(const uint8_t *jpeg, const JpegHeader &hdr, uint16_t width, uint16_t height,
+                    JpegBitWriter &bw) {
+    jpegPutBytes(bw, jpeg, 2);
+    size_t pos = 2;
+    while (pos < hdr.sos_pos) {
+        if (jpeg[pos + 1] == 0xFF) {
+            pos++;
+            continue;
+        }
+        size_t seg = 2 + be16(jpeg + pos + 2);
+        if (jpeg[pos + 1] != 0xDD) {
+            size_t start = bw.len;
+            jpegPutBytes(bw, jpeg + pos, seg);
+            if (pos == hdr.sof_pos && bw.ok) {
+                bw.out[start + 5] = (uint8_t)(height >> 8);
+                bw.out[start + 6] = (uint8_t)height;
+                bw.out[start + 7] = (uint8_t)(width >> 8);
+                bw.out[start + 8] = (uint8_t)width;
+            }
+        }
+        pos += seg;
+    }
+    jpegPutBytes(bw, jpeg + hdr.sos_pos, hdr.scan_start - hdr.sos_pos);
+}
+
+bool jpegCopyAc(JpegBitReader &br, const JpegHuffDecoder &ac, JpegBitWriter *bw,
+                const JpegHuffEncoder &enc) {
+    for (int k = 1; k < 64;) {
+        int rs = jpegDecodeSymbol(br, ac);
+        if (rs < 0) return false;
+        int r = rs >> 4;
+        int size = rs & 15;
+        uint32_t extra = jpegGetBits(br, size);
+        if (bw) {
+            jpegPutBits(*bw, enc.code[rs], enc.size[rs]);
+            if (size) jpegPutBits(*bw, extra, size);
+        }
+        if (size == 0) {
+            if (r != 15) break;         // EOB
+            k += 16;
+            continue;
+        }
+        k += r + 1;
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+/**
+ * JPEG 域隐私遮挡实现
+ */
+
+#include "jpeg_mask.h"
+#include <string.h>
+
+// 矩形换算成 MCU 范围 [x0, x1) x [y0, y1)
+struct MaskSpan {
+    int x0, y0, x1, y1;
+};
+
+// 第一个遮挡的 MCU 之前，输出与原帧逐位相同：只解码不写出，到这里再把原数据整段复制过来。
+// 读取器 acc 中还有 nbits 位未消耗 (最后一个字节可能只消耗了一部分)，往回退到对应的源字节
+static bool copyPrefix(const uint8_t *jpeg, size_t scan_start, const JpegBitReader &br,
+                       JpegBitWriter &bw) {
+    if (br.marker) return false;            // acc 中含有补的 0，无法对应到源数据
+    const uint8_t *start = jpeg + scan_start;
+    const uint8_t *q = br.p;
+    int partial = br.nbits % 8;             // 部分消耗的字节中剩余的位数
+    int back = br.nbits / 8 + (partial ? 1 : 0);
+    for (int i = 0; i < back; i++) {
+        q--;
+        if (*q == 0x00 && q - 1 >= start && q[-1] == 0xFF) q--;      // 填充的 FF00 是一个数据字节
+    }
+    jpegPutBytes(bw, start, q - start);
+    if (partial) jpegPutBits(bw, *q >> partial, 8 - partial);
+    return true;
+}
+
+// 最后一个遮挡的 MCU 之后 (DC 预测已与原帧一致)，剩余数据不再解码，按位原样接到输出后面：
+// 输出恰好字节对齐时整段复制，否则逐字节移位写出 (FF 由 jpegPutBits 重新填充)
+static bool copyTail(JpegBitReader &br, JpegBitWriter &bw) {
+    if (br.marker) return false;
+    if (br.nbits > 16) {
+        jpegPutBits(bw, br.acc >> 16, 16);
+        br.acc <<= 16;
+        br.nbits -= 16;
+    }
+    if (br.nbits) jpegPutBits(bw, br.acc >> (32 - br.nbits), br.nbits);
+
+    const uint8_t *p = br.p;
+    const uint8_t *end = p;
+    while (end < br.end && !(end[0] == 0xFF && (end + 1 >= br.end || end[1] != 0x00))) {
+        end += end[0] == 0xFF ? 2 : 1;
+    }
+    if (bw.nbits == 0) {
+        jpegPutBytes(bw, p, end - p);
+        return true;
+    }
+    while (p < end) {
+        jpegPutBits(bw, *p, 8);
+        p += *p == 0xFF ? 2 : 1;
+    }
+    return true;
+}
+
+size_t jpegMask(const uint8_t *jpeg, size_t len, const JpegRect *rects, int count,
+                JpegRecodeWork *work, uint8_t *out, size_t out_cap) {
+    if (!jpegRecodeBegin(jpeg, len, work)) return 0;
+    const JpegHeader &hdr = work->hdr;
+
+    int mcu_w = 8 * hdr.hmax;
+    int mcu_h = 8 * hdr.vmax;
+    MaskSpan spans[JPEG_MASK_MAX_RECTS];
+    int nspans = 0;
+    for (int i = 0; i < count && i < JPEG_MASK_MAX_RECTS; i++) {
+        const JpegRect &r = rects[i];
+        if (r.w == 0 || r.h == 0 || r.x >= hdr.width || r.y >= hdr.height) continue;
+        int right = r.x + r.w < hdr.width ? r.x + r.w : hdr.width;
+        int bottom = r.y + r.h < hdr.height ? r.y + r.h : hdr.height;
+        spans[nspans++] = { r.x / mcu_w, r.y / mcu_h, (right + mcu_w - 1) / mcu_w,
+                            (bottom + mcu_h - 1) / mcu_h };
+    }
+    int first = hdr.mcux * hdr.mcuy;        // 第一个 / 最后一个遮挡的 MCU
+    int last = -1;
+    for (int i = 0; i < nspans; i++) {
+        int a = spans[i].y0 * hdr.mcux + spans[i].x0;
+        int b = (spans[i].y1 - 1) * hdr.mcux + spans[i].x1 - 1;
+        first = a < first ? a : first;
+        last = b > last ? b : last;
+    }
+    if (nspans == 0) {
+        if (len > out_cap) return 0;
+        memcpy(out, jpeg, len);
+        return len;
+    }
+
+    // 遮挡块的量化 DC：亮度为黑 (电平平移后 -128，DC = -128 * 8)，色度为 0 (中性)
+    int black_dc[JPEG_MAX_COMPONENTS];
+    for (int ci = 0; ci < hdr.ncomp; ci++) {
+        int q = hdr.qdc[hdr.comp[ci].tq] ? hdr.qdc[hdr.comp[ci].tq] : 1;
+        black_dc[ci] = ci == 0 ? -((1024 + q / 2) / q) : 0;
+        if (work->ac[hdr.comp[ci].ta].size[0x00] == 0) return 0;       // 没有 EOB 码字
+    }
+
+    JpegBitWriter bw;
+    jpegBitWriterBegin(bw, out, out_cap);
+    jpegCopyHeader(jpeg, hdr, hdr.width, hdr.height, bw);
+
+    JpegBitReader br;
+    jpegBitReaderBegin(br, jpeg, len, hdr.scan_start);
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };        // 原帧的 DC 预测值
+    int out_pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };    // 输出的 DC 预测值
+    int restart_left = hdr.restart_interval;
+    int total = hdr.mcux * hdr.mcuy;
+    // 输出不带 DRI，带重启间隔的帧不能整段复制原数据，每个块都重新写出
+    bool direct = hdr.restart_interval == 0;
+
+    for (int m = 0; m < total; m++) {
+        if (direct && m == first) {
+            if (!copyPrefix(jpeg, hdr.scan_start, br, bw)) return 0;
+            for (int i = 0; i < hdr.ncomp; i++) out_pred[i] = pred[i];
+        }
+        // 遮挡区之后完整的一个 MCU 写完，各分量的 DC 预测都已回到原帧的值
+        if (direct && m == last + 2 && copyTail(br, bw)) break;
+        bool write = !direct || m >= first;
+
+        if (hdr.restart_interval) {
+            if (restart_left == 0) {
+                jpegBitReaderRestart(br);
+                for (int i = 0; i < hdr.ncomp; i++) pred[i] = 0;
+                restart_left = hdr.restart_interval;
+            }
+            restart_left--;
+        }
+
+        int mx = m % hdr.mcux;
+        int my = m / hdr.mcux;
+        bool masked = false;
+        for (int i = 0; i < nspans && !masked; i++) {
+            masked = mx >= spans[i].x0 && mx < spans[i].x1 && my >= spans[i].y0 && my < spans[i].y1;
+        }
+        for (int ci = 0; ci < hdr.ncomp; ci++) {
+            const JpegComponent &c = hdr.comp[ci];
+            const JpegHuffEncoder &ac_enc = work->ac[c.ta];
+            for (int b = 0; b < c.h * c.v; b++) {
+                // 遮挡块仍要读完原数据 (后续块的位置和 DC 预测依赖它)，只是不写出
+                if (!jpegReadDc(br, hdr.dc[c.td], &pred[ci])) return 0;
+                if (!write) {
+                    if (!jpegCopyAc(br, hdr.ac[c.ta], NULL, ac_enc)) return 0;
+                    continue;
+                }
+                int dc = masked ? black_dc[ci] : pred[ci];
+                if (!jpegPutDc(bw, work->dc[c.td], dc - out_pred[ci])) return 0;
+                out_pred[ci] = dc;
+                if (!jpegCopyAc(br, hdr.ac[c.ta], masked ? NULL : &bw, ac_enc)) return 0;
+                if (masked) jpegPutBits(bw, ac_enc.code[0x00], ac_enc.size[0x00]);
+            }
+        }
+        if (!bw.ok) return 0;
+    }
+
+    jpegFinishScan(bw);
+    return bw.ok ? bw.len : 0;
+}
@@ -0,0 +1,375 @@
+/**
+ * 1/8 缩略图实现：DC 系数提取 + 最小基线 JPEG 编码器 (熵编解码见 jpeg_entropy.cpp)
+ */
+
+#include "jpeg_thumb.h"
+#include "jpeg_entropy.h"
+#include <string.h>
+#include <math.h>
+
+// 各分量的 DC 平面：每个块一个字节 (块平均值)
+struct DcPlanes {
+    uint8_t *plane[JPEG_MAX_COMPONENTS];
+    int stride[JPEG_MAX_COMPONENTS];        // 平面宽度 (块)
+};
+
+static size_t planeBytes(const JpegHeader &hdr) {
+    size_t total = 0;
+    for (int i = 0; i < hdr.ncomp; i++) {
+        total += (size_t)hdr.mcux * hdr.comp[i].h * hdr.mcuy * hdr.comp[i].v;
+    }
+    return total;
+}
+
+size_t jpegThumbWorkBytes(uint16_t width, uint16_t height) {
+    // 3 个分量都按 16x16 的 MCU 补齐，覆盖 4:4:4 / 4:2:2 / 4:2:0
+    size_t blocks_x = (width + 15) / 16 * 2;
+    size_t blocks_y = (height + 15) / 16 * 2;
+    return sizeof(JpegHeader) + 3 * blocks_x * blocks_y;
+}
+
+// ==================== 熵解码 (只保留 DC) ====================
+
+static bool decodeDc(const uint8_t *buf, size_t len, const JpegHeader &hdr, DcPlanes &planes) {
+    JpegBitReader br;
+    jpegBitReaderBegin(br, buf, len, hdr.scan_start);
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };
+    int mcus = hdr.mcux * hdr.mcuy;
+    int restart_left = hdr.restart_interval;
+
+    for (int m = 0; m < mcus; m++) {
+        if (hdr.restart_interval) {
+            if (restart_left == 0) {
+                // 重启间隔边界：DC 预测值清零
+                jpegBitReaderRestart(br);
+                for (int i = 0; i < hdr.ncomp; i++) pred[i] = 0;
+                restart_left = hdr.restart_interval;
+            }
+            restart_left--;
+        }
+
+        int mx = m % hdr.mcux;
+        int my = m / hdr.mcux;
+        for (int ci = 0; ci < hdr.ncomp; ci++) {
+            const JpegComponent &c = hdr.comp[ci];
+            const JpegHuffDecoder &dc = hdr.dc[c.td];
+            const JpegHuffDecoder &ac = hdr.ac[c.ta];
+            for (int v = 0; v < c.v; v++) {
+                for (int h = 0; h < c.h; h++) {
+                    int s = jpegDecodeSymbol(br, dc);
+                    if (s < 0 || s > 11) return false;
+                    pred[ci] += s ? jpegExtend(jpegGetBits(br, s), s) : 0;
+
+                    // AC 系数只按长度跳过
+                    for (int k = 1; k < 64;) {
+                        int rs = jpegDecodeSymbol(br, ac);
+                        if (rs < 0) return false;
+                        int r = rs >> 4;
+                        int size = rs & 15;
+                        if (size == 0) {
+                            if (r != 15) break;         // EOB
+                            k += 16;
+                            continue;
+                        }
+                        jpegGetBits(br, size);
+                        k += r + 1;
+                    }
+
+                    // 块平均值 = DC * Q / 8 + 128
+                    int value = pred[ci] * hdr.qdc[c.tq];
+                    value = (value >= 0 ? value + 4 : value - 4) / 8 + 128;
+                    planes.plane[ci][(my * c.v + v) * planes.stride[ci] + mx * c.h + h] =
+                        (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// ==================== 基线编码 ====================
+
+static const uint8_t ZIGZAG[64] = {
+    0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+// JPEG 标准 Annex K 的量化表和 Huffman 表
+static const uint8_t STD_LUMA_Q[64] = {
+    16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55,
+    14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+    18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99,
+};
+static const uint8_t STD_CHROMA_Q[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+};
+
+static const uint8_t DC_LUMA_BITS[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t DC_CHROMA_BITS[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+static const uint8_t DC_VALS[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+static const uint8_t AC_LUMA_BITS[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+static const uint8_t AC_LUMA_VALS[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+static const uint8_t AC_CHROMA_BITS[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+static const uint8_t AC_CHROMA_VALS[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+static void putHuffTable(JpegBitWriter &bw, uint8_t cls_id, const uint8_t *bits, const uint8_t *vals, int count) {
+    jpegPutMarker(bw, 0xC4, (uint16_t)(3 + 16 + count));
+    jpegPutByte(bw, cls_id);
+    jpegPutBytes(bw, bits, 16);
+    jpegPutBytes(bw, vals, count);
+}
+
+static void encodeBlock(JpegBitWriter &bw, const float block[64], const float *qinv, int &pred,
+                        const JpegHuffEncoder &dc, const JpegHuffEncoder &ac) {
+    static float cos_table[8][8];
+    static bool cos_ready = false;
+    if (!cos_ready) {
+        for (int u = 0; u < 8; u++) {
+            for (int x = 0; x < 8; x++) {
+                float cu = u == 0 ? 0.353553391f : 0.5f;
+                cos_table[u][x] = cu * cosf((2 * x + 1) * u * 3.14159265f / 16.0f);
+            }
+        }
+        cos_ready = true;
+    }
+
+    // 可分离 FDCT：先行后列
+    float tmp[64];
+    float coef[64];
+    for (int y = 0; y < 8; y++) {
+        for (int u = 0; u < 8; u++) {
+            float s = 0;
+            for (int x = 0; x < 8; x++) s += cos_table[u][x] * block[y * 8 + x];
+            tmp[y * 8 + u] = s;
+        }
+    }
+    for (int u = 0; u < 8; u++) {
+        for (int v = 0; v < 8; v++) {
+            float s = 0;
+            for (int y = 0; y < 8; y++) s += cos_table[v][y] * tmp[y * 8 + u];
+            coef[v * 8 + u] = s;
+        }
+    }
+
+    int q[64];
+    for (int i = 0; i < 64; i++) {
+        float f = coef[ZIGZAG[i]] * qinv[i];
+        q[i] = (int)(f < 0 ? f - 0.5f : f + 0.5f);
+    }
+
+    int diff = q[0] - pred;
+    pred = q[0];
+    int s = jpegCategory(diff);
+    jpegPutBits(bw, dc.code[s], dc.size[s]);
+    if (s) jpegPutBits(bw, diff < 0 ? diff - 1 : diff, s);
+
+    int run = 0;
+    for (int i = 1; i < 64; i++) {
+        if (q[i] == 0) {
+            run++;
+            continue;
+        }
+        while (run > 15) {
+            jpegPutBits(bw, ac.code[0xF0], ac.size[0xF0]);
+            run -= 16;
+        }
+        int size = jpegCategory(q[i]);
+        int rs = (run << 4) | size;
+        jpegPutBits(bw, ac.code[rs], ac.size[rs]);
+        jpegPutBits(bw, q[i] < 0 ? q[i] - 1 : q[i], size);
+        run = 0;
+    }
+    if (run) jpegPutBits(bw, ac.code[0x00], ac.size[0x00]);
+}
+
+static void scaleTable(const uint8_t *std_table, int quality, uint8_t *zz_out, float *qinv) {
+    if (quality < 1) quality = 1;
+    if (quality > 100) quality = 100;
+    int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+    for (int i = 0; i < 64; i++) {
+        int v = (std_table[ZIGZAG[i]] * scale + 50) / 100;
+        v = v < 1 ? 1 : v > 255 ? 255 : v;
+        zz_out[i] = (uint8_t)v;
+        qinv[i] = 1.0f / v;
+    }
+}
+
+// 从 DC 平面取缩略图像素 (x, y)，色度按采样因子映射
+static inline uint8_t samplePlane(const JpegHeader &hdr, const DcPlanes &planes, int ci, int x, int y) {
+    const JpegComponent &c = hdr.comp[ci];
+    int px = x * c.h / hdr.hmax;
+    int py = y * c.v / hdr.vmax;
+    return planes.plane[ci][py * planes.stride[ci] + px];
+}
+
+static bool encodeThumb(const JpegHeader &hdr, const DcPlanes &planes, int tw, int th, int quality, JpegBitWriter &bw) {
+    uint8_t luma_q[64];
+    uint8_t chroma_q[64];
+    float luma_inv[64];
+    float chroma_inv[64];
+    scaleTable(STD_LUMA_Q, quality, luma_q, luma_inv);
+    scaleTable(STD_CHROMA_Q, quality, chroma_q, chroma_inv);
+
+    static JpegHuffEncoder dc_luma;
+    static JpegHuffEncoder ac_luma;
+    static JpegHuffEncoder dc_chroma;
+    static JpegHuffEncoder ac_chroma;
+    static bool tables_ready = false;
+    if (!tables_ready) {
+        jpegBuildEncoder(dc_luma, DC_LUMA_BITS, DC_VALS);
+        jpegBuildEncoder(ac_luma, AC_LUMA_BITS, AC_LUMA_VALS);
+        jpegBuildEncoder(dc_chroma, DC_CHROMA_BITS, DC_VALS);
+        jpegBuildEncoder(ac_chroma, AC_CHROMA_BITS, AC_CHROMA_VALS);
+        tables_ready = true;
+    }
+
+    int ncomp = hdr.ncomp;
+    static const uint8_t JFIF[] = {
+        0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+    };
+    jpegPutByte(bw, 0xFF);
+    jpegPutByte(bw, 0xD8);
+    jpegPutBytes(bw, JFIF, sizeof(JFIF));
+
+    jpegPutMarker(bw, 0xDB, (uint16_t)(2 + 65 * (ncomp > 1 ? 2 : 1)));
+    jpegPutByte(bw, 0x00);
+    jpegPutBytes(bw, luma_q, 64);
+    if (ncomp > 1) {
+        jpegPutByte(bw, 0x01);
+        jpegPutBytes(bw, chroma_q, 64);
+    }
+
+    jpegPutMarker(bw, 0xC0, (uint16_t)(8 + 3 * ncomp));
+    jpegPutByte(bw, 8);
+    jpegPutByte(bw, (uint8_t)(th >> 8));
+    jpegPutByte(bw, (uint8_t)th);
+    jpegPutByte(bw, (uint8_t)(tw >> 8));
+    jpegPutByte(bw, (uint8_t)tw);
+    jpegPutByte(bw, (uint8_t)ncomp);
+    for (int i = 0; i < ncomp; i++) {
+        jpegPutByte(bw, (uint8_t)(i + 1));
+        jpegPutByte(bw, 0x11);                  // 4:4:4
+        jpegPutByte(bw, i == 0 ? 0 : 1);
+    }
+
+    putHuffTable(bw, 0x00, DC_LUMA_BITS, DC_VALS, sizeof(DC_VALS));
+    putHuffTable(bw, 0x10, AC_LUMA_BITS, AC_LUMA_VALS, sizeof(AC_LUMA_VALS));
+    if (ncomp > 1) {
+        putHuffTable(bw, 0x01, DC_CHROMA_BITS, DC_VALS, sizeof(DC_VALS));
+        putHuffTable(bw, 0x11, AC_CHROMA_BITS, AC_CHROMA_VALS, sizeof(AC_CHROMA_VALS));
+    }
+
+    jpegPutMarker(bw, 0xDA, (uint16_t)(6 + 2 * ncomp));
+    jpegPutByte(bw, (uint8_t)ncomp);
+    for (int i = 0; i < ncomp; i++) {
+        jpegPutByte(bw, (uint8_t)(i + 1));
+        jpegPutByte(bw, i == 0 ? 0x00 : 0x11);
+    }
+    jpegPutByte(bw, 0);
+    jpegPutByte(bw, 63);
+    jpegPutByte(bw, 0);
+
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };
+    float block[64];
+    for (int by = 0; by < (th + 7) / 8; by++) {
+        for (int bx = 0; bx < (tw + 7) / 8; bx++) {
+            for (int ci = 0; ci < ncomp; ci++) {
+                // 右侧和底部不足 8 像素时复制边缘像素
+                for (int y = 0; y < 8; y++) {
+                    int sy = by * 8 + y < th ? by * 8 + y : th - 1;
+                    for (int x = 0; x < 8; x++) {
+                        int sx = bx * 8 + x < tw ? bx * 8 + x : tw - 1;
+                        block[y * 8 + x] = (float)samplePlane(hdr, planes, ci, sx, sy) - 128.0f;
+                    }
+                }
+                if (ci == 0) {
+                    encodeBlock(bw, block, luma_inv, pred[0], dc_luma, ac_luma);
+                } else {
+                    encodeBlock(bw, block, chroma_inv, pred[ci], dc_chroma, ac_chroma);
+                }
+            }
+            if (!bw.ok) return false;
+        }
+    }
+
+    jpegFinishScan(bw);
+    return bw.ok;
+}
+
+// ==================== 接口 ====================
+
+bool jpegThumbnail(const uint8_t *jpeg, size_t len, uint8_t *work, size_t work_cap,
+                   uint8_t *out, size_t out_cap, uint8_t quality, JpegThumb *thumb) {
+    // 解析状态约 7 KB，放在工作区开头而不在堆栈上
+    if (work_cap < sizeof(JpegHeader)) return false;
+    JpegHeader &hdr = *(JpegHeader *)work;
+    if (!jpegParseHeader(jpeg, len, &hdr, true)) return false;
+    if (sizeof(JpegHeader) + planeBytes(hdr) > work_cap) return false;
+
+    DcPlanes planes;
+    uint8_t *p = work + sizeof(JpegHeader);
+    for (int i = 0; i < hdr.ncomp; i++) {
+        const JpegComponent &c = hdr.comp[i];
+        if (hdr.qdc[c.tq] == 0) return false;
+        planes.stride[i] = hdr.mcux * c.h;
+        planes.plane[i] = p;
+        p += (size_t)planes.stride[i] * hdr.mcuy * c.v;
+    }
+    if (!decodeDc(jpeg, len, hdr, planes)) return false;
+
+    int tw = (hdr.width + 7) / 8;
+    int th = (hdr.height + 7) / 8;
+    JpegBitWriter bw;
+    jpegBitWriterBegin(bw, out, out_cap);
+    if (!encodeThumb(hdr, planes, tw, th, quality, bw)) return false;
+
+    thumb->width = (uint16_t)tw;
+    thumb->height = (uint16_t)th;
+    thumb->len = bw.len;
+    return true;
+}
+
+void jpegThumbPlanes(const uint8_t *work, JpegDcPlanes *planes) {
+    const JpegHeader &hdr = *(const JpegHeader *)work;
+    const uint8_t *p = work + sizeof(JpegHeader);
+    planes->ncomp = hdr.ncomp;
+    for (int i = 0; i < hdr.ncomp; i++) {
+        const JpegComponent &c = hdr.comp[i];
+        planes->plane[i] = p;
+        planes->stride[i] = hdr.mcux * c.h;
+        // 分量的像素尺寸按采样因子缩小，再按 8 向上取整
+        planes->width[i] = ((hdr.width * c.h + hdr.hmax - 1) / hdr.hmax + 7) / 8;
+        planes->height[i] = ((hdr.height * c.v + hdr.vmax - 1) / hdr.vmax + 7) / 8;
+        p += (size_t)planes->stride[i] * hdr.mcuy * c.v;
+    }
+}
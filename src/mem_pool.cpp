@@ -0,0 +1,180 @@
+/**
+ * 固定块内存池与请求级 arena 实现
+ */
+
+#include "mem_pool.h"
+#include "hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 登记表在静态初始化阶段由构造函数填写 (零初始化先于任何构造函数)
+static MemPool *registered_pools[MEM_MAX_REGISTERED];
+static MemArena *registered_arenas[MEM_MAX_REGISTERED];
+static uint8_t registered_pool_count = 0;
+static uint8_t registered_arena_count = 0;
+
+static void *allocRegion(size_t size, MemRegion region) {
+    if (region == MEM_PSRAM && halPsramFound()) {
+        return halAllocLarge(size);
+    }
+    return halAllocInternal(size);
+}
+
+static const char *regionName(MemRegion region) {
+    return region == MEM_PSRAM && halPsramFound() ? "psram" : "internal";
+}
+
+// ==================== MemPool ====================
+
+MemPool::MemPool(const char *name, size_t block_size, uint8_t blocks, MemRegion region)
+    : name_(name), block_size_((block_size + 3) & ~(size_t)3),
+      blocks_(blocks > 32 ? 32 : blocks), region_(region) {
+    if (registered_pool_count < MEM_MAX_REGISTERED) {
+        registered_pools[registered_pool_count++] = this;
+    }
+}
+
+bool MemPool::begin() {
+    if (base_) return true;
+    base_ = (uint8_t *)allocRegion(block_size_ * blocks_, region_);
+    if (!base_) {
+        halLog("❌ 内存池 %s 分配失败 (%u x %u)\n", name_, (unsigned)block_size_, blocks_);
+        return false;
+    }
+    return true;
+}
+
+void *MemPool::alloc() {
+    if (!base_) {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    const uint32_t all = blocks_ == 32 ? 0xFFFFFFFFu : ((1u << blocks_) - 1);
+    uint32_t mask = used_mask_.load(std::memory_order_relaxed);
+    while (1) {
+        uint32_t free_bits = ~mask & all;
+        if (free_bits == 0) {
+            failures_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        uint32_t bit = free_bits & (~free_bits + 1);    // 最低位的空闲块
+        if (used_mask_.compare_exchange_weak(mask, mask | bit, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+            uint8_t in_use = (uint8_t)__builtin_popcount(mask | bit);
+            uint8_t prev = peak_.load(std::memory_order_relaxed);
+            while (in_use > prev && !peak_.compare_exchange_weak(prev, in_use, std::memory_order_relaxed)) {
+            }
+            return base_ + (size_t)__builtin_ctz(bit) * block_size_;
+        }
+    }
+}
+
+void MemPool::free(void *p) {
+    if (!p) return;
+    size_t index = (size_t)((uint8_t *)p - base_) / block_size_;
+    used_mask_.fetch_and(~(1u << index), std::memory_order_release);
+}
+
+uint8_t MemPool::used() const {
+    return (uint8_t)__builtin_popcount(used_mask_.load(std::memory_order_relaxed));
+}
+
+// ==================== MemArena ====================
+
+MemArena::MemArena(const char *name, size_t capacity, MemRegion region)
+    : name_(name), capacity_(capacity), region_(region) {
+    if (registered_arena_count < MEM_MAX_REGISTERED) {
+        registered_arenas[registered_arena_count++] = this;
+    }
+}
+
+bool MemArena::begin() {
+    if (base_) return true;
+    base_ = (uint8_t *)allocRegion(capacity_, region_);
+    if (!base_) {
+        halLog("❌ arena %s 分配失败 (%u 字节)\n", name_, (unsigned)capacity_);
+        return false;
+    }
+    return true;
+}
+
+void *MemArena::alloc(size_t size, size_t align) {
+    size_t start = (offset_ + align - 1) & ~(align - 1);
+    if (!base_ || start + size > capacity_) {
+        overflows_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    offset_ = start + size;
+    if (offset_ > peak_.load(std::memory_order_relaxed)) {
+        peak_.store(offset_, std::memory_order_relaxed);
+    }
+    return base_ + start;
+}
+
+void MemArena::reset() {
+    offset_ = 0;
+}
+
+// ==================== 登记与指标 ====================
+
+bool memBegin() {
+    bool ok = true;
+    size_t total = 0;
+    for (uint8_t i = 0; i < registered_pool_count; i++) {
+        ok = registered_pools[i]->begin() && ok;
+        total += registered_pools[i]->blockSize() * registered_pools[i]->blocks();
+    }
+    for (uint8_t i = 0; i < registered_arena_count; i++) {
+        ok = registered_arenas[i]->begin() && ok;
+        total += registered_arenas[i]->capacity();
+    }
+    halLog("🧱 内存池: %u 个池, %u 个 arena, 共 %u KB\n",
+           registered_pool_count, registered_arena_count, (unsigned)(total / 1024));
+    return ok;
+}
+
+void memRenderMetrics(MetricsWriter &w) {
+    char labels[64];
+
+    w.type("autodiary_mem_pool_blocks", "gauge");
+    for (uint8_t i = 0; i < registered_pool_count; i++) {
+        const MemPool &p = *registered_pools[i];
+        snprintf(labels, sizeof(labels), "pool=\"%s\",region=\"%s\",state=\"used\"",
+                 p.name(), regionName(p.region()));
+        w.gauge("autodiary_mem_pool_blocks", labels, p.used());
+        snprintf(labels, sizeof(labels), "pool=\"%s\",region=\"%s\",state=\"total\"",
+                 p.name(), regionName(p.region()));
+        w.gauge("autodiary_mem_pool_blocks", labels, p.blocks());
+    }
+    w.type("autodiary_mem_pool_peak_blocks", "gauge");
+    for (uint8_t i = 0; i < registered_pool_count; i++) {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", registered_pools[i]->name());
+        w.gauge("autodiary_mem_pool_peak_blocks", labels, registered_pools[i]->peak());
+    }
+    w.type("autodiary_mem_pool_block_bytes", "gauge");
+    for (uint8_t i = 0; i < registered_pool_count; i++) {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", registered_pools[i]->name());
+        w.gauge("autodiary_mem_pool_block_bytes", labels, (double)registered_pools[i]->blockSize());
+    }
+    w.type("autodiary_mem_pool_failures_total", "counter");
+    for (uint8_t i = 0; i < registered_pool_count; i++) {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", registered_pools[i]->name());
+        w.counter("autodiary_mem_pool_failures_total", labels, registered_pools[i]->failures());
+    }
+
+    w.type("autodiary_mem_arena_bytes", "gauge");
+    for (uint8_t i = 0; i < registered_arena_count; i++) {
+        const MemArena &a = *registered_arenas[i];
+        snprintf(labels, sizeof(labels), "arena=\"%s\",region=\"%s\",kind=\"capacity\"",
+                 a.name(), regionName(a.region()));
+        w.gauge("autodiary_mem_arena_bytes", labels, (double)a.capacity());
+        snprintf(labels, sizeof(labels), "arena=\"%s\",region=\"%s\",kind=\"peak\"",
+                 a.name(), regionName(a.region()));
+        w.gauge("autodiary_mem_arena_bytes", labels, (double)a.peak());
+    }
+    w.type("autodiary_mem_arena_overflows_total", "counter");
+    for (uint8_t i = 0; i < registered_arena_count; i++) {
+        snprintf(labels, sizeof(labels), "arena=\"%s\"", registered_arenas[i]->name());
+        w.counter("autodiary_mem_arena_overflows_total", labels, registered_arenas[i]->overflows());
+    }
+}
@@ -0,0 +1,243 @@
+/**
+ * 性能指标实现
+ */
+
+#include "metrics.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <utility>
+
+// ==================== 桶边界 ====================
+
+static const uint32_t LATENCY_US_BOUNDS[] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000
+};
+static const uint32_t JPEG_SIZE_BOUNDS[] = {
+    8192, 16384, 24576, 32768, 49152, 65536, 98304, 131072, 196608, 262144
+};
+
+static const uint32_t RECONNECT_MS_BOUNDS[] = {
+    100, 250, 500, 1000, 2000, 5000, 10000, 30000, 60000, 120000
+};
+
+#define COUNT_OF(a) ((uint8_t)(sizeof(a) / sizeof((a)[0])))
+#define LATENCY_HISTOGRAM { LATENCY_US_BOUNDS, COUNT_OF(LATENCY_US_BOUNDS) }
+
+// 按标签枚举展开的一组延迟直方图，个数由枚举决定 (Histogram 含原子量，不能先构造再赋值)
+template <size_t... I>
+static std::array<Histogram, sizeof...(I)> latencyHistograms(std::index_sequence<I...>) {
+    return {{ ((void)I, Histogram(LATENCY_US_BOUNDS, COUNT_OF(LATENCY_US_BOUNDS)))... }};
+}
+
+// ==================== 指标实例 ====================
+
+Histogram metric_capture_latency_us LATENCY_HISTOGRAM;
+Histogram metric_jpeg_size_bytes(JPEG_SIZE_BOUNDS, COUNT_OF(JPEG_SIZE_BOUNDS));
+std::array<Histogram, STREAM_COUNT> metric_send_time_us = latencyHistograms(std::make_index_sequence<STREAM_COUNT>());
+std::array<Histogram, ROUTE_COUNT> metric_http_handler_us = latencyHistograms(std::make_index_sequence<ROUTE_COUNT>());
+Counter metric_stream_bytes_sent[STREAM_COUNT];
+Counter metric_stream_writes[STREAM_COUNT];
+Counter metric_audio_overruns;
+Counter metric_audio_fetch_gap_samples;
+Counter metric_audio_stream_gap_samples;
+Counter metric_frames_captured;
+Counter metric_capture_failures;
+Counter metric_frames_dropped;
+Histogram metric_thumb_encode_us LATENCY_HISTOGRAM;
+Counter metric_thumb_failures;
+Histogram metric_crop_us LATENCY_HISTOGRAM;
+Counter metric_crop_failures;
+Histogram metric_privacy_mask_us LATENCY_HISTOGRAM;
+Histogram metric_still_switch_us LATENCY_HISTOGRAM;
+Histogram metric_still_preview_gap_us LATENCY_HISTOGRAM;
+Counter metric_wifi_connect_attempts;
+Counter metric_wifi_disconnects;
+Gauge metric_wifi_rssi_dbm;
+Counter metric_wifi_connects[WIFI_PATH_COUNT];
+Counter metric_wifi_fast_connect_fallbacks;
+Gauge metric_wifi_boot_connect_ms;
+Histogram metric_wifi_reconnect_ms(RECONNECT_MS_BOUNDS, COUNT_OF(RECONNECT_MS_BOUNDS));
+Gauge metric_boot_first_frame_ms;
+
+const char *metricsRouteName(HttpRoute route) {
+    static const char *const names[] = {
+        "/", "/video.jpg", "/capture", "/save", "/saved_photo",
+        "/audio", "/audio/stream", "/status", "/metrics", "/trace", "/restart",
+        "/power", "/time", "/trigger", "/segment/audio", "/segment/frames",
+        "/stream", "/ui", "/camera/config", "/thumb", "/frames", "/privacy", "/events",
+        "not_found"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == ROUTE_COUNT, "名称数量与 HttpRoute 不一致");
+    return route < ROUTE_COUNT ? names[route] : "unknown";
+}
+
+const char *metricsStreamName(StreamKind kind) {
+    static const char *const names[] = { "video", "audio", "events" };
+    static_assert(sizeof(names) / sizeof(names[0]) == STREAM_COUNT, "名称数量与 StreamKind 不一致");
+    return kind < STREAM_COUNT ? names[kind] : "unknown";
+}
+
+const char *metricsWifiPathName(WifiConnectPath path) {
+    static const char *const names[] = { "fast", "scan" };
+    static_assert(sizeof(names) / sizeof(names[0]) == WIFI_PATH_COUNT, "名称数量与 WifiConnectPath 不一致");
+    return path < WIFI_PATH_COUNT ? names[path] : "unknown";
+}
+
+// ==================== MetricsWriter ====================
+
+void MetricsWriter::flush() {
+    if (len_ > 0 && flush_) {
+        flush_(buf_, len_, ctx_);
+    }
+    len_ = 0;
+}
+
+void MetricsWriter::printf(const char *fmt, ...) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf_ + len_, cap_ - len_, fmt, args);
+        va_end(args);
+        if (n < 0) return;
+        if (len_ + (size_t)n < cap_) {
+            len_ += n;
+            return;
+        }
+        if (len_ == 0) {
+            // 单行比整个缓冲区还长，截断输出
+            len_ = cap_ - 1;
+            return;
+        }
+        flush();
+    }
+}
+
+void MetricsWriter::type(const char *name, const char *kind) {
+    printf("# TYPE %s %s\n", name, kind);
+}
+
+void MetricsWriter::counter(const char *name, const char *labels, uint64_t value) {
+    if (labels && labels[0]) {
+        printf("%s{%s} %llu\n", name, labels, (unsigned long long)value);
+    } else {
+        printf("%s %llu\n", name, (unsigned long long)value);
+    }
+}
+
+void MetricsWriter::gauge(const char *name, const char *labels, double value) {
+    if (labels && labels[0]) {
+        printf("%s{%s} %.10g\n", name, labels, value);
+    } else {
+        printf("%s %.10g\n", name, value);
+    }
+}
+
+void MetricsWriter::histogram(const char *name, const char *labels, const Histogram &h) {
+    const char *sep = (labels && labels[0]) ? "," : "";
+    const char *lbl = labels ? labels : "";
+    uint64_t cumulative = 0;
+    for (uint8_t i = 0; i < h.bucket_count; i++) {
+        cumulative += h.buckets[i].load(std::memory_order_relaxed);
+        printf("%s_bucket{%s%sle=\"%u\"} %llu\n", name, lbl, sep,
+               (unsigned)h.bounds[i], (unsigned long long)cumulative);
+    }
+    cumulative += h.buckets[h.bucket_count].load(std::memory_order_relaxed);
+    printf("%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, lbl, sep, (unsigned long long)cumulative);
+    if (lbl[0]) {
+        printf("%s_sum{%s} %llu\n", name, lbl, (unsigned long long)h.sum.value());
+        printf("%s_count{%s} %llu\n", name, lbl, (unsigned long long)h.count.value());
+    } else {
+        printf("%s_sum %llu\n", name, (unsigned long long)h.sum.value());
+        printf("%s_count %llu\n", name, (unsigned long long)h.count.value());
+    }
+}
+
+void MetricsWriter::finish() {
+    flush();
+}
+
+// ==================== 渲染 ====================
+
+void metricsRender(MetricsWriter &w) {
+    char labels[48];
+
+    w.type("autodiary_capture_latency_us", "histogram");
+    w.histogram("autodiary_capture_latency_us", NULL, metric_capture_latency_us);
+
+    w.type("autodiary_jpeg_size_bytes", "histogram");
+    w.histogram("autodiary_jpeg_size_bytes", NULL, metric_jpeg_size_bytes);
+
+    w.type("autodiary_send_time_us", "histogram");
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "stream=\"%s\"", metricsStreamName((StreamKind)i));
+        w.histogram("autodiary_send_time_us", labels, metric_send_time_us[i]);
+    }
+
+    w.type("autodiary_http_handler_us", "histogram");
+    for (int i = 0; i < ROUTE_COUNT; i++) {
+        // 未被访问过的路由不输出，减少 /metrics 体积
+        if (metric_http_handler_us[i].count.value() == 0) continue;
+        snprintf(labels, sizeof(labels), "route=\"%s\"", metricsRouteName((HttpRoute)i));
+        w.histogram("autodiary_http_handler_us", labels, metric_http_handler_us[i]);
+    }
+
+    w.type("autodiary_stream_bytes_sent_total", "counter");
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "stream=\"%s\"", metricsStreamName((StreamKind)i));
+        w.counter("autodiary_stream_bytes_sent_total", labels, metric_stream_bytes_sent[i].value());
+    }
+    w.type("autodiary_stream_writes_total", "counter");
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "stream=\"%s\"", metricsStreamName((StreamKind)i));
+        w.counter("autodiary_stream_writes_total", labels, metric_stream_writes[i].value());
+    }
+
+    w.type("autodiary_audio_overruns_total", "counter");
+    w.counter("autodiary_audio_overruns_total", NULL, metric_audio_overruns.value());
+    w.type("autodiary_audio_fetch_gap_samples_total", "counter");
+    w.counter("autodiary_audio_fetch_gap_samples_total", NULL, metric_audio_fetch_gap_samples.value());
+    w.type("autodiary_audio_stream_gap_samples_total", "counter");
+    w.counter("autodiary_audio_stream_gap_samples_total", NULL, metric_audio_stream_gap_samples.value());
+    w.type("autodiary_frames_captured_total", "counter");
+    w.counter("autodiary_frames_captured_total", NULL, metric_frames_captured.value());
+    w.type("autodiary_capture_failures_total", "counter");
+    w.counter("autodiary_capture_failures_total", NULL, metric_capture_failures.value());
+    w.type("autodiary_frames_dropped_total", "counter");
+    w.counter("autodiary_frames_dropped_total", NULL, metric_frames_dropped.value());
+    w.type("autodiary_thumb_encode_us", "histogram");
+    w.histogram("autodiary_thumb_encode_us", NULL, metric_thumb_encode_us);
+    w.type("autodiary_thumb_failures_total", "counter");
+    w.counter("autodiary_thumb_failures_total", NULL, metric_thumb_failures.value());
+    w.type("autodiary_crop_us", "histogram");
+    w.histogram("autodiary_crop_us", NULL, metric_crop_us);
+    w.type("autodiary_crop_failures_total", "counter");
+    w.counter("autodiary_crop_failures_total", NULL, metric_crop_failures.value());
+    w.type("autodiary_privacy_mask_us", "histogram");
+    w.histogram("autodiary_privacy_mask_us", NULL, metric_privacy_mask_us);
+    w.type("autodiary_still_switch_us", "histogram");
+    w.histogram("autodiary_still_switch_us", NULL, metric_still_switch_us);
+    w.type("autodiary_still_preview_gap_us", "histogram");
+    w.histogram("autodiary_still_preview_gap_us", NULL, metric_still_preview_gap_us);
+
+    w.type("autodiary_wifi_rssi_dbm", "gauge");
+    w.gauge("autodiary_wifi_rssi_dbm", NULL, metric_wifi_rssi_dbm.value());
+    w.type("autodiary_wifi_connect_attempts_total", "counter");
+    w.counter("autodiary_wifi_connect_attempts_total", NULL, metric_wifi_connect_attempts.value());
+    w.type("autodiary_wifi_disconnects_total", "counter");
+    w.counter("autodiary_wifi_disconnects_total", NULL, metric_wifi_disconnects.value());
+    w.type("autodiary_wifi_connects_total", "counter");
+    for (int i = 0; i < WIFI_PATH_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "path=\"%s\"", metricsWifiPathName((WifiConnectPath)i));
+        w.counter("autodiary_wifi_connects_total", labels, metric_wifi_connects[i].value());
+    }
+    w.type("autodiary_wifi_fast_connect_fallbacks_total", "counter");
+    w.counter("autodiary_wifi_fast_connect_fallbacks_total", NULL, metric_wifi_fast_connect_fallbacks.value());
+    w.type("autodiary_wifi_boot_connect_ms", "gauge");
+    w.gauge("autodiary_wifi_boot_connect_ms", NULL, metric_wifi_boot_connect_ms.value());
+    w.type("autodiary_wifi_reconnect_ms", "histogram");
+    w.histogram("autodiary_wifi_reconnect_ms", NULL, metric_wifi_reconnect_ms);
+
+    w.type("autodiary_boot_first_frame_ms", "gauge");
+    w.gauge("autodiary_boot_first_frame_ms", NULL, metric_boot_first_frame_ms.value());
+}
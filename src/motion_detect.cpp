@@ -0,0 +1,107 @@
+/**
+ * 画面运动检测实现
+ */
+
+#include "motion_detect.h"
+#include "events.h"
+#include "preroll.h"
+#include <string.h>
+#include <atomic>
+
+#define MOTION_CELLS (MOTION_GRID_W * MOTION_GRID_H)
+
+// 以下只在视频任务中访问
+static uint8_t motion_prev[MOTION_CELLS];
+static bool motion_has_prev = false;
+static int64_t motion_start_us = 0;
+static int64_t motion_last_us = 0;      // 最近一次达到阈值的采样时刻
+
+static std::atomic<bool> motion_active{false};
+static std::atomic<uint32_t> motion_area{0};     // 最近一次采样的变化面积 (千分比)
+
+static Counter motion_samples;
+static Counter motion_events;
+
+// ==================== 判定 ====================
+
+// Y 分量 DC 平面按网格取平均，平面小于网格时相邻格取同一块
+static void sampleGrid(const JpegDcPlanes &planes, uint8_t *grid) {
+    const int w = planes.width[0];
+    const int h = planes.height[0];
+    for (int gy = 0; gy < MOTION_GRID_H; gy++) {
+        int y0 = gy * h / MOTION_GRID_H;
+        int y1 = (gy + 1) * h / MOTION_GRID_H;
+        if (y1 <= y0) y1 = y0 + 1;
+        for (int gx = 0; gx < MOTION_GRID_W; gx++) {
+            int x0 = gx * w / MOTION_GRID_W;
+            int x1 = (gx + 1) * w / MOTION_GRID_W;
+            if (x1 <= x0) x1 = x0 + 1;
+            uint32_t sum = 0;
+            for (int y = y0; y < y1; y++) {
+                const uint8_t *row = planes.plane[0] + y * planes.stride[0];
+                for (int x = x0; x < x1; x++) sum += row[x];
+            }
+            grid[gy * MOTION_GRID_W + gx] = (uint8_t)(sum / ((y1 - y0) * (x1 - x0)));
+        }
+    }
+}
+
+void motionObserve(const JpegDcPlanes &planes, int64_t timestamp_us) {
+    if (planes.width[0] == 0 || planes.height[0] == 0) return;
+    uint8_t cur[MOTION_CELLS];
+    sampleGrid(planes, cur);
+    motion_samples.inc();
+    if (!motion_has_prev) {
+        memcpy(motion_prev, cur, sizeof(cur));
+        motion_has_prev = true;
+        return;
+    }
+
+    // 减去整体亮度变化后统计变化的格
+    int32_t total = 0;
+    for (int i = 0; i < MOTION_CELLS; i++) total += (int)cur[i] - (int)motion_prev[i];
+    int32_t bias = total / MOTION_CELLS;
+    uint32_t changed = 0;
+    for (int i = 0; i < MOTION_CELLS; i++) {
+        int32_t d = (int)cur[i] - (int)motion_prev[i] - bias;
+        if (d > MOTION_CELL_DELTA || d < -MOTION_CELL_DELTA) changed++;
+    }
+    memcpy(motion_prev, cur, sizeof(cur));
+
+    uint32_t area = changed * 1000 / MOTION_CELLS;
+    motion_area.store(area);
+    if (area >= MOTION_AREA_PERMILLE) {
+        motion_last_us = timestamp_us;
+        if (!motion_active.load()) {
+            motion_active.store(true);
+            motion_start_us = timestamp_us;
+            motion_events.inc();
+#if MOTION_PREROLL_TRIGGER
+            uint32_t segment = prerollTrigger(TRIGGER_MOTION);
+#else
+            uint32_t segment = 0;
+#endif
+            eventPublish(EVENT_MOTION, timestamp_us, 1, area, segment);
+        }
+        return;
+    }
+    if (motion_active.load() && timestamp_us - motion_last_us >= MOTION_HOLD_MS * 1000LL) {
+        motion_active.store(false);
+        eventPublish(EVENT_MOTION, motion_last_us, 0, (uint32_t)((motion_last_us - motion_start_us) / 1000));
+    }
+}
+
+bool motionActive() {
+    return motion_active.load();
+}
+
+void motionRenderMetrics(MetricsWriter &w) {
+    w.type("autodiary_motion_samples_total", "counter");
+    w.counter("autodiary_motion_samples_total", NULL, motion_samples.value());
+    w.type("autodiary_motion_events_total", "counter");
+    w.counter("autodiary_motion_events_total", NULL, motion_events.value());
+    w.type("autodiary_motion_active", "gauge");
+    w.gauge("autodiary_motion_active", NULL, motion_active.load() ? 1 : 0);
+    w.type("autodiary_motion_area_permille", "gauge");
+    w.gauge("autodiary_motion_area_permille", NULL, motion_area.load());
+}
@@ -0,0 +1,107 @@
+/**
+ * AutoDiary - 主机构建入口 (pio run -e native)
+ *
+ * 与 ESP32 固件共用 HTTP 路由、采集环、流任务、指标和追踪代码，
+ * 摄像头和麦克风由 JPEG / WAV 文件回放代替，默认只监听 127.0.0.1。
+ *
+ * 用法:
+ *   .pio/build/native/program [--port 8080] [--bind 127.0.0.1]
+ *                             [--jpeg FILE|DIR] [--wav FILE] [--fps 10]
+ *                             [--camera-fault AFTER_MS:DURATION_MS]
+ *
+ * 不指定 --jpeg 时回放 test/fixtures/scene_vga_422.jpg (VGA 4:2:2，与 OV2640 输出结构相同)。
+ *
+ * pio test -e native 时 (PIO_UNIT_TESTING) 由各测试套件提供 main()，本文件不参与编译。
+ */
+
+#ifndef PIO_UNIT_TESTING
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "hal/native/hal_native.h"
+#include "pipeline.h"
+#include "http_routes.h"
+#include "sys_monitor.h"
+#include "metrics.h"
+#include "boot.h"
+#include "power.h"
+#include "mem_pool.h"
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "用法: %s [--port N] [--bind ADDR] [--jpeg FILE|DIR] [--wav FILE] [--fps N]\n"
+            "          [--camera-fault AFTER_MS:DURATION_MS]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    uint16_t port = 8080;
+    const char *bind_addr = "127.0.0.1";
+    HalNativeConfig cfg = { "test/fixtures/scene_vga_422.jpg", NULL, 10, ".native_fs", 0, 0 };
+
+    for (int i = 1; i < argc; i++) {
+        const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--port") == 0 && next) {
+            port = (uint16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bind") == 0 && next) {
+            bind_addr = argv[++i];
+        } else if (strcmp(argv[i], "--jpeg") == 0 && next) {
+            cfg.jpeg_path = argv[++i];
+        } else if (strcmp(argv[i], "--wav") == 0 && next) {
+            cfg.wav_path = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && next) {
+            cfg.fps = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--camera-fault") == 0 && next) {
+            // 模拟摄像头故障：开机 AFTER_MS 后连续 DURATION_MS 取帧失败
+            const char *spec = argv[++i];
+            const char *colon = strchr(spec, ':');
+            cfg.camera_fault_after_ms = (uint32_t)atoi(spec);
+            cfg.camera_fault_ms = colon ? (uint32_t)atoi(colon + 1) : 0;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // 对端关闭后写 socket 返回 EPIPE，而不是结束进程
+    signal(SIGPIPE, SIG_IGN);
+
+    halLog("\n========================================\n");
+    halLog("AutoDiary - Native Host Build\n");
+    halLog("========================================\n\n");
+
+    halNativeConfigure(cfg);
+    bootPhaseStart(BOOT_PHASE_SETUP);
+    powerApplyProfile(POWER_DEFAULT_PROFILE);
+    memBegin();
+    if (!pipelineBeginAudio()) {
+        halLog("❌ 麦克风回放初始化失败\n");
+    }
+    if (!routesBegin(port, bind_addr)) {
+        return 1;
+    }
+    bootMark(BOOT_PHASE_WIFI_CONNECTED);    // 回环网络启动即可用
+    pipelineStartTasks();                   // 摄像头回放在视频任务中初始化
+    sysMonitorBegin();
+    bootPhaseEnd(BOOT_PHASE_SETUP);
+
+    halLog("\n📡 服务已启动: http://%s:%u/\n\n", bind_addr, port);
+
+    uint32_t last_debug = halMillis();
+    while (1) {
+        halDelayMs(100);
+        if (bootComplete()) bootLogSummary();
+        if (halMillis() - last_debug > 30000) {
+            halLog("[DEBUG] Frames captured: %lu, Audio overruns: %u, Streams: %d\n",
+                   frame_count, (uint32_t)metric_audio_overruns.value(), stream_clients.load());
+            last_debug = halMillis();
+        }
+    }
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
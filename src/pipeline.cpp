@@ -0,0 +1,222 @@
+/**
+ * 采集流水线实现
+ */
+
+#include "pipeline.h"
+#include "task_config.h"
+#include "http_routes.h"
+#include "metrics.h"
+#include "trace.h"
+#include "boot.h"
+#include "frame_store.h"
+#include "camera_config.h"
+#include "privacy_mask.h"
+#include "still_capture.h"
+#include "camera_health.h"
+#include "vad.h"
+#include "sys_monitor.h"
+#include "hal.h"
+#include <stdlib.h>
+
+// ==================== 共享状态 ====================
+
+static int16_t audio_buffer[AUDIO_BUFFER_SIZE];
+AudioRing audio_ring;
+
+std::atomic<int> stream_clients{0};
+volatile bool audio_streaming = false;
+
+unsigned long frame_count = 0;
+unsigned long audio_bytes_captured = 0;
+volatile unsigned long frame_latency_ms = 0;
+volatile unsigned long frame_latency_max_ms = 0;
+std::atomic<uint32_t> video_frame_interval_ms{VIDEO_FRAME_INTERVAL_MS};
+
+void *videoTaskHandle = NULL;
+void *audioTaskHandle = NULL;
+void *httpTaskHandle = NULL;
+
+// ==================== 后台任务 ====================
+
+// 按 video_frame_interval_ms 等待下一次捕获；分段等待，切换配置档后最多 100 ms 生效，
+// 有待应用的摄像头参数或静态照片请求时提前返回 (延时摄影档下请求不必等满 30 s)
+static void waitFrameInterval() {
+    uint32_t waited_ms = 0;
+    while (1) {
+        uint32_t interval_ms = video_frame_interval_ms.load();
+        if (waited_ms >= interval_ms || cameraConfigPending() || stillPending()) return;
+        uint32_t step_ms = interval_ms - waited_ms < 100 ? interval_ms - waited_ms : 100;
+        halDelayMs(step_ms);
+        waited_ms += step_ms;
+    }
+}
+
+static void videoCaptureTask(void *parameter) {
+    halLog("🎥 视频捕获任务启动\n");
+
+    // 摄像头在视频任务中初始化 (核心 1)，与 setup() 中的 WiFi / I2S / HTTP 初始化并行
+    cameraConfigBegin();
+    privacyMaskBegin();
+    if (!halCameraReady()) {
+        bootPhaseStart(BOOT_PHASE_CAMERA);
+        bool ok = halCameraBegin();
+        bootPhaseEnd(BOOT_PHASE_CAMERA);
+        if (!ok) {
+            halLog("⚠️ 摄像头未初始化，视频任务退出\n");
+            sysMonitorUnwatchTask("VideoCapture");
+            halTaskExit();
+            return;
+        }
+    }
+    cameraConfigReapply();
+
+    // 没有 PSRAM 时不保留预录帧
+    bool psram = halPsramFound();
+    size_t slot_bytes = psram ? FRAME_STORE_SLOT_BYTES : FRAME_STORE_SLOT_BYTES_DRAM;
+    if (!frameStoreReady() && !frameStoreBegin(slot_bytes, psram ? FRAME_PREROLL_FRAMES : 0)) {
+        halLog("⚠️ 帧缓存不可用，视频任务退出\n");
+        sysMonitorUnwatchTask("VideoCapture");
+        halTaskExit();
+        return;
+    }
+
+    // 持续捕获并发布到帧缓存，网络就绪前就开始缓冲
+    // 每帧交给健康监督判定，异常时在本任务中分级恢复 (camera_health.h)
+    while (1) {
+        // 参数只在两次取帧之间写入传感器，不与 fb_get 并发；静态照片同样在这里切换分辨率
+        cameraConfigApplyPending();
+        stillServe();
+
+        int64_t start_us = halNowUs();
+        HalFrame frame;
+        bool ok = halCameraGrab(&frame);
+        uint32_t capture_us = (uint32_t)(halNowUs() - start_us);
+        traceRecord(TRACE_CAPTURE, start_us, capture_us, ok ? frame.len : 0);
+
+        if (!ok) metric_capture_failures.inc();
+        CameraFault fault = cameraHealthCheck(ok ? &frame : NULL, capture_us);
+        if (fault == CAMERA_FAULT_GRAB_FAILED || fault == CAMERA_FAULT_BAD_JPEG) {
+            if (ok) halCameraRelease(&frame);       // 损坏的帧不发布，读者继续拿到上一帧正常帧
+            cameraHealthRecover();
+            continue;
+        }
+
+        if (stillResyncDrop(frame)) {
+            halCameraRelease(&frame);               // 切回预览前排队的静态照片尺寸帧
+            continue;
+        }
+
+        recordFrameCaptured(frame, capture_us);
+        frameStorePublish(frame);
+        halCameraRelease(&frame);
+        bootMark(BOOT_PHASE_FIRST_FRAME);
+        if (fault == CAMERA_FAULT_SLOW) cameraHealthRecover();
+
+        waitFrameInterval();
+    }
+}
+
+static void audioCaptureTask(void *parameter) {
+    halLog("🎤 音频捕获任务启动\n");
+
+    if (!halMicReady()) {
+        halLog("⚠️ I2S 未初始化，音频任务退出\n");
+        sysMonitorUnwatchTask("AudioCapture");
+        halTaskExit();
+        return;
+    }
+
+    // I2S 驱动内部最多缓冲两个 DMA 块，两次读取间隔超过这个时长就会丢样本
+    const int64_t overrun_us = 2LL * AUDIO_BUFFER_SIZE * 1000000LL / AUDIO_SAMPLE_RATE;
+    int64_t last_read_us = halNowUs();
+
+    while (1) {
+        // 阻塞读取一个块，数据未到达前任务让出 CPU
+        int64_t read_start_us = halNowUs();
+        int samples = halMicRead(audio_buffer, AUDIO_BUFFER_SIZE);
+        int64_t now_us = halNowUs();
+        traceRecord(TRACE_I2S_READ, read_start_us, (uint32_t)(now_us - read_start_us),
+                    samples > 0 ? samples * sizeof(int16_t) : 0);
+
+        if (samples > 0) {
+            if (now_us - last_read_us > overrun_us) {
+                metric_audio_overruns.inc();
+            }
+            last_read_us = now_us;
+
+            audio_ring.write(audio_buffer, samples, now_us);
+            vadObserve(audio_buffer, samples, AUDIO_SAMPLE_RATE, now_us);
+            audio_bytes_captured += samples * sizeof(int16_t);
+            bootMark(BOOT_PHASE_FIRST_AUDIO);
+        } else {
+            halDelayMs(1);
+        }
+    }
+}
+
+// ==================== 接口 ====================
+
+bool pipelineBeginAudio() {
+    bootPhaseStart(BOOT_PHASE_MIC);
+    bool ok = halMicBegin(AUDIO_SAMPLE_RATE, AUDIO_BUFFER_SIZE);
+    if (ok) {
+        // 有 PSRAM 时采集环放在 PSRAM 并多保留 AUDIO_PREROLL_MS 作为预录，否则 1 秒内部 RAM
+        uint32_t capacity = AUDIO_RING_SAMPLES;
+        int16_t *storage = NULL;
+        if (halPsramFound()) {
+            capacity += (uint32_t)((uint64_t)AUDIO_PREROLL_MS * AUDIO_SAMPLE_RATE / 1000);
+            storage = (int16_t *)halAllocLarge(capacity * sizeof(int16_t));
+        }
+        if (!storage) {
+            capacity = AUDIO_RING_SAMPLES;
+            storage = (int16_t *)malloc(capacity * sizeof(int16_t));
+        }
+        if (storage) {
+            audio_ring.begin(storage, capacity, AUDIO_BUFFER_SIZE, AUDIO_SAMPLE_RATE);
+            halLog("🎤 采集环: %lu 样本 (%lu ms, %lu KB)\n", (unsigned long)capacity,
+                   (unsigned long)(capacity * 1000ULL / AUDIO_SAMPLE_RATE),
+                   (unsigned long)(capacity * sizeof(int16_t) / 1024));
+        } else {
+            halLog("❌ 采集环分配失败\n");
+            ok = false;
+        }
+    }
+    bootPhaseEnd(BOOT_PHASE_MIC);
+    return ok;
+}
+
+void pipelineStartTasks() {
+    // 优先级 / 核心 / 堆栈见 task_config.h
+    if (!halTaskCreate(videoCaptureTask, "VideoCapture", TASK_VIDEO_STACK, NULL,
+                       TASK_VIDEO_PRIORITY, TASK_VIDEO_CORE, &videoTaskHandle)) {
+        halLog("❌ 视频任务创建失败!\n");
+    }
+
+    if (!halTaskCreate(audioCaptureTask, "AudioCapture", TASK_AUDIO_STACK, NULL,
+                       TASK_AUDIO_PRIORITY, TASK_AUDIO_CORE, &audioTaskHandle)) {
+        halLog("❌ 音频任务创建失败!\n");
+    }
+
+    if (!halTaskCreate(httpServerTask, "HttpServer", TASK_HTTP_STACK, NULL,
+                       TASK_HTTP_PRIORITY, TASK_HTTP_CORE, &httpTaskHandle)) {
+        halLog("❌ HTTP 任务创建失败!\n");
+    }
+}
+
+void recordFrameLatency(unsigned long latency_ms) {
+    frame_latency_ms = latency_ms;
+    if (latency_ms > frame_latency_max_ms) {
+        frame_latency_max_ms = latency_ms;
+    }
+}
+
+void recordFrameCaptured(const HalFrame &frame, uint32_t capture_us) {
+    metric_capture_latency_us.observe(capture_us);
+    metric_jpeg_size_bytes.observe(frame.len);
+    metric_frames_captured.inc();
+    if (metric_boot_first_frame_ms.value() == 0) {
+        // 0 表示尚未记录，开机 1 ms 内的帧记为 1
+        int32_t ms = (int32_t)(frame.timestamp_us / 1000);
+        metric_boot_first_frame_ms.set(ms > 0 ? ms : 1);
+    }
+}
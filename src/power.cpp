@@ -0,0 +1,74 @@
+/**
+ * 电源配置档实现
+ */
+
+#include "power.h"
+#include "pipeline.h"
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+
+static const PowerProfile POWER_PROFILES[POWER_PROFILE_COUNT] = {
+    // name         wifi_ps                 listen  max  min  sleep  xclk  interval
+    { "live",       HAL_WIFI_PS_NONE,       0,      240, 240, false, 20,   0     },
+    { "lifelog",    HAL_WIFI_PS_MIN_MODEM,  0,      160, 80,  true,  10,   1000  },
+    { "timelapse",  HAL_WIFI_PS_MAX_MODEM,  10,     80,  40,  true,  10,   30000 },
+};
+
+static std::atomic<int> power_current{POWER_DEFAULT_PROFILE};
+static std::atomic<bool> power_dfs_active{false};
+static Counter power_switches;
+
+const PowerProfile &powerProfile(PowerProfileId id) {
+    return POWER_PROFILES[id < POWER_PROFILE_COUNT ? id : POWER_DEFAULT_PROFILE];
+}
+
+PowerProfileId powerCurrentProfile() {
+    return (PowerProfileId)power_current.load();
+}
+
+PowerProfileId powerProfileByName(const char *name) {
+    for (int i = 0; i < POWER_PROFILE_COUNT; i++) {
+        if (strcmp(name, POWER_PROFILES[i].name) == 0) return (PowerProfileId)i;
+    }
+    return POWER_PROFILE_COUNT;
+}
+
+void powerApplyProfile(PowerProfileId id) {
+    const PowerProfile &p = powerProfile(id);
+
+    bool wifi_ok = halWifiSetPowerSave(p.wifi_ps, p.listen_interval);
+    bool dfs = halCpuSetFrequency(p.cpu_max_mhz, p.cpu_min_mhz, p.light_sleep);
+    bool xclk_ok = halCameraSetXclk(p.xclk_mhz);
+    video_frame_interval_ms.store(p.frame_interval_ms);
+
+    power_dfs_active.store(dfs);
+    power_current.store(id);
+    power_switches.inc();
+
+    halLog("🔋 电源配置档: %s (WiFi PS %d%s, CPU %u~%u MHz%s, XCLK %u MHz%s, 间隔 %lu ms)\n",
+           p.name, (int)p.wifi_ps, wifi_ok ? "" : " 失败",
+           p.cpu_min_mhz, p.cpu_max_mhz, dfs ? (p.light_sleep ? " + light sleep" : "") : " (无 DFS，固定 max)",
+           p.xclk_mhz, xclk_ok ? "" : " 失败", (unsigned long)p.frame_interval_ms);
+}
+
+bool powerDfsActive() {
+    return power_dfs_active.load();
+}
+
+void powerRenderMetrics(MetricsWriter &w) {
+    char labels[32];
+    int current = power_current.load();
+
+    w.type("autodiary_power_profile", "gauge");
+    for (int i = 0; i < POWER_PROFILE_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "profile=\"%s\"", POWER_PROFILES[i].name);
+        w.gauge("autodiary_power_profile", labels, i == current ? 1 : 0);
+    }
+    w.type("autodiary_power_profile_switches_total", "counter");
+    w.counter("autodiary_power_profile_switches_total", NULL, power_switches.value());
+    w.type("autodiary_power_dfs_active", "gauge");
+    w.gauge("autodiary_power_dfs_active", NULL, power_dfs_active.load() ? 1 : 0);
+    w.type("autodiary_cpu_freq_mhz", "gauge");
+    w.gauge("autodiary_cpu_freq_mhz", NULL, halCpuFrequencyMhz());
+}
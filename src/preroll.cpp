@@ -0,0 +1,94 @@
+/**
+ * 触发录制与预录实现
+ *
+ * 片段表是一个小环，每项的 id 兼作序列号：写入者先清零 id、写字段、最后写入新 id，
+ * 读者复制后再确认 id 未变。
+ */
+
+#include "preroll.h"
+#include "pipeline.h"
+#include "frame_store.h"
+#include "hal.h"
+#include <stdio.h>
+#include <atomic>
+
+struct SegmentSlot {
+    std::atomic<uint32_t> id{0};
+    PrerollSegment segment;
+};
+
+static SegmentSlot segments[PREROLL_MAX_SEGMENTS];
+static std::atomic<uint32_t> segment_next_id{1};
+static Counter preroll_triggers[TRIGGER_COUNT];
+
+uint32_t prerollTrigger(TriggerSource source) {
+    uint64_t head = audio_ring.head();
+    if (!audio_ring.ready() || head == 0) return 0;
+
+    int64_t trigger_us = halNowUs();
+    uint32_t rate = audio_ring.sampleRate();
+
+    // 触发时刻对应的样本序号，再往前 AUDIO_PREROLL_MS，不早于采集环中最旧的样本
+    int64_t head_us = audio_ring.sampleTimeUs(head);
+    int64_t back = head_us > trigger_us ? (head_us - trigger_us) * rate / 1000000 : 0;
+    back += (int64_t)AUDIO_PREROLL_MS * rate / 1000;
+    uint64_t oldest = audio_ring.tail();
+    uint64_t start = head > oldest + (uint64_t)back ? head - (uint64_t)back : oldest;
+
+    uint32_t id = segment_next_id.fetch_add(1);
+    SegmentSlot &slot = segments[id % PREROLL_MAX_SEGMENTS];
+    slot.id.store(0);
+    slot.segment.id = id;
+    slot.segment.source = source;
+    slot.segment.trigger_us = trigger_us;
+    slot.segment.audio_start = start;
+    slot.segment.start_us = audio_ring.sampleTimeUs(start);
+    slot.id.store(id);
+
+    preroll_triggers[source].inc();
+    halLog("⏺️ 触发 #%lu (%s): 预录 %lld ms\n", (unsigned long)id, prerollTriggerName(source),
+           (long long)((trigger_us - slot.segment.start_us) / 1000));
+    return id;
+}
+
+bool prerollGetSegment(uint32_t id, PrerollSegment *segment) {
+    if (id == 0) return false;
+    SegmentSlot &slot = segments[id % PREROLL_MAX_SEGMENTS];
+    if (slot.id.load() != id) return false;
+    *segment = slot.segment;
+    return slot.id.load() == id;
+}
+
+const char *prerollTriggerName(TriggerSource source) {
+    static const char *const names[TRIGGER_COUNT] = { "http", "vad", "motion" };
+    return source < TRIGGER_COUNT ? names[source] : "unknown";
+}
+
+void prerollRenderMetrics(MetricsWriter &w) {
+    char labels[32];
+    int64_t now_us = halNowUs();
+
+    // 预录缓冲区占用的内存 (启动时一次性分配，不随运行增长)
+    w.type("autodiary_preroll_buffer_bytes", "gauge");
+    w.gauge("autodiary_preroll_buffer_bytes", "buffer=\"audio\"",
+            (double)audio_ring.capacity() * sizeof(int16_t));
+    w.gauge("autodiary_preroll_buffer_bytes", "buffer=\"video\"", (double)frameStoreBytes());
+
+    // 当前实际可回溯的时长
+    w.type("autodiary_preroll_span_ms", "gauge");
+    uint64_t oldest = audio_ring.tail();
+    int64_t audio_span = audio_ring.head() > oldest ? (now_us - audio_ring.sampleTimeUs(oldest)) / 1000 : 0;
+    w.gauge("autodiary_preroll_span_ms", "buffer=\"audio\"", (double)audio_span);
+    int64_t frame_oldest = frameStoreHistoryOldestUs();
+    w.gauge("autodiary_preroll_span_ms", "buffer=\"video\"",
+            frame_oldest >= 0 ? (double)((now_us - frame_oldest) / 1000) : 0);
+
+    w.type("autodiary_preroll_frames", "gauge");
+    w.gauge("autodiary_preroll_frames", NULL, frameStoreHistoryCount());
+
+    w.type("autodiary_preroll_triggers_total", "counter");
+    for (int i = 0; i < TRIGGER_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "source=\"%s\"", prerollTriggerName((TriggerSource)i));
+        w.counter("autodiary_preroll_triggers_total", labels, preroll_triggers[i].value());
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ * 隐私遮挡区域实现
+ */
+
+#include "privacy_mask.h"
+#include "camera_config.h"
+#include "trace.h"
+#include "hal.h"
+#include <string.h>
+#include <mutex>
+
+#define PRIVACY_MASK_MAGIC      0x4B534D50u     // "PMSK"
+#define PRIVACY_MASK_VERSION    1
+
+// 存储格式：头部 + 全部区域
+struct PrivacyMaskFile {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    JpegRect rects[PRIVACY_MASK_MAX];
+};
+
+static JpegRect mask_rects[PRIVACY_MASK_MAX];
+static int mask_count = 0;
+static std::mutex mask_mutex;
+
+// 以下只在视频任务中使用
+static JpegRecodeWork *mask_work = NULL;
+static uint32_t mask_zoom_generation = 0;         // 上一帧时已应用变焦窗口的序号
+static int mask_settle = 0;                       // 还要丢弃的帧数
+
+static Counter mask_frames;
+static Counter mask_drop_errors;
+static Counter mask_drop_settle;
+
+// ==================== 配置 ====================
+
+void privacyMaskBegin() {
+    PrivacyMaskFile file;
+    memset(&file, 0, sizeof(file));
+    size_t n = halStorageRead(PRIVACY_MASK_PATH, 0, (uint8_t *)&file, sizeof(file));
+    if (n != sizeof(file) || file.magic != PRIVACY_MASK_MAGIC || file.version != PRIVACY_MASK_VERSION ||
+        privacyMaskValidate(file.rects, file.count) != NULL) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mask_mutex);
+    memcpy(mask_rects, file.rects, sizeof(mask_rects));
+    mask_count = file.count;
+    halLog("🙈 隐私遮挡: 读取 %s (%d 个区域)\n", PRIVACY_MASK_PATH, mask_count);
+}
+
+int privacyMaskGet(JpegRect *rects, int max) {
+    std::lock_guard<std::mutex> lock(mask_mutex);
+    int n = mask_count < max ? mask_count : max;
+    memcpy(rects, mask_rects, n * sizeof(JpegRect));
+    return n;
+}
+
+const char *privacyMaskValidate(const JpegRect *rects, int count) {
+    if (count < 0 || count > PRIVACY_MASK_MAX) return "最多 8 个区域";
+    for (int i = 0; i < count; i++) {
+        const JpegRect &r = rects[i];
+        if (r.w == 0 || r.h == 0) return "区域宽高不能为 0";
+        if (r.x + r.w > HAL_SENSOR_WIDTH || r.y + r.h > HAL_SENSOR_HEIGHT) {
+            return "区域超出传感器范围 (1600x1200)";
+        }
+    }
+    return NULL;
+}
+
+void privacyMaskSet(const JpegRect *rects, int count, bool *persisted) {
+    {
+        std::lock_guard<std::mutex> lock(mask_mutex);
+        memset(mask_rects, 0, sizeof(mask_rects));
+        memcpy(mask_rects, rects, count * sizeof(JpegRect));
+        mask_count = count;
+    }
+
+    PrivacyMaskFile file;
+    memset(&file, 0, sizeof(file));
+    file.magic = PRIVACY_MASK_MAGIC;
+    file.version = PRIVACY_MASK_VERSION;
+    file.count = (uint16_t)count;
+    memcpy(file.rects, rects, count * sizeof(JpegRect));
+    *persisted = halStorageWrite(PRIVACY_MASK_PATH, (const uint8_t *)&file, sizeof(file));
+    halLog("🙈 隐私遮挡: %d 个区域\n", count);
+}
+
+// 传感器坐标 [s0, s1) 换算到帧坐标，起点向下、终点向上取整 (宁多勿少)，截到 [0, size]
+static void mapSpan(int s0, int s1, int zoom_pos, int zoom_len, int size, int *f0, int *f1) {
+    int a = s0 - zoom_pos;
+    int b = s1 - zoom_pos;
+    a = a <= 0 ? 0 : a * size / zoom_len;
+    b = b <= 0 ? 0 : (b * size + zoom_len - 1) / zoom_len;
+    *f0 = a < size ? a : size;
+    *f1 = b < size ? b : size;
+}
+
+int privacyMaskToFrame(const JpegRect *rects, int count, uint16_t width, uint16_t height,
+                       JpegRect *out) {
+    // 按已写入传感器的窗口换算：新提交的变焦在视频任务应用之前不影响帧
+    HalCameraSettings s = cameraConfigApplied();
+    int zx = s.zoom_w ? s.zoom_x : 0;
+    int zy = s.zoom_w ? s.zoom_y : 0;
+    int zw = s.zoom_w ? s.zoom_w : HAL_SENSOR_WIDTH;
+    int zh = s.zoom_w ? s.zoom_h : HAL_SENSOR_HEIGHT;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        int x0, x1, y0, y1;
+        mapSpan(rects[i].x, rects[i].x + rects[i].w, zx, zw, width, &x0, &x1);
+        mapSpan(rects[i].y, rects[i].y + rects[i].h, zy, zh, height, &y0, &y1);
+        if (x1 <= x0 || y1 <= y0) continue;             // 在变焦窗口之外
+        out[n++] = { (uint16_t)x0, (uint16_t)y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0) };
+    }
+    return n;
+}
+
+// ==================== 视频任务调用 ====================
+
+size_t privacyMaskCopy(const uint8_t *jpeg, size_t len, uint16_t width, uint16_t height,
+                       uint8_t *out, size_t out_cap) {
+    JpegRect rects[PRIVACY_MASK_MAX];
+    int count = privacyMaskGet(rects, PRIVACY_MASK_MAX);
+
+    // 视频任务应用新的变焦窗口之后，驱动中排队的帧可能还是旧窗口采集的，按新窗口换算会错位；
+    // 从应用时刻 (而不是 HTTP 提交时刻) 开始计数
+    uint32_t zoom_generation = cameraConfigZoomGeneration();
+    if (zoom_generation != mask_zoom_generation) {
+        mask_zoom_generation = zoom_generation;
+        mask_settle = PRIVACY_MASK_SETTLE_FRAMES;
+    }
+    if (count == 0) {
+        if (mask_settle > 0) mask_settle--;
+        if (len > out_cap) return 0;
+        memcpy(out, jpeg, len);
+        return len;
+    }
+    if (mask_settle > 0) {
+        mask_settle--;
+        mask_drop_settle.inc();
+        return 0;
+    }
+
+    if (!mask_work) {
+        mask_work = (JpegRecodeWork *)halAllocLarge(sizeof(JpegRecodeWork));
+        if (!mask_work) {
+            mask_drop_errors.inc();
+            return 0;
+        }
+    }
+
+    JpegRect frame_rects[PRIVACY_MASK_MAX];
+    int n = privacyMaskToFrame(rects, count, width, height, frame_rects);
+    int64_t start_us = halNowUs();
+    size_t out_len = jpegMask(jpeg, len, frame_rects, n, mask_work, out, out_cap);
+    uint32_t mask_us = (uint32_t)(halNowUs() - start_us);
+    metric_privacy_mask_us.observe(mask_us);
+    traceRecord(TRACE_ENCODE, start_us, mask_us, (uint32_t)out_len);
+    if (out_len == 0) {
+        mask_drop_errors.inc();
+        return 0;
+    }
+    mask_frames.inc();
+    return out_len;
+}
+
+void privacyMaskRenderMetrics(MetricsWriter &w) {
+    JpegRect rects[PRIVACY_MASK_MAX];
+    w.type("autodiary_privacy_masks", "gauge");
+    w.gauge("autodiary_privacy_masks", NULL, privacyMaskGet(rects, PRIVACY_MASK_MAX));
+    w.type("autodiary_privacy_masked_frames_total", "counter");
+    w.counter("autodiary_privacy_masked_frames_total", NULL, mask_frames.value());
+    w.type("autodiary_privacy_dropped_frames_total", "counter");
+    w.counter("autodiary_privacy_dropped_frames_total", "reason=\"error\"", mask_drop_errors.value());
+    w.counter("autodiary_privacy_dropped_frames_total", "reason=\"settle\"", mask_drop_settle.value());
+}
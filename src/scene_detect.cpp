@@ -0,0 +1,166 @@
+/**
+ * 场景切换检测实现
+ */
+
+#include "scene_detect.h"
+#include "events.h"
+#include "hal.h"
+#include <string.h>
+#include <mutex>
+
+// 颜色矩差 (3 个分量的均值差 + 标准差差之和) 达到该值时记为最大距离
+#define SCENE_MOMENT_RANGE  96
+
+struct SceneStats {
+    uint16_t hist[SCENE_HIST_BINS];     // 亮度直方图，千分比
+    uint8_t mean[3];                    // Y / Cb / Cr
+    uint8_t stddev[3];
+};
+
+// 只在视频任务中访问
+static SceneStats scene_ref;            // 参考统计 (当前场景)
+static bool scene_has_ref = false;
+static int scene_over = 0;              // 连续超过阈值的采样次数
+static int64_t scene_over_us = 0;       // 其中第一次的帧时刻
+static uint32_t scene_over_seq = 0;
+static int64_t scene_last_change_us = -1;
+
+static SceneState scene_state = { 0, 0, 0 };
+static std::mutex scene_mutex;
+
+static Counter scene_samples;
+static Counter scene_suppressed;
+
+// ==================== 统计 ====================
+
+static uint8_t isqrt(uint32_t v) {
+    uint32_t r = 0;
+    while ((r + 1) * (r + 1) <= v) r++;
+    return (uint8_t)(r > 255 ? 255 : r);
+}
+
+static void computeStats(const JpegDcPlanes &planes, SceneStats *s) {
+    uint32_t counts[SCENE_HIST_BINS];
+    memset(counts, 0, sizeof(counts));
+    for (int ci = 0; ci < 3; ci++) {
+        if (ci >= planes.ncomp) {
+            s->mean[ci] = 128;                      // 灰度图：色度为中性
+            s->stddev[ci] = 0;
+            continue;
+        }
+        uint32_t sum = 0;
+        uint32_t sum_sq = 0;
+        uint32_t n = (uint32_t)planes.width[ci] * planes.height[ci];
+        for (int y = 0; y < planes.height[ci]; y++) {
+            const uint8_t *row = planes.plane[ci] + y * planes.stride[ci];
+            for (int x = 0; x < planes.width[ci]; x++) {
+                uint32_t v = row[x];
+                sum += v;
+                sum_sq += v * v;
+                if (ci == 0) counts[v * SCENE_HIST_BINS / 256]++;
+            }
+        }
+        if (n == 0) n = 1;
+        uint32_t mean = sum / n;
+        uint32_t mean_sq = sum_sq / n;
+        s->mean[ci] = (uint8_t)mean;
+        s->stddev[ci] = isqrt(mean_sq > mean * mean ? mean_sq - mean * mean : 0);
+        if (ci == 0) {
+            for (int i = 0; i < SCENE_HIST_BINS; i++) s->hist[i] = (uint16_t)(counts[i] * 1000 / n);
+        }
+    }
+}
+
+static int absDiff(int a, int b) {
+    return a > b ? a - b : b - a;
+}
+
+// 0~100：直方图 L1 距离 (0~1000) 和颜色矩差 (换算到 0~1000) 的平均
+static int sceneDistance(const SceneStats &a, const SceneStats &b) {
+    int hist = 0;
+    for (int i = 0; i < SCENE_HIST_BINS; i++) hist += absDiff(a.hist[i], b.hist[i]);
+    hist /= 2;
+    int moment = 0;
+    for (int ci = 0; ci < 3; ci++) {
+        moment += absDiff(a.mean[ci], b.mean[ci]) + absDiff(a.stddev[ci], b.stddev[ci]);
+    }
+    moment = moment * 1000 / SCENE_MOMENT_RANGE;
+    if (moment > 1000) moment = 1000;
+    if (hist > 1000) hist = 1000;
+    return (hist + moment) / 20;
+}
+
+// 参考统计向当前帧移动 1/4
+static void followStats(SceneStats &ref, const SceneStats &cur) {
+    for (int i = 0; i < SCENE_HIST_BINS; i++) ref.hist[i] = (uint16_t)((ref.hist[i] * 3 + cur.hist[i] + 2) / 4);
+    for (int ci = 0; ci < 3; ci++) {
+        ref.mean[ci] = (uint8_t)((ref.mean[ci] * 3 + cur.mean[ci] + 2) / 4);
+        ref.stddev[ci] = (uint8_t)((ref.stddev[ci] * 3 + cur.stddev[ci] + 2) / 4);
+    }
+}
+
+// ==================== 判定 ====================
+
+void sceneObserve(const JpegDcPlanes &planes, int64_t timestamp_us, uint32_t frame_seq) {
+    SceneStats cur;
+    computeStats(planes, &cur);
+    scene_samples.inc();
+    if (!scene_has_ref) {
+        scene_ref = cur;
+        scene_has_ref = true;
+        return;
+    }
+
+    int score = sceneDistance(scene_ref, cur);
+    {
+        std::lock_guard<std::mutex> lock(scene_mutex);
+        scene_state.score = (uint8_t)score;
+    }
+    if (score < SCENE_THRESHOLD) {
+        scene_over = 0;
+        if (score < SCENE_THRESHOLD / 2) followStats(scene_ref, cur);
+        return;
+    }
+
+    if (scene_over++ == 0) {
+        scene_over_us = timestamp_us;
+        scene_over_seq = frame_seq;
+    }
+    if (scene_over < SCENE_CONFIRM_SAMPLES) return;
+    scene_over = 0;
+
+    // 距上次切换太近：不切换也不更新参考，画面仍不同时间隔过后再判定
+    if (scene_last_change_us >= 0 &&
+        scene_over_us - scene_last_change_us < SCENE_MIN_INTERVAL_MS * 1000LL) {
+        scene_suppressed.inc();
+        return;
+    }
+
+    scene_ref = cur;
+    scene_last_change_us = scene_over_us;
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(scene_mutex);
+        id = ++scene_state.id;
+        scene_state.start_us = scene_over_us;
+    }
+    eventPublish(EVENT_SCENE, scene_over_us, score, scene_over_seq);
+    halLog("🎬 场景切换 #%u (距离 %d, 帧 #%u)\n", (unsigned)id, score, (unsigned)scene_over_seq);
+}
+
+SceneState sceneCurrent() {
+    std::lock_guard<std::mutex> lock(scene_mutex);
+    return scene_state;
+}
+
+void sceneRenderMetrics(MetricsWriter &w) {
+    SceneState s = sceneCurrent();
+    w.type("autodiary_scene_samples_total", "counter");
+    w.counter("autodiary_scene_samples_total", NULL, scene_samples.value());
+    w.type("autodiary_scene_changes_total", "counter");
+    w.counter("autodiary_scene_changes_total", NULL, s.id);
+    w.type("autodiary_scene_suppressed_total", "counter");
+    w.counter("autodiary_scene_suppressed_total", NULL, scene_suppressed.value());
+    w.type("autodiary_scene_score", "gauge");
+    w.gauge("autodiary_scene_score", NULL, s.score);
+}
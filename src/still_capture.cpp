@@ -0,0 +1,135 @@
+/**
+ * 双流静态照片实现
+ */
+
+#include "still_capture.h"
+#include "camera_config.h"
+#include "privacy_mask.h"
+#include "jpeg_check.h"
+#include <atomic>
+
+static std::atomic<uint32_t> still_requested{0};    // 最新请求的序号
+static std::atomic<uint32_t> still_done{0};         // 视频任务已处理的序号
+static std::atomic<uint8_t> still_request_size{HAL_FRAME_SIZE_COUNT};
+static std::atomic<bool> still_ok{false};
+static StillFrame still_result;                     // 由 still_done 发布
+
+static uint8_t *still_buf = NULL;
+
+// 只在视频任务中访问
+static int resync_left = 0;                         // 还允许丢弃的静态照片尺寸帧数
+static uint16_t resync_width = 0;
+static uint16_t resync_height = 0;
+static int64_t resync_start_us = 0;
+
+static Counter still_captured;
+static Counter still_failed;
+static Counter still_skipped;
+
+// ==================== HTTP 任务 ====================
+
+bool stillCapture(uint8_t frame_size, uint32_t timeout_ms, StillFrame *still) {
+    uint32_t generation = still_requested.load() + 1;
+    still_request_size.store(frame_size);
+    still_requested.store(generation);
+
+    uint32_t waited_ms = 0;
+    while ((int32_t)(still_done.load() - generation) < 0) {
+        if (waited_ms >= timeout_ms) return false;
+        halDelayMs(10);
+        waited_ms += 10;
+    }
+    if (!still_ok.load()) return false;
+    *still = still_result;
+    return true;
+}
+
+// ==================== 视频任务调用 ====================
+
+bool stillPending() {
+    return still_done.load() != still_requested.load();
+}
+
+// 切到 still_size 取一张照片 (经隐私遮挡) 写入 still_buf，再切回预览参数
+static bool captureStill(uint8_t frame_size, StillFrame *still) {
+    if (!still_buf) {
+        still_buf = (uint8_t *)halAllocLarge(STILL_BUFFER_BYTES);
+        if (!still_buf) {
+            halLog("❌ 静态照片缓冲区分配失败\n");
+            return false;
+        }
+    }
+
+    HalCameraSettings preview = cameraConfigEffective();
+    HalCameraSettings settings = preview;
+    settings.frame_size = frame_size;
+    uint16_t width, height;
+    cameraFrameSizeDims(frame_size, &width, &height);
+
+    int64_t start_us = halNowUs();
+    bool applied = halCameraApply(settings);
+    size_t len = 0;
+    for (int i = 0; applied && len == 0 && i <= STILL_SKIP_MAX; i++) {
+        HalFrame frame;
+        if (!halCameraGrab(&frame)) continue;
+        JpegCheck jpeg = jpegValidate(frame.buf, frame.len);
+        // 驱动中排队的还是预览尺寸的帧，切换途中的帧可能损坏
+        if (frame.width == width && frame.height == height && jpeg.status == JPEG_OK) {
+            len = privacyMaskCopy(frame.buf, jpeg.len, width, height, still_buf, STILL_BUFFER_BYTES);
+            still->timestamp_us = frame.timestamp_us;
+        }
+        if (len == 0) still_skipped.inc();
+        halCameraRelease(&frame);
+    }
+    uint32_t switch_us = (uint32_t)(halNowUs() - start_us);
+
+    if (!halCameraApply(preview)) {
+        halLog("⚠️ 切回预览分辨率失败 (%s)\n", cameraFrameSizeName(preview.frame_size));
+    }
+    cameraFrameSizeDims(preview.frame_size, &resync_width, &resync_height);
+    resync_left = STILL_SKIP_MAX;
+    resync_start_us = start_us;
+
+    if (len == 0) {
+        halLog("⚠️ 静态照片失败 (%s, %s)\n", cameraFrameSizeName(frame_size),
+               applied ? "没有取到该尺寸的正常帧" : "切换分辨率失败");
+        return false;
+    }
+    metric_still_switch_us.observe(switch_us);
+    still->buf = still_buf;
+    still->len = len;
+    still->width = width;
+    still->height = height;
+    still->switch_us = switch_us;
+    return true;
+}
+
+void stillServe() {
+    uint32_t generation = still_requested.load();
+    if (generation == still_done.load()) return;
+    bool ok = captureStill(still_request_size.load(), &still_result);
+    (ok ? still_captured : still_failed).inc();
+    still_ok.store(ok);
+    still_done.store(generation);
+}
+
+bool stillResyncDrop(const HalFrame &frame) {
+    if (resync_left == 0) return false;
+    if (frame.width == resync_width && frame.height == resync_height) {
+        // 预览恢复：从开始切换到第一张预览帧为预览中断时长
+        resync_left = 0;
+        metric_still_preview_gap_us.observe((uint32_t)(halNowUs() - resync_start_us));
+        return false;
+    }
+    resync_left--;
+    still_skipped.inc();
+    return true;
+}
+
+void stillRenderMetrics(MetricsWriter &w) {
+    w.type("autodiary_stills_total", "counter");
+    w.counter("autodiary_stills_total", "result=\"ok\"", still_captured.value());
+    w.counter("autodiary_stills_total", "result=\"failed\"", still_failed.value());
+    w.type("autodiary_still_skipped_frames_total", "counter");
+    w.counter("autodiary_still_skipped_frames_total", NULL, still_skipped.value());
+}
@@ -0,0 +1,275 @@
+/**
+ * 系统资源采样实现
+ */
+
+#include "sys_monitor.h"
+#include "task_config.h"
+#include "events.h"
+#include "hal.h"
+#include <string.h>
+#include <stdio.h>
+
+SysStats sys_stats;
+
+static_assert(SYS_STORAGE_CLEAR_PERMILLE < SYS_STORAGE_FULL_PERMILLE, "解除阈值需低于触发阈值");
+
+static bool storage_full = false;
+static bool heap_low = false;
+
+// ==================== 阈值事件 ====================
+
+// 存储用量 (第一次调用时挂载文件系统，不放在 sysMonitorBegin 中拖慢启动)
+static void sampleStorage() {
+    uint64_t used, total;
+    if (halStorageUsage(&used, &total)) {
+        sys_stats.storage_used = used;
+        sys_stats.storage_total = total;
+    }
+}
+
+static void checkThresholds() {
+    if (sys_stats.storage_total > 0) {
+        uint32_t permille = (uint32_t)(sys_stats.storage_used * 1000 / sys_stats.storage_total);
+        if (!storage_full && permille >= SYS_STORAGE_FULL_PERMILLE) {
+            storage_full = true;
+            uint32_t free_kb = (uint32_t)((sys_stats.storage_total - sys_stats.storage_used) / 1024);
+            eventPublish(EVENT_STORAGE_FULL, halNowUs(), (int32_t)permille, free_kb);
+            halLog("⚠️ 存储将满: 已用 %u‰, 剩余 %u KB\n", (unsigned)permille, (unsigned)free_kb);
+        } else if (storage_full && permille < SYS_STORAGE_CLEAR_PERMILLE) {
+            storage_full = false;
+        }
+    }
+
+    const HeapRegionStats &heap = sys_stats.internal;
+    if (heap.total > 0) {
+        if (!heap_low && heap.free < SYS_LOW_HEAP_BYTES) {
+            heap_low = true;
+            eventPublish(EVENT_LOW_HEAP, halNowUs(), (int32_t)heap.free, heap.largest_block);
+            halLog("⚠️ 内部堆不足: 空闲 %u, 最大块 %u\n", (unsigned)heap.free, (unsigned)heap.largest_block);
+        } else if (heap_low && heap.free > SYS_LOW_HEAP_BYTES / 4 * 5) {
+            heap_low = false;
+        }
+    }
+}
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+static portMUX_TYPE sys_monitor_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t monitorTaskHandle = NULL;
+static const TaskStackStats *sampling_task = NULL;  // 采样任务正在读取水位的条目 (受 sys_monitor_mux 保护)
+
+// ==================== 内部函数 ====================
+
+// 分配失败回调，可能在任意任务中调用，只做计数
+static void onAllocFailed(size_t size, uint32_t caps, const char *function_name) {
+    sys_stats.alloc_failures++;
+    sys_stats.alloc_failure_last_size = size;
+    sys_stats.alloc_failure_last_caps = caps;
+}
+
+static void sampleRegion(HeapRegionStats &region, uint32_t caps) {
+    region.total = heap_caps_get_total_size(caps);
+    region.free = heap_caps_get_free_size(caps);
+    region.min_free = heap_caps_get_minimum_free_size(caps);
+    region.largest_block = heap_caps_get_largest_free_block(caps);
+}
+
+static void sampleOnce() {
+    sampleRegion(sys_stats.internal, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (psramFound()) {
+        sampleRegion(sys_stats.psram, MALLOC_CAP_SPIRAM);
+    }
+
+    // 句柄在临界区中取出，水位在临界区外读取 (要扫描整个堆栈，不能关着中断做)；
+    // sampling_task 让 sysMonitorUnwatchTask 等到读取结束，任务在此期间不会被删除
+    portENTER_CRITICAL(&sys_monitor_mux);
+    uint8_t count = sys_stats.task_count;
+    portEXIT_CRITICAL(&sys_monitor_mux);
+    for (uint8_t i = 0; i < count; i++) {
+        TaskStackStats &t = sys_stats.tasks[i];
+        portENTER_CRITICAL(&sys_monitor_mux);
+        TaskHandle_t handle = (TaskHandle_t)t.handle;
+        sampling_task = handle ? &t : NULL;
+        portEXIT_CRITICAL(&sys_monitor_mux);
+        if (handle == NULL) continue;
+
+        uint32_t free_min = uxTaskGetStackHighWaterMark(handle);
+
+        portENTER_CRITICAL(&sys_monitor_mux);
+        t.free_min = free_min;
+        sampling_task = NULL;
+        portEXIT_CRITICAL(&sys_monitor_mux);
+    }
+
+    sys_stats.samples++;
+}
+
+static void monitorTask(void *parameter) {
+    while (1) {
+        sampleOnce();
+        sampleStorage();
+        checkThresholds();
+        vTaskDelay(pdMS_TO_TICKS(SYS_MONITOR_INTERVAL_MS));
+    }
+}
+
+static TaskStackStats *findOrAddTask(const char *name) {
+    for (uint8_t i = 0; i < sys_stats.task_count; i++) {
+        if (strcmp(sys_stats.tasks[i].name, name) == 0) {
+            return &sys_stats.tasks[i];
+        }
+    }
+    if (sys_stats.task_count >= SYS_MONITOR_MAX_TASKS) {
+        return NULL;
+    }
+    TaskStackStats *t = &sys_stats.tasks[sys_stats.task_count++];
+    t->name = name;
+    t->handle = NULL;
+    t->stack_size = 0;
+    t->free_min = UINT32_MAX;
+    t->exited = false;
+    return t;
+}
+
+// ==================== 公共接口 ====================
+
+void sysMonitorBegin() {
+    heap_caps_register_failed_alloc_callback(onAllocFailed);
+    sampleOnce();
+
+    xTaskCreatePinnedToCore(
+        monitorTask,
+        "SysMonitor",
+        TASK_MONITOR_STACK,
+        NULL,
+        TASK_MONITOR_PRIORITY,
+        &monitorTaskHandle,
+        TASK_MONITOR_CORE
+    );
+
+    if (monitorTaskHandle == NULL) {
+        Serial.println("❌ 资源采样任务创建失败!");
+    } else {
+        sysMonitorWatchTask(monitorTaskHandle, "SysMonitor", TASK_MONITOR_STACK);
+    }
+}
+
+void sysMonitorWatchTask(void *handle, const char *name, uint32_t stack_size) {
+    if (handle == NULL) return;
+    portENTER_CRITICAL(&sys_monitor_mux);
+    TaskStackStats *t = findOrAddTask(name);
+    if (t && !t->exited) {
+        t->handle = handle;
+        t->stack_size = stack_size;
+    }
+    portEXIT_CRITICAL(&sys_monitor_mux);
+}
+
+void sysMonitorUnwatchTask(const char *name) {
+    uint32_t free_now = uxTaskGetStackHighWaterMark(NULL);
+    while (1) {
+        portENTER_CRITICAL(&sys_monitor_mux);
+        TaskStackStats *t = findOrAddTask(name);
+        bool busy = t != NULL && t == sampling_task;
+        if (t && !busy) {
+            t->handle = NULL;
+            t->exited = true;
+            if (free_now < t->free_min) {
+                t->free_min = free_now;
+            }
+        }
+        portEXIT_CRITICAL(&sys_monitor_mux);
+        if (!busy) return;
+        vTaskDelay(1);      // 采样任务正在读取本任务的水位
+    }
+}
+
+void sysMonitorReportSelf(const char *name, uint32_t stack_size) {
+    uint32_t free_now = uxTaskGetStackHighWaterMark(NULL);
+    portENTER_CRITICAL(&sys_monitor_mux);
+    TaskStackStats *t = findOrAddTask(name);
+    if (t) {
+        t->stack_size = stack_size;
+        if (free_now < t->free_min) {
+            t->free_min = free_now;
+        }
+    }
+    portEXIT_CRITICAL(&sys_monitor_mux);
+}
+
+#else  // 主机构建：没有 heap_caps 和任务水位，只采样存储用量
+
+static void monitorTask(void *parameter) {
+    while (1) {
+        sampleStorage();
+        checkThresholds();
+        sys_stats.samples++;
+        halDelayMs(SYS_MONITOR_INTERVAL_MS);
+    }
+}
+
+void sysMonitorBegin() {
+    if (!halTaskCreate(monitorTask, "SysMonitor", TASK_MONITOR_STACK, NULL,
+                       TASK_MONITOR_PRIORITY, TASK_MONITOR_CORE, NULL)) {
+        halLog("❌ 资源采样任务创建失败!\n");
+    }
+}
+
+void sysMonitorWatchTask(void *handle, const char *name, uint32_t stack_size) {}
+
+void sysMonitorUnwatchTask(const char *name) {}
+
+void sysMonitorReportSelf(const char *name, uint32_t stack_size) {}
+
+#endif // ARDUINO
+
+float sysMonitorFragmentation(const HeapRegionStats &region) {
+    if (region.free == 0) return 0.0f;
+    return 1.0f - (float)region.largest_block / (float)region.free;
+}
+
+void sysMonitorRenderMetrics(MetricsWriter &w) {
+    const struct { const char *labels; const HeapRegionStats *stats; } regions[] = {
+        { "region=\"internal\"", &sys_stats.internal },
+        { "region=\"psram\"", &sys_stats.psram },
+    };
+
+    w.type("autodiary_heap_total_bytes", "gauge");
+    for (const auto &r : regions) w.gauge("autodiary_heap_total_bytes", r.labels, r.stats->total);
+    w.type("autodiary_heap_free_bytes", "gauge");
+    for (const auto &r : regions) w.gauge("autodiary_heap_free_bytes", r.labels, r.stats->free);
+    w.type("autodiary_heap_min_free_bytes", "gauge");
+    for (const auto &r : regions) w.gauge("autodiary_heap_min_free_bytes", r.labels, r.stats->min_free);
+    w.type("autodiary_heap_largest_free_block_bytes", "gauge");
+    for (const auto &r : regions) w.gauge("autodiary_heap_largest_free_block_bytes", r.labels, r.stats->largest_block);
+    w.type("autodiary_heap_fragmentation_ratio", "gauge");
+    for (const auto &r : regions) w.gauge("autodiary_heap_fragmentation_ratio", r.labels, sysMonitorFragmentation(*r.stats));
+
+    w.type("autodiary_alloc_failures_total", "counter");
+    w.counter("autodiary_alloc_failures_total", NULL, sys_stats.alloc_failures);
+    w.type("autodiary_alloc_failure_last_size_bytes", "gauge");
+    w.gauge("autodiary_alloc_failure_last_size_bytes", NULL, sys_stats.alloc_failure_last_size);
+
+    w.type("autodiary_storage_used_bytes", "gauge");
+    w.gauge("autodiary_storage_used_bytes", NULL, (double)sys_stats.storage_used);
+    w.type("autodiary_storage_total_bytes", "gauge");
+    w.gauge("autodiary_storage_total_bytes", NULL, (double)sys_stats.storage_total);
+
+    char labels[48];
+    w.type("autodiary_task_stack_size_bytes", "gauge");
+    for (uint8_t i = 0; i < sys_stats.task_count; i++) {
+        const TaskStackStats &t = sys_stats.tasks[i];
+        snprintf(labels, sizeof(labels), "task=\"%s\"", t.name);
+        w.gauge("autodiary_task_stack_size_bytes", labels, t.stack_size);
+    }
+    w.type("autodiary_task_stack_free_min_bytes", "gauge");
+    for (uint8_t i = 0; i < sys_stats.task_count; i++) {
+        const TaskStackStats &t = sys_stats.tasks[i];
+        if (t.free_min == UINT32_MAX) continue;
+        snprintf(labels, sizeof(labels), "task=\"%s\"", t.name);
+        w.gauge("autodiary_task_stack_free_min_bytes", labels, t.free_min);
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * 热路径追踪实现
+ */
+
+#include "trace.h"
+#include <atomic>
+
+struct TraceSlot {
+    int64_t start_us;
+    uint32_t dur_us;
+    uint32_t arg;
+    std::atomic<uint32_t> seq;   // 发布序号：写完后置为 index + 1，0 表示空
+    uint8_t event;
+    uint8_t core;
+};
+
+struct TraceRing {
+    std::atomic<uint32_t> head{0};
+    TraceSlot slots[TRACE_RING_EVENTS];
+};
+
+static TraceRing trace_rings[TRACE_CORES];
+static std::atomic<bool> trace_enabled{TRACE_ENABLED != 0};
+
+static const char *const TRACE_EVENT_NAMES[TRACE_EVENT_COUNT] = {
+    "capture", "encode", "send", "i2s_read", "http"
+};
+
+void traceRecord(TraceEvent event, int64_t start_us, uint32_t dur_us, uint32_t arg) {
+#if TRACE_ENABLED
+    if (!trace_enabled.load(std::memory_order_relaxed)) return;
+
+    uint8_t core = (uint8_t)halCoreId();
+    TraceRing &ring = trace_rings[core < TRACE_CORES ? core : 0];
+    uint32_t index = ring.head.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot &slot = ring.slots[index % TRACE_RING_EVENTS];
+
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start_us = start_us;
+    slot.dur_us = dur_us;
+    slot.arg = arg;
+    slot.event = (uint8_t)event;
+    slot.core = core;
+    slot.seq.store(index + 1, std::memory_order_release);
+#endif
+}
+
+void traceSetEnabled(bool enabled) {
+    trace_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool traceIsEnabled() {
+    return trace_enabled.load(std::memory_order_relaxed);
+}
+
+void traceRenderJson(MetricsWriter &w) {
+    w.printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // 元数据：进程 = 核心，线程 = 流水线阶段
+    bool first = true;
+    for (int core = 0; core < TRACE_CORES; core++) {
+        w.printf("%s{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":\"core%d\"}}",
+                 first ? "" : ",", core, core);
+        first = false;
+        for (int e = 0; e < TRACE_EVENT_COUNT; e++) {
+            w.printf(",{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     core, e, TRACE_EVENT_NAMES[e]);
+        }
+    }
+
+    for (int core = 0; core < TRACE_CORES; core++) {
+        TraceRing &ring = trace_rings[core];
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+        uint32_t start = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+
+        for (uint32_t index = start; index < head; index++) {
+            TraceSlot &slot = ring.slots[index % TRACE_RING_EVENTS];
+            if (slot.seq.load(std::memory_order_acquire) != index + 1) continue;
+
+            int64_t start_us = slot.start_us;
+            uint32_t dur_us = slot.dur_us;
+            uint32_t arg = slot.arg;
+            uint8_t event = slot.event;
+
+            // 复制期间被覆盖的槽位直接跳过
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != index + 1) continue;
+            if (event >= TRACE_EVENT_COUNT) continue;
+
+            w.printf(",{\"ph\":\"X\",\"name\":\"%s\",\"pid\":%d,\"tid\":%u,\"ts\":%lld,\"dur\":%u,\"args\":{\"arg\":%u}}",
+                     TRACE_EVENT_NAMES[event], core, (unsigned)event,
+                     (long long)start_us, (unsigned)dur_us, (unsigned)arg);
+        }
+    }
+
+    w.printf("]}");
+}
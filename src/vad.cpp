@@ -0,0 +1,116 @@
+/**
+ * 语音活动检测实现
+ */
+
+#include "vad.h"
+#include "events.h"
+#include "preroll.h"
+#include "hal.h"
+#include <math.h>
+#include <atomic>
+
+// 以下只在音频任务中访问
+static int32_t vad_dc_q8 = 0;           // 直流分量 (Q8)
+static uint64_t vad_energy = 0;         // 当前帧的平方和
+static uint32_t vad_frame_fill = 0;     // 当前帧已累计的样本数
+static float vad_floor_db = -1.0f;      // 噪声底，负数表示尚未初始化
+static uint32_t vad_loud_ms = 0;        // 连续高于起始阈值的时长
+static uint32_t vad_quiet_ms = 0;       // 语音中连续低于结束阈值的时长
+static int64_t vad_loud_start_us = 0;
+static int64_t vad_quiet_start_us = 0;
+static int64_t vad_onset_us = 0;
+static uint32_t vad_peak_db = 0;
+
+static std::atomic<bool> vad_active{false};
+static std::atomic<int32_t> vad_level_x10{0};   // 最近一帧能量 (0.1 dB)
+static std::atomic<int32_t> vad_floor_x10{0};
+
+static Counter vad_segments;
+
+// ==================== 判定 ====================
+
+static void onFrame(float level_db, int64_t frame_start_us) {
+    if (vad_floor_db < 0) vad_floor_db = level_db;
+
+    // 噪声底：向下快速跟随，向上限速
+    if (level_db < vad_floor_db) {
+        vad_floor_db += (level_db - vad_floor_db) * 0.1f;
+    } else {
+        float rise = (float)VAD_FLOOR_RISE_DB * VAD_FRAME_MS / 1000.0f;
+        vad_floor_db += level_db - vad_floor_db < rise ? level_db - vad_floor_db : rise;
+    }
+    vad_level_x10.store((int32_t)(level_db * 10));
+    vad_floor_x10.store((int32_t)(vad_floor_db * 10));
+
+    float above_db = level_db - vad_floor_db;
+    if (!vad_active.load()) {
+        if (above_db < VAD_ONSET_DB) {
+            vad_loud_ms = 0;
+            return;
+        }
+        if (vad_loud_ms == 0) {
+            vad_loud_start_us = frame_start_us;
+            vad_peak_db = 0;
+        }
+        vad_loud_ms += VAD_FRAME_MS;
+        if (above_db > vad_peak_db) vad_peak_db = (uint32_t)above_db;
+        if (vad_loud_ms < VAD_ONSET_MS) return;
+
+        vad_active.store(true);
+        vad_onset_us = vad_loud_start_us;
+        vad_quiet_ms = 0;
+        vad_segments.inc();
+#if VAD_PREROLL_TRIGGER
+        uint32_t segment = prerollTrigger(TRIGGER_VAD);
+#else
+        uint32_t segment = 0;
+#endif
+        eventPublish(EVENT_VAD, vad_onset_us, 1, vad_peak_db, segment);
+        return;
+    }
+
+    if (above_db >= VAD_OFFSET_DB) {
+        vad_quiet_ms = 0;
+        return;
+    }
+    if (vad_quiet_ms == 0) vad_quiet_start_us = frame_start_us;
+    vad_quiet_ms += VAD_FRAME_MS;
+    if (vad_quiet_ms < VAD_HANGOVER_MS) return;
+
+    vad_active.store(false);
+    vad_loud_ms = 0;
+    eventPublish(EVENT_VAD, vad_quiet_start_us, 0, (uint32_t)((vad_quiet_start_us - vad_onset_us) / 1000));
+}
+
+void vadObserve(const int16_t *samples, int count, uint32_t sample_rate, int64_t end_us) {
+    const uint32_t frame_samples = sample_rate * VAD_FRAME_MS / 1000;
+    for (int i = 0; i < count; i++) {
+        int32_t x = (int32_t)samples[i] * 256;
+        vad_dc_q8 += (x - vad_dc_q8) >> 8;
+        int32_t y = (x - vad_dc_q8) >> 8;
+        vad_energy += (uint64_t)((int64_t)y * y);
+        if (++vad_frame_fill < frame_samples) continue;
+
+        // 均方值 +1 避免数字静音时取对数为负无穷
+        float level_db = 10.0f * log10f((float)(vad_energy / frame_samples) + 1.0f);
+        int64_t frame_end_us = end_us - (int64_t)(count - 1 - i) * 1000000 / sample_rate;
+        onFrame(level_db, frame_end_us - (int64_t)VAD_FRAME_MS * 1000);
+        vad_energy = 0;
+        vad_frame_fill = 0;
+    }
+}
+
+bool vadActive() {
+    return vad_active.load();
+}
+
+void vadRenderMetrics(MetricsWriter &w) {
+    w.type("autodiary_vad_active", "gauge");
+    w.gauge("autodiary_vad_active", NULL, vad_active.load() ? 1 : 0);
+    w.type("autodiary_vad_segments_total", "counter");
+    w.counter("autodiary_vad_segments_total", NULL, vad_segments.value());
+    w.type("autodiary_vad_level_db", "gauge");
+    w.gauge("autodiary_vad_level_db", NULL, vad_level_x10.load() / 10.0f);
+    w.type("autodiary_vad_noise_floor_db", "gauge");
+    w.gauge("autodiary_vad_noise_floor_db", NULL, vad_floor_x10.load() / 10.0f);
+}
@@ -0,0 +1,139 @@
+/**
+ * Web UI 资源 (由 scripts/tools/embed_web_assets.py 从 web/ 生成，不要手动修改)
+ */
+
+#include "web_assets.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <pgmspace.h>
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// /: 1080 -> 492 字节
+static const uint8_t asset_index[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x94, 0x4d, 0x6f, 0xdb, 0x30,
+    0x0c, 0x86, 0xef, 0xfd, 0x15, 0x9a, 0xce, 0x73, 0xbc, 0xc4, 0x5b, 0x90, 0x15, 0xb6, 0x87, 0x22,
+    0x69, 0x87, 0x1d, 0x86, 0x06, 0x4b, 0xd7, 0x6d, 0x47, 0x45, 0x62, 0x62, 0xae, 0xb6, 0x6c, 0x48,
+    0x8c, 0x83, 0xfc, 0xfb, 0xd1, 0x5f, 0x49, 0xda, 0x00, 0xfb, 0xba, 0xd8, 0x94, 0xf8, 0xea, 0x21,
+    0x45, 0x93, 0x8e, 0x5f, 0x2d, 0xee, 0xe7, 0x0f, 0x3f, 0x96, 0xb7, 0x22, 0xa3, 0x22, 0x4f, 0xaf,
+    0xe2, 0xe1, 0x05, 0xca, 0xa4, 0x57, 0x42, 0xc4, 0x05, 0x90, 0x12, 0x3a, 0x53, 0xce, 0x03, 0x25,
+    0xf2, 0xeb, 0xc3, 0x5d, 0x30, 0x93, 0x27, 0x87, 0x55, 0x05, 0x24, 0xb2, 0x46, 0xd8, 0x57, 0xa5,
+    0x23, 0x29, 0x74, 0x69, 0x09, 0x2c, 0x0b, 0xf7, 0x68, 0x28, 0x4b, 0x0c, 0xd4, 0xa8, 0x21, 0x68,
+    0x17, 0xaf, 0x05, 0x5a, 0x24, 0x54, 0x79, 0xe0, 0xb5, 0xca, 0x21, 0x19, 0x77, 0x18, 0x42, 0xca,
+    0x21, 0xbd, 0xd9, 0x51, 0xb9, 0x40, 0xe5, 0x0e, 0xe2, 0x73, 0xc9, 0xaa, 0xd2, 0xc5, 0x61, 0xe7,
+    0x68, 0x24, 0x39, 0xda, 0x27, 0xe1, 0x20, 0x4f, 0xa4, 0xa7, 0x43, 0x0e, 0x3e, 0x03, 0xe0, 0x50,
+    0x99, 0x83, 0x4d, 0x22, 0xc3, 0x1d, 0x86, 0xaa, 0xaa, 0x46, 0xda, 0xfb, 0x0f, 0x75, 0xf2, 0x4e,
+    0x8d, 0x23, 0x13, 0x99, 0xcd, 0x64, 0x36, 0xe6, 0x87, 0x89, 0x38, 0x44, 0x1c, 0x76, 0x57, 0x89,
+    0xd7, 0xa5, 0x39, 0xb4, 0x38, 0x83, 0xb5, 0xd0, 0xb9, 0xf2, 0x3e, 0x91, 0x4d, 0xba, 0x0a, 0x2d,
+    0xb8, 0x36, 0x17, 0xf6, 0x65, 0xe3, 0xb3, 0x54, 0xe6, 0x7c, 0x39, 0xa7, 0x4e, 0x19, 0xb1, 0xb3,
+    0x53, 0x9d, 0x11, 0x6a, 0x34, 0x50, 0x06, 0x2f, 0x39, 0xac, 0xc1, 0x62, 0x2b, 0xd0, 0xf4, 0x82,
+    0x15, 0x39, 0x50, 0x85, 0x14, 0xde, 0x69, 0x4e, 0xd9, 0xf7, 0x2b, 0x95, 0x73, 0xa1, 0x1e, 0x1b,
+    0xbf, 0xe8, 0x05, 0x3d, 0x3f, 0xe4, 0x00, 0xa7, 0x50, 0x47, 0xe4, 0x7a, 0x47, 0x54, 0xda, 0x21,
+    0xf2, 0x9a, 0x6c, 0x50, 0x39, 0x2c, 0x38, 0x53, 0x29, 0x8c, 0x22, 0x15, 0xf4, 0x15, 0xd1, 0xaa,
+    0xa2, 0x9d, 0x03, 0x99, 0xce, 0x3b, 0x43, 0x2c, 0xb3, 0x92, 0xca, 0x38, 0xec, 0x8e, 0xff, 0x2b,
+    0xcd, 0x93, 0xa2, 0x9d, 0x97, 0xe9, 0x47, 0x20, 0xce, 0xb2, 0xb1, 0xff, 0x82, 0x64, 0x94, 0xdd,
+    0x72, 0x31, 0x9e, 0x81, 0x1c, 0x30, 0x8a, 0x7b, 0x24, 0xfd, 0xd2, 0x19, 0xcf, 0x31, 0x2f, 0xee,
+    0x3c, 0xc0, 0x86, 0xe8, 0x43, 0xa8, 0x2c, 0x4a, 0x57, 0x07, 0x4f, 0x50, 0x1c, 0x73, 0xe1, 0x9d,
+    0xc1, 0x79, 0x71, 0x2e, 0x40, 0x56, 0xca, 0x34, 0xf6, 0x95, 0xb2, 0xe9, 0xa2, 0xed, 0xc5, 0xeb,
+    0x38, 0x6c, 0x57, 0xed, 0x5e, 0xfb, 0x81, 0xba, 0x1e, 0x95, 0xe9, 0xf7, 0x4f, 0x37, 0xf7, 0xc1,
+    0xed, 0x6a, 0x19, 0x4d, 0x56, 0xd1, 0x20, 0x0a, 0xcf, 0xcb, 0xff, 0x7b, 0xfc, 0x37, 0xbc, 0xc3,
+    0x4b, 0xf8, 0x1e, 0x37, 0xc8, 0x1f, 0x22, 0x03, 0xfd, 0x84, 0x76, 0x3b, 0x1a, 0x8d, 0xfe, 0x83,
+    0xdc, 0xb5, 0xe1, 0x25, 0x5b, 0xb7, 0xfb, 0x7f, 0xa0, 0x1f, 0xcd, 0x93, 0xe1, 0xb5, 0xc3, 0x8a,
+    0xfa, 0x5e, 0xec, 0xc7, 0xe7, 0x67, 0x33, 0x3d, 0xeb, 0xf7, 0x6f, 0x41, 0x4d, 0x67, 0xe3, 0x08,
+    0x26, 0x6f, 0xa6, 0xd3, 0x29, 0x4f, 0x0f, 0xf3, 0x5a, 0x71, 0x33, 0x46, 0xdd, 0xfc, 0x70, 0xc1,
+    0xdb, 0x1f, 0xc4, 0x2f, 0x97, 0x4e, 0xfe, 0x86, 0x38, 0x04, 0x00, 0x00,
+};
+
+// /ui/app.css: 808 -> 384 字节
+static const uint8_t asset_ui_app_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x92, 0xd1, 0x6e, 0x83, 0x30,
+    0x0c, 0x45, 0xdf, 0xf7, 0x15, 0x91, 0xa6, 0x3d, 0x66, 0x0a, 0x65, 0xed, 0x18, 0x3c, 0xed, 0x53,
+    0x02, 0x31, 0xe0, 0x2d, 0x24, 0x28, 0x09, 0xa5, 0x68, 0xda, 0xbf, 0xcf, 0xa1, 0xb4, 0xb0, 0x75,
+    0xd3, 0x14, 0x29, 0x52, 0x2c, 0xdb, 0xf7, 0x5c, 0x3b, 0xa5, 0x55, 0x13, 0xfb, 0x60, 0xb5, 0x35,
+    0x81, 0xd7, 0xb2, 0x43, 0x3d, 0xe5, 0xec, 0xd5, 0xa1, 0xd4, 0x05, 0x2b, 0x65, 0xf5, 0xde, 0x38,
+    0x3b, 0x18, 0x95, 0xb3, 0xfb, 0xc3, 0xe1, 0x19, 0x40, 0x16, 0x4c, 0xa1, 0xef, 0xb5, 0xa4, 0xa4,
+    0x5a, 0xc3, 0xa9, 0x60, 0x6f, 0x83, 0x0f, 0x58, 0x4f, 0xbc, 0xa2, 0x7a, 0x30, 0x21, 0x67, 0x15,
+    0xdd, 0xe0, 0x0a, 0x26, 0x35, 0x36, 0x86, 0x63, 0x80, 0xce, 0xaf, 0xc1, 0x0e, 0x0d, 0x6f, 0x01,
+    0x9b, 0x96, 0x12, 0x13, 0x21, 0x8e, 0x6d, 0xc1, 0x3e, 0xef, 0x1e, 0x63, 0xad, 0x44, 0x03, 0x8e,
+    0x38, 0xb6, 0x9a, 0x63, 0x4b, 0xe5, 0x84, 0x61, 0x9d, 0x02, 0xc7, 0x9d, 0x54, 0x38, 0x50, 0xaf,
+    0x64, 0xdf, 0x93, 0x6e, 0x2f, 0x95, 0x42, 0xd3, 0xe4, 0x2c, 0x15, 0xf1, 0xd9, 0xc9, 0x13, 0x1f,
+    0x51, 0x85, 0x36, 0x67, 0x99, 0x98, 0x23, 0xcb, 0x8b, 0x54, 0x1e, 0xa2, 0x48, 0x9b, 0x50, 0xf3,
+    0xca, 0x6a, 0xeb, 0xc8, 0x4b, 0x9a, 0xa6, 0x05, 0x0b, 0x70, 0x0a, 0x7c, 0xa6, 0x5c, 0xf9, 0x08,
+    0xe6, 0x88, 0x0a, 0x2c, 0xff, 0x0b, 0xe9, 0x5e, 0x08, 0x71, 0x4b, 0xb4, 0x20, 0xb8, 0x06, 0xa9,
+    0xd7, 0x8e, 0x5e, 0x4c, 0xc4, 0x5e, 0xd8, 0x35, 0x54, 0xfe, 0x0d, 0xe4, 0x62, 0x5e, 0x0e, 0xc1,
+    0xc6, 0x94, 0x72, 0x08, 0xc1, 0x1a, 0xca, 0xba, 0xfa, 0x49, 0x76, 0xdb, 0x66, 0xb3, 0xd7, 0xb3,
+    0x5c, 0xce, 0x8c, 0x35, 0xb7, 0xe3, 0xc8, 0x62, 0x46, 0x35, 0x38, 0x1f, 0x9d, 0xf5, 0x16, 0xcf,
+    0x46, 0xe6, 0x75, 0x8e, 0x8b, 0x58, 0x69, 0xb5, 0x9a, 0xbd, 0x95, 0xc1, 0xf0, 0xde, 0x21, 0x35,
+    0x9f, 0x7e, 0xfa, 0xba, 0xac, 0x77, 0x19, 0xd1, 0x32, 0xfa, 0xa5, 0x46, 0x49, 0xd3, 0xdc, 0x8e,
+    0xa2, 0xde, 0x1f, 0xe8, 0xfc, 0x52, 0xe2, 0x83, 0x0c, 0x83, 0xbf, 0x49, 0xcf, 0xea, 0x97, 0x5a,
+    0x6e, 0x36, 0x97, 0x6c, 0xcc, 0x5d, 0xed, 0x6c, 0x63, 0x1a, 0x6a, 0xa2, 0x7f, 0xa2, 0x71, 0x7a,
+    0xab, 0x51, 0xad, 0x90, 0x57, 0x8d, 0xf9, 0x7f, 0x91, 0xd0, 0x7f, 0x9f, 0xd2, 0xf7, 0xb2, 0x02,
+    0x5e, 0x42, 0x18, 0x01, 0xcc, 0x06, 0x21, 0x3b, 0xaf, 0x6a, 0xd1, 0x2b, 0x2d, 0x2d, 0xa3, 0x23,
+    0xb0, 0x55, 0x11, 0x44, 0x3c, 0x51, 0xf1, 0x0b, 0xad, 0x37, 0xd8, 0x81, 0x28, 0x03, 0x00, 0x00,
+};
+
+// /ui/app.js: 1040 -> 595 字节
+static const uint8_t asset_ui_app_js[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x53, 0x5d, 0x6b, 0x13, 0x41,
+    0x14, 0x7d, 0xef, 0xaf, 0xb8, 0x6f, 0xb3, 0x8b, 0x75, 0x53, 0x5f, 0x0d, 0xa5, 0xb4, 0x36, 0x48,
+    0xfd, 0x86, 0x3e, 0x8a, 0x84, 0x71, 0xf7, 0x26, 0x99, 0x3a, 0x99, 0x89, 0xb3, 0x77, 0x53, 0xab,
+    0x14, 0xd2, 0x17, 0xc1, 0x2a, 0x06, 0x05, 0xf5, 0xa1, 0x5a, 0x4c, 0x41, 0x2a, 0x45, 0xa8, 0x08,
+    0xa9, 0x85, 0xb6, 0xf4, 0xcf, 0x34, 0xdb, 0xe4, 0xa9, 0x7f, 0xc1, 0xd9, 0xdd, 0x24, 0x8d, 0x35,
+    0xea, 0xdb, 0xde, 0xb9, 0x1f, 0xe7, 0x9c, 0x7b, 0xee, 0xe6, 0x72, 0xd0, 0xdd, 0x7e, 0xde, 0xdb,
+    0x7a, 0xd3, 0x6d, 0x7f, 0x87, 0x5c, 0x48, 0x06, 0x79, 0x15, 0x9c, 0xdb, 0x37, 0xee, 0x15, 0xae,
+    0x9f, 0x1d, 0xbe, 0x3a, 0xd9, 0x6f, 0x9c, 0xec, 0xef, 0xf4, 0xde, 0x1d, 0x77, 0x8f, 0x37, 0xe3,
+    0xd7, 0x5f, 0xdc, 0xb3, 0xc3, 0x8d, 0xb8, 0xbd, 0x96, 0x05, 0x9d, 0x9f, 0x3f, 0xe2, 0x83, 0x56,
+    0xfc, 0x61, 0xaf, 0xd7, 0x68, 0x74, 0x36, 0x36, 0xe3, 0xdd, 0xe6, 0xe9, 0xf6, 0xdb, 0xf8, 0xe5,
+    0x8b, 0x4e, 0xf3, 0xbd, 0x6d, 0x8b, 0xbf, 0xb5, 0x20, 0x57, 0x17, 0x01, 0x6a, 0x6f, 0xa9, 0x56,
+    0x9e, 0x70, 0x4a, 0x91, 0xf2, 0x49, 0x68, 0x05, 0x8e, 0x0b, 0xcf, 0x26, 0x00, 0xea, 0xdc, 0x40,
+    0x9a, 0x86, 0x69, 0x08, 0xb4, 0x1f, 0x55, 0x51, 0x91, 0x57, 0x46, 0x2a, 0x48, 0x4c, 0x3e, 0xe7,
+    0x56, 0x16, 0x02, 0x87, 0xa5, 0x05, 0x8b, 0x29, 0x27, 0xe6, 0xe6, 0xfb, 0x5d, 0x35, 0x2d, 0xa5,
+    0x50, 0x65, 0xdb, 0xa7, 0x22, 0x29, 0xf3, 0x13, 0xc9, 0x73, 0x8a, 0xc3, 0x83, 0xa0, 0x50, 0xb7,
+    0xbd, 0xb7, 0x44, 0x48, 0xa8, 0xd0, 0x38, 0x0c, 0x8d, 0xd1, 0x86, 0x4d, 0xc2, 0x45, 0x70, 0x00,
+    0x51, 0x02, 0xa7, 0x3f, 0xc8, 0x05, 0x83, 0x14, 0x19, 0x95, 0x4f, 0x13, 0xe7, 0xd3, 0x43, 0xa4,
+    0x05, 0x45, 0x68, 0xea, 0x5c, 0x3a, 0x7f, 0x0e, 0x18, 0x80, 0x86, 0xc6, 0xb7, 0xb5, 0xec, 0x5c,
+    0xea, 0x0c, 0x4d, 0x33, 0xb8, 0x04, 0xf3, 0x9c, 0xd0, 0x53, 0x7a, 0xd9, 0x71, 0xb3, 0xb9, 0xab,
+    0x93, 0x70, 0x65, 0x6a, 0x6a, 0x2a, 0x8d, 0x56, 0xdd, 0x94, 0xf5, 0x50, 0xf6, 0xe3, 0x08, 0xcd,
+    0xca, 0x22, 0x4a, 0xf4, 0x49, 0x9b, 0x59, 0x29, 0x1d, 0xf6, 0x30, 0x22, 0xd2, 0xea, 0x7e, 0xc0,
+    0x89, 0x5f, 0xae, 0x18, 0x2c, 0x3d, 0x60, 0xae, 0x57, 0xd2, 0xa6, 0xc0, 0xfd, 0xca, 0x08, 0x97,
+    0xac, 0x6a, 0xc0, 0x28, 0x8b, 0xc6, 0x6c, 0xc1, 0x97, 0xc2, 0x7f, 0x34, 0x76, 0x0b, 0x00, 0x52,
+    0xfb, 0x3c, 0x79, 0xf3, 0x12, 0x14, 0x2b, 0xa4, 0x3f, 0xc4, 0x1a, 0x31, 0x4b, 0x64, 0x84, 0x0d,
+    0xd1, 0x61, 0x43, 0x1a, 0x6c, 0x20, 0x66, 0x54, 0x46, 0x2e, 0x07, 0xa7, 0xeb, 0x7b, 0x71, 0x63,
+    0xad, 0xd3, 0xdc, 0xe9, 0x7c, 0xfc, 0xda, 0x6b, 0xb5, 0x7b, 0x9f, 0xb6, 0x3a, 0xeb, 0x9f, 0xbb,
+    0x47, 0x47, 0xf6, 0x38, 0xba, 0xbb, 0x07, 0xc3, 0x83, 0xb0, 0xc5, 0x25, 0x24, 0x2b, 0x81, 0xd9,
+    0x43, 0xe3, 0x14, 0x85, 0x56, 0x15, 0x55, 0x50, 0x8d, 0x48, 0x32, 0x18, 0xd6, 0x2c, 0xbb, 0xbe,
+    0x25, 0x90, 0x84, 0xde, 0x52, 0xa8, 0x95, 0x5d, 0xa3, 0xc5, 0xbb, 0x58, 0x1d, 0x0e, 0x84, 0xfc,
+    0xf5, 0x82, 0x02, 0xac, 0x0b, 0x1f, 0x13, 0x1c, 0x7c, 0x42, 0xd7, 0xb4, 0xf5, 0x53, 0x51, 0xe2,
+    0xad, 0x97, 0x25, 0xf2, 0xff, 0xee, 0x5e, 0x16, 0x25, 0x31, 0xa6, 0x37, 0x79, 0x2e, 0xfa, 0x5a,
+    0x29, 0x6b, 0x18, 0x06, 0x30, 0x63, 0x9f, 0x44, 0xad, 0x68, 0x17, 0x6f, 0xe9, 0x86, 0xd6, 0x7b,
+    0x06, 0x4e, 0x72, 0x02, 0xa1, 0x17, 0x8a, 0xb2, 0xe2, 0xb2, 0x98, 0xfc, 0x55, 0xaa, 0x4c, 0x95,
+    0x34, 0x15, 0xcc, 0x55, 0x5d, 0x06, 0x57, 0x81, 0xcd, 0x8b, 0x70, 0x38, 0x83, 0xfd, 0x87, 0x88,
+    0xcf, 0xab, 0x68, 0xf8, 0x18, 0x2a, 0x59, 0xa2, 0x28, 0x94, 0x20, 0xc1, 0xa5, 0x78, 0x9a, 0xd2,
+    0x61, 0x77, 0x6f, 0xa6, 0x08, 0x77, 0x34, 0xc1, 0x48, 0x86, 0x65, 0xa6, 0xd9, 0x1e, 0xfa, 0xed,
+    0x8c, 0xec, 0x12, 0x13, 0x2b, 0x57, 0xdd, 0xe4, 0x56, 0x7f, 0x01, 0x34, 0x67, 0xea, 0x19, 0x10,
+    0x04, 0x00, 0x00,
+};
+
+static const WebAsset web_assets[] = {
+    { "/", "text/html; charset=utf-8", "no-cache", "\"82048c29989a8992\"", asset_index, sizeof(asset_index) },
+    { "/ui/app.css", "text/css; charset=utf-8", "public, max-age=31536000, immutable", "\"5a13d3df281df2d3\"", asset_ui_app_css, sizeof(asset_ui_app_css) },
+    { "/ui/app.js", "application/javascript; charset=utf-8", "public, max-age=31536000, immutable", "\"b94ea6813e206663\"", asset_ui_app_js, sizeof(asset_ui_app_js) },
+};
+
+const WebAsset *webAssetFind(const char *path) {
+    for (size_t i = 0; i < webAssetCount(); i++) {
+        if (strcmp(web_assets[i].path, path) == 0) return &web_assets[i];
+    }
+    return NULL;
+}
+
+size_t webAssetCount() {
+    return sizeof(web_assets) / sizeof(web_assets[0]);
+}
+
+const WebAsset *webAssetAt(size_t index) {
+    return index < webAssetCount() ? &web_assets[index] : NULL;
+}
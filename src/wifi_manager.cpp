@@ -0,0 +1,277 @@
+/**
+ * WiFi 连接管理实现
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_wifi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include "wifi_manager.h"
+#include "task_config.h"
+#include "metrics.h"
+#include "sys_monitor.h"
+#include "boot.h"
+#include "events.h"
+#include "hal.h"
+
+#define WIFI_EVENT_GOT_IP        BIT0
+#define WIFI_EVENT_DISCONNECTED  BIT1
+
+#define WIFI_NVS_NAMESPACE       "wifi"
+#define WIFI_NVS_KEY             "cache"
+#define WIFI_CACHE_VERSION       1
+
+// 保存在 NVS 中的连接参数
+struct WifiCache {
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+    uint32_t ssid_hash;     // SSID 变化后缓存自动失效
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+static const char *wifi_ssid = NULL;
+static const char *wifi_password = NULL;
+static WifiCache wifi_cache;
+static bool wifi_cache_valid = false;
+static EventGroupHandle_t wifi_events = NULL;
+static volatile WifiState wifi_state = WIFI_STATE_IDLE;
+static volatile uint8_t wifi_last_reason = 0;
+static volatile uint8_t wifi_listen_interval = 0;
+
+// ==================== NVS 缓存 ====================
+
+static uint32_t hashSsid(const char *s) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    while (*s) {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static void loadCache() {
+    Preferences prefs;
+    wifi_cache_valid = false;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, true)) return;
+    if (prefs.getBytesLength(WIFI_NVS_KEY) == sizeof(wifi_cache) &&
+        prefs.getBytes(WIFI_NVS_KEY, &wifi_cache, sizeof(wifi_cache)) == sizeof(wifi_cache)) {
+        wifi_cache_valid = wifi_cache.version == WIFI_CACHE_VERSION &&
+                           wifi_cache.ssid_hash == hashSsid(wifi_ssid) &&
+                           wifi_cache.channel != 0;
+    }
+    prefs.end();
+}
+
+// 连接成功后记录当前参数，与已保存的内容相同时不写 flash
+static void saveCache() {
+    WifiCache fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    fresh.version = WIFI_CACHE_VERSION;
+    fresh.channel = (uint8_t)WiFi.channel();
+    memcpy(fresh.bssid, WiFi.BSSID(), sizeof(fresh.bssid));
+    fresh.ssid_hash = hashSsid(wifi_ssid);
+    fresh.ip = (uint32_t)WiFi.localIP();
+    fresh.gateway = (uint32_t)WiFi.gatewayIP();
+    fresh.subnet = (uint32_t)WiFi.subnetMask();
+    fresh.dns = (uint32_t)WiFi.dnsIP(0);
+
+    if (wifi_cache_valid && memcmp(&fresh, &wifi_cache, sizeof(fresh)) == 0) return;
+
+    Preferences prefs;
+    if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        prefs.putBytes(WIFI_NVS_KEY, &fresh, sizeof(fresh));
+        prefs.end();
+    }
+    wifi_cache = fresh;
+    wifi_cache_valid = true;
+}
+
+void wifiManagerForgetCache() {
+    Preferences prefs;
+    if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+        prefs.remove(WIFI_NVS_KEY);
+        prefs.end();
+    }
+    wifi_cache_valid = false;
+}
+
+// ==================== 连接 ====================
+
+static void onWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+        xEventGroupSetBits(wifi_events, WIFI_EVENT_GOT_IP);
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+        metric_wifi_disconnects.inc();
+        wifi_last_reason = info.wifi_sta_disconnected.reason;
+        xEventGroupSetBits(wifi_events, WIFI_EVENT_DISCONNECTED);
+    }
+}
+
+static void applyIpConfig(bool fast) {
+#ifdef WIFI_STATIC_IP
+    IPAddress ip, gateway, subnet, dns;
+    ip.fromString(WIFI_STATIC_IP);
+    gateway.fromString(WIFI_STATIC_GATEWAY);
+    subnet.fromString(WIFI_STATIC_SUBNET);
+    dns.fromString(WIFI_STATIC_DNS);
+    WiFi.config(ip, gateway, subnet, dns);
+#else
+    if (fast && WIFI_CACHE_DHCP_LEASE && wifi_cache.ip != 0) {
+        WiFi.config(IPAddress(wifi_cache.ip), IPAddress(wifi_cache.gateway),
+                    IPAddress(wifi_cache.subnet), IPAddress(wifi_cache.dns));
+    } else {
+        // 全 0 表示重新启用 DHCP
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+#endif
+}
+
+static void startAttempt(bool fast) {
+    metric_wifi_connect_attempts.inc();
+    xEventGroupClearBits(wifi_events, WIFI_EVENT_GOT_IP | WIFI_EVENT_DISCONNECTED);
+    applyIpConfig(fast);
+    wifi_state = WIFI_STATE_CONNECTING;
+
+    if (fast) {
+        halLog("📶 快速连接: 信道 %u, BSSID %02X:%02X:%02X:%02X:%02X:%02X\n",
+               wifi_cache.channel, wifi_cache.bssid[0], wifi_cache.bssid[1], wifi_cache.bssid[2],
+               wifi_cache.bssid[3], wifi_cache.bssid[4], wifi_cache.bssid[5]);
+        WiFi.begin(wifi_ssid, wifi_password, wifi_cache.channel, wifi_cache.bssid, false);
+    } else {
+        halLog("📶 扫描连接: %s\n", wifi_ssid);
+        WiFi.begin(wifi_ssid, wifi_password, 0, NULL, false);
+    }
+
+    // WiFi.begin() 每次重写 STA 配置并把 listen_interval 清零，先写回再发起关联
+    if (wifi_listen_interval > 0) {
+        wifi_config_t conf;
+        if (esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK) {
+            conf.sta.listen_interval = wifi_listen_interval;
+            esp_wifi_set_config(WIFI_IF_STA, &conf);
+        }
+    }
+    esp_wifi_connect();
+}
+
+// 等待本次尝试的结果：获得 IP 返回 true，断开或超时返回 false
+static bool waitAttempt(bool fast) {
+    uint32_t timeout_ms = fast ? WIFI_FAST_CONNECT_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS;
+    EventBits_t bits = xEventGroupWaitBits(wifi_events, WIFI_EVENT_GOT_IP | WIFI_EVENT_DISCONNECTED,
+                                           pdTRUE, pdFALSE, pdMS_TO_TICKS(timeout_ms));
+    if (bits & WIFI_EVENT_GOT_IP) return true;
+    if (bits & WIFI_EVENT_DISCONNECTED) {
+        halLog("⚠️ WiFi 连接失败 (reason %u)\n", wifi_last_reason);
+    } else {
+        halLog("⚠️ WiFi 连接超时 (%u ms)\n", timeout_ms);
+        WiFi.disconnect(false, false);
+    }
+    return false;
+}
+
+// ==================== 状态机任务 ====================
+
+static void wifiManagerTask(void *parameter) {
+    bool booting = true;
+    int64_t down_since_us = 0;
+    uint32_t backoff_ms = WIFI_BACKOFF_MIN_MS;
+
+    while (1) {
+        // 一轮连接：有缓存先走快速路径，失败立即回退到扫描
+        bool connected = false;
+        WifiConnectPath path = WIFI_PATH_SCAN;
+        if (wifi_cache_valid) {
+            startAttempt(true);
+            if (waitAttempt(true)) {
+                connected = true;
+                path = WIFI_PATH_FAST;
+            } else {
+                metric_wifi_fast_connect_fallbacks.inc();
+                wifiManagerForgetCache();
+            }
+        }
+        if (!connected) {
+            startAttempt(false);
+            connected = waitAttempt(false);
+        }
+
+        if (!connected) {
+            wifi_state = WIFI_STATE_BACKOFF;
+            halLog("⏳ %u ms 后重试 WiFi\n", backoff_ms);
+            halDelayMs(backoff_ms);
+            backoff_ms = backoff_ms * 2 > WIFI_BACKOFF_MAX_MS ? WIFI_BACKOFF_MAX_MS : backoff_ms * 2;
+            continue;
+        }
+
+        // 已连接
+        uint32_t elapsed_ms = (uint32_t)((halNowUs() - down_since_us) / 1000);
+        if (booting) {
+            metric_wifi_boot_connect_ms.set(elapsed_ms);
+            bootMark(BOOT_PHASE_WIFI_CONNECTED);
+            booting = false;
+        } else {
+            metric_wifi_reconnect_ms.observe(elapsed_ms);
+        }
+        metric_wifi_connects[path].inc();
+        backoff_ms = WIFI_BACKOFF_MIN_MS;
+        wifi_state = WIFI_STATE_CONNECTED;
+        saveCache();
+        halLog("✅ WiFi 已连接 (%s, %u ms), IP: %s\n", metricsWifiPathName(path),
+               elapsed_ms, WiFi.localIP().toString().c_str());
+        eventPublish(EVENT_WIFI, halNowUs(), 1, elapsed_ms);
+
+        // 等待断开事件，然后立即重连
+        xEventGroupWaitBits(wifi_events, WIFI_EVENT_DISCONNECTED, pdTRUE, pdFALSE, portMAX_DELAY);
+        down_since_us = halNowUs();
+        // 断开期间推送不出去，留在事件环中，主机重连后按 Last-Event-ID 补取
+        eventPublish(EVENT_WIFI, down_since_us, 0, wifi_last_reason);
+        halLog("⚠️ WiFi 断开 (reason %u)，开始重连\n", wifi_last_reason);
+    }
+}
+
+// ==================== 公共接口 ====================
+
+void wifiManagerBegin(const char *ssid, const char *password) {
+    wifi_ssid = ssid;
+    wifi_password = password;
+    wifi_events = xEventGroupCreate();
+
+    // 重连由状态机负责；不把 SSID / 密码写入 WiFi 驱动自己的 flash 配置
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+
+    loadCache();
+    halLog("连接到 WiFi: %s (%s)\n", ssid, wifi_cache_valid ? "有缓存" : "无缓存");
+
+    void *handle = NULL;
+    if (!halTaskCreate(wifiManagerTask, "WiFiManager", TASK_WIFI_STACK, NULL,
+                       TASK_WIFI_PRIORITY, TASK_WIFI_CORE, &handle)) {
+        halLog("❌ WiFi 管理任务创建失败!\n");
+    } else {
+        sysMonitorWatchTask(handle, "WiFiManager", TASK_WIFI_STACK);
+    }
+}
+
+bool wifiManagerWaitConnected(uint32_t timeout_ms) {
+    uint32_t start = halMillis();
+    while (wifi_state != WIFI_STATE_CONNECTED) {
+        if (halMillis() - start >= timeout_ms) return false;
+        halDelayMs(20);
+    }
+    return true;
+}
+
+WifiState wifiManagerState() {
+    return wifi_state;
+}
+
+void wifiManagerSetListenInterval(uint8_t interval) {
+    wifi_listen_interval = interval;
+}
@@ -0,0 +1,245 @@
+/**
+ * 扁平对象编码器实现
+ */
+
+#include "wire_writer.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+// ==================== 格式选择 ====================
+
+// 不区分大小写的子串查找 (Accept 头很短，逐字节比较即可)
+static bool containsToken(const char *haystack, const char *token) {
+    size_t n = strlen(token);
+    for (const char *p = haystack; *p; p++) {
+        size_t i = 0;
+        while (i < n && p[i] && tolower((unsigned char)p[i]) == token[i]) i++;
+        if (i == n) return true;
+    }
+    return false;
+}
+
+WireFormat wireFormatFromAccept(const char *accept) {
+    if (!accept) return WIRE_JSON;
+    if (containsToken(accept, "application/cbor")) return WIRE_CBOR;
+    if (containsToken(accept, "msgpack")) return WIRE_MSGPACK;     // application/msgpack, application/x-msgpack
+    return WIRE_JSON;
+}
+
+WireFormat wireFormatByName(const char *name, WireFormat fallback) {
+    if (strcmp(name, "json") == 0) return WIRE_JSON;
+    if (strcmp(name, "cbor") == 0) return WIRE_CBOR;
+    if (strcmp(name, "msgpack") == 0) return WIRE_MSGPACK;
+    return fallback;
+}
+
+const char *wireContentType(WireFormat format) {
+    switch (format) {
+        case WIRE_CBOR:    return "application/cbor";
+        case WIRE_MSGPACK: return "application/msgpack";
+        default:           return "application/json; charset=utf-8";
+    }
+}
+
+// ==================== 底层写入 ====================
+
+void WireWriter::put(uint8_t byte) {
+    if (len_ < cap_) {
+        buf_[len_++] = byte;
+    } else {
+        ok_ = false;
+    }
+}
+
+void WireWriter::putBytes(const void *data, size_t len) {
+    if (len > cap_ - len_) {
+        ok_ = false;
+        len_ = cap_;
+        return;
+    }
+    memcpy(buf_ + len_, data, len);
+    len_ += len;
+}
+
+void WireWriter::putBigEndian(uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        put((uint8_t)(value >> (i * 8)));
+    }
+}
+
+// CBOR 头部：3 位主类型 + 按大小选择的参数长度
+void WireWriter::cborHead(uint8_t major, uint64_t value) {
+    major <<= 5;
+    if (value < 24) {
+        put(major | (uint8_t)value);
+    } else if (value <= 0xFF) {
+        put(major | 24);
+        put((uint8_t)value);
+    } else if (value <= 0xFFFF) {
+        put(major | 25);
+        putBigEndian(value, 2);
+    } else if (value <= 0xFFFFFFFFULL) {
+        put(major | 26);
+        putBigEndian(value, 4);
+    } else {
+        put(major | 27);
+        putBigEndian(value, 8);
+    }
+}
+
+void WireWriter::string(const char *s) {
+    size_t n = strlen(s);
+    switch (format_) {
+        case WIRE_CBOR:
+            cborHead(3, n);
+            putBytes(s, n);
+            break;
+        case WIRE_MSGPACK:
+            if (n < 32) {
+                put(0xA0 | (uint8_t)n);
+            } else if (n <= 0xFF) {
+                put(0xD9);
+                put((uint8_t)n);
+            } else {
+                put(0xDA);
+                putBigEndian(n, 2);
+            }
+            putBytes(s, n);
+            break;
+        default:
+            put('"');
+            for (const char *p = s; *p; p++) {
+                unsigned char c = (unsigned char)*p;
+                if (c == '"' || c == '\\') {
+                    put('\\');
+                    put(c);
+                } else if (c < 0x20) {
+                    char esc[7];
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    putBytes(esc, 6);
+                } else {
+                    put(c);
+                }
+            }
+            put('"');
+            break;
+    }
+}
+
+void WireWriter::key(const char *name) {
+    if (format_ == WIRE_JSON && written_ > 0) put(',');
+    written_++;
+    string(name);
+    if (format_ == WIRE_JSON) put(':');
+}
+
+// ==================== 对象与字段 ====================
+
+void WireWriter::beginObject(uint8_t fields) {
+    declared_ = fields;
+    written_ = 0;
+    switch (format_) {
+        case WIRE_CBOR:
+            cborHead(5, fields);
+            break;
+        case WIRE_MSGPACK:
+            if (fields < 16) {
+                put(0x80 | fields);
+            } else {
+                put(0xDE);
+                putBigEndian(fields, 2);
+            }
+            break;
+        default:
+            put('{');
+            break;
+    }
+}
+
+void WireWriter::endObject() {
+    if (format_ == WIRE_JSON) put('}');
+    if (written_ != declared_) ok_ = false;
+}
+
+void WireWriter::fieldStr(const char *name, const char *value) {
+    key(name);
+    string(value ? value : "");
+}
+
+void WireWriter::fieldBool(const char *name, bool value) {
+    key(name);
+    switch (format_) {
+        case WIRE_CBOR:    put(value ? 0xF5 : 0xF4); break;
+        case WIRE_MSGPACK: put(value ? 0xC3 : 0xC2); break;
+        default:           putBytes(value ? "true" : "false", value ? 4 : 5); break;
+    }
+}
+
+void WireWriter::fieldUint(const char *name, uint64_t value) {
+    key(name);
+    switch (format_) {
+        case WIRE_CBOR:
+            cborHead(0, value);
+            break;
+        case WIRE_MSGPACK:
+            if (value < 128) {
+                put((uint8_t)value);
+            } else if (value <= 0xFF) {
+                put(0xCC);
+                put((uint8_t)value);
+            } else if (value <= 0xFFFF) {
+                put(0xCD);
+                putBigEndian(value, 2);
+            } else if (value <= 0xFFFFFFFFULL) {
+                put(0xCE);
+                putBigEndian(value, 4);
+            } else {
+                put(0xCF);
+                putBigEndian(value, 8);
+            }
+            break;
+        default: {
+            char num[24];
+            int n = snprintf(num, sizeof(num), "%llu", (unsigned long long)value);
+            putBytes(num, (size_t)n);
+            break;
+        }
+    }
+}
+
+void WireWriter::fieldInt(const char *name, int64_t value) {
+    if (value >= 0) {
+        fieldUint(name, (uint64_t)value);
+        return;
+    }
+    key(name);
+    switch (format_) {
+        case WIRE_CBOR:
+            cborHead(1, (uint64_t)(-1 - value));
+            break;
+        case WIRE_MSGPACK:
+            if (value >= -32) {
+                put((uint8_t)(int8_t)value);            // negative fixint
+            } else if (value >= INT8_MIN) {
+                put(0xD0);
+                put((uint8_t)(int8_t)value);
+            } else if (value >= INT16_MIN) {
+                put(0xD1);
+                putBigEndian((uint16_t)(int16_t)value, 2);
+            } else if (value >= INT32_MIN) {
+                put(0xD2);
+                putBigEndian((uint32_t)(int32_t)value, 4);
+            } else {
+                put(0xD3);
+                putBigEndian((uint64_t)value, 8);
+            }
+            break;
+        default: {
+            char num[24];
+            int n = snprintf(num, sizeof(num), "%lld", (long long)value);
+            putBytes(num, (size_t)n);
+            break;
+        }
+    }
+}
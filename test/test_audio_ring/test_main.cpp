@@ -0,0 +1,303 @@
+/**
+ * 音频采集环与 /audio?from= 批量读取
+ *
+ *   pio test -e native -f test_audio_ring
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "audio_ring.h"
+#include "pipeline.h"
+#include "http_routes.h"
+#include "mem_pool.h"
+#include "metrics.h"
+#include "hal.h"
+#include "hal/native/hal_native.h"
+
+#define TEST_PORT       18931
+#define TEST_RATE       16000
+#define TEST_RING       4000
+
+static int16_t ring_storage[TEST_RING];
+
+// 样本值即序号 (低 15 位)，读者据此检查读到的是不是对应位置的样本
+static int16_t sampleAt(uint64_t index) {
+    return (int16_t)(index & 0x7FFF);
+}
+
+static void produce(AudioRing &ring, uint64_t from, uint32_t count, uint32_t block) {
+    static int16_t buf[TEST_RING];      // 同一时刻只有一个生产者
+    TEST_ASSERT_TRUE(block <= TEST_RING);
+    int64_t t = 1000000;
+    for (uint64_t i = from; i < from + count; i += block) {
+        uint32_t n = from + count - i < block ? (uint32_t)(from + count - i) : block;
+        for (uint32_t k = 0; k < n; k++) buf[k] = sampleAt(i + k);
+        t += (int64_t)n * 1000000 / TEST_RATE;
+        ring.write(buf, n, t);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ==================== AudioRing ====================
+
+void test_read_across_wrap(void) {
+    static int16_t storage[16];
+    AudioRing ring;
+    ring.begin(storage, 16, 0, TEST_RATE);
+    produce(ring, 0, 10, 10);
+    produce(ring, 10, 10, 10);      // 第二块跨过环尾
+
+    TEST_ASSERT_EQUAL_UINT64(20, ring.head());
+    TEST_ASSERT_EQUAL_UINT64(4, ring.tail());
+
+    int16_t out[16];
+    uint64_t cursor = 4;
+    uint64_t dropped = 0;
+    TEST_ASSERT_EQUAL_UINT32(16, ring.read(&cursor, out, 16, &dropped));
+    TEST_ASSERT_EQUAL_UINT64(20, cursor);
+    TEST_ASSERT_EQUAL_UINT64(0, dropped);
+    for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_INT(sampleAt(4 + i), out[i]);
+
+    TEST_ASSERT_EQUAL_UINT32(0, ring.read(&cursor, out, 16, &dropped));
+}
+
+void test_lagging_reader_skips_to_tail(void) {
+    static int16_t storage[16];
+    AudioRing ring;
+    ring.begin(storage, 16, 4, TEST_RATE);     // guard 4：可读窗口 12
+    produce(ring, 0, 40, 8);
+
+    int16_t out[16];
+    uint64_t cursor = 3;
+    uint64_t dropped = 0;
+    uint32_t n = ring.read(&cursor, out, 16, &dropped);
+    TEST_ASSERT_EQUAL_UINT64(40 - 12 - 3, dropped);
+    TEST_ASSERT_EQUAL_UINT32(12, n);
+    TEST_ASSERT_EQUAL_INT(sampleAt(28), out[0]);
+    TEST_ASSERT_EQUAL_UINT64(40, cursor);
+}
+
+void test_sample_time_anchor(void) {
+    static int16_t storage[64];
+    AudioRing ring;
+    ring.begin(storage, 64, 0, TEST_RATE);
+    TEST_ASSERT_EQUAL_INT64(-1, ring.sampleTimeUs(0));
+
+    int16_t block[32] = { 0 };
+    ring.write(block, 32, 2000000);
+    // 最后一个样本的时刻为 end_us，之前的样本按采样率往前推算
+    TEST_ASSERT_EQUAL_INT64(2000000, ring.sampleTimeUs(31));
+    TEST_ASSERT_EQUAL_INT64(2000000 - 16 * 1000000LL / TEST_RATE, ring.sampleTimeUs(15));
+}
+
+// 生产者不停写入时，读者读到的每个样本都必须与序号对应，head 不回退
+void test_concurrent_reads_are_consistent(void) {
+    static int16_t storage[1024];
+    static AudioRing ring;
+    ring.begin(storage, 1024, 256, TEST_RATE);
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> bad{0};
+
+    std::thread producer([&] {
+        produce(ring, 0, 2000000, 37);
+        done.store(true);
+    });
+    std::thread readers[2];
+    for (auto &t : readers) {
+        t = std::thread([&] {
+            int16_t out[200];
+            uint64_t cursor = 0;
+            uint64_t last_head = 0;
+            while (!done.load()) {
+                uint64_t h = ring.head();
+                if (h < last_head) bad++;
+                last_head = h;
+                uint32_t n = ring.read(&cursor, out, 200, NULL);
+                for (uint32_t i = 0; i < n; i++) {
+                    if (out[i] != sampleAt(cursor - n + i)) bad++;
+                }
+            }
+        });
+    }
+    producer.join();
+    for (auto &t : readers) t.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad.load());
+    TEST_ASSERT_EQUAL_UINT64(2000000, ring.head());
+}
+
+// ==================== /audio?from= ====================
+
+struct Response {
+    int status;
+    std::string headers;
+    std::string body;       // 已去掉 chunked 封装
+};
+
+static void startServer() {
+    static bool started = false;
+    if (started) return;
+    HalNativeConfig cfg = {};      // 不启动摄像头，不需要 JPEG
+    cfg.fps = 10;
+    cfg.storage_dir = ".native_fs";
+    halNativeConfigure(cfg);
+    memBegin();
+    halMicBegin(TEST_RATE, 512);
+    TEST_ASSERT_TRUE(routesBegin(TEST_PORT, "127.0.0.1"));
+    started = true;
+}
+
+static std::string dechunk(const std::string &raw) {
+    std::string out;
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        size_t line_end = raw.find("\r\n", pos);
+        if (line_end == std::string::npos) break;
+        size_t n = strtoul(raw.c_str() + pos, NULL, 16);
+        if (n == 0) break;
+        out.append(raw, line_end + 2, n);
+        pos = line_end + 2 + n + 2;
+    }
+    return out;
+}
+
+// HTTP 任务是串行的：先把请求写进 socket，再在当前线程处理一次
+static int request(const char *path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(TEST_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    char req[256];
+    int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: test\r\n\r\n", path);
+    TEST_ASSERT_EQUAL_INT(len, (int)send(fd, req, len, 0));
+    server.handleClient(1000);
+    return fd;
+}
+
+// 读完整个响应 (对端关闭为止)
+static Response readResponse(int fd) {
+    struct timeval tv = {5, 0};     // 流没有结束时不会一直挂住
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::string raw;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) raw.append(buf, n);
+    close(fd);
+
+    Response r;
+    size_t head_end = raw.find("\r\n\r\n");
+    TEST_ASSERT_TRUE(head_end != std::string::npos);
+    r.status = atoi(raw.c_str() + 9);
+    r.headers = raw.substr(0, head_end + 2);
+    r.body = raw.substr(head_end + 4);
+    if (r.headers.find("Transfer-Encoding: chunked") != std::string::npos) r.body = dechunk(r.body);
+    return r;
+}
+
+static Response get(const char *path) {
+    return readResponse(request(path));
+}
+
+static long long header(const Response &r, const char *name) {
+    std::string key = std::string("\r\n") + name + ": ";
+    size_t pos = r.headers.find(key);
+    if (pos == std::string::npos) return -1;
+    return strtoll(r.headers.c_str() + pos + key.size(), NULL, 10);
+}
+
+static void resetRing(uint32_t samples) {
+    startServer();
+    audio_ring.begin(ring_storage, TEST_RING, 0, TEST_RATE);
+    produce(audio_ring, 0, samples, 500);
+}
+
+void test_fetch_ahead_of_head_is_416(void) {
+    resetRing(1000);
+    Response r = get("/audio?from=1500");
+    TEST_ASSERT_EQUAL_INT(416, r.status);
+    TEST_ASSERT_EQUAL_INT64(1000, header(r, "X-Ring-Head"));
+}
+
+void test_fetch_contiguous_batch(void) {
+    resetRing(10000);
+    Response r = get("/audio?from=7000&max_ms=100");
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_INT64(0, header(r, "X-Gap-Samples"));
+    TEST_ASSERT_EQUAL_INT64(7000, header(r, "X-Sample-Index"));
+    TEST_ASSERT_EQUAL_size_t(1600 * sizeof(int16_t), r.body.size());
+    const int16_t *s = (const int16_t *)r.body.data();
+    for (int i = 0; i < 1600; i++) TEST_ASSERT_EQUAL_INT(sampleAt(7000 + i), s[i]);
+}
+
+void test_fetch_reports_gap_when_overwritten(void) {
+    resetRing(10000);       // 环中只剩 [6000, 10000)
+    Response r = get("/audio?from=1000&max_ms=50");
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_INT64(5000, header(r, "X-Gap-Samples"));
+    TEST_ASSERT_EQUAL_INT64(6000, header(r, "X-Sample-Index"));
+    TEST_ASSERT_EQUAL_size_t(800 * sizeof(int16_t), r.body.size());
+    TEST_ASSERT_EQUAL_INT(sampleAt(6000), ((const int16_t *)r.body.data())[0]);
+}
+
+void test_fetch_stops_at_head(void) {
+    resetRing(10000);
+    Response r = get("/audio?from=9900&max_ms=1000");
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_INT64(10000, header(r, "X-Ring-Head"));
+    TEST_ASSERT_EQUAL_size_t(100 * sizeof(int16_t), r.body.size());
+
+    r = get("/audio?from=10000");
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_size_t(0, r.body.size());
+}
+
+// ==================== /audio/stream ====================
+
+void test_stream_ends_at_gap(void) {
+    resetRing(1000);
+    uint64_t gaps_before = metric_audio_stream_gap_samples.value();
+    int fd = request("/audio/stream?latency_ms=10");
+
+    // 连续写满三圈：流任务每次最多读一个发送缓冲区，无论何时读取，都会有未发送的样本被覆盖
+    produce(audio_ring, 1000, 3 * TEST_RING, TEST_RING);
+
+    Response r = readResponse(fd);
+    TEST_ASSERT_EQUAL_INT(200, r.status);
+    TEST_ASSERT_EQUAL_INT64(1000, header(r, "X-Sample-Index"));
+    TEST_ASSERT_TRUE(r.body.size() < 3 * TEST_RING * sizeof(int16_t));
+
+    // 已发送的样本从 X-Sample-Index 起连续，缺口之后的样本不发送
+    const int16_t *s = (const int16_t *)r.body.data();
+    for (size_t i = 0; i < r.body.size() / sizeof(int16_t); i++) TEST_ASSERT_EQUAL_INT(sampleAt(1000 + i), s[i]);
+    TEST_ASSERT_GREATER_THAN(0, (int)(metric_audio_stream_gap_samples.value() - gaps_before));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_across_wrap);
+    RUN_TEST(test_lagging_reader_skips_to_tail);
+    RUN_TEST(test_sample_time_anchor);
+    RUN_TEST(test_concurrent_reads_are_consistent);
+    RUN_TEST(test_fetch_ahead_of_head_is_416);
+    RUN_TEST(test_fetch_contiguous_batch);
+    RUN_TEST(test_fetch_reports_gap_when_overwritten);
+    RUN_TEST(test_fetch_stops_at_head);
+    RUN_TEST(test_stream_ends_at_gap);
+    return UNITY_END();
+}
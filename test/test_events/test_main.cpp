@@ -0,0 +1,162 @@
+/**
+ * 事件环：since 游标、覆盖后的 oldest、并发发布、等待者唤醒与 JSON 格式
+ *
+ *   pio test -e native -f test_events
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "events.h"
+#include "hal.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_empty_ring(void) {
+    Event out[4];
+    uint32_t oldest = 123;
+    TEST_ASSERT_EQUAL_UINT32(0, eventsLastSeq());
+    TEST_ASSERT_EQUAL_INT(0, eventsRead(0, out, 4, &oldest));
+    TEST_ASSERT_EQUAL_UINT32(0, oldest);
+}
+
+void test_cursor_returns_only_newer_events(void) {
+    uint32_t base = eventsLastSeq();
+    const int64_t t = 5000000000LL;          // 超过 32 位，检查两个半字拼回原值
+    eventPublish(EVENT_SCENE, t, 42, 7);
+    eventPublish(EVENT_VAD, t + 1, 1, 12, 3);
+    eventPublish(EVENT_MOTION, t + 2, 0, 900);
+
+    Event out[8];
+    uint32_t oldest;
+    TEST_ASSERT_EQUAL_INT(3, eventsRead(base, out, 8, &oldest));
+    TEST_ASSERT_EQUAL_UINT32(base + 1, out[0].seq);
+    TEST_ASSERT_EQUAL_INT(EVENT_SCENE, out[0].type);
+    TEST_ASSERT_EQUAL_INT64(t, out[0].timestamp_us);
+    TEST_ASSERT_EQUAL_INT(42, out[0].value);
+    TEST_ASSERT_EQUAL_UINT32(7, out[0].ref);
+    TEST_ASSERT_EQUAL_UINT32(3, out[1].segment);
+    TEST_ASSERT_EQUAL_INT64(t + 2, out[2].timestamp_us);
+
+    // 从中间继续，max 限制条数
+    TEST_ASSERT_EQUAL_INT(1, eventsRead(base + 1, out, 1, &oldest));
+    TEST_ASSERT_EQUAL_UINT32(base + 2, out[0].seq);
+    TEST_ASSERT_EQUAL_INT(0, eventsRead(base + 3, out, 8, &oldest));
+    TEST_ASSERT_EQUAL_UINT32(base + 3, eventsLastSeq());
+}
+
+void test_overrun_advances_oldest(void) {
+    uint32_t base = eventsLastSeq();
+    for (int i = 0; i < EVENT_QUEUE_SIZE + 5; i++) {
+        eventPublish(EVENT_LOW_HEAP, 1000 + i, i, 0);
+    }
+    uint32_t last = eventsLastSeq();
+    TEST_ASSERT_EQUAL_UINT32(base + EVENT_QUEUE_SIZE + 5, last);
+
+    Event out[EVENT_QUEUE_SIZE + 8];
+    uint32_t oldest;
+    int n = eventsRead(base, out, EVENT_QUEUE_SIZE + 8, &oldest);
+    // 只剩最新的一圈；oldest 大于 since + 1 说明中间的事件已被覆盖
+    TEST_ASSERT_EQUAL_UINT32(last - EVENT_QUEUE_SIZE + 1, oldest);
+    TEST_ASSERT_GREATER_THAN(base + 1, oldest);
+    TEST_ASSERT_EQUAL_INT(EVENT_QUEUE_SIZE, n);
+    TEST_ASSERT_EQUAL_UINT32(oldest, out[0].seq);
+    TEST_ASSERT_EQUAL_UINT32(last, out[n - 1].seq);
+    for (int i = 1; i < n; i++) TEST_ASSERT_EQUAL_UINT32(out[i - 1].seq + 1, out[i].seq);
+    TEST_ASSERT_EQUAL_INT(5, out[0].value);
+}
+
+// 多个发布方同时写入时，读者读到的事件序号递增 (被覆盖的会跳过) 且字段属于同一次发布
+void test_concurrent_publish(void) {
+    uint32_t base = eventsLastSeq();
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> bad{0};
+
+    std::thread reader([&] {
+        Event out[EVENT_QUEUE_SIZE];
+        uint32_t cursor = base;
+        uint32_t oldest;
+        while (!done.load()) {
+            int n = eventsRead(cursor, out, EVENT_QUEUE_SIZE, &oldest);
+            for (int i = 0; i < n; i++) {
+                if (out[i].seq <= (i > 0 ? out[i - 1].seq : cursor)) bad++;
+                if (out[i].timestamp_us != ((int64_t)out[i].value << 32 | out[i].ref)) bad++;
+            }
+            if (n) cursor = out[n - 1].seq;
+        }
+    });
+    std::thread publishers[2];
+    for (int p = 0; p < 2; p++) {
+        publishers[p] = std::thread([p] {
+            for (uint32_t i = 0; i < 200000; i++) {
+                int32_t value = p + 1;
+                eventPublish(EVENT_SCENE, (int64_t)value << 32 | i, value, i);
+            }
+        });
+    }
+    for (auto &t : publishers) t.join();
+    done.store(true);
+    reader.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad.load());
+    TEST_ASSERT_EQUAL_UINT32(base + 400000, eventsLastSeq());
+}
+
+// 注册的信号量在每条事件写完后被 give，阻塞的读者立即醒来并读到这条事件；注销后不再唤醒
+void test_waiter_woken_on_publish(void) {
+    HalSemaphore sem = halSemaphoreCreate();
+    TEST_ASSERT_TRUE(eventsAddWaiter(sem));
+    uint32_t base = eventsLastSeq();
+    int64_t woken_after_us = -1;
+    Event seen = {};
+
+    std::thread reader([&] {
+        int64_t start = halNowUs();
+        if (!halSemaphoreTake(sem, 2000)) return;
+        woken_after_us = halNowUs() - start;
+        uint32_t oldest;
+        eventsRead(base, &seen, 1, &oldest);
+    });
+    halDelayMs(20);
+    eventPublish(EVENT_MOTION, 7, 1, 50);
+    reader.join();
+    TEST_ASSERT_TRUE(woken_after_us >= 0);
+    TEST_ASSERT_LESS_THAN(200000, (int)woken_after_us);
+    TEST_ASSERT_EQUAL_UINT32(base + 1, seen.seq);
+    TEST_ASSERT_EQUAL_INT(EVENT_MOTION, seen.type);
+
+    eventsRemoveWaiter(sem);
+    eventPublish(EVENT_MOTION, 8, 0, 10);
+    TEST_ASSERT_FALSE(halSemaphoreTake(sem, 0));
+}
+
+void test_format_json(void) {
+    char buf[160];
+    Event e = { 9, EVENT_VAD, 5000000000LL, 1, 12, 3 };
+    int n = eventFormatJson(e, buf, sizeof(buf));
+    const char expected[] =
+        "{\"seq\":9,\"type\":\"vad\",\"capture_us\":5000000000,\"active\":true,\"level_db\":12,\"segment\":3}";
+    TEST_ASSERT_EQUAL_INT((int)strlen(expected), n);
+    TEST_ASSERT_EQUAL_STRING(expected, buf);
+
+    Event end = { 10, EVENT_MOTION, 1, 0, 900, 0 };
+    eventFormatJson(end, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"seq\":10,\"type\":\"motion\",\"capture_us\":1,\"active\":false,\"duration_ms\":900}", buf);
+
+    // 缓冲区不够时返回值不小于容量 (同 snprintf)，调用方据此判断截断
+    char small[16];
+    TEST_ASSERT_GREATER_THAN((int)sizeof(small) - 1, eventFormatJson(e, small, sizeof(small)));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_ring);
+    RUN_TEST(test_cursor_returns_only_newer_events);
+    RUN_TEST(test_overrun_advances_oldest);
+    RUN_TEST(test_concurrent_publish);
+    RUN_TEST(test_waiter_woken_on_publish);
+    RUN_TEST(test_format_json);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+/**
+ * HttpStreamWriter：chunked 封装、合并缓冲与发送次数 (socketpair 的另一端读取实际字节)
+ *
+ *   pio test -e native -f test_http_stream
+ */
+
+#include <unity.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <string>
+#include <thread>
+#include "http_server.h"
+#include "metrics.h"
+
+static int fds[2];
+static std::string received;
+static std::thread reader;
+
+// 另一端在后台读到 EOF，大块写入不会因 socket 缓冲区满而阻塞
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    received.clear();
+    reader = std::thread([] {
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(fds[1], buf, sizeof(buf), 0)) > 0) received.append(buf, n);
+    });
+}
+
+void tearDown(void) {
+    if (fds[0] >= 0) close(fds[0]);
+    if (reader.joinable()) reader.join();
+    close(fds[1]);
+}
+
+// 关闭写端并等读者读完
+static const std::string &drain() {
+    close(fds[0]);
+    fds[0] = -1;
+    reader.join();
+    return received;
+}
+
+static std::string chunk(const std::string &data) {
+    char head[16];
+    snprintf(head, sizeof(head), "%X\r\n", (unsigned)data.size());
+    return head + data + "\r\n";
+}
+
+void test_buffered_chunks_are_framed(void) {
+    uint8_t buf[64];
+    Counter sends;
+    HttpStreamWriter w;
+    w.begin(fds[0], buf, sizeof(buf), true, &sends);
+    std::string big(100, 'x');
+    TEST_ASSERT_TRUE(w.write("hello", 5));
+    TEST_ASSERT_TRUE(w.write(big.data(), big.size()));
+    TEST_ASSERT_TRUE(w.finish());
+    std::string expected = chunk("hello") + chunk(big) + "0\r\n\r\n";
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), drain().c_str());
+    // 两个 chunk 加结束块共 121 字节：64 字节缓冲区满时发送一次，finish() 再发送剩余部分
+    TEST_ASSERT_EQUAL_UINT64(2, sends.value());
+}
+
+void test_reserve_commit_uses_fixed_width_header(void) {
+    uint8_t buf[64];
+    HttpStreamWriter w;
+    w.begin(fds[0], buf, sizeof(buf), true);
+    size_t room;
+    uint8_t *p = w.reserve(&room);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL_size_t(64 - 6 - 2, room);
+    memcpy(p, "abc", 3);
+    TEST_ASSERT_TRUE(w.commit(3));
+    TEST_ASSERT_EQUAL_size_t(6 + 3 + 2, w.buffered());
+
+    p = w.reserve(&room);
+    memcpy(p, "de", 2);
+    TEST_ASSERT_TRUE(w.commit(2));
+    TEST_ASSERT_TRUE(w.finish());
+    TEST_ASSERT_EQUAL_STRING("0003\r\nabc\r\n0002\r\nde\r\n0\r\n\r\n", drain().c_str());
+}
+
+// 不缓冲时每个 chunk (头 + 数据 + CRLF) 一次发送：小块拷贝合并，大块走 iovec
+void test_unbuffered_chunk_is_one_send(void) {
+    Counter sends;
+    HttpStreamWriter w;
+    w.begin(fds[0], NULL, 0, true, &sends);
+    std::string small(10, 's');
+    std::string large(100000, 'L');
+    TEST_ASSERT_TRUE(w.write(small.data(), small.size()));
+    TEST_ASSERT_EQUAL_UINT64(1, sends.value());
+    TEST_ASSERT_TRUE(w.write(large.data(), large.size()));
+    TEST_ASSERT_EQUAL_UINT64(2, sends.value());
+    TEST_ASSERT_TRUE(w.finish());
+    TEST_ASSERT_EQUAL_UINT64(3, sends.value());
+    std::string expected = chunk(small) + chunk(large) + "0\r\n\r\n";
+    TEST_ASSERT_EQUAL_size_t(expected.size(), drain().size());
+    TEST_ASSERT_TRUE(received == expected);
+}
+
+void test_plain_mode_coalesces_and_passes_through(void) {
+    uint8_t buf[16];
+    Counter sends;
+    HttpStreamWriter w;
+    w.begin(fds[0], buf, sizeof(buf), false, &sends);
+    TEST_ASSERT_TRUE(w.write("0123456789", 10));
+    TEST_ASSERT_EQUAL_size_t(10, w.buffered());
+    TEST_ASSERT_EQUAL_UINT64(0, sends.value());
+    std::string large(40, 'z');
+    TEST_ASSERT_TRUE(w.write(large.data(), large.size()));   // 填满缓冲区后，剩余 34 字节直接发送
+    TEST_ASSERT_EQUAL_size_t(0, w.buffered());
+    TEST_ASSERT_EQUAL_UINT64(2, sends.value());
+    TEST_ASSERT_TRUE(w.finish());
+    std::string expected = "0123456789" + large;
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), drain().c_str());
+}
+
+void test_write_after_peer_close_fails(void) {
+    uint8_t buf[16];
+    HttpStreamWriter w;
+    w.begin(fds[0], buf, sizeof(buf), true);
+    shutdown(fds[1], SHUT_RD);
+    std::string data(4096, 'q');
+    bool ok = true;
+    for (int i = 0; i < 64 && ok; i++) ok = w.write(data.data(), data.size());
+    TEST_ASSERT_FALSE(ok);
+    TEST_ASSERT_FALSE(w.ok());
+    TEST_ASSERT_FALSE(w.flush());
+}
+
+int main(int argc, char **argv) {
+    signal(SIGPIPE, SIG_IGN);
+    UNITY_BEGIN();
+    RUN_TEST(test_buffered_chunks_are_framed);
+    RUN_TEST(test_reserve_commit_uses_fixed_width_header);
+    RUN_TEST(test_unbuffered_chunk_is_one_send);
+    RUN_TEST(test_plain_mode_coalesces_and_passes_through);
+    RUN_TEST(test_write_after_peer_close_fails);
+    return UNITY_END();
+}
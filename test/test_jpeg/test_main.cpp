@@ -0,0 +1,294 @@
+/**
+ * JPEG 校验、1/8 缩略图、ROI 裁剪与隐私遮挡 (test/fixtures 下 64x48 的 4:2:2 / 4:2:0 / 灰度图)
+ *
+ * 裁剪和遮挡的结果逐块解出 DC 系数与原图比对：裁剪区域内、遮挡区域外的块必须完全相同
+ *
+ *   pio test -e native -f test_jpeg
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "jpeg_check.h"
+#include "jpeg_crop.h"
+#include "jpeg_entropy.h"
+#include "jpeg_mask.h"
+#include "jpeg_thumb.h"
+
+struct Fixture {
+    const char *name;
+    int mcu_w;
+    int mcu_h;
+    int ncomp;
+};
+
+static const Fixture FIXTURES[] = {
+    { "small_422.jpg", 16, 8, 3 },
+    { "small_420.jpg", 16, 16, 3 },
+    { "small_gray.jpg", 8, 8, 1 },
+};
+
+static JpegRecodeWork work;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// fixtures 目录相对本文件定位，不依赖运行时的当前目录
+static std::vector<uint8_t> load(const char *name) {
+    std::string path = __FILE__;
+    for (int i = 0; i < 2; i++) path.erase(path.find_last_of('/'));
+    path += std::string("/fixtures/") + name;
+    std::vector<uint8_t> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) TEST_FAIL_MESSAGE(path.c_str());
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+// 每个分量的块平面 (含 MCU 补齐)，值为累加差分后的量化 DC 系数
+struct DcBlocks {
+    int ncomp;
+    int h[3];                   // 采样因子
+    int v[3];
+    int width[3];
+    int height[3];
+    std::vector<int> dc[3];
+
+    int at(int c, int x, int y) const { return dc[c][y * width[c] + x]; }
+};
+
+// 只做 Huffman 解码：DC 累加差分，AC 按长度跳过 (测试图片不带重启间隔)
+static DcBlocks decodeDc(const uint8_t *jpeg, size_t len, JpegHeader *hdr) {
+    TEST_ASSERT_TRUE(jpegParseHeader(jpeg, len, hdr, true));
+    TEST_ASSERT_EQUAL_INT(0, hdr->restart_interval);
+    DcBlocks d;
+    d.ncomp = hdr->ncomp;
+    for (int c = 0; c < d.ncomp; c++) {
+        d.h[c] = hdr->comp[c].h;
+        d.v[c] = hdr->comp[c].v;
+        d.width[c] = hdr->mcux * d.h[c];
+        d.height[c] = hdr->mcuy * d.v[c];
+        d.dc[c].assign(d.width[c] * d.height[c], 0);
+    }
+
+    JpegBitReader br;
+    jpegBitReaderBegin(br, jpeg, len, hdr->scan_start);
+    int pred[JPEG_MAX_COMPONENTS] = { 0, 0, 0 };
+    for (int my = 0; my < hdr->mcuy; my++) {
+        for (int mx = 0; mx < hdr->mcux; mx++) {
+            for (int c = 0; c < d.ncomp; c++) {
+                const JpegComponent &comp = hdr->comp[c];
+                for (int b = 0; b < comp.h * comp.v; b++) {
+                    int s = jpegDecodeSymbol(br, hdr->dc[comp.td]);
+                    TEST_ASSERT_TRUE(s >= 0);
+                    if (s) pred[c] += jpegExtend(jpegGetBits(br, s), s);
+                    d.dc[c][(my * comp.v + b / comp.h) * d.width[c] + mx * comp.h + b % comp.h] = pred[c];
+                    for (int k = 1; k < 64;) {
+                        int rs = jpegDecodeSymbol(br, hdr->ac[comp.ta]);
+                        TEST_ASSERT_TRUE(rs >= 0);
+                        if ((rs & 0x0F) == 0) {
+                            if (rs != 0xF0) break;      // EOB
+                            k += 16;
+                            continue;
+                        }
+                        jpegGetBits(br, rs & 0x0F);
+                        k += (rs >> 4) + 1;
+                    }
+                }
+            }
+        }
+    }
+    return d;
+}
+
+// ==================== jpegValidate ====================
+
+void test_validate_fixtures(void) {
+    for (const Fixture &fx : FIXTURES) {
+        std::vector<uint8_t> jpeg = load(fx.name);
+        JpegCheck check = jpegValidate(jpeg.data(), jpeg.size());
+        TEST_ASSERT_EQUAL_INT(JPEG_OK, check.status);
+        TEST_ASSERT_EQUAL_size_t(jpeg.size(), check.len);
+    }
+}
+
+void test_validate_rejects_damage(void) {
+    std::vector<uint8_t> jpeg = load("small_422.jpg");
+
+    // EOI 之后的填充去掉
+    std::vector<uint8_t> padded = jpeg;
+    padded.resize(jpeg.size() + 100, 0);
+    JpegCheck check = jpegValidate(padded.data(), padded.size());
+    TEST_ASSERT_EQUAL_INT(JPEG_OK, check.status);
+    TEST_ASSERT_EQUAL_size_t(jpeg.size(), check.len);
+
+    TEST_ASSERT_EQUAL_INT(JPEG_NO_EOI, jpegValidate(jpeg.data(), jpeg.size() - 10).status);
+
+    std::vector<uint8_t> no_soi = jpeg;
+    no_soi[0] = 0x00;
+    TEST_ASSERT_EQUAL_INT(JPEG_NO_SOI, jpegValidate(no_soi.data(), no_soi.size()).status);
+
+    // 截断在头部段中间
+    TEST_ASSERT_EQUAL_INT(JPEG_BAD_HEADER, jpegValidate(jpeg.data(), 40).status);
+    TEST_ASSERT_EQUAL_INT(JPEG_NO_SOI, jpegValidate(jpeg.data(), 1).status);
+}
+
+// ==================== jpegThumbnail ====================
+
+void test_thumbnail(void) {
+    for (const Fixture &fx : FIXTURES) {
+        std::vector<uint8_t> jpeg = load(fx.name);
+        std::vector<uint8_t> thumb_work(jpegThumbWorkBytes(64, 48));
+        uint8_t out[4096];
+        JpegThumb thumb;
+        TEST_ASSERT_TRUE(jpegThumbnail(jpeg.data(), jpeg.size(), thumb_work.data(), thumb_work.size(),
+                                       out, sizeof(out), JPEG_THUMB_QUALITY, &thumb));
+        TEST_ASSERT_EQUAL_INT(8, thumb.width);
+        TEST_ASSERT_EQUAL_INT(6, thumb.height);
+        TEST_ASSERT_EQUAL_INT(JPEG_OK, jpegValidate(out, thumb.len).status);
+
+        // 工作区或输出空间不足时失败
+        TEST_ASSERT_FALSE(jpegThumbnail(jpeg.data(), jpeg.size(), thumb_work.data(), 256,
+                                        out, sizeof(out), JPEG_THUMB_QUALITY, &thumb));
+        TEST_ASSERT_FALSE(jpegThumbnail(jpeg.data(), jpeg.size(), thumb_work.data(), thumb_work.size(),
+                                        out, 100, JPEG_THUMB_QUALITY, &thumb));
+    }
+}
+
+// ==================== jpegCrop ====================
+
+void test_crop_matches_source_blocks(void) {
+    for (const Fixture &fx : FIXTURES) {
+        std::vector<uint8_t> jpeg = load(fx.name);
+        JpegHeader src_hdr;
+        DcBlocks src = decodeDc(jpeg.data(), jpeg.size(), &src_hdr);
+        TEST_ASSERT_EQUAL_INT(fx.ncomp, src.ncomp);
+
+        const JpegRect roi = { 19, 9, 20, 20 };
+        uint8_t out[4096];
+        JpegRect aligned;
+        size_t n = jpegCrop(jpeg.data(), jpeg.size(), roi, &work, out, sizeof(out), &aligned);
+        TEST_ASSERT_GREATER_THAN(0, (int)n);
+
+        // 向外对齐到 MCU 且包含 roi
+        TEST_ASSERT_EQUAL_INT(0, aligned.x % fx.mcu_w);
+        TEST_ASSERT_EQUAL_INT(0, aligned.y % fx.mcu_h);
+        TEST_ASSERT_LESS_OR_EQUAL(roi.x, aligned.x);
+        TEST_ASSERT_LESS_OR_EQUAL(roi.y, aligned.y);
+        TEST_ASSERT_LESS_OR_EQUAL(aligned.x + aligned.w, roi.x + roi.w);
+        TEST_ASSERT_LESS_OR_EQUAL(aligned.y + aligned.h, roi.y + roi.h);
+
+        JpegCheck check = jpegValidate(out, n);
+        TEST_ASSERT_EQUAL_INT(JPEG_OK, check.status);
+        TEST_ASSERT_EQUAL_size_t(n, check.len);
+        JpegHeader hdr;
+        DcBlocks crop = decodeDc(out, n, &hdr);
+        TEST_ASSERT_EQUAL_INT(aligned.w, hdr.width);
+        TEST_ASSERT_EQUAL_INT(aligned.h, hdr.height);
+        for (int c = 0; c < fx.ncomp; c++) {
+            int ox = aligned.x / (fx.mcu_w / crop.h[c]);
+            int oy = aligned.y / (fx.mcu_h / crop.v[c]);
+            for (int y = 0; y < crop.height[c]; y++) {
+                for (int x = 0; x < crop.width[c]; x++) {
+                    TEST_ASSERT_EQUAL_INT(src.at(c, ox + x, oy + y), crop.at(c, x, y));
+                }
+            }
+        }
+    }
+}
+
+void test_crop_clips_to_frame(void) {
+    std::vector<uint8_t> jpeg = load("small_420.jpg");
+    uint8_t out[4096];
+    JpegRect aligned;
+    const JpegRect edge = { 50, 40, 100, 100 };
+    TEST_ASSERT_GREATER_THAN(0, (int)jpegCrop(jpeg.data(), jpeg.size(), edge, &work, out, sizeof(out), &aligned));
+    TEST_ASSERT_EQUAL_INT(48, aligned.x);
+    TEST_ASSERT_EQUAL_INT(32, aligned.y);
+    TEST_ASSERT_EQUAL_INT(16, aligned.w);
+    TEST_ASSERT_EQUAL_INT(16, aligned.h);
+
+    const JpegRect outside = { 64, 0, 8, 8 };
+    TEST_ASSERT_EQUAL_size_t(0, jpegCrop(jpeg.data(), jpeg.size(), outside, &work, out, sizeof(out), &aligned));
+    const JpegRect empty = { 0, 0, 0, 8 };
+    TEST_ASSERT_EQUAL_size_t(0, jpegCrop(jpeg.data(), jpeg.size(), empty, &work, out, sizeof(out), &aligned));
+    TEST_ASSERT_EQUAL_size_t(0, jpegCrop(jpeg.data(), jpeg.size(), edge, &work, out, 100, &aligned));
+}
+
+// ==================== jpegMask ====================
+
+void test_mask_blacks_out_only_covered_mcus(void) {
+    for (const Fixture &fx : FIXTURES) {
+        std::vector<uint8_t> jpeg = load(fx.name);
+        JpegHeader src_hdr;
+        DcBlocks src = decodeDc(jpeg.data(), jpeg.size(), &src_hdr);
+
+        const JpegRect rects[2] = { { 3, 2, 10, 4 }, { 40, 30, 30, 30 } };
+        std::vector<uint8_t> out(jpeg.size() + 1024);
+        size_t n = jpegMask(jpeg.data(), jpeg.size(), rects, 2, &work, out.data(), out.size());
+        TEST_ASSERT_GREATER_THAN(0, (int)n);
+        TEST_ASSERT_EQUAL_INT(JPEG_OK, jpegValidate(out.data(), n).status);
+        JpegHeader hdr;
+        DcBlocks masked = decodeDc(out.data(), n, &hdr);
+        TEST_ASSERT_EQUAL_INT(64, hdr.width);
+        TEST_ASSERT_EQUAL_INT(48, hdr.height);
+
+        int covered_blocks = 0;
+        for (int c = 0; c < fx.ncomp; c++) {
+            int q = hdr.qdc[hdr.comp[c].tq];
+            for (int y = 0; y < src.height[c]; y++) {
+                for (int x = 0; x < src.width[c]; x++) {
+                    // 块所在的 MCU 与任一矩形 (向外扩展到 MCU) 重叠即被遮挡
+                    int mx = x / src.h[c];
+                    int my = y / src.v[c];
+                    bool covered = false;
+                    for (const JpegRect &r : rects) {
+                        covered |= mx >= r.x / fx.mcu_w && mx * fx.mcu_w < r.x + r.w &&
+                                   my >= r.y / fx.mcu_h && my * fx.mcu_h < r.y + r.h;
+                    }
+                    if (!covered) {
+                        TEST_ASSERT_EQUAL_INT(src.at(c, x, y), masked.at(c, x, y));
+                    } else if (c == 0) {
+                        // 亮度为黑：反量化后的 DC 在一个量化步长内等于 -128 * 8
+                        TEST_ASSERT_LESS_OR_EQUAL(q / 2, abs(masked.at(c, x, y) * q + 1024));
+                        covered_blocks++;
+                    } else {
+                        TEST_ASSERT_EQUAL_INT(0, masked.at(c, x, y));     // 色度中性
+                    }
+                }
+            }
+        }
+        TEST_ASSERT_GREATER_THAN(0, covered_blocks);
+    }
+}
+
+void test_mask_outside_frame_copies(void) {
+    std::vector<uint8_t> jpeg = load("small_422.jpg");
+    std::vector<uint8_t> out(jpeg.size());
+    const JpegRect outside = { 100, 100, 10, 10 };
+    size_t n = jpegMask(jpeg.data(), jpeg.size(), &outside, 1, &work, out.data(), out.size());
+    TEST_ASSERT_EQUAL_size_t(jpeg.size(), n);
+    TEST_ASSERT_EQUAL_MEMORY(jpeg.data(), out.data(), n);
+
+    const JpegRect rect = { 0, 0, 16, 8 };
+    TEST_ASSERT_EQUAL_size_t(0, jpegMask(jpeg.data(), jpeg.size(), &rect, 1, &work, out.data(), 200));
+    TEST_ASSERT_EQUAL_size_t(0, jpegMask(jpeg.data(), 40, &rect, 1, &work, out.data(), out.size()));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_validate_fixtures);
+    RUN_TEST(test_validate_rejects_damage);
+    RUN_TEST(test_thumbnail);
+    RUN_TEST(test_crop_matches_source_blocks);
+    RUN_TEST(test_crop_clips_to_frame);
+    RUN_TEST(test_mask_blacks_out_only_covered_mcus);
+    RUN_TEST(test_mask_outside_frame_copies);
+    return UNITY_END();
+}
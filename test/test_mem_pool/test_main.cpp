@@ -0,0 +1,147 @@
+/**
+ * MemPool / MemArena：耗尽、归还、复位与统计
+ *
+ *   pio test -e native -f test_mem_pool
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "mem_pool.h"
+
+// 登记表保存的是指针，池和 arena 必须是静态对象
+static MemPool small_pool("test_small", 30, 3, MEM_INTERNAL);
+static MemPool full_pool("test_full", 8, 32, MEM_PSRAM);
+static MemPool idle_pool("test_idle", 16, 2, MEM_INTERNAL);
+static MemArena arena("test_arena", 64, MEM_INTERNAL);
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ==================== MemPool ====================
+
+void test_pool_rounds_block_size(void) {
+    TEST_ASSERT_EQUAL_size_t(32, small_pool.blockSize());
+    TEST_ASSERT_EQUAL_INT(3, small_pool.blocks());
+}
+
+void test_pool_alloc_before_begin_fails(void) {
+    TEST_ASSERT_FALSE(idle_pool.ready());
+    TEST_ASSERT_NULL(idle_pool.alloc());
+    TEST_ASSERT_EQUAL_UINT32(1, idle_pool.failures());
+}
+
+void test_pool_exhaustion_and_free(void) {
+    TEST_ASSERT_TRUE(small_pool.begin());
+    void *a = small_pool.alloc();
+    void *b = small_pool.alloc();
+    void *c = small_pool.alloc();
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_EQUAL_size_t(32, (uint8_t *)b - (uint8_t *)a);
+    TEST_ASSERT_EQUAL_size_t(32, (uint8_t *)c - (uint8_t *)b);
+    TEST_ASSERT_EQUAL_INT(3, small_pool.used());
+
+    TEST_ASSERT_NULL(small_pool.alloc());
+    TEST_ASSERT_EQUAL_UINT32(1, small_pool.failures());
+
+    // 归还中间一块后再借，拿到的正是这一块
+    small_pool.free(b);
+    TEST_ASSERT_EQUAL_INT(2, small_pool.used());
+    TEST_ASSERT_TRUE(small_pool.alloc() == b);
+
+    small_pool.free(a);
+    small_pool.free(b);
+    small_pool.free(c);
+    small_pool.free(NULL);
+    TEST_ASSERT_EQUAL_INT(0, small_pool.used());
+    TEST_ASSERT_EQUAL_INT(3, small_pool.peak());
+    TEST_ASSERT_EQUAL_UINT32(1, small_pool.failures());
+}
+
+void test_pool_all_32_blocks(void) {
+    TEST_ASSERT_TRUE(full_pool.begin());
+    void *blocks[32];
+    for (int i = 0; i < 32; i++) {
+        blocks[i] = full_pool.alloc();
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(32, full_pool.used());
+    TEST_ASSERT_NULL(full_pool.alloc());
+    for (int i = 0; i < 32; i++) full_pool.free(blocks[i]);
+    TEST_ASSERT_EQUAL_INT(0, full_pool.used());
+    TEST_ASSERT_EQUAL_INT(32, full_pool.peak());
+}
+
+// 多个线程同时借还，同一块不会同时借给两个线程
+void test_pool_concurrent_alloc_free(void) {
+    TEST_ASSERT_TRUE(full_pool.begin());
+    std::atomic<uint32_t> bad{0};
+    std::thread workers[4];
+    for (int t = 0; t < 4; t++) {
+        workers[t] = std::thread([&, t] {
+            for (int i = 0; i < 100000; i++) {
+                uint8_t *p = (uint8_t *)full_pool.alloc();
+                if (!p) continue;
+                memset(p, t + 1, 8);
+                for (int k = 0; k < 8; k++) {
+                    if (p[k] != t + 1) bad++;
+                }
+                full_pool.free(p);
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad.load());
+    TEST_ASSERT_EQUAL_INT(0, full_pool.used());
+}
+
+// ==================== MemArena ====================
+
+void test_arena_alignment_and_overflow(void) {
+    TEST_ASSERT_TRUE(arena.begin());
+    arena.reset();
+    uint8_t *a = (uint8_t *)arena.alloc(3, 1);
+    uint8_t *b = (uint8_t *)arena.alloc(8, 8);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_size_t(8, b - a);     // 按偏移对齐：3 向上取到 8
+
+    // 已用 16 字节，剩余 48
+    TEST_ASSERT_NULL(arena.alloc(49, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, arena.overflows());
+    TEST_ASSERT_NOT_NULL(arena.alloc(48, 1));
+    TEST_ASSERT_NULL(arena.alloc(1, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, arena.overflows());
+    TEST_ASSERT_EQUAL_size_t(64, arena.peak());
+}
+
+void test_arena_reset_reuses_memory(void) {
+    TEST_ASSERT_TRUE(arena.begin());
+    arena.reset();
+    void *first = arena.alloc(40);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NULL(arena.alloc(40));
+
+    arena.reset();
+    TEST_ASSERT_TRUE(arena.alloc(40) == first);
+    arena.reset();
+    TEST_ASSERT_NOT_NULL(arena.alloc(64, 1));
+    // 峰值跨复位保留
+    TEST_ASSERT_EQUAL_size_t(64, arena.peak());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pool_rounds_block_size);
+    RUN_TEST(test_pool_alloc_before_begin_fails);
+    RUN_TEST(test_pool_exhaustion_and_free);
+    RUN_TEST(test_pool_all_32_blocks);
+    RUN_TEST(test_pool_concurrent_alloc_free);
+    RUN_TEST(test_arena_alignment_and_overflow);
+    RUN_TEST(test_arena_reset_reuses_memory);
+    return UNITY_END();
+}
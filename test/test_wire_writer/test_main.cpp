@@ -0,0 +1,165 @@
+/**
+ * WireWriter：同一组字段的 JSON / CBOR / MessagePack 编码与已知字节比对
+ *
+ *   pio test -e native -f test_wire_writer
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "wire_writer.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// {"a":1,"b":true,"s":"hi","n":-2}
+static size_t encodeSample(WireFormat format, uint8_t *buf, size_t cap, bool *ok) {
+    WireWriter w(buf, cap, format);
+    w.beginObject(4);
+    w.fieldUint("a", 1);
+    w.fieldBool("b", true);
+    w.fieldStr("s", "hi");
+    w.fieldInt("n", -2);
+    w.endObject();
+    *ok = w.ok();
+    return w.length();
+}
+
+void test_json_object(void) {
+    uint8_t buf[64];
+    bool ok;
+    size_t n = encodeSample(WIRE_JSON, buf, sizeof(buf), &ok);
+    TEST_ASSERT_TRUE(ok);
+    const char expected[] = "{\"a\":1,\"b\":true,\"s\":\"hi\",\"n\":-2}";
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), n);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, n);
+}
+
+void test_cbor_object(void) {
+    uint8_t buf[64];
+    bool ok;
+    size_t n = encodeSample(WIRE_CBOR, buf, sizeof(buf), &ok);
+    TEST_ASSERT_TRUE(ok);
+    const uint8_t expected[] = {
+        0xA4,                           // map(4)
+        0x61, 'a', 0x01,
+        0x61, 'b', 0xF5,
+        0x61, 's', 0x62, 'h', 'i',
+        0x61, 'n', 0x21,                // -2 = nint(1)
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, n);
+}
+
+void test_msgpack_object(void) {
+    uint8_t buf[64];
+    bool ok;
+    size_t n = encodeSample(WIRE_MSGPACK, buf, sizeof(buf), &ok);
+    TEST_ASSERT_TRUE(ok);
+    const uint8_t expected[] = {
+        0x84,                           // fixmap(4)
+        0xA1, 'a', 0x01,
+        0xA1, 'b', 0xC3,
+        0xA1, 's', 0xA2, 'h', 'i',
+        0xA1, 'n', 0xFE,                // negative fixint
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, n);
+}
+
+// 整数按大小选择最短编码
+static size_t encodeInts(WireFormat format, uint8_t *buf, size_t cap) {
+    WireWriter w(buf, cap, format);
+    w.beginObject(4);
+    w.fieldUint("u", 200);
+    w.fieldUint("v", 70000);
+    w.fieldUint("w", 5000000000ULL);
+    w.fieldInt("i", -200);
+    w.endObject();
+    TEST_ASSERT_TRUE(w.ok());
+    return w.length();
+}
+
+void test_cbor_integer_widths(void) {
+    uint8_t buf[64];
+    size_t n = encodeInts(WIRE_CBOR, buf, sizeof(buf));
+    const uint8_t expected[] = {
+        0xA4,
+        0x61, 'u', 0x18, 0xC8,
+        0x61, 'v', 0x1A, 0x00, 0x01, 0x11, 0x70,
+        0x61, 'w', 0x1B, 0x00, 0x00, 0x00, 0x01, 0x2A, 0x05, 0xF2, 0x00,
+        0x61, 'i', 0x38, 0xC7,
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, n);
+}
+
+void test_msgpack_integer_widths(void) {
+    uint8_t buf[64];
+    size_t n = encodeInts(WIRE_MSGPACK, buf, sizeof(buf));
+    const uint8_t expected[] = {
+        0x84,
+        0xA1, 'u', 0xCC, 0xC8,
+        0xA1, 'v', 0xCE, 0x00, 0x01, 0x11, 0x70,
+        0xA1, 'w', 0xCF, 0x00, 0x00, 0x00, 0x01, 0x2A, 0x05, 0xF2, 0x00,
+        0xA1, 'i', 0xD1, 0xFF, 0x38,
+    };
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, n);
+}
+
+void test_json_integer_widths_and_escapes(void) {
+    uint8_t buf[96];
+    size_t n = encodeInts(WIRE_JSON, buf, sizeof(buf));
+    const char expected[] = "{\"u\":200,\"v\":70000,\"w\":5000000000,\"i\":-200}";
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), n);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, n);
+
+    WireWriter w(buf, sizeof(buf), WIRE_JSON);
+    w.beginObject(1);
+    w.fieldStr("k", "a\"b\\c\n");
+    w.endObject();
+    TEST_ASSERT_TRUE(w.ok());
+    const char escaped[] = "{\"k\":\"a\\\"b\\\\c\\u000a\"}";
+    TEST_ASSERT_EQUAL_size_t(strlen(escaped), w.length());
+    TEST_ASSERT_EQUAL_MEMORY(escaped, buf, w.length());
+}
+
+void test_overflow_and_field_count_mismatch(void) {
+    uint8_t buf[64];
+    bool ok;
+    for (size_t cap = 0; cap < 15; cap++) {
+        encodeSample(WIRE_CBOR, buf, cap, &ok);
+        TEST_ASSERT_FALSE(ok);
+    }
+    encodeSample(WIRE_CBOR, buf, 15, &ok);
+    TEST_ASSERT_TRUE(ok);
+
+    WireWriter w(buf, sizeof(buf), WIRE_MSGPACK);
+    w.beginObject(2);
+    w.fieldUint("a", 1);
+    w.endObject();
+    TEST_ASSERT_FALSE(w.ok());
+}
+
+void test_format_selection(void) {
+    TEST_ASSERT_EQUAL_INT(WIRE_JSON, wireFormatFromAccept(NULL));
+    TEST_ASSERT_EQUAL_INT(WIRE_JSON, wireFormatFromAccept("*/*"));
+    TEST_ASSERT_EQUAL_INT(WIRE_CBOR, wireFormatFromAccept("Application/CBOR, */*;q=0.1"));
+    TEST_ASSERT_EQUAL_INT(WIRE_MSGPACK, wireFormatFromAccept("application/x-msgpack"));
+    TEST_ASSERT_EQUAL_INT(WIRE_CBOR, wireFormatByName("cbor", WIRE_JSON));
+    TEST_ASSERT_EQUAL_INT(WIRE_MSGPACK, wireFormatByName("xml", WIRE_MSGPACK));
+    TEST_ASSERT_EQUAL_STRING("application/cbor", wireContentType(WIRE_CBOR));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_json_object);
+    RUN_TEST(test_cbor_object);
+    RUN_TEST(test_msgpack_object);
+    RUN_TEST(test_cbor_integer_widths);
+    RUN_TEST(test_msgpack_integer_widths);
+    RUN_TEST(test_json_integer_widths_and_escapes);
+    RUN_TEST(test_overflow_and_field_count_mismatch);
+    RUN_TEST(test_format_selection);
+    return UNITY_END();
+}
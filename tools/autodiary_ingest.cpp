@@ -0,0 +1,928 @@
+/**
+ * AutoDiary 多设备采集服务 (Linux)
+ *
+ * 替代 scripts/servers/http_server.py 中 ESPDevice 的轮询 (每台设备一个 requests.Session、
+ * 阻塞请求、3 s 超时，设备一多就跟不上)。一个进程按固件的 HTTP 协议同时采集几百台设备：
+ *
+ *   /video.jpg     按 --fps 轮询；X-Frame-Seq 与上一帧相同时不保存
+ *   /audio/stream  chunked 长连接，断开后退避重连 (重连处的缺口见音频索引)
+ *   /status        每 --status-interval 秒一次，原样写入 status.json
+ *
+ * 每个工作线程一个 epoll，全部 socket 非阻塞，设备按顺序分给 --threads 个线程；
+ * 连接、超时、轮询间隔和重连退避都由线程内的定时器堆驱动，没有每设备线程、没有阻塞调用
+ * (写文件除外，落在页缓存上)。固件每个响应都是 Connection: close，帧读完后等设备先关闭
+ * (TIME_WAIT 留在设备一侧)，主机不会因为每秒几千个短连接耗尽临时端口。
+ *
+ * 零拷贝落盘：响应头用 MSG_PEEK 查看后只 recv 头部的字节，帧和音频数据用
+ * splice(socket → 线程的管道 → 文件) 在内核中搬运，不经过用户态缓冲区；
+ * --copy 改用 recv + pwrite (对比基准用)。
+ *
+ * 输出 (每台设备一个目录)：
+ *   <out>/<name>/video-<unix秒>-<序号>.mjpeg   JPEG 首尾相接
+ *   <out>/<name>/video-<unix秒>-<序号>.idx     每帧一行：seq capture_us clock_offset_us offset len
+ *   <out>/<name>/audio-<unix秒>-<序号>.pcm     16-bit 单声道 PCM (与 X-Audio-Format 相同)
+ *   <out>/<name>/audio-<unix秒>-<序号>.idx     每次 (重新) 连接或换文件一行：
+ *                                             sample_index capture_us clock_offset_us byte_offset sample_rate
+ *   <out>/<name>/status.json                   最近一次 /status (写临时文件后 rename)
+ * capture_us 为设备单调时钟，加上 clock_offset_us 为墙上时间 (偏移未知时为 0)。
+ * 文件超过 --rotate-mb 时换新文件；退出时截掉写了一半的帧。
+ *
+ * 构建与运行：
+ *
+ *     g++ -std=gnu++17 -O2 -pthread tools/autodiary_ingest.cpp -o autodiary_ingest
+ *     ./autodiary_ingest --out data/ingest --device cam1=192.168.1.11 --device cam2=192.168.1.12:80
+ *     ./autodiary_ingest --out data/ingest --devices devices.txt --threads 2
+ *
+ * devices.txt 每行 "名称 主机[:端口]"，# 开头为注释。负载测试见 scripts/test/ingest_bench.cpp。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define HEADER_MAX          4096        // 响应头上限 (固件约 600 字节)
+#define STATUS_BODY_MAX     8192
+#define CHUNK_HEAD_MAX      32
+#define EPOLL_BATCH         256
+#define BACKOFF_MIN_MS      1000
+#define BACKOFF_MAX_MS      30000
+#define AUDIO_IDLE_MS       5000        // 音频流超过该时长没有数据视为断开
+#define DRAIN_TIMEOUT_MS    500         // 响应读完后等设备关闭连接的上限
+#define PIPE_BYTES          (1 << 20)
+
+struct Config {
+    const char *out_dir = "data/ingest";
+    int threads = 1;
+    double fps = 5.0;
+    uint32_t status_interval_ms = 5000;
+    uint32_t timeout_ms = 3000;
+    uint32_t audio_latency_ms = 100;
+    uint64_t rotate_bytes = 256ULL << 20;
+    uint32_t stats_interval_s = 10;
+    bool copy = false;
+    bool video = true;
+    bool audio = true;
+    bool status = true;
+};
+
+static Config config;
+static std::atomic<bool> stopping{false};
+
+static int64_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ==================== 设备与输出文件 ====================
+
+enum StreamType { KIND_VIDEO, KIND_AUDIO, KIND_STATUS, KIND_COUNT };
+
+static const char *const KIND_NAMES[KIND_COUNT] = { "video", "audio", "status" };
+
+// 数据文件 + 索引文件；数据按 off 显式定位写入 (splice 不能写 O_APPEND 文件)
+struct OutFile {
+    int fd = -1;
+    int idx_fd = -1;
+    int64_t off = 0;
+    uint32_t serial = 0;        // 本次运行中换文件的次数
+};
+
+struct Stats {
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> frames_duplicate{0};
+    std::atomic<uint64_t> video_bytes{0};
+    std::atomic<uint64_t> audio_bytes{0};
+    std::atomic<uint64_t> status_ok{0};
+    std::atomic<uint64_t> errors[KIND_COUNT];
+};
+
+struct Conn;
+
+struct Device {
+    std::string name;
+    std::string host;           // Host 头
+    std::string dir;
+    struct sockaddr_in addr;
+    OutFile video;
+    OutFile audio;
+    uint32_t last_seq = 0;      // 最近保存的帧序号
+    std::atomic<int> online{-1};  // -1 尚未连上过；统计线程只读
+    Conn *conns[KIND_COUNT] = {};
+    Stats stats;
+};
+
+static bool ensureDir(const std::string &path) {
+    if (mkdir(path.c_str(), 0755) == 0 || errno == EEXIST) return true;
+    fprintf(stderr, "❌ 无法创建目录 %s: %s\n", path.c_str(), strerror(errno));
+    return false;
+}
+
+static bool writeAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// 截掉写了一半的数据后关闭
+static void closeOutFile(OutFile &f) {
+    if (f.fd >= 0) {
+        if (ftruncate(f.fd, f.off) != 0) { /* 只影响末尾的残帧 */ }
+        close(f.fd);
+    }
+    if (f.idx_fd >= 0) close(f.idx_fd);
+    f.fd = f.idx_fd = -1;
+    f.off = 0;
+}
+
+static bool openOutFile(Device &dev, OutFile &f, const char *prefix, const char *ext) {
+    closeOutFile(f);
+    // 序号保证同一秒内换文件时不覆盖，文件名按字典序即时间顺序
+    char name[64];
+    snprintf(name, sizeof(name), "/%s-%ld-%04u", prefix, (long)time(NULL), f.serial++);
+    std::string base = dev.dir + name;
+    f.fd = open((base + ext).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    f.idx_fd = open((base + ".idx").c_str(), O_WRONLY | O_CREAT | O_APPEND | O_TRUNC | O_CLOEXEC, 0644);
+    f.off = 0;
+    if (f.fd < 0 || f.idx_fd < 0) {
+        fprintf(stderr, "❌ %s: 无法创建 %s%s: %s\n", dev.name.c_str(), base.c_str(), ext, strerror(errno));
+        closeOutFile(f);
+        return false;
+    }
+    return true;
+}
+
+// ==================== 连接 ====================
+
+enum ConnState {
+    CONN_IDLE,
+    CONN_CONNECTING,
+    CONN_SENDING,
+    CONN_HEADERS,
+    CONN_BODY,                  // Content-Length 响应体 (帧 / 状态)
+    CONN_CHUNK_HEAD,            // 音频流 chunk 头
+    CONN_CHUNK_DATA,
+    CONN_CHUNK_TAIL,            // chunk 之后的 CRLF
+    CONN_DRAIN,                 // 响应已读完，等设备关闭
+};
+
+struct Conn {
+    Device *dev;
+    StreamType kind;
+    int fd = -1;
+    ConnState state = CONN_IDLE;
+    uint32_t timer_gen = 0;     // 定时器堆中只有 gen 相同的一项有效
+    int64_t deadline_ms = 0;    // 进行中的连接：超时时刻；空闲：下一次开始的时刻
+    int64_t started_ms = 0;
+    uint32_t backoff_ms = BACKOFF_MIN_MS;
+
+    char request[256];
+    size_t request_len = 0;
+    size_t request_sent = 0;
+
+    uint64_t body_left = 0;
+    bool discard = false;       // 重复帧：读完丢弃
+    std::string body;           // /status 响应体
+
+    // 帧
+    uint32_t seq = 0;
+    int64_t capture_us = 0;
+    int64_t clock_offset_us = 0;
+    int64_t frame_start = 0;
+
+    // 音频
+    uint64_t next_sample = 0;   // 下一个写入样本的绝对序号
+    uint32_t sample_rate = 16000;
+    uint32_t tail_left = 0;
+};
+
+struct Timer {
+    int64_t when_ms;
+    Conn *conn;
+    uint32_t gen;
+    bool operator<(const Timer &o) const { return when_ms > o.when_ms; }   // 最小堆
+};
+
+// ==================== 工作线程 ====================
+
+struct Worker {
+    int ep = -1;
+    int pipe_r = -1;            // splice 中转管道，每次搬运后立即排空
+    int pipe_w = -1;
+    int devnull = -1;
+    std::vector<Device *> devices;
+    std::vector<Conn *> conns;
+    std::priority_queue<Timer> timers;
+    char buf[64 * 1024];        // --copy 模式和丢弃数据用
+};
+
+static void schedule(Worker &w, Conn *c, int64_t when_ms) {
+    c->deadline_ms = when_ms;
+    c->timer_gen++;
+    w.timers.push({ when_ms, c, c->timer_gen });
+}
+
+static void markOnline(Conn *c, bool ok, const char *reason) {
+    Device *dev = c->dev;
+    if (ok && dev->online != 1) {
+        dev->online = 1;
+        fprintf(stderr, "✅ %s 在线 (%s)\n", dev->name.c_str(), dev->host.c_str());
+    } else if (!ok && dev->online != 0) {
+        dev->online = 0;
+        fprintf(stderr, "⚠️ %s 离线: %s %s\n", dev->name.c_str(), KIND_NAMES[c->kind], reason);
+    }
+}
+
+static void closeConn(Worker &w, Conn *c) {
+    if (c->fd >= 0) {
+        epoll_ctl(w.ep, EPOLL_CTL_DEL, c->fd, NULL);
+        close(c->fd);
+        c->fd = -1;
+    }
+    c->state = CONN_IDLE;
+}
+
+// 本轮结束，安排下一次：成功时按轮询间隔，失败时指数退避
+static void finishConn(Worker &w, Conn *c, bool ok, const char *reason) {
+    closeConn(w, c);
+    int64_t now = nowMs();
+    if (!ok) {
+        c->dev->stats.errors[c->kind]++;
+        markOnline(c, false, reason);
+        schedule(w, c, now + c->backoff_ms);
+        c->backoff_ms = c->backoff_ms * 2 > BACKOFF_MAX_MS ? BACKOFF_MAX_MS : c->backoff_ms * 2;
+        return;
+    }
+    c->backoff_ms = BACKOFF_MIN_MS;
+    int64_t interval = c->kind == KIND_VIDEO ? (int64_t)(1000.0 / config.fps)
+                     : c->kind == KIND_STATUS ? config.status_interval_ms : BACKOFF_MIN_MS;
+    int64_t next = c->started_ms + interval;
+    schedule(w, c, next > now ? next : now);
+}
+
+static void startConn(Worker &w, Conn *c) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        finishConn(w, c, false, strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    c->fd = fd;
+    c->started_ms = nowMs();
+    if (connect(fd, (struct sockaddr *)&c->dev->addr, sizeof(c->dev->addr)) != 0 && errno != EINPROGRESS) {
+        finishConn(w, c, false, strerror(errno));
+        return;
+    }
+
+    const char *path = c->kind == KIND_VIDEO ? "/video.jpg" : c->kind == KIND_STATUS ? "/status" : NULL;
+    char audio_path[48];
+    if (!path) {
+        snprintf(audio_path, sizeof(audio_path), "/audio/stream?latency_ms=%u", config.audio_latency_ms);
+        path = audio_path;
+    }
+    c->request_len = (size_t)snprintf(c->request, sizeof(c->request),
+        "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", path, c->dev->host.c_str());
+    c->request_sent = 0;
+    c->body.clear();
+    c->discard = false;
+    c->state = CONN_CONNECTING;
+
+    struct epoll_event ev;
+    ev.events = EPOLLOUT;
+    ev.data.ptr = c;
+    epoll_ctl(w.ep, EPOLL_CTL_ADD, fd, &ev);
+    schedule(w, c, c->started_ms + config.timeout_ms);
+}
+
+// 有进展时推迟超时 (定时器到期时再检查，不必每次重新入堆)
+static void touch(Conn *c) {
+    c->deadline_ms = nowMs() + (c->kind == KIND_AUDIO ? AUDIO_IDLE_MS : config.timeout_ms);
+}
+
+// ==================== 响应头 ====================
+
+static const char *findHeader(const char *head, size_t len, const char *name) {
+    size_t name_len = strlen(name);
+    const char *end = head + len;
+    for (const char *p = head; p < end; ) {
+        const char *eol = (const char *)memmem(p, end - p, "\r\n", 2);
+        if (!eol) break;
+        if ((size_t)(eol - p) > name_len && p[name_len] == ':' && strncasecmp(p, name, name_len) == 0) {
+            const char *v = p + name_len + 1;
+            while (v < eol && *v == ' ') v++;
+            return v;
+        }
+        p = eol + 2;
+    }
+    return NULL;
+}
+
+static int64_t headerInt(const char *head, size_t len, const char *name, int64_t fallback) {
+    const char *v = findHeader(head, len, name);
+    return v ? strtoll(v, NULL, 10) : fallback;
+}
+
+static void writeIndex(int idx_fd, const char *line, int len) {
+    if (idx_fd >= 0 && len > 0) writeAll(idx_fd, line, (size_t)len);
+}
+
+static void audioIndexLine(Conn *c) {
+    char line[128];
+    int len = snprintf(line, sizeof(line), "%llu %lld %lld %lld %u\n",
+                       (unsigned long long)c->next_sample, (long long)c->capture_us,
+                       (long long)c->clock_offset_us, (long long)c->dev->audio.off, c->sample_rate);
+    writeIndex(c->dev->audio.idx_fd, line, len);
+}
+
+// 读完整个响应头：返回 1 完成，0 还没收全，-1 出错 (reason 为原因)
+static int readHeaders(Conn *c, const char **reason) {
+    char head[HEADER_MAX];
+    ssize_t n = recv(c->fd, head, sizeof(head), MSG_PEEK);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EINTR) return 0;
+        *reason = strerror(errno);
+        return -1;
+    }
+    if (n == 0) {
+        *reason = "连接在响应头之前关闭";
+        return -1;
+    }
+    const char *end = (const char *)memmem(head, n, "\r\n\r\n", 4);
+    if (!end) {
+        if (n == (ssize_t)sizeof(head)) {
+            *reason = "响应头过长";
+            return -1;
+        }
+        return 0;
+    }
+    size_t head_len = end + 4 - head;
+    // 只取走头部，响应体留在 socket 中给 splice
+    if (recv(c->fd, head, head_len, 0) != (ssize_t)head_len) {
+        *reason = "读取响应头失败";
+        return -1;
+    }
+
+    int code = 0;
+    if (sscanf(head, "HTTP/1.%*d %d", &code) != 1 || code != 200) {
+        *reason = code == 503 ? "503 (摄像头 / 麦克风未就绪或流连接已满)" : "响应状态不是 200";
+        return -1;
+    }
+    c->capture_us = headerInt(head, head_len, "X-Capture-Us", 0);
+    c->clock_offset_us = headerInt(head, head_len, "X-Clock-Offset-Us", 0);
+    int64_t length = headerInt(head, head_len, "Content-Length", -1);
+    Device *dev = c->dev;
+
+    if (c->kind == KIND_AUDIO) {
+        const char *te = findHeader(head, head_len, "Transfer-Encoding");
+        if (!te || strncasecmp(te, "chunked", 7) != 0) {
+            *reason = "音频流不是 chunked";
+            return -1;
+        }
+        c->next_sample = (uint64_t)headerInt(head, head_len, "X-Sample-Index", 0);
+        c->sample_rate = (uint32_t)headerInt(head, head_len, "X-Sample-Rate", 16000);
+        if (dev->audio.fd < 0 && !openOutFile(*dev, dev->audio, "audio", ".pcm")) {
+            *reason = "无法创建音频文件";
+            return -1;
+        }
+        audioIndexLine(c);
+        c->state = CONN_CHUNK_HEAD;
+        return 1;
+    }
+
+    if (length < 0) {
+        *reason = "缺少 Content-Length";
+        return -1;
+    }
+    c->body_left = (uint64_t)length;
+    c->state = CONN_BODY;
+    if (c->kind == KIND_STATUS) {
+        if (length > STATUS_BODY_MAX) {
+            *reason = "状态响应过大";
+            return -1;
+        }
+        return 1;
+    }
+
+    c->seq = (uint32_t)headerInt(head, head_len, "X-Frame-Seq", 0);
+    if (c->seq != 0 && c->seq == dev->last_seq) {
+        // 设备还没有新帧：丢弃响应体，不写文件
+        c->discard = true;
+        dev->stats.frames_duplicate++;
+        return 1;
+    }
+    if (dev->video.fd < 0 || (uint64_t)dev->video.off >= config.rotate_bytes) {
+        if (!openOutFile(*dev, dev->video, "video", ".mjpeg")) {
+            *reason = "无法创建视频文件";
+            return -1;
+        }
+    }
+    c->frame_start = dev->video.off;
+    return 1;
+}
+
+// ==================== 数据搬运 ====================
+
+// 从 socket 搬最多 want 字节到文件 f (f 为 NULL 时丢弃)：返回搬运的字节数，
+// 0 表示对端关闭，-1 表示暂时没有数据，-2 表示出错
+static ssize_t transfer(Worker &w, Conn *c, OutFile *f, uint64_t want) {
+    if (config.copy || !f) {
+        size_t cap = want < sizeof(w.buf) ? (size_t)want : sizeof(w.buf);
+        ssize_t n = recv(c->fd, w.buf, cap, 0);
+        if (n < 0) return errno == EAGAIN || errno == EINTR ? -1 : -2;
+        if (n == 0 || !f) return n;
+        if (pwrite(f->fd, w.buf, n, f->off) != n) return -2;
+        f->off += n;
+        return n;
+    }
+
+    size_t cap = want < PIPE_BYTES ? (size_t)want : PIPE_BYTES;
+    ssize_t n = splice(c->fd, NULL, w.pipe_w, NULL, cap, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (n < 0) return errno == EAGAIN || errno == EINTR ? -1 : -2;
+    if (n == 0) return 0;
+    // 管道必须在返回前排空 (下一个连接复用同一个管道)
+    ssize_t left = n;
+    while (left > 0) {
+        loff_t off = f->off;
+        ssize_t m = splice(w.pipe_r, NULL, f->fd, &off, left, SPLICE_F_MOVE);
+        if (m <= 0) {
+            if (m < 0 && errno == EINTR) continue;
+            while (left > 0) {
+                ssize_t d = read(w.pipe_r, w.buf, left < (ssize_t)sizeof(w.buf) ? left : sizeof(w.buf));
+                if (d <= 0) break;
+                left -= d;
+            }
+            return -2;
+        }
+        f->off += m;
+        left -= m;
+    }
+    return n;
+}
+
+// 读完一个 chunk 头：返回 1 完成，0 还没收全，-1 出错
+static int readChunkHead(Conn *c, const char **reason) {
+    char head[CHUNK_HEAD_MAX];
+    ssize_t n = recv(c->fd, head, sizeof(head), MSG_PEEK);
+    if (n < 0) return errno == EAGAIN || errno == EINTR ? 0 : (*reason = strerror(errno), -1);
+    if (n == 0) {
+        *reason = "音频流被关闭";
+        return -1;
+    }
+    const char *eol = (const char *)memmem(head, n, "\r\n", 2);
+    if (!eol) {
+        if (n == (ssize_t)sizeof(head)) {
+            *reason = "chunk 头格式错误";
+            return -1;
+        }
+        return 0;
+    }
+    size_t head_len = eol + 2 - head;
+    recv(c->fd, head, head_len, 0);
+    char *end;
+    unsigned long size = strtoul(head, &end, 16);
+    if (end == head) {
+        *reason = "chunk 头格式错误";
+        return -1;
+    }
+    if (size == 0) {
+        *reason = "音频流结束";
+        return -1;
+    }
+    c->body_left = size;
+    c->state = CONN_CHUNK_DATA;
+    return 1;
+}
+
+static void saveStatus(Conn *c) {
+    Device *dev = c->dev;
+    std::string tmp = dev->dir + "/status.json.tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    bool ok = writeAll(fd, c->body.data(), c->body.size());
+    close(fd);
+    if (ok && rename(tmp.c_str(), (dev->dir + "/status.json").c_str()) == 0) {
+        dev->stats.status_ok++;
+    }
+}
+
+// 响应体读完：帧写索引，状态写文件，然后等设备关闭连接
+static void bodyDone(Conn *c) {
+    Device *dev = c->dev;
+    if (c->kind == KIND_VIDEO && !c->discard) {
+        char line[128];
+        int len = snprintf(line, sizeof(line), "%u %lld %lld %lld %lld\n", (unsigned)c->seq,
+                           (long long)c->capture_us, (long long)c->clock_offset_us,
+                           (long long)c->frame_start, (long long)(dev->video.off - c->frame_start));
+        writeIndex(dev->video.idx_fd, line, len);
+        dev->last_seq = c->seq;
+        dev->stats.frames++;
+        dev->stats.video_bytes += dev->video.off - c->frame_start;
+    } else if (c->kind == KIND_STATUS) {
+        saveStatus(c);
+    }
+    markOnline(c, true, NULL);
+    c->state = CONN_DRAIN;
+    c->deadline_ms = nowMs() + DRAIN_TIMEOUT_MS;
+}
+
+// 处理可读数据直到暂时没有数据、连接结束或出错
+static void pump(Worker &w, Conn *c) {
+    const char *reason = "连接错误";
+    while (1) {
+        switch (c->state) {
+            case CONN_HEADERS: {
+                int r = readHeaders(c, &reason);
+                if (r == 0) return;
+                if (r < 0) goto fail;
+                touch(c);
+                if (c->state == CONN_BODY && c->body_left == 0) bodyDone(c);
+                break;
+            }
+            case CONN_BODY: {
+                ssize_t n;
+                if (c->kind == KIND_STATUS) {
+                    char buf[2048];
+                    n = recv(c->fd, buf, c->body_left < sizeof(buf) ? c->body_left : sizeof(buf), 0);
+                    if (n < 0) n = errno == EAGAIN || errno == EINTR ? -1 : -2;
+                    if (n > 0) c->body.append(buf, n);
+                } else {
+                    n = transfer(w, c, c->discard ? NULL : &c->dev->video, c->body_left);
+                }
+                if (n == -1) return;
+                if (n <= 0) {
+                    reason = n == 0 ? "响应体不完整" : "读取或写入失败";
+                    if (c->kind == KIND_VIDEO && !c->discard) c->dev->video.off = c->frame_start;
+                    goto fail;
+                }
+                c->body_left -= n;
+                touch(c);
+                if (c->body_left == 0) bodyDone(c);
+                break;
+            }
+            case CONN_CHUNK_HEAD: {
+                Device *dev = c->dev;
+                if ((uint64_t)dev->audio.off >= config.rotate_bytes) {
+                    if (!openOutFile(*dev, dev->audio, "audio", ".pcm")) {
+                        reason = "无法创建音频文件";
+                        goto fail;
+                    }
+                    audioIndexLine(c);
+                }
+                int r = readChunkHead(c, &reason);
+                if (r == 0) return;
+                if (r < 0) goto fail;
+                break;
+            }
+            case CONN_CHUNK_DATA: {
+                ssize_t n = transfer(w, c, &c->dev->audio, c->body_left);
+                if (n == -1) return;
+                if (n <= 0) {
+                    reason = n == 0 ? "音频流被关闭" : "读取或写入失败";
+                    goto fail;
+                }
+                c->body_left -= n;
+                c->next_sample += n / 2;
+                c->dev->stats.audio_bytes += n;
+                touch(c);
+                if (c->body_left == 0) {
+                    c->state = CONN_CHUNK_TAIL;
+                    c->tail_left = 2;
+                }
+                break;
+            }
+            case CONN_CHUNK_TAIL: {
+                char crlf[2];
+                ssize_t n = recv(c->fd, crlf, c->tail_left, 0);
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+                if (n <= 0) {
+                    reason = "音频流被关闭";
+                    goto fail;
+                }
+                c->tail_left -= n;
+                if (c->tail_left == 0) {
+                    c->state = CONN_CHUNK_HEAD;
+                    markOnline(c, true, NULL);
+                }
+                break;
+            }
+            case CONN_DRAIN: {
+                ssize_t n = recv(c->fd, w.buf, sizeof(w.buf), 0);
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+                finishConn(w, c, true, NULL);
+                return;
+            }
+            default:
+                return;
+        }
+    }
+
+fail:
+    finishConn(w, c, false, reason);
+}
+
+static void onIo(Worker &w, Conn *c, uint32_t events) {
+    if (c->state == CONN_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            finishConn(w, c, false, strerror(err));
+            return;
+        }
+        c->state = CONN_SENDING;
+    }
+    if (c->state == CONN_SENDING) {
+        ssize_t n = send(c->fd, c->request + c->request_sent, c->request_len - c->request_sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EINTR) finishConn(w, c, false, strerror(errno));
+            return;
+        }
+        c->request_sent += n;
+        if (c->request_sent < c->request_len) return;
+        c->state = CONN_HEADERS;
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        epoll_ctl(w.ep, EPOLL_CTL_MOD, c->fd, &ev);
+        return;
+    }
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) pump(w, c);
+}
+
+static void onTimer(Worker &w, Conn *c, int64_t now) {
+    if (c->state == CONN_IDLE) {
+        startConn(w, c);
+    } else if (now >= c->deadline_ms) {
+        // 等设备关闭超时不算失败：响应已经完整收到
+        if (c->state == CONN_DRAIN) finishConn(w, c, true, NULL);
+        else finishConn(w, c, false, "超时");
+    } else {
+        schedule(w, c, c->deadline_ms);
+    }
+}
+
+static void workerRun(Worker *w) {
+    struct epoll_event events[EPOLL_BATCH];
+    while (!stopping.load()) {
+        int64_t now = nowMs();
+        while (!w->timers.empty() && w->timers.top().when_ms <= now) {
+            Timer t = w->timers.top();
+            w->timers.pop();
+            if (t.gen == t.conn->timer_gen) onTimer(*w, t.conn, now);
+        }
+        int timeout = 200;
+        if (!w->timers.empty()) {
+            int64_t wait = w->timers.top().when_ms - nowMs();
+            timeout = wait < 0 ? 0 : wait < timeout ? (int)wait : timeout;
+        }
+        int n = epoll_wait(w->ep, events, EPOLL_BATCH, timeout);
+        for (int i = 0; i < n; i++) {
+            onIo(*w, (Conn *)events[i].data.ptr, events[i].events);
+        }
+    }
+    for (Conn *c : w->conns) closeConn(*w, c);
+    for (Device *dev : w->devices) {
+        closeOutFile(dev->video);
+        closeOutFile(dev->audio);
+    }
+}
+
+static bool workerBegin(Worker &w) {
+    w.ep = epoll_create1(EPOLL_CLOEXEC);
+    int p[2];
+    if (w.ep < 0 || pipe2(p, O_CLOEXEC) != 0) {
+        fprintf(stderr, "❌ epoll / pipe 创建失败: %s\n", strerror(errno));
+        return false;
+    }
+    w.pipe_r = p[0];
+    w.pipe_w = p[1];
+    fcntl(w.pipe_w, F_SETPIPE_SZ, PIPE_BYTES);
+
+    // 同一线程的设备错开开始时刻，不在同一毫秒发起全部连接
+    int64_t now = nowMs();
+    int64_t spread = (int64_t)(1000.0 / config.fps);
+    size_t i = 0;
+    for (Device *dev : w.devices) {
+        for (int k = 0; k < KIND_COUNT; k++) {
+            bool enabled = k == KIND_VIDEO ? config.video : k == KIND_AUDIO ? config.audio : config.status;
+            if (!enabled) continue;
+            Conn *c = new Conn();
+            c->dev = dev;
+            c->kind = (StreamType)k;
+            dev->conns[k] = c;
+            w.conns.push_back(c);
+            schedule(w, c, now + (int64_t)(i * spread / w.devices.size()));
+        }
+        i++;
+    }
+    return true;
+}
+
+// ==================== 配置 ====================
+
+static bool addDevice(std::vector<Device *> &devices, const std::string &name, const std::string &target) {
+    std::string host = target;
+    int port = 80;
+    size_t colon = target.rfind(':');
+    if (colon != std::string::npos) {
+        host = target.substr(0, colon);
+        port = atoi(target.c_str() + colon + 1);
+    }
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(host.c_str(), NULL, &hints, &res) != 0 || !res) {
+        fprintf(stderr, "❌ 无法解析设备地址: %s\n", target.c_str());
+        return false;
+    }
+    Device *dev = new Device();
+    dev->name = name;
+    dev->host = target;
+    dev->addr = *(struct sockaddr_in *)res->ai_addr;
+    dev->addr.sin_port = htons((uint16_t)port);
+    freeaddrinfo(res);
+    dev->dir = std::string(config.out_dir) + "/" + name;
+    devices.push_back(dev);
+    return true;
+}
+
+static bool loadDevices(std::vector<Device *> &devices, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "❌ 无法打开设备列表 %s\n", path);
+        return false;
+    }
+    char line[256];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        char name[128], target[128];
+        if (line[0] == '#' || sscanf(line, "%127s %127s", name, target) != 2) continue;
+        ok = addDevice(devices, name, target);
+    }
+    fclose(f);
+    return ok;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "用法: %s --out DIR (--device NAME=HOST[:PORT] ... | --devices FILE)\n"
+            "          [--threads N] [--fps F] [--status-interval S] [--timeout-ms MS]\n"
+            "          [--audio-latency-ms MS] [--rotate-mb MB] [--stats-interval S]\n"
+            "          [--no-video] [--no-audio] [--no-status] [--copy]\n", prog);
+}
+
+static void onSignal(int) {
+    stopping.store(true);
+}
+
+// ==================== 统计 ====================
+
+struct Totals {
+    uint64_t frames, duplicates, video_bytes, audio_bytes, status_ok, errors;
+    int online;
+};
+
+static Totals collect(const std::vector<Device *> &devices) {
+    Totals t = {};
+    for (Device *dev : devices) {
+        t.frames += dev->stats.frames.load();
+        t.duplicates += dev->stats.frames_duplicate.load();
+        t.video_bytes += dev->stats.video_bytes.load();
+        t.audio_bytes += dev->stats.audio_bytes.load();
+        t.status_ok += dev->stats.status_ok.load();
+        for (int k = 0; k < KIND_COUNT; k++) t.errors += dev->stats.errors[k].load();
+        t.online += dev->online == 1 ? 1 : 0;
+    }
+    return t;
+}
+
+int main(int argc, char **argv) {
+    std::vector<Device *> devices;
+    std::vector<std::pair<std::string, std::string>> device_args;
+    const char *devices_file = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--out") == 0 && next) {
+            config.out_dir = argv[++i];
+        } else if (strcmp(argv[i], "--device") == 0 && next) {
+            const char *eq = strchr(next, '=');
+            if (!eq) {
+                usage(argv[0]);
+                return 2;
+            }
+            device_args.push_back({ std::string(next, eq - next), eq + 1 });
+            i++;
+        } else if (strcmp(argv[i], "--devices") == 0 && next) {
+            devices_file = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && next) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && next) {
+            config.fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--status-interval") == 0 && next) {
+            config.status_interval_ms = (uint32_t)(atof(argv[++i]) * 1000);
+        } else if (strcmp(argv[i], "--timeout-ms") == 0 && next) {
+            config.timeout_ms = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--audio-latency-ms") == 0 && next) {
+            config.audio_latency_ms = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rotate-mb") == 0 && next) {
+            config.rotate_bytes = (uint64_t)atoll(argv[++i]) << 20;
+        } else if (strcmp(argv[i], "--stats-interval") == 0 && next) {
+            config.stats_interval_s = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-video") == 0) {
+            config.video = false;
+        } else if (strcmp(argv[i], "--no-audio") == 0) {
+            config.audio = false;
+        } else if (strcmp(argv[i], "--no-status") == 0) {
+            config.status = false;
+        } else if (strcmp(argv[i], "--copy") == 0) {
+            config.copy = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.threads < 1) config.threads = 1;
+    if (config.fps <= 0) config.fps = 1;
+    if (config.rotate_bytes == 0) config.rotate_bytes = 256ULL << 20;
+
+    if (!ensureDir(config.out_dir)) return 1;
+    if (devices_file && !loadDevices(devices, devices_file)) return 1;
+    for (auto &d : device_args) {
+        if (!addDevice(devices, d.first, d.second)) return 1;
+    }
+    if (devices.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (Device *dev : devices) {
+        if (!ensureDir(dev->dir)) return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    int threads = config.threads < (int)devices.size() ? config.threads : (int)devices.size();
+    std::vector<Worker *> workers;
+    for (int t = 0; t < threads; t++) workers.push_back(new Worker());
+    for (size_t i = 0; i < devices.size(); i++) workers[i * threads / devices.size()]->devices.push_back(devices[i]);
+    for (Worker *w : workers) {
+        if (!workerBegin(*w)) return 1;
+    }
+
+    fprintf(stderr, "📡 采集 %zu 台设备 (%d 线程, 视频 %.1f fps, %s)，输出到 %s\n", devices.size(), threads,
+            config.fps, config.copy ? "recv + pwrite" : "splice 零拷贝", config.out_dir);
+
+    std::vector<std::thread> running;
+    for (Worker *w : workers) running.emplace_back(workerRun, w);
+
+    Totals last = collect(devices);
+    int64_t last_ms = nowMs();
+    while (!stopping.load()) {
+        usleep(100 * 1000);
+        int64_t now = nowMs();
+        if (config.stats_interval_s == 0 || now - last_ms < (int64_t)config.stats_interval_s * 1000) continue;
+        Totals cur = collect(devices);
+        double sec = (now - last_ms) / 1000.0;
+        fprintf(stderr, "📊 在线 %d/%zu | 帧 %.1f/s (重复 %.1f/s) %.2f MB/s | 音频 %.1f KB/s | 状态 %.1f/s | 错误 %llu\n",
+                cur.online, devices.size(), (cur.frames - last.frames) / sec,
+                (cur.duplicates - last.duplicates) / sec, (cur.video_bytes - last.video_bytes) / sec / 1e6,
+                (cur.audio_bytes - last.audio_bytes) / sec / 1e3, (cur.status_ok - last.status_ok) / sec,
+                (unsigned long long)(cur.errors - last.errors));
+        last = cur;
+        last_ms = now;
+    }
+
+    for (std::thread &t : running) t.join();
+    Totals total = collect(devices);
+    fprintf(stderr, "✅ 已停止: 帧 %llu (%.1f MB), 重复 %llu, 音频 %.1f MB, 状态 %llu, 错误 %llu\n",
+            (unsigned long long)total.frames, total.video_bytes / 1e6, (unsigned long long)total.duplicates,
+            total.audio_bytes / 1e6, (unsigned long long)total.status_ok, (unsigned long long)total.errors);
+    return 0;
+}
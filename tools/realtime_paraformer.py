@@ -26,6 +26,8 @@ import threading
 import queue
 import time
 import datetime
+import json
+import urllib.request
 import warnings
 from pathlib import Path
 from typing import Callable, List
@@ -365,7 +367,8 @@ class RealtimeRecorder:
                  min_speech_ms: int = 500,  # 降低最小语音长度，让VAD自己判断
                  silence_threshold_ms: int = 2000,  # 静默阈值：增加到2秒，积累更多上下文
                  paragraph_gap_minutes: float = 1.0,  # 段落间隔：1分钟无语音视为新段落
-                 save_audio: bool = False):  # 新增：是否保存音频
+                 save_audio: bool = False,  # 新增：是否保存音频
+                 scene_device: str = ""):  # 设备地址：按设备的场景切换事件分段
 
         self.recognizer = recognizer
         self.vad_model = vad_model
@@ -378,6 +381,7 @@ class RealtimeRecorder:
         self.silence_threshold_ms = silence_threshold_ms  # 静默阈值
         self.paragraph_gap_seconds = paragraph_gap_minutes * 60  # 转换为秒
         self.save_audio = save_audio  # 新增：是否保存音频
+        self.scene_device = scene_device.rstrip("/")
 
         self.chunk_size = 1024
         self.audio_buffer = []
@@ -882,6 +886,28 @@ class RealtimeRecorder:
                 print(f"\n[检测到静默] 超过 {self.paragraph_gap_seconds/60:.1f} 分钟无新语音，触发段落总结...")
                 self.flush_pending_texts()
 
+    def scene_monitor_thread(self):
+        """Poll the device's /events feed and start a new paragraph on scene changes"""
+        since = None
+        while self.is_recording:
+            try:
+                url = f"{self.scene_device}/events?since={since or 0}"
+                with urllib.request.urlopen(url, timeout=3) as resp:
+                    feed = json.load(resp)
+            except (OSError, ValueError) as e:
+                print(f"[场景事件] 读取失败: {e}")
+                time.sleep(5)
+                continue
+
+            # 第一次只记下当前序号，不处理启动前的旧事件；设备重启后序号从头开始
+            if since is not None and (feed["events"] or feed["next"] < since):
+                scenes = [e for e in feed["events"] if e["type"] == "scene"]
+                if scenes:
+                    print(f"\n[场景切换] 设备检测到画面变化 (距离 {scenes[-1]['score']})，触发段落总结...")
+                    self.flush_pending_texts()
+            since = feed["next"]
+            time.sleep(2)
+
     def start(self):
         """Start recording"""
         self.audio = pyaudio.PyAudio()
@@ -901,6 +927,8 @@ class RealtimeRecorder:
         print(f"[最小语音长度] {self.min_speech_ms} ms")
         print(f"[静默阈值] {self.silence_threshold_ms} ms (超过此时间触发处理)")
         print(f"[段落间隔] {self.paragraph_gap_seconds/60:.1f} 分钟 (超过此时间视为新段落)")
+        if self.scene_device:
+            print(f"[场景分段] {self.scene_device}/events (设备检测到场景切换时视为新段落)")
         print(f"[模式] VAD 驱动的智能触发（语音结束后自动处理）")
 
         if self.save_audio:
@@ -924,6 +952,8 @@ class RealtimeRecorder:
         # 启动段落监控线程
         monitor_thread = threading.Thread(target=self.paragraph_monitor_thread, daemon=True)
         monitor_thread.start()
+        if self.scene_device:
+            threading.Thread(target=self.scene_monitor_thread, daemon=True).start()
 
         try:
             while self.is_recording and self.stream.is_active():
@@ -1001,6 +1031,9 @@ def get_args():
     parser.add_argument("--paragraph-gap", type=float, default=5.0,
                         help="Paragraph gap in minutes (default: 5.0). "
                              "If no speech for this duration, trigger paragraph summarization.")
+    parser.add_argument("--scene-device", type=str, default="",
+                        help="Device URL (e.g. http://192.168.1.11). Also start a new paragraph "
+                             "when the device reports a scene change on /events.")
     parser.add_argument("--save-audio", action="store_true",
                         help="Save raw audio to WAV file while recognizing (default: False)")
     parser.add_argument("--list-devices", action="store_true",
@@ -1080,7 +1113,8 @@ def main():
         min_speech_ms=args.min_speech,
         silence_threshold_ms=args.silence_threshold,
         paragraph_gap_minutes=args.paragraph_gap,
-        save_audio=args.save_audio  # 新增：传递音频保存参数
+        save_audio=args.save_audio,  # 新增：传递音频保存参数
+        scene_device=args.scene_device
     )
 
     recorder.start()
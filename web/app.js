@@ -0,0 +1,25 @@
+// 视频走 /stream (MJPEG，一个长连接)；流连接已满时退回每秒拉取一次 /video.jpg
+(function () {
+  var video = document.getElementById('videoStream');
+  var polling = null;
+
+  video.addEventListener('error', function () {
+    if (polling) return;
+    polling = setInterval(function () {
+      video.src = '/video.jpg?t=' + Date.now();
+    }, 1000);
+  });
+
+  document.querySelectorAll('button[data-href]').forEach(function (button) {
+    button.addEventListener('click', function () {
+      location.href = button.getAttribute('data-href');
+    });
+  });
+
+  // 状态只在页面加载时读取一次
+  fetch('/status').then(function (resp) { return resp.json(); }).then(function (s) {
+    document.getElementById('device').textContent = s.device;
+    document.getElementById('wifi').textContent = s.wifi_connected ? s.ip_address + ' (' + s.signal_strength + ' dBm)' : 'Disconnected';
+    document.getElementById('camera').textContent = s.camera_initialized ? 'OK' : 'Not initialized';
+  }).catch(function () {});
+})();